@@ -102,6 +102,10 @@
  * @defgroup libmeos_spantime_comp Comparison functions
  * @ingroup libmeos_spantime
  * @brief Comparison functions for span and time types.
+ *
+ * @defgroup libmeos_spantime_index Index functions
+ * @ingroup libmeos_spantime
+ * @brief Interval index for period types.
  */
 
 /**
@@ -144,6 +148,10 @@
  * @defgroup libmeos_box_comp Comparison functions
  * @ingroup libmeos_box
  * @brief Comparison functions for box types.
+ *
+ * @defgroup libmeos_box_index Index functions
+ * @ingroup libmeos_box
+ * @brief R-tree index for box types.
  */
 
 /**
@@ -246,6 +254,14 @@
  * @defgroup libmeos_temporal_analytics Analytics functions
  * @ingroup libmeos_temporal
  * @brief Analytics functions for temporal types.
+ *
+ * @defgroup libmeos_temporal_batch Batch functions
+ * @ingroup libmeos_temporal
+ * @brief Functions applied in parallel to arrays of temporal values.
+ *
+ * Concurrent calls of the batch functions are executed one after the other.
+ * A batch only applies functions that are safe to run concurrently, the
+ * functions calling GEOS raise an error when called within a batch.
  */
 
 /*****************************************************************************
@@ -0,0 +1,76 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief In-memory interval index over periods.
+ */
+
+#ifndef __PERIOD_INDEX_H__
+#define __PERIOD_INDEX_H__
+
+/* MobilityDB */
+#include <meos.h>
+
+/*****************************************************************************/
+
+/** Size of the subtrees of the index that are scanned linearly */
+#define PERIOD_INDEX_SCAN_LEVEL 3
+
+/**
+ * Upper bound of a period
+ */
+typedef struct
+{
+  TimestampTz t;               /**< Value of the bound */
+  bool inclusive;              /**< Inclusivity of the bound */
+} PeriodIndexBound;
+
+/**
+ * Interval index over periods associated to user identifiers.
+ *
+ * The periods are sorted by lower bound and form an implicit balanced binary
+ * tree, in which the element at position @p i is at level @p k when the
+ * @p k lowest bits of @p i are set. Each element keeps the maximum upper
+ * bound of its subtree. The upper bounds are additionally kept sorted for
+ * answering count queries by binary search.
+ */
+struct PeriodIndex
+{
+  int count;                   /**< Number of periods */
+  int maxlevel;                /**< Level of the root of the implicit tree */
+  bool distinct;               /**< True when each identifier has one period */
+  Period *periods;             /**< Periods sorted by lower bound */
+  int64 *ids;                  /**< Identifiers of the periods */
+  TimestampTz *maxupper;       /**< Maximum upper bound of the subtrees */
+  PeriodIndexBound *uppers;    /**< Upper bounds sorted */
+};
+
+/*****************************************************************************/
+
+#endif /* __PERIOD_INDEX_H__ */
@@ -0,0 +1,104 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief In-memory R-tree indexing spatiotemporal and temporal boxes.
+ */
+
+#ifndef __RTREE_H__
+#define __RTREE_H__
+
+/* MobilityDB */
+#include <meos.h>
+#include "general/temporal_catalog.h"
+
+/*****************************************************************************/
+
+/** Maximum number of entries of a node */
+#define RTREE_MAXENTRIES 16
+/** Minimum number of entries of a non-root node */
+#define RTREE_MINENTRIES 6
+/** Number of dimensions of the rectangles: x, y, z, t */
+#define RTREE_MAXDIMS 4
+
+/**
+ * Rectangle of a node entry. The dimensions that are not used by the boxes
+ * of the tree are not stored, those that are not used by a query box are set
+ * to an infinite range.
+ */
+typedef struct
+{
+  double min[RTREE_MAXDIMS];   /**< Lower bounds */
+  double max[RTREE_MAXDIMS];   /**< Upper bounds */
+} RTreeRect;
+
+/**
+ * Node of an R-tree. The pointers of the leaf nodes are the slots of the
+ * boxes and identifiers in the tree, the pointers of the internal nodes are
+ * the numbers of the child nodes.
+ */
+typedef struct
+{
+  int16 count;                           /**< Number of entries */
+  int16 level;                           /**< Level, 0 for the leaves */
+  RTreeRect rects[RTREE_MAXENTRIES];     /**< Rectangles of the entries */
+  int64 ptrs[RTREE_MAXENTRIES];          /**< Slots or child nodes */
+} RTreeNode;
+
+/**
+ * R-tree over boxes of type STBOX or TBOX associated to user identifiers.
+ * The nodes are stored in an array and refer to each other by their number,
+ * so that a tree can be written to a file and memory-mapped as is.
+ */
+struct RTree
+{
+  mobdbType boxtype;           /**< Type of the boxes, T_STBOX or T_TBOX */
+  int16 flags;                 /**< Flags of the indexed boxes */
+  int32 srid;                  /**< SRID of the indexed boxes */
+  bool hasflags;               /**< True when the flags are known */
+  int ndims;                   /**< Number of dimensions used */
+  int dims[RTREE_MAXDIMS];     /**< Dimensions used */
+  int32 root;                  /**< Number of the root node */
+  int64 count;                 /**< Number of indexed boxes */
+  RTreeNode *nodes;            /**< Array of nodes */
+  int32 nnodes;                /**< Number of nodes in the array */
+  int32 maxnodes;              /**< Capacity of the array of nodes */
+  int32 freenode;              /**< First node of the free list, or -1 */
+  char *boxes;                 /**< Array of boxes indexed by slot */
+  int64 *ids;                  /**< Array of identifiers indexed by slot */
+  int64 nslots;                /**< Number of slots in the arrays */
+  int64 maxslots;              /**< Capacity of the arrays */
+  int64 freeslot;              /**< First slot of the free list, or -1 */
+  void *mapping;               /**< Address of the file mapping, if any */
+  size_t mapsize;              /**< Size of the file mapping */
+};
+
+/*****************************************************************************/
+
+#endif /* __RTREE_H__ */
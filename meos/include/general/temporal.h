@@ -157,9 +157,28 @@ typedef enum
 #define TSEQUENCE       3
 #define TSEQUENCESET    4
 
+/*****************************************************************************
+ * Block directory of temporal sequences
+ *****************************************************************************/
+
+/** Number of segments summarized by each block of a temporal sequence */
+#define TSEQUENCE_BLOCK_SIZE   64
+/** Minimum number of instants of a temporal sequence with blocks */
+#define TSEQUENCE_BLOCK_MIN    512
+
+/*****************************************************************************
+ * Instant index of temporal sequence sets
+ *****************************************************************************/
+
+/** Minimum number of sequences of a temporal sequence set with an index of
+ * its distinct instants and timestamps */
+#define TSEQUENCESET_INDEX_MIN 8
+
 /*****************************************************************************
  * Macros for manipulating the 'flags' element where the less significant
- * bits are GTZXLCB, where
+ * bits are IKGTZXLCB, where
+ *   I: sequence set has an instant index
+ *   K: sequence has a block directory
  *   G: coordinates are geodetic
  *   T: has T coordinate,
  *   Z: has Z coordinate
@@ -180,6 +199,8 @@ typedef enum
 #define MOBDB_FLAG_Z          0x0010
 #define MOBDB_FLAG_T          0x0020
 #define MOBDB_FLAG_GEODETIC   0x0040
+#define MOBDB_FLAG_BLOCKS     0x0080
+#define MOBDB_FLAG_INDEX      0x0100
 
 /* The following flag is only used for TInstant */
 #define MOBDB_FLAGS_GET_BYVAL(flags)      ((bool) (((flags) & MOBDB_FLAG_BYVAL)))
@@ -189,6 +210,13 @@ typedef enum
 #define MOBDB_FLAGS_GET_Z(flags)          ((bool) (((flags) & MOBDB_FLAG_Z)>>4))
 #define MOBDB_FLAGS_GET_T(flags)          ((bool) (((flags) & MOBDB_FLAG_T)>>5))
 #define MOBDB_FLAGS_GET_GEODETIC(flags)   ((bool) (((flags) & MOBDB_FLAG_GEODETIC)>>6))
+#define MOBDB_FLAGS_GET_BLOCKS(flags)     ((bool) (((flags) & MOBDB_FLAG_BLOCKS)>>7))
+#define MOBDB_FLAGS_GET_INDEX(flags)      ((bool) (((flags) & MOBDB_FLAG_INDEX)>>8))
+
+/* Flags describing the storage layout of a value rather than the value itself,
+ * they are ignored when comparing values */
+#define MOBDB_FLAGS_LAYOUT    (MOBDB_FLAG_BLOCKS | MOBDB_FLAG_INDEX)
+#define MOBDB_FLAGS_GET_VALUE(flags)      ((flags) & ~MOBDB_FLAGS_LAYOUT)
 
 /* The following flag is only used for TInstant */
 #define MOBDB_FLAGS_SET_BYVAL(flags, value) \
@@ -205,6 +233,10 @@ typedef enum
   ((flags) = (value) ? ((flags) | MOBDB_FLAG_T) : ((flags) & ~MOBDB_FLAG_T))
 #define MOBDB_FLAGS_SET_GEODETIC(flags, value) \
   ((flags) = (value) ? ((flags) | MOBDB_FLAG_GEODETIC) : ((flags) & ~MOBDB_FLAG_GEODETIC))
+#define MOBDB_FLAGS_SET_BLOCKS(flags, value) \
+  ((flags) = (value) ? ((flags) | MOBDB_FLAG_BLOCKS) : ((flags) & ~MOBDB_FLAG_BLOCKS))
+#define MOBDB_FLAGS_SET_INDEX(flags, value) \
+  ((flags) = (value) ? ((flags) | MOBDB_FLAG_INDEX) : ((flags) & ~MOBDB_FLAG_INDEX))
 
 /*****************************************************************************
  * Well-Known Binary (WKB)
@@ -27,24 +27,28 @@
  *
  *****************************************************************************/
 
-/*
- * tempcache.sql
- * Routine that pre-computes the opcache and store it as a table in the
- * catalog.
+/**
+ * @brief Compressed representation of temporal booleans and temporal texts.
  */
 
-CREATE TABLE mobilitydb_opcache (
-  ltypnum INT,
-  rtypnum INT,
-  opnum INT,
-  opid Oid
-);
+#ifndef __TEMPORAL_COMPRESS_H__
+#define __TEMPORAL_COMPRESS_H__
 
-CREATE FUNCTION fill_opcache()
-  RETURNS VOID
-  AS 'MODULE_PATHNAME', 'fill_opcache'
-  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+/* PostgreSQL */
+#include <postgres.h>
+/* MobilityDB */
+#include <meos.h>
 
-SELECT fill_opcache();
+/*****************************************************************************/
 
-/******************************************************************************/
+/** Maximum number of distinct values of a compressed temporal text */
+#define CTSEQUENCE_MAX_DICT 65536
+
+/*****************************************************************************/
+
+extern const CTimeSet *ctsequence_times(const CTSequence *cts);
+extern Datum ctsequence_value_n(const CTSequence *cts, int n);
+
+/*****************************************************************************/
+
+#endif /* __TEMPORAL_COMPRESS_H__ */
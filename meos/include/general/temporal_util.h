@@ -42,6 +42,17 @@
 
 /*****************************************************************************/
 
+/**
+ * Attribute compiling a numeric kernel for several instruction sets, the
+ * variant matching the CPU is selected when the library is loaded
+ */
+#if defined(__GNUC__) && ! defined(__clang__) && defined(__x86_64__) && \
+    defined(__linux__)
+  #define MOBDB_SIMD_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+  #define MOBDB_SIMD_CLONES
+#endif
+
 /* Miscellaneous functions */
 
 extern size_t double_pad(size_t size);
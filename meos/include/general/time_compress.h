@@ -0,0 +1,73 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Compressed representation of timestamp sets and period sets.
+ */
+
+#ifndef __TIME_COMPRESS_H__
+#define __TIME_COMPRESS_H__
+
+/* PostgreSQL */
+#include <postgres.h>
+/* MobilityDB */
+#include "general/timetypes.h"
+
+/*****************************************************************************/
+
+/**
+ * Encodings of the elements of a compressed time set
+ */
+typedef enum
+{
+  CTIMESET_DELTA = 1,   /**< Delta-encoded elements with sampled positions */
+  CTIMESET_RLE = 2,     /**< Runs of elements with equal deltas */
+} CTimeSetEncoding;
+
+/** Number of elements between two samples of a delta-encoded set */
+#define CTIMESET_SAMPLE 64
+
+/**
+ * Sample of a delta-encoded set allowing to start decoding at every
+ * CTIMESET_SAMPLE-th element
+ */
+typedef struct
+{
+  TimestampTz last;     /**< Timestamp or upper bound of the previous element */
+  uint32 offset;        /**< Offset of the element in the encoding */
+  uint32 padding;       /**< Not used */
+} CTimeSetSample;
+
+/*****************************************************************************/
+
+extern void ctimeset_iterator_seek(CTimeSetIterator *iter, TimestampTz t);
+
+/*****************************************************************************/
+
+#endif
@@ -88,6 +88,55 @@ typedef struct
   Period elems[1];      /**< Beginning of variable-length data */
 } PeriodSet;
 
+/**
+ * Structure to represent compressed timestamp sets and period sets. Only
+ * the elements are encoded, the bounding period is kept as is so that the
+ * bounding box tests never decode the elements.
+ */
+typedef struct
+{
+  int32 vl_len_;        /**< Varlena header (do not touch directly!) */
+  uint8 settype;        /**< Type of the set, T_TIMESTAMPSET or T_PERIODSET */
+  uint8 encoding;       /**< Encoding of the elements */
+  int16 padding;        /**< Not used */
+  int32 count;          /**< Number of elements */
+  Period period;        /**< Bounding period */
+  /* variable-length data follows */
+} CTimeSet;
+
+/**
+ * Structure to decode sequentially the elements of a compressed time set
+ */
+typedef struct
+{
+  const CTimeSet *cts;  /**< Compressed time set */
+  const uint8 *ptr;     /**< Position of the next element in the encoding */
+  int i;                /**< Number of the next element */
+  TimestampTz last;     /**< Timestamp or upper bound of the last element */
+  int runleft;          /**< Remaining elements of the current run */
+  uint64 delta;         /**< Delta or gap of the elements of the run */
+  uint64 duration;      /**< Duration of the periods of the run */
+  uint8 flags;          /**< Inclusive flags of the periods of the run */
+} CTimeSetIterator;
+
+/**
+ * Structure to represent compressed temporal boolean and temporal text
+ * sequences. The timestamps are kept in a compressed timestamp set, the
+ * values of a temporal boolean in a bitset, and the values of a temporal
+ * text as codes in a dictionary of its distinct values.
+ */
+typedef struct
+{
+  int32 vl_len_;        /**< Varlena header (do not touch directly!) */
+  uint8 temptype;       /**< Temporal type, T_TBOOL or T_TTEXT */
+  uint8 codesize;       /**< Size in bytes of the codes, 0 for a bitset */
+  int16 padding;        /**< Not used */
+  int32 count;          /**< Number of instants */
+  int32 ndict;          /**< Number of values in the dictionary */
+  Period period;        /**< Time span */
+  /* variable-length data follows */
+} CTSequence;
+
 /**
  * Structure to represent temporal boxes
  */
@@ -215,6 +264,30 @@ typedef struct
   int j;
 } Match;
 
+/**
+ * Opaque structure of an in-memory R-tree over STBOX or TBOX values
+ */
+typedef struct RTree RTree;
+
+/**
+ * Opaque structure of an in-memory interval index over periods
+ */
+typedef struct PeriodIndex PeriodIndex;
+
+/**
+ * Enumeration for the methods of online compression of temporal points
+ */
+typedef enum
+{
+  COMPRESS_DEADRECKONING,
+  COMPRESS_SQUISHE,
+} CompressMethod;
+
+/**
+ * Opaque structure of an online compressor of temporal points
+ */
+typedef struct TPointCompressor TPointCompressor;
+
 /*****************************************************************************
  * Initialization of the MEOS library
  *****************************************************************************/
@@ -222,6 +295,40 @@ typedef struct
 extern void meos_initialize(void);
 extern void meos_finish(void);
 
+/*****************************************************************************
+ * Memory management of the MEOS library
+ *****************************************************************************/
+
+/* The types are also defined in postgres/utils/palloc.h */
+#ifndef MEOS_ALLOCATOR_TYPES
+#define MEOS_ALLOCATOR_TYPES
+/* The functions must follow the semantics of malloc, realloc, and free */
+typedef void *(*meos_malloc_fn) (size_t size);
+typedef void *(*meos_realloc_fn) (void *pointer, size_t size);
+typedef void (*meos_free_fn) (void *pointer);
+/* Arena context. Opaque to the callers. */
+typedef struct MeosArenaData *MeosArena;
+/* Default size of the first block of an arena */
+#define MEOS_ARENA_DEFAULT_BLOCKSIZE  (8 * 1024)
+#endif /* MEOS_ALLOCATOR_TYPES */
+
+/* Allocator hooks used by palloc and pfree */
+
+extern void meos_set_allocator(meos_malloc_fn malloc_fn, meos_realloc_fn realloc_fn, meos_free_fn free_fn);
+extern void meos_set_thread_allocator(meos_malloc_fn malloc_fn, meos_realloc_fn realloc_fn, meos_free_fn free_fn);
+extern void meos_get_thread_allocator(meos_malloc_fn *malloc_fn, meos_realloc_fn *realloc_fn, meos_free_fn *free_fn);
+
+/* Arena contexts */
+
+extern MeosArena meos_arena_create(size_t blocksize);
+extern MeosArena meos_arena_begin(MeosArena arena);
+extern void meos_arena_end(MeosArena previous);
+extern MeosArena meos_arena_current(void);
+extern void *meos_arena_alloc(MeosArena arena, size_t size);
+extern void meos_arena_reset(MeosArena arena);
+extern void meos_arena_delete(MeosArena arena);
+extern size_t meos_arena_mem_size(MeosArena arena);
+
 /*****************************************************************************
  * Functions for input/output base types
  *****************************************************************************/
@@ -1449,6 +1556,7 @@ extern Temporal *tpoint_cumulative_length(const Temporal *temp);
 extern Temporal *tpoint_get_coord(const Temporal *temp, int coord);
 extern bool tpoint_is_simple(const Temporal *temp);
 extern double tpoint_length(const Temporal *temp);
+extern void tpoint_motion_metrics(const Temporal *temp, double *length, Temporal **cumlength, Temporal **speed, Temporal **azimuth);
 extern Temporal *tpoint_speed(const Temporal *temp);
 extern int tpoint_srid(const Temporal *temp);
 extern STBOX *tpoint_stboxes(const Temporal *temp, int *count);
@@ -1531,6 +1639,102 @@ bool tpoint_AsMVTGeom(const Temporal *temp, const STBOX *bounds, int32_t extent,
   int32_t buffer, bool clip_geom, GSERIALIZED **geom, int64 **timesarr, int *count);
 bool tpoint_to_geo_measure(const Temporal *tpoint, const Temporal *measure, bool segmentize, GSERIALIZED **result);
 
+/* Online compression of temporal points */
+
+extern TPointCompressor *tpoint_compressor_make(CompressMethod method, double eps_dist, int bufsize);
+extern void tpoint_compressor_append(TPointCompressor *comp, const TInstant *inst);
+extern TSequence *tpoint_compressor_finish(TPointCompressor *comp);
+extern void tpoint_compressor_free(TPointCompressor *comp);
+
+/*****************************************************************************/
+
+/* Compressed timestamp sets and period sets */
+
+extern CTimeSet *periodset_compress(const PeriodSet *ps);
+extern PeriodSet *periodset_decompress(const CTimeSet *cts);
+extern CTimeSet *timestampset_compress(const TimestampSet *ts);
+extern TimestampSet *timestampset_decompress(const CTimeSet *cts);
+extern int ctimeset_mem_size(const CTimeSet *cts);
+extern int ctimeset_num_elems(const CTimeSet *cts);
+extern Period *ctimeset_period_n(const CTimeSet *cts, int n);
+extern bool ctimeset_timestamp_n(const CTimeSet *cts, int n, TimestampTz *result);
+extern Period *ctimeset_to_period(const CTimeSet *cts);
+extern void ctimeset_iterator_init(CTimeSetIterator *iter, const CTimeSet *cts);
+extern bool ctimeset_iterator_next_period(CTimeSetIterator *iter, Period *result);
+extern bool ctimeset_iterator_next_timestamp(CTimeSetIterator *iter, TimestampTz *result);
+extern bool contains_ctimeset_timestamp(const CTimeSet *cts, TimestampTz t);
+extern bool overlaps_ctimeset_period(const CTimeSet *cts, const Period *p);
+
+/*****************************************************************************/
+
+/* Compressed temporal booleans and temporal texts */
+
+extern CTSequence *tsequence_compress(const TSequence *seq);
+extern TSequence *tsequence_decompress(const CTSequence *cts);
+extern int ctsequence_mem_size(const CTSequence *cts);
+extern int ctsequence_num_instants(const CTSequence *cts);
+extern TInstant *ctsequence_inst_n(const CTSequence *cts, int n);
+extern bool ctsequence_value_at_timestamp(const CTSequence *cts, TimestampTz t, Datum *result);
+
+/*****************************************************************************/
+
+/* Batch functions for temporal types */
+
+extern void meos_set_num_threads(int n);
+extern int meos_num_threads(void);
+
+extern uint8_t **temporal_as_wkb_batch(const Temporal **temps, int count, uint8_t variant, size_t *sizes);
+extern double *temporal_dyntimewarp_distance_batch(const Temporal **temps1, const Temporal **temps2, int count);
+extern double *temporal_frechet_distance_batch(const Temporal **temps1, const Temporal **temps2, int count);
+extern Temporal **temporal_simplify_batch(const Temporal **temps, int count, double eps_dist, bool synchronized);
+extern Temporal **distance_tpoint_geo_batch(const Temporal **temps, int count, const GSERIALIZED **geos, int ngeos);
+extern Temporal **distance_tpoint_tpoint_batch(const Temporal **temps1, const Temporal **temps2, int count);
+extern double *nad_tpoint_geo_batch(const Temporal **temps, int count, const GSERIALIZED **geos, int ngeos);
+extern double *nad_tpoint_tpoint_batch(const Temporal **temps1, const Temporal **temps2, int count);
+extern Temporal **tpoint_at_stbox_batch(const Temporal **temps, int count, const STBOX **boxes, int nboxes);
+extern double *tpoint_length_batch(const Temporal **temps, int count);
+extern Temporal **tpoint_minus_stbox_batch(const Temporal **temps, int count, const STBOX **boxes, int nboxes);
+extern Temporal **tpoint_speed_batch(const Temporal **temps, int count);
+
+/*****************************************************************************/
+
+/* R-tree index for boxes */
+
+extern RTree *rtree_make_stbox(void);
+extern RTree *rtree_make_tbox(void);
+extern RTree *rtree_bulk_load_stbox(const STBOX *boxes, const int64 *ids, int count);
+extern RTree *rtree_bulk_load_tbox(const TBOX *boxes, const int64 *ids, int count);
+extern void rtree_free(RTree *rtree);
+extern int64 rtree_count(const RTree *rtree);
+extern void rtree_insert_stbox(RTree *rtree, const STBOX *box, int64 id);
+extern void rtree_insert_tbox(RTree *rtree, const TBOX *box, int64 id);
+extern bool rtree_delete_stbox(RTree *rtree, const STBOX *box, int64 id);
+extern bool rtree_delete_tbox(RTree *rtree, const TBOX *box, int64 id);
+extern int64 *rtree_search_stbox(const RTree *rtree, const STBOX *box, int *count);
+extern int64 *rtree_search_tbox(const RTree *rtree, const TBOX *box, int *count);
+extern int64 *rtree_knn_stbox(const RTree *rtree, const STBOX *box, int k, double *dists, int *count);
+extern int64 *rtree_knn_tbox(const RTree *rtree, const TBOX *box, int k, double *dists, int *count);
+extern int64 *rtree_join(const RTree *rtree1, const RTree *rtree2, int *count);
+extern bool rtree_save(const RTree *rtree, const char *filename);
+extern RTree *rtree_open(const char *filename);
+
+/*****************************************************************************/
+
+/* Interval index for periods */
+
+extern PeriodIndex *period_index_make(const Period *periods, const int64 *ids, int count);
+extern PeriodIndex *period_index_make_periodsets(const PeriodSet **ps, const int64 *ids, int count);
+extern void period_index_free(PeriodIndex *idx);
+extern int period_index_count(const PeriodIndex *idx);
+extern int64 *period_index_stab(const PeriodIndex *idx, TimestampTz t, int *count);
+extern int period_index_stab_count(const PeriodIndex *idx, TimestampTz t);
+extern int64 *period_index_overlaps(const PeriodIndex *idx, const Period *p, int *count);
+extern int period_index_overlaps_count(const PeriodIndex *idx, const Period *p);
+extern int64 *period_index_contains(const PeriodIndex *idx, const Period *p, int *count);
+extern int period_index_contains_count(const PeriodIndex *idx, const Period *p);
+extern TSequenceSet *period_index_tcount(const PeriodIndex *idx);
+extern PeriodSet *period_index_tunion(const PeriodIndex *idx);
+
 /*****************************************************************************/
 
 #endif
@@ -369,6 +369,12 @@ extern Interval *tsequence_duration(const TSequence *seq);
 extern TimestampTz tsequence_end_timestamp(const TSequence *seq);
 extern uint32 tsequence_hash(const TSequence *seq);
 extern const TInstant *tsequence_inst_n(const TSequence *seq, int index);
+extern int tsequence_num_blocks(const TSequence *seq);
+extern const void *tsequence_block_bbox(const TSequence *seq, int b);
+extern void tsequence_block_range(const TSequence *seq, int b, int *first, int *last);
+extern bool tsequence_block_overlaps(const TSequence *seq, int b, const void *box);
+extern PeriodSet *tsequence_blocks_time(const TSequence *seq, const void *box);
+extern void tsequence_recompute_bbox(TSequence *seq);
 extern const TInstant **tsequence_instants(const TSequence *seq, int *count);
 extern const TInstant *tsequence_max_instant(const TSequence *seq);
 extern Datum tsequence_max_value(const TSequence *seq);
@@ -429,6 +435,7 @@ extern TInstant *tinstantset_to_tinstant(const TInstantSet *ti);
 extern TSequence *tinstantset_to_tsequence(const TInstantSet *is, bool linear);
 extern TSequenceSet *tinstantset_to_tsequenceset(const TInstantSet *is, bool linear);
 extern Temporal *tsequence_append_tinstant(const TSequence *seq, const TInstant *inst);
+extern void tsequence_compact(TSequence *seq, const int *keep, int count, bool lower_inc, bool upper_inc, bool normalize);
 extern Temporal *tsequence_merge(const TSequence *seq1, const TSequence *seq2);
 extern Temporal *tsequence_merge_array(const TSequence **sequences, int count);
 extern TSequence *tsequence_shift_tscale(const TSequence *seq, const Interval *start, const Interval *duration);
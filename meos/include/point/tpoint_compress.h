@@ -0,0 +1,80 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Online compression of temporal points while appending instants.
+ */
+
+#ifndef __TPOINT_COMPRESS_H__
+#define __TPOINT_COMPRESS_H__
+
+/* MobilityDB */
+#include <meos.h>
+
+/*****************************************************************************/
+
+/** Default capacity of the buffer of the SQUISH-E compressor */
+#define COMPRESS_DEFAULT_BUFSIZE 32
+/** Minimum capacity of the buffer of the SQUISH-E compressor */
+#define COMPRESS_MIN_BUFSIZE 3
+
+/**
+ * State of an online compressor of temporal points. The instants kept by the
+ * compressor are copied into the output array, the instants that may still
+ * be removed are kept in the buffer.
+ *
+ * For dead reckoning the buffer contains at most the last instant received,
+ * which is kept in the output when the stream ends. For SQUISH-E the first
+ * instant of the buffer is the last instant of the output and acts as fixed
+ * start point of the instants in the buffer.
+ */
+struct TPointCompressor
+{
+  CompressMethod method;       /**< Compression method */
+  double eps_dist;             /**< Distance threshold */
+  int bufsize;                 /**< Capacity of the buffer */
+  bool hasz;                   /**< True when the points have Z coordinates */
+  int32 srid;                  /**< SRID of the points */
+  TInstant **output;           /**< Instants kept */
+  int noutput;                 /**< Number of instants kept */
+  int maxoutput;               /**< Capacity of the output array */
+  TInstant **buffer;           /**< Instants that may still be removed */
+  double *priority;            /**< SQUISH-E priority of the buffer instants */
+  double *pi;                  /**< SQUISH-E error inherited from the instants
+                                    removed next to the buffer instants */
+  int nbuffer;                 /**< Number of instants in the buffer */
+  bool hasvelocity;            /**< True when the dead reckoning velocity is
+                                    known */
+  double vx, vy, vz;           /**< Dead reckoning velocity in units per
+                                    microsecond */
+};
+
+/*****************************************************************************/
+
+#endif /* __TPOINT_COMPRESS_H__ */
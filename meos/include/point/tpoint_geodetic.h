@@ -0,0 +1,76 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Geodetic acceleration structures for temporal geography points.
+ */
+
+#ifndef __TPOINT_GEODETIC_H__
+#define __TPOINT_GEODETIC_H__
+
+/* PostgreSQL */
+#include <postgres.h>
+/* PostGIS */
+#include <liblwgeom.h>
+#include <lwgeodetic.h>
+/* MobilityDB */
+#include "general/temporal.h"
+
+/*****************************************************************************/
+
+/**
+ * Structure to cache the geodetic computations on the points of a temporal
+ * geography point sequence that are shared by several functions
+ */
+typedef struct
+{
+  SPHEROID s;                 /**< Spheroid used in the computations */
+  int count;                  /**< Number of points */
+  GEOGRAPHIC_POINT *points;   /**< Points in radians */
+  double *z;                  /**< Z values, NULL when the points are 2D */
+  double *seglength;          /**< Spheroid lengths of the segments, computed
+                                   on demand, negative if not yet computed */
+} GeodSeqCache;
+
+/* Geodetic cache of a temporal sequence */
+
+extern GeodSeqCache *geodseq_cache_make(const TSequence *seq);
+extern void geodseq_cache_free(GeodSeqCache *cache);
+extern double geodseq_cache_seglength(GeodSeqCache *cache, int i);
+extern double geodseq_cache_length(GeodSeqCache *cache);
+
+/* Distance functions for geography points */
+
+extern Datum pt_distance_geog(Datum geog1, Datum geog2);
+extern bool geog_point_dwithin_approx(const POINT2D *p1, const POINT2D *p2,
+  double dist, bool *result);
+
+/*****************************************************************************/
+
+#endif
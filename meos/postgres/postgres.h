@@ -62,13 +62,9 @@
       exit(EXIT_FAILURE); \
   } while(0);
 
-/* MEOS: redefining palloc0, palloc, and pfree */
+/* MEOS: redefining palloc0, palloc, and pfree, see utils/mcxt.c */
 #if MEOS
-#define palloc0(X) (calloc(1, X))
-#define palloc malloc
-#define repalloc realloc
-#define pfree free
-#define pstrdup strdup
+#include "utils/palloc.h"
 #endif /* MEOS */
 
 /* ----------------------------------------------------------------
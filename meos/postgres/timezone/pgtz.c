@@ -22,6 +22,7 @@
 // #include "datatype/timestamp.h" /* MobilityDB */
 #include "utils/timestamp_def.h"
 #include "pgtz.h"
+#include <liblwgeom.h> /* MEOS */
 
 /* Function in findtimezone.c */
 extern const char *select_default_timezone(const char *share_path);
@@ -234,7 +235,10 @@ static struct hsearch_data *timezone_cache = NULL;
 static bool
 init_timezone_hashtable(void)
 {
+  /* MEOS: the cache must survive the reset of the current arena */
+  MeosArena arena = meos_arena_begin(NULL);
   timezone_cache = palloc0(sizeof(struct hsearch_data));
+  meos_arena_end(arena);
   if (!timezone_cache)
     return false;
 
@@ -326,7 +330,10 @@ pg_tzset(const char *name)
   }
 
   /* Save timezone in the cache */
+  /* MEOS: the cache must survive the reset of the current arena */
+  MeosArena arena = meos_arena_begin(NULL);
   pg_tz *tz = palloc(sizeof(pg_tz));
+  meos_arena_end(arena);
   strcpy(tz->TZname, canonname);
   memcpy(&tz->state, &tzstate, sizeof(tzstate));
 
@@ -410,6 +417,8 @@ meos_initialize(void)
     meos_timezone_initialize("GMT");
   else
     meos_timezone_initialize(tz_str);
+  /* MEOS: geometries are allocated with the MEOS allocator and arenas */
+  lwgeom_set_handlers(palloc, repalloc, pfree, NULL, NULL);
   return;
 }
 
@@ -0,0 +1,438 @@
+/*-------------------------------------------------------------------------
+ *
+ * mcxt.c
+ *    POSTGRES memory context management code.
+ *
+ * MEOS: This module replaces the PostgreSQL memory context machinery with
+ * two much simpler mechanisms.
+ *
+ * 1. Allocator hooks. By default palloc, repalloc, and pfree map to malloc,
+ *    realloc, and free. An embedding application can replace these functions
+ *    globally with meos_set_allocator() or for the calling thread with
+ *    meos_set_thread_allocator(), the latter taking precedence.
+ *
+ * 2. Arena contexts, mirroring the AllocSet contexts of PostgreSQL. An arena
+ *    obtains large blocks from the allocator and hands out chunks from them
+ *    with a bump pointer. Calling meos_arena_begin() makes an arena current
+ *    for the calling thread so that every palloc made by MEOS is served by
+ *    the arena, and meos_arena_reset() releases all the temporaries of, e.g.,
+ *    a batch of trajectories at once. pfree is a no-op on arena chunks,
+ *    except for the last chunk of the active block whose space is given back.
+ *
+ * Memory obtained from an arena must not be released with pfree or free
+ * while the arena is not the current one.
+ *
+ * Portions Copyright (c) 1996-2021, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *    src/backend/utils/mmgr/mcxt.c
+ *    src/backend/utils/mmgr/aset.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * An arena block. The chunks are allocated from the space between the end of
+ * the header and endptr, freeptr points to the first free byte.
+ */
+typedef struct ArenaBlockData
+{
+  struct ArenaBlockData *next;  /* next block in the arena's block list */
+  char *freeptr;                /* start of free space in this block */
+  char *endptr;                 /* end of space in this block */
+} ArenaBlockData;
+
+typedef ArenaBlockData *ArenaBlock;
+
+/*
+ * Every chunk is preceded by its requested size (rounded up to MAXALIGN)
+ * so that repalloc knows how many bytes must be copied.
+ */
+typedef struct ArenaChunkData
+{
+  size_t size;                  /* usable size of the chunk */
+} ArenaChunkData;
+
+typedef ArenaChunkData *ArenaChunk;
+
+#define ARENA_BLOCKHDRSZ  MAXALIGN(sizeof(ArenaBlockData))
+#define ARENA_CHUNKHDRSZ  MAXALIGN(sizeof(ArenaChunkData))
+#define ARENA_CTXHDRSZ    MAXALIGN(sizeof(struct MeosArenaData))
+
+#define ArenaChunkGetPointer(chk)  ((void *)(((char *)(chk)) + ARENA_CHUNKHDRSZ))
+#define ArenaPointerGetChunk(ptr)  ((ArenaChunk)(((char *)(ptr)) - ARENA_CHUNKHDRSZ))
+
+/* Maximum size of the blocks requested when an arena grows */
+#define ARENA_MAX_BLOCKSIZE  (8 * 1024 * 1024)
+/* Chunks larger than this are given a dedicated block */
+#define ARENA_CHUNK_LIMIT    (ARENA_MAX_BLOCKSIZE / 8)
+/* Minimum size of the first block of an arena */
+#define ARENA_MIN_BLOCKSIZE  1024
+
+/*
+ * Arena context. The keeper block is allocated together with the header and
+ * is preserved on reset, so that resetting an arena used for a single batch
+ * does not return any memory to the allocator.
+ */
+struct MeosArenaData
+{
+  ArenaBlock blocks;            /* head of the block list, active block */
+  ArenaBlock keeper;            /* block allocated with the context header */
+  size_t initBlockSize;         /* size of the keeper block */
+  size_t nextBlockSize;         /* size of the next block to allocate */
+  meos_malloc_fn malloc_fn;     /* function used to obtain the blocks */
+  meos_free_fn free_fn;         /* function used to release the blocks */
+};
+
+/*****************************************************************************
+ * Global and per-thread state
+ *****************************************************************************/
+
+static meos_malloc_fn global_malloc = malloc;
+static meos_realloc_fn global_realloc = realloc;
+static meos_free_fn global_free = free;
+
+static _Thread_local meos_malloc_fn thread_malloc = NULL;
+static _Thread_local meos_realloc_fn thread_realloc = NULL;
+static _Thread_local meos_free_fn thread_free = NULL;
+
+/* Arena serving the palloc calls of the thread, NULL for the allocator */
+static _Thread_local MeosArena current_arena = NULL;
+
+#define MEOS_MALLOC(size) \
+  (thread_malloc ? thread_malloc(size) : global_malloc(size))
+#define MEOS_REALLOC(pointer, size) \
+  (thread_realloc ? thread_realloc((pointer), (size)) : \
+    global_realloc((pointer), (size)))
+#define MEOS_MALLOC_FN  (thread_malloc ? thread_malloc : global_malloc)
+#define MEOS_FREE_FN  (thread_free ? thread_free : global_free)
+
+/**
+ * Set the functions used by MEOS for allocating memory in all threads.
+ * Passing NULL functions restores malloc, realloc, and free.
+ *
+ * This function is not thread-safe and should be called before any other
+ * MEOS function, typically just before meos_initialize().
+ */
+void
+meos_set_allocator(meos_malloc_fn malloc_fn, meos_realloc_fn realloc_fn,
+  meos_free_fn free_fn)
+{
+  if (! malloc_fn || ! realloc_fn || ! free_fn)
+  {
+    global_malloc = malloc;
+    global_realloc = realloc;
+    global_free = free;
+    return;
+  }
+  global_malloc = malloc_fn;
+  global_realloc = realloc_fn;
+  global_free = free_fn;
+  return;
+}
+
+/**
+ * Set the functions used by MEOS for allocating memory in the calling thread,
+ * overriding those set by meos_set_allocator(). Passing NULL functions
+ * restores the global allocator for the thread.
+ */
+void
+meos_set_thread_allocator(meos_malloc_fn malloc_fn, meos_realloc_fn realloc_fn,
+  meos_free_fn free_fn)
+{
+  if (! malloc_fn || ! realloc_fn || ! free_fn)
+  {
+    thread_malloc = NULL;
+    thread_realloc = NULL;
+    thread_free = NULL;
+    return;
+  }
+  thread_malloc = malloc_fn;
+  thread_realloc = realloc_fn;
+  thread_free = free_fn;
+  return;
+}
+
+/**
+ * Get the allocator functions of the calling thread, which are NULL when the
+ * thread uses the global allocator. This enables worker threads to allocate
+ * their results as the thread that dispatched the work.
+ */
+void
+meos_get_thread_allocator(meos_malloc_fn *malloc_fn,
+  meos_realloc_fn *realloc_fn, meos_free_fn *free_fn)
+{
+  *malloc_fn = thread_malloc;
+  *realloc_fn = thread_realloc;
+  *free_fn = thread_free;
+  return;
+}
+
+/*****************************************************************************
+ * Arena contexts
+ *****************************************************************************/
+
+/**
+ * Create an arena whose first block has the given size, or
+ * MEOS_ARENA_DEFAULT_BLOCKSIZE if the size is 0. All the blocks of the arena
+ * are obtained from and released to the allocator of the thread creating it,
+ * even if the arena is later used by other threads or the allocator changes.
+ */
+MeosArena
+meos_arena_create(size_t blocksize)
+{
+  if (blocksize == 0)
+    blocksize = MEOS_ARENA_DEFAULT_BLOCKSIZE;
+  else if (blocksize < ARENA_MIN_BLOCKSIZE)
+    blocksize = ARENA_MIN_BLOCKSIZE;
+  else if (blocksize > ARENA_MAX_BLOCKSIZE)
+    blocksize = ARENA_MAX_BLOCKSIZE;
+  blocksize = MAXALIGN(blocksize);
+
+  meos_malloc_fn malloc_fn = MEOS_MALLOC_FN;
+  MeosArena arena = malloc_fn(ARENA_CTXHDRSZ + blocksize);
+  if (! arena)
+    elog(ERROR, "out of memory");
+  ArenaBlock block = (ArenaBlock) (((char *) arena) + ARENA_CTXHDRSZ);
+  block->next = NULL;
+  block->freeptr = ((char *) block) + ARENA_BLOCKHDRSZ;
+  block->endptr = ((char *) block) + blocksize;
+  arena->blocks = arena->keeper = block;
+  arena->initBlockSize = arena->nextBlockSize = blocksize;
+  arena->malloc_fn = malloc_fn;
+  arena->free_fn = MEOS_FREE_FN;
+  return arena;
+}
+
+/**
+ * Make the arena the current one for the calling thread and return the
+ * previous one, which must be restored with meos_arena_end(). Passing NULL
+ * makes palloc use the allocator functions again.
+ */
+MeosArena
+meos_arena_begin(MeosArena arena)
+{
+  MeosArena previous = current_arena;
+  current_arena = arena;
+  return previous;
+}
+
+/**
+ * Restore the arena that was current before the matching meos_arena_begin().
+ */
+void
+meos_arena_end(MeosArena previous)
+{
+  current_arena = previous;
+  return;
+}
+
+/**
+ * Return the current arena of the calling thread, NULL if none
+ */
+MeosArena
+meos_arena_current(void)
+{
+  return current_arena;
+}
+
+/**
+ * Return the block of the arena containing the pointer, NULL if none
+ */
+static ArenaBlock
+arena_find_block(MeosArena arena, const void *pointer)
+{
+  const char *ptr = (const char *) pointer;
+  for (ArenaBlock block = arena->blocks; block != NULL; block = block->next)
+  {
+    if (ptr >= ((char *) block) + ARENA_BLOCKHDRSZ && ptr < block->freeptr)
+      return block;
+  }
+  return NULL;
+}
+
+/**
+ * Allocate memory from an arena
+ */
+void *
+meos_arena_alloc(MeosArena arena, size_t size)
+{
+  size_t chunk_size = MAXALIGN(size);
+  size_t required = ARENA_CHUNKHDRSZ + chunk_size;
+  ArenaBlock block = arena->blocks;
+
+  /* Fast path: the chunk fits in the active block */
+  if ((size_t) (block->endptr - block->freeptr) < required)
+  {
+    size_t blksize;
+    if (chunk_size > ARENA_CHUNK_LIMIT)
+      /* Dedicated block, linked behind the active block */
+      blksize = ARENA_BLOCKHDRSZ + required;
+    else
+    {
+      blksize = arena->nextBlockSize;
+      arena->nextBlockSize <<= 1;
+      if (arena->nextBlockSize > ARENA_MAX_BLOCKSIZE)
+        arena->nextBlockSize = ARENA_MAX_BLOCKSIZE;
+      while (blksize < ARENA_BLOCKHDRSZ + required)
+        blksize <<= 1;
+    }
+    ArenaBlock newblock = arena->malloc_fn(blksize);
+    if (! newblock)
+      elog(ERROR, "out of memory");
+    newblock->freeptr = ((char *) newblock) + ARENA_BLOCKHDRSZ;
+    newblock->endptr = ((char *) newblock) + blksize;
+    if (chunk_size > ARENA_CHUNK_LIMIT)
+    {
+      newblock->next = block->next;
+      block->next = newblock;
+    }
+    else
+    {
+      newblock->next = block;
+      arena->blocks = newblock;
+    }
+    block = newblock;
+  }
+
+  ArenaChunk chunk = (ArenaChunk) block->freeptr;
+  chunk->size = chunk_size;
+  block->freeptr += required;
+  return ArenaChunkGetPointer(chunk);
+}
+
+/**
+ * Release all the memory allocated in the arena except the keeper block
+ */
+void
+meos_arena_reset(MeosArena arena)
+{
+  ArenaBlock block = arena->blocks;
+  while (block != NULL)
+  {
+    ArenaBlock next = block->next;
+    if (block != arena->keeper)
+      arena->free_fn(block);
+    block = next;
+  }
+  arena->keeper->next = NULL;
+  arena->keeper->freeptr = ((char *) arena->keeper) + ARENA_BLOCKHDRSZ;
+  arena->blocks = arena->keeper;
+  arena->nextBlockSize = arena->initBlockSize;
+  return;
+}
+
+/**
+ * Release all the memory of the arena, including the arena itself.
+ * The arena must not be current in any thread.
+ */
+void
+meos_arena_delete(MeosArena arena)
+{
+  if (current_arena == arena)
+    current_arena = NULL;
+  meos_arena_reset(arena);
+  arena->free_fn(arena);
+  return;
+}
+
+/**
+ * Return the total size of the blocks owned by the arena
+ */
+size_t
+meos_arena_mem_size(MeosArena arena)
+{
+  size_t result = ARENA_CTXHDRSZ;
+  for (ArenaBlock block = arena->blocks; block != NULL; block = block->next)
+    result += block->endptr - (char *) block;
+  return result;
+}
+
+/*****************************************************************************
+ * Fundamental memory-allocation operations
+ *****************************************************************************/
+
+void *
+palloc(size_t size)
+{
+  if (current_arena)
+    return meos_arena_alloc(current_arena, size);
+  void *result = MEOS_MALLOC(size);
+  if (! result && size != 0)
+    elog(ERROR, "out of memory");
+  return result;
+}
+
+void *
+palloc0(size_t size)
+{
+  void *result = palloc(size);
+  if (result)
+    memset(result, 0, size);
+  return result;
+}
+
+void *
+repalloc(void *pointer, size_t size)
+{
+  if (! pointer)
+    return palloc(size);
+
+  ArenaBlock block;
+  if (current_arena && (block = arena_find_block(current_arena, pointer)))
+  {
+    ArenaChunk chunk = ArenaPointerGetChunk(pointer);
+    size_t chunk_size = MAXALIGN(size);
+    if (chunk_size <= chunk->size)
+      return pointer;
+    /* The last chunk of the active block can be extended in place */
+    if (block == current_arena->blocks &&
+        (char *) pointer + chunk->size == block->freeptr &&
+        (size_t) (block->endptr - (char *) pointer) >= chunk_size)
+    {
+      block->freeptr = (char *) pointer + chunk_size;
+      chunk->size = chunk_size;
+      return pointer;
+    }
+    void *result = meos_arena_alloc(current_arena, size);
+    memcpy(result, pointer, chunk->size);
+    return result;
+  }
+
+  void *result = MEOS_REALLOC(pointer, size);
+  if (! result && size != 0)
+    elog(ERROR, "out of memory");
+  return result;
+}
+
+void
+pfree(void *pointer)
+{
+  ArenaBlock block;
+  if (current_arena && pointer &&
+      (block = arena_find_block(current_arena, pointer)))
+  {
+    /* Give back the space of the last chunk of the active block */
+    ArenaChunk chunk = ArenaPointerGetChunk(pointer);
+    if (block == current_arena->blocks &&
+        (char *) pointer + chunk->size == block->freeptr)
+      block->freeptr = (char *) chunk;
+    return;
+  }
+  MEOS_FREE_FN(pointer);
+  return;
+}
+
+char *
+pstrdup(const char *in)
+{
+  size_t len = strlen(in) + 1;
+  char *result = palloc(len);
+  memcpy(result, in, len);
+  return result;
+}
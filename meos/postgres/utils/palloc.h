@@ -0,0 +1,73 @@
+/*-------------------------------------------------------------------------
+ *
+ * palloc.h
+ *    POSTGRES memory allocator definitions.
+ *
+ * MEOS: PostgreSQL memory contexts are replaced by a pluggable allocator
+ * (global or per thread) and by lightweight arena contexts. When no arena
+ * is current, palloc and pfree call the allocator functions, which default
+ * to malloc and free, so that values returned by MEOS can still be released
+ * with free(). When an arena is current, palloc carves the memory from the
+ * arena blocks and all of it is released at once by resetting the arena.
+ *
+ * Portions Copyright (c) 1996-2021, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/utils/palloc.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef PALLOC_H
+#define PALLOC_H
+
+#include <stddef.h>
+
+/*
+ * Allocator functions and arena contexts. These types and the functions below
+ * are also declared in meos.h, which is the header installed for the
+ * applications using MEOS, the guard avoids defining the types twice.
+ */
+#ifndef MEOS_ALLOCATOR_TYPES
+#define MEOS_ALLOCATOR_TYPES
+/* The functions must follow the semantics of malloc, realloc, and free */
+typedef void *(*meos_malloc_fn) (size_t size);
+typedef void *(*meos_realloc_fn) (void *pointer, size_t size);
+typedef void (*meos_free_fn) (void *pointer);
+/* Arena context. Opaque to the callers, see mcxt.c. */
+typedef struct MeosArenaData *MeosArena;
+/* Default size of the first block of an arena */
+#define MEOS_ARENA_DEFAULT_BLOCKSIZE  (8 * 1024)
+#endif /* MEOS_ALLOCATOR_TYPES */
+
+/*
+ * Fundamental memory-allocation operations
+ */
+extern void *palloc(size_t size);
+extern void *palloc0(size_t size);
+extern void *repalloc(void *pointer, size_t size);
+extern void pfree(void *pointer);
+extern char *pstrdup(const char *in);
+
+/*
+ * Allocator hooks
+ */
+extern void meos_set_allocator(meos_malloc_fn malloc_fn,
+  meos_realloc_fn realloc_fn, meos_free_fn free_fn);
+extern void meos_set_thread_allocator(meos_malloc_fn malloc_fn,
+  meos_realloc_fn realloc_fn, meos_free_fn free_fn);
+extern void meos_get_thread_allocator(meos_malloc_fn *malloc_fn,
+  meos_realloc_fn *realloc_fn, meos_free_fn *free_fn);
+
+/*
+ * Arena contexts
+ */
+extern MeosArena meos_arena_create(size_t blocksize);
+extern MeosArena meos_arena_begin(MeosArena arena);
+extern void meos_arena_end(MeosArena previous);
+extern MeosArena meos_arena_current(void);
+extern void *meos_arena_alloc(MeosArena arena, size_t size);
+extern void meos_arena_reset(MeosArena arena);
+extern void meos_arena_delete(MeosArena arena);
+extern size_t meos_arena_mem_size(MeosArena arena);
+
+#endif							/* PALLOC_H */
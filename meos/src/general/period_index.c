@@ -0,0 +1,693 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief In-memory interval index over periods.
+ *
+ * The index associates periods to user identifiers, e.g., the position of a
+ * period set in an application array, and answers stabbing queries (which
+ * periods contain a timestamp), overlap queries, and containment queries
+ * without scanning all the periods. The index is bulk built: the periods are
+ * sorted by lower bound and laid out as an implicit augmented interval tree,
+ * where each element stores the maximum upper bound of its subtree, as in
+ * the cgranges library of H. Li. The subtrees of the lowest levels are
+ * scanned linearly, which is faster than descending into them.
+ *
+ * The count queries for stabbing and overlaps are answered by binary search
+ * in the sorted lower and upper bounds, without visiting the periods. When
+ * the index is built from period sets, each period of a set is indexed with
+ * the identifier of the set. Since the periods of a set are disjoint, a
+ * timestamp stabs at most one of them, the results of overlap queries are
+ * deduplicated.
+ *
+ * The sorted bounds of the index also serve the temporal count and the union
+ * of the periods, which are computed in a single sweep over the bounds.
+ */
+
+#include "general/period_index.h"
+
+#if MEOS
+
+/* C */
+#include <assert.h>
+#include <limits.h>
+/* MobilityDB */
+#include <meos_internal.h>
+#include "general/temporal_util.h"
+
+/**
+ * Period of the index and its identifier, used while building the index
+ */
+typedef struct
+{
+  Period period;
+  int64 id;
+} PeriodIndexEntry;
+
+/**
+ * Element of the stack used for traversing the implicit tree
+ */
+typedef struct
+{
+  int64 x;      /**< Position of the node */
+  int k;        /**< Level of the node */
+  bool right;   /**< True when the left subtree has been visited */
+} PeriodIndexStack;
+
+/*****************************************************************************
+ * Construction
+ *****************************************************************************/
+
+/**
+ * Comparator of entries used for sorting them by lower bound
+ */
+static int
+period_index_entry_cmp(const PeriodIndexEntry *e1, const PeriodIndexEntry *e2)
+{
+  return span_cmp(&e1->period, &e2->period);
+}
+
+/**
+ * Comparator of upper bounds, the exclusive bounds come before the
+ * inclusive ones with the same value
+ */
+static int
+period_index_bound_cmp(const PeriodIndexBound *b1, const PeriodIndexBound *b2)
+{
+  if (b1->t != b2->t)
+    return b1->t < b2->t ? -1 : 1;
+  if (b1->inclusive != b2->inclusive)
+    return b1->inclusive ? 1 : -1;
+  return 0;
+}
+
+/**
+ * Compute the maximum upper bound of the subtrees of the implicit tree
+ *
+ * @return Level of the root of the tree
+ */
+static int
+period_index_augment(PeriodIndex *idx)
+{
+  int64 n = idx->count, i, last_i = 0;
+  TimestampTz last = DT_NOBEGIN;
+  int k;
+  /* The leaves are at the even positions */
+  for (i = 0; i < n; i += 2)
+  {
+    last_i = i;
+    last = idx->maxupper[i] = DatumGetTimestampTz(idx->periods[i].upper);
+  }
+  for (k = 1; ((int64) 1 << k) <= n; k++)
+  {
+    int64 x = (int64) 1 << (k - 1), i0 = (x << 1) - 1, step = x << 2;
+    for (i = i0; i < n; i += step)
+    {
+      TimestampTz left = idx->maxupper[i - x];
+      /* The right subtree may be truncated by the end of the array */
+      TimestampTz right = (i + x < n) ? idx->maxupper[i + x] : last;
+      TimestampTz upper = DatumGetTimestampTz(idx->periods[i].upper);
+      idx->maxupper[i] = Max(upper, Max(left, right));
+    }
+    /* Maximum of the last subtree of the level */
+    last_i = ((last_i >> k) & 1) ? last_i - x : last_i + x;
+    if (last_i < n && idx->maxupper[last_i] > last)
+      last = idx->maxupper[last_i];
+  }
+  return k - 1;
+}
+
+/**
+ * Build an index from an array of entries, which is freed
+ */
+static PeriodIndex *
+period_index_build(PeriodIndexEntry *entries, int count, bool distinct)
+{
+  PeriodIndex *result = palloc0(sizeof(PeriodIndex));
+  result->count = count;
+  result->distinct = distinct;
+  if (count == 0)
+  {
+    pfree(entries);
+    return result;
+  }
+  qsort(entries, (size_t) count, sizeof(PeriodIndexEntry),
+    (qsort_comparator) &period_index_entry_cmp);
+  result->periods = palloc(sizeof(Period) * count);
+  result->ids = palloc(sizeof(int64) * count);
+  result->maxupper = palloc(sizeof(TimestampTz) * count);
+  result->uppers = palloc(sizeof(PeriodIndexBound) * count);
+  for (int i = 0; i < count; i++)
+  {
+    result->periods[i] = entries[i].period;
+    result->ids[i] = entries[i].id;
+    result->uppers[i].t = DatumGetTimestampTz(entries[i].period.upper);
+    result->uppers[i].inclusive = entries[i].period.upper_inc;
+  }
+  pfree(entries);
+  qsort(result->uppers, (size_t) count, sizeof(PeriodIndexBound),
+    (qsort_comparator) &period_index_bound_cmp);
+  result->maxlevel = period_index_augment(result);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_spantime_index
+ * @brief Return an interval index built from an array of periods.
+ *
+ * @param[in] periods Array of periods
+ * @param[in] ids Identifiers of the periods, if NULL the position of the
+ * period in the array is used
+ * @param[in] count Number of periods
+ */
+PeriodIndex *
+period_index_make(const Period *periods, const int64 *ids, int count)
+{
+  PeriodIndexEntry *entries = palloc(sizeof(PeriodIndexEntry) * Max(count, 1));
+  for (int i = 0; i < count; i++)
+  {
+    entries[i].period = periods[i];
+    entries[i].id = ids ? ids[i] : i;
+  }
+  return period_index_build(entries, Max(count, 0), true);
+}
+
+/**
+ * @ingroup libmeos_spantime_index
+ * @brief Return an interval index built from an array of period sets, in
+ * which each period of a set is associated to the identifier of the set.
+ *
+ * @param[in] ps Array of period sets
+ * @param[in] ids Identifiers of the period sets, if NULL the position of the
+ * period set in the array is used
+ * @param[in] count Number of period sets
+ */
+PeriodIndex *
+period_index_make_periodsets(const PeriodSet **ps, const int64 *ids,
+  int count)
+{
+  int64 total = 0;
+  for (int i = 0; i < count; i++)
+    total += ps[i]->count;
+  if (total > INT_MAX)
+    elog(ERROR, "Too many periods for an interval index");
+  PeriodIndexEntry *entries = palloc(sizeof(PeriodIndexEntry) * Max(total, 1));
+  int k = 0;
+  for (int i = 0; i < count; i++)
+  {
+    for (int j = 0; j < ps[i]->count; j++)
+    {
+      entries[k].period = *periodset_per_n(ps[i], j);
+      entries[k++].id = ids ? ids[i] : i;
+    }
+  }
+  return period_index_build(entries, k, total == count);
+}
+
+/**
+ * @ingroup libmeos_spantime_index
+ * @brief Free an interval index.
+ */
+void
+period_index_free(PeriodIndex *idx)
+{
+  if (idx->count > 0)
+  {
+    pfree(idx->periods);
+    pfree(idx->ids);
+    pfree(idx->maxupper);
+    pfree(idx->uppers);
+  }
+  pfree(idx);
+  return;
+}
+
+/**
+ * @ingroup libmeos_spantime_index
+ * @brief Return the number of periods indexed by an interval index.
+ */
+int
+period_index_count(const PeriodIndex *idx)
+{
+  return idx->count;
+}
+
+/*****************************************************************************
+ * Count queries by binary search
+ *****************************************************************************/
+
+/**
+ * Return the number of periods whose lower bound is before a timestamp,
+ * including those whose inclusive lower bound is equal to the timestamp
+ * when @p inc is true
+ */
+static int
+period_index_lower_before(const PeriodIndex *idx, TimestampTz t, bool inc)
+{
+  /* The periods are sorted by lower bound, inclusive bounds first */
+  int first = 0, last = idx->count;
+  while (first < last)
+  {
+    int middle = first + (last - first) / 2;
+    const Period *p = &idx->periods[middle];
+    TimestampTz lower = DatumGetTimestampTz(p->lower);
+    if (lower < t || (inc && p->lower_inc && lower == t))
+      first = middle + 1;
+    else
+      last = middle;
+  }
+  return first;
+}
+
+/**
+ * Return the number of periods whose upper bound is before a timestamp,
+ * including those whose upper bound is equal to the timestamp when either
+ * bound is exclusive
+ */
+static int
+period_index_upper_before(const PeriodIndex *idx, TimestampTz t, bool inc)
+{
+  /* The upper bounds are sorted, exclusive bounds first */
+  int first = 0, last = idx->count;
+  while (first < last)
+  {
+    int middle = first + (last - first) / 2;
+    const PeriodIndexBound *b = &idx->uppers[middle];
+    if (b->t < t || (b->t == t && (! b->inclusive || ! inc)))
+      first = middle + 1;
+    else
+      last = middle;
+  }
+  return first;
+}
+
+/*****************************************************************************
+ * Queries in the implicit tree
+ *****************************************************************************/
+
+/**
+ * Return true if an indexed period satisfies the predicate of a query
+ */
+static inline bool
+period_index_match(const Period *p, const Period *query, bool contains)
+{
+  return contains ? contains_span_span(p, query) :
+    overlaps_span_span(p, query);
+}
+
+/**
+ * Append an identifier to a result array
+ */
+static void
+period_index_result_add(int64 **result, int *count, int *maxcount, int64 id)
+{
+  if (*count == *maxcount)
+  {
+    *maxcount *= 2;
+    *result = repalloc(*result, sizeof(int64) * *maxcount);
+  }
+  (*result)[(*count)++] = id;
+  return;
+}
+
+/**
+ * Comparator of identifiers
+ */
+static int
+int64_cmp(const int64 *l, const int64 *r)
+{
+  return (*l < *r) ? -1 : ((*l > *r) ? 1 : 0);
+}
+
+/**
+ * Return the number of periods of an index that overlap or contain a query
+ * period and, if @p result is not NULL, their identifiers.
+ *
+ * The candidate periods have a lower bound not after @p hi and an upper
+ * bound not before @p lo, where these values are the bounds of the query
+ * period for overlaps and the reversed bounds for containment.
+ */
+static int
+period_index_query(const PeriodIndex *idx, const Period *query, bool contains,
+  int64 **result)
+{
+  int maxcount = 64, nres = 0;
+  if (result)
+    *result = palloc(sizeof(int64) * maxcount);
+  if (idx->count == 0)
+    return 0;
+  TimestampTz lo = DatumGetTimestampTz(contains ? query->upper : query->lower);
+  TimestampTz hi = DatumGetTimestampTz(contains ? query->lower : query->upper);
+  int64 n = idx->count;
+  /* Each level pushes at most two elements */
+  PeriodIndexStack stack[64];
+  int top = 0;
+  stack[top].x = ((int64) 1 << idx->maxlevel) - 1;
+  stack[top].k = idx->maxlevel;
+  stack[top++].right = false;
+  while (top > 0)
+  {
+    PeriodIndexStack z = stack[--top];
+    if (z.k <= PERIOD_INDEX_SCAN_LEVEL)
+    {
+      /* Scan the subtree in sorted order */
+      int64 i0 = z.x >> z.k << z.k;
+      int64 i1 = Min(i0 + ((int64) 1 << (z.k + 1)) - 1, n);
+      for (int64 i = i0; i < i1 &&
+          DatumGetTimestampTz(idx->periods[i].lower) <= hi; i++)
+      {
+        if (period_index_match(&idx->periods[i], query, contains))
+        {
+          if (result)
+            period_index_result_add(result, &nres, &maxcount, idx->ids[i]);
+          else
+            nres++;
+        }
+      }
+    }
+    else if (! z.right)
+    {
+      /* Revisit the node after its left subtree */
+      int64 y = z.x - ((int64) 1 << (z.k - 1));
+      stack[top].x = z.x;
+      stack[top].k = z.k;
+      stack[top++].right = true;
+      /* The left child may be beyond the end of the array */
+      if (y >= n || idx->maxupper[y] >= lo)
+      {
+        stack[top].x = y;
+        stack[top].k = z.k - 1;
+        stack[top++].right = false;
+      }
+    }
+    else if (z.x < n && DatumGetTimestampTz(idx->periods[z.x].lower) <= hi)
+    {
+      if (period_index_match(&idx->periods[z.x], query, contains))
+      {
+        if (result)
+          period_index_result_add(result, &nres, &maxcount, idx->ids[z.x]);
+        else
+          nres++;
+      }
+      stack[top].x = z.x + ((int64) 1 << (z.k - 1));
+      stack[top].k = z.k - 1;
+      stack[top++].right = false;
+    }
+  }
+  return nres;
+}
+
+/**
+ * Sort a result array and remove its duplicate identifiers
+ */
+static int
+period_index_result_unique(int64 *result, int count)
+{
+  if (count <= 1)
+    return count;
+  qsort(result, (size_t) count, sizeof(int64), (qsort_comparator) &int64_cmp);
+  int k = 1;
+  for (int i = 1; i < count; i++)
+  {
+    if (result[i] != result[k - 1])
+      result[k++] = result[i];
+  }
+  return k;
+}
+
+/*****************************************************************************/
+
+/**
+ * @ingroup libmeos_spantime_index
+ * @brief Return the identifiers of the periods of an interval index that
+ * contain a timestamp.
+ * @sqlop @p \@>
+ */
+int64 *
+period_index_stab(const PeriodIndex *idx, TimestampTz t, int *count)
+{
+  Period query;
+  span_set(TimestampTzGetDatum(t), TimestampTzGetDatum(t), true, true,
+    T_TIMESTAMPTZ, &query);
+  int64 *result;
+  /* The periods of a period set are disjoint, hence no duplicates */
+  *count = period_index_query(idx, &query, false, &result);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_spantime_index
+ * @brief Return the number of periods of an interval index that contain a
+ * timestamp.
+ */
+int
+period_index_stab_count(const PeriodIndex *idx, TimestampTz t)
+{
+  /* A period contains t if its lower bound admits t and its upper bound
+   * is not before t, the latter implying the former */
+  return period_index_lower_before(idx, t, true) -
+    period_index_upper_before(idx, t, true);
+}
+
+/**
+ * @ingroup libmeos_spantime_index
+ * @brief Return the identifiers of the periods of an interval index that
+ * overlap a period.
+ * @sqlop @p &&
+ */
+int64 *
+period_index_overlaps(const PeriodIndex *idx, const Period *p, int *count)
+{
+  int64 *result;
+  int nres = period_index_query(idx, p, false, &result);
+  if (! idx->distinct)
+    nres = period_index_result_unique(result, nres);
+  *count = nres;
+  return result;
+}
+
+/**
+ * @ingroup libmeos_spantime_index
+ * @brief Return the number of periods of an interval index that overlap a
+ * period.
+ */
+int
+period_index_overlaps_count(const PeriodIndex *idx, const Period *p)
+{
+  if (! idx->distinct)
+  {
+    int count;
+    int64 *ids = period_index_overlaps(idx, p, &count);
+    pfree(ids);
+    return count;
+  }
+  /* The periods that are neither before nor after the query period */
+  return period_index_lower_before(idx, DatumGetTimestampTz(p->upper),
+      p->upper_inc) -
+    period_index_upper_before(idx, DatumGetTimestampTz(p->lower),
+      p->lower_inc);
+}
+
+/**
+ * @ingroup libmeos_spantime_index
+ * @brief Return the identifiers of the periods of an interval index that
+ * contain a period.
+ * @sqlop @p \@>
+ */
+int64 *
+period_index_contains(const PeriodIndex *idx, const Period *p, int *count)
+{
+  int64 *result;
+  /* A period is contained in at most one period of a period set */
+  *count = period_index_query(idx, p, true, &result);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_spantime_index
+ * @brief Return the number of periods of an interval index that contain a
+ * period.
+ */
+int
+period_index_contains_count(const PeriodIndex *idx, const Period *p)
+{
+  return period_index_query(idx, p, true, NULL);
+}
+
+/*****************************************************************************
+ * Aggregates by sweeping the sorted bounds
+ *****************************************************************************/
+
+/**
+ * Append to an array of sequences a run of a temporal count, that is, a
+ * step sequence whose count is positive everywhere, and free its instants
+ */
+static void
+period_index_tcount_add(TSequence **sequences, int *count,
+  TInstant **instants, int ninsts, bool lower_inc, bool upper_inc)
+{
+  sequences[(*count)++] = tsequence_make((const TInstant **) instants, ninsts,
+    lower_inc, upper_inc, STEP, NORMALIZE_NO);
+  for (int i = 0; i < ninsts; i++)
+    pfree(instants[i]);
+  return;
+}
+
+/**
+ * @ingroup libmeos_spantime_index
+ * @brief Return the temporal count of the periods of an interval index, or
+ * NULL if the index is empty.
+ *
+ * The result is the same as the one of the tcount aggregate over the
+ * periods. Since the lower bounds and the upper bounds are kept sorted by
+ * the index, it is computed in a single sweep over the bounds instead of
+ * merging one temporal value per period.
+ * @sqlfunc tcount()
+ */
+TSequenceSet *
+period_index_tcount(const PeriodIndex *idx)
+{
+  int n = idx->count;
+  if (n == 0)
+    return NULL;
+  /* Each distinct bound starts at most one run and adds at most one instant
+   * to the current run */
+  TSequence **sequences = palloc(sizeof(TSequence *) * n * 2);
+  TInstant **instants = palloc(sizeof(TInstant *) * (n * 2 + 1));
+  int nseqs = 0, ninsts = 0, i = 0, j = 0, active = 0;
+  bool lower_inc = true;
+  while (j < n)
+  {
+    TimestampTz t = (i < n &&
+      DatumGetTimestampTz(idx->periods[i].lower) <= idx->uppers[j].t) ?
+      DatumGetTimestampTz(idx->periods[i].lower) : idx->uppers[j].t;
+    int lower_inc_t = 0, lower_exc_t = 0, upper_inc_t = 0, upper_exc_t = 0;
+    for ( ; i < n && DatumGetTimestampTz(idx->periods[i].lower) == t; i++)
+    {
+      if (idx->periods[i].lower_inc)
+        lower_inc_t++;
+      else
+        lower_exc_t++;
+    }
+    for ( ; j < n && idx->uppers[j].t == t; j++)
+    {
+      if (idx->uppers[j].inclusive)
+        upper_inc_t++;
+      else
+        upper_exc_t++;
+    }
+    /* Count at t, where the periods ending at t with an exclusive bound and
+     * the ones starting at t with an exclusive bound are not counted, and
+     * count right after t. The count before t is the active one. */
+    int at = active + lower_inc_t - upper_exc_t;
+    int after = active + lower_inc_t + lower_exc_t - upper_inc_t -
+      upper_exc_t;
+    bool inst_t = false;
+    if (at == 0)
+    {
+      /* Close the run with an exclusive bound, the last value is repeated
+       * as required by step interpolation */
+      if (active > 0)
+      {
+        instants[ninsts++] = tinstant_make(Int32GetDatum(active), T_TINT, t);
+        period_index_tcount_add(sequences, &nseqs, instants, ninsts,
+          lower_inc, false);
+        ninsts = 0;
+      }
+    }
+    else if (active == 0 || at != active)
+    {
+      /* Start a run with an inclusive bound or change the value of the
+       * current one */
+      if (active == 0)
+        lower_inc = true;
+      instants[ninsts++] = tinstant_make(Int32GetDatum(at), T_TINT, t);
+      inst_t = true;
+    }
+    if (after != at)
+    {
+      /* A step sequence cannot change its value right after an instant, so
+       * the run is closed with an inclusive bound and another one starts
+       * with an exclusive bound */
+      if (at > 0)
+      {
+        if (! inst_t)
+          instants[ninsts++] = tinstant_make(Int32GetDatum(at), T_TINT, t);
+        period_index_tcount_add(sequences, &nseqs, instants, ninsts,
+          lower_inc, true);
+        ninsts = 0;
+      }
+      if (after > 0)
+      {
+        instants[ninsts++] = tinstant_make(Int32GetDatum(after), T_TINT, t);
+        lower_inc = false;
+      }
+    }
+    active = after;
+  }
+  pfree(instants);
+  /* The runs are maximal and thus the result is already normalized */
+  return tsequenceset_make_free(sequences, nseqs, NORMALIZE_NO);
+}
+
+/**
+ * @ingroup libmeos_spantime_index
+ * @brief Return the union of the periods of an interval index, or NULL if
+ * the index is empty.
+ *
+ * Since the periods are sorted by lower bound in the index, the union is
+ * computed in a single sweep over the periods.
+ * @sqlfunc tunion()
+ */
+PeriodSet *
+period_index_tunion(const PeriodIndex *idx)
+{
+  if (idx->count == 0)
+    return NULL;
+  Period **periods = palloc(sizeof(Period *) * idx->count);
+  Period *current = span_copy(&idx->periods[0]);
+  int k = 0;
+  for (int i = 1; i < idx->count; i++)
+  {
+    const Period *p = &idx->periods[i];
+    if (overlaps_span_span(current, p) || adjacent_span_span(current, p))
+      span_expand(p, current);
+    else
+    {
+      periods[k++] = current;
+      current = span_copy(p);
+    }
+  }
+  periods[k++] = current;
+  return periodset_make_free(periods, k, NORMALIZE);
+}
+
+#endif /* MEOS */
+
+/*****************************************************************************/
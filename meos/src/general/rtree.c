@@ -0,0 +1,1525 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief In-memory R-tree indexing spatiotemporal and temporal boxes.
+ *
+ * The tree associates boxes of type STBOX or TBOX to user identifiers, e.g.,
+ * the position of a trajectory in an application array, and answers window,
+ * k nearest neighbor, and join queries without scanning all the boxes.
+ * The tree can be bulk loaded using the Sort-Tile-Recursive (STR) algorithm
+ * and updated with the insertion and deletion algorithms of Guttman using the
+ * quadratic split. A tree can be saved to a file and memory-mapped back in a
+ * read-only form. The file uses the byte order of the machine.
+ *
+ * The rectangles of the nodes consider closed bounds, the queries check the
+ * original boxes at the leaves with the functions of the box types, e.g.,
+ * overlaps_stbox_stbox() and nad_stbox_stbox().
+ */
+
+#include "general/rtree.h"
+
+#if MEOS
+
+/* C */
+#include <assert.h>
+#include <fcntl.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+/* MobilityDB */
+#include <meos_internal.h>
+#include "general/temporal_util.h"
+#include "general/tnumber_distance.h"
+#include "point/tpoint_spatialfuncs.h"
+
+/** Flags of the boxes that must be equal for all the boxes of a tree */
+#define RTREE_FLAGS_MASK \
+  (MOBDB_FLAG_X | MOBDB_FLAG_Z | MOBDB_FLAG_T | MOBDB_FLAG_GEODETIC)
+
+/** Identifier of the file format */
+#define RTREE_MAGIC "MEOSRTRE"
+#define RTREE_VERSION 1
+
+#define RTREE_BOXSIZE(rtree) \
+  ((rtree)->boxtype == T_STBOX ? sizeof(STBOX) : sizeof(TBOX))
+#define RTREE_BOX_N(rtree, slot) \
+  ((const void *) ((rtree)->boxes + (slot) * RTREE_BOXSIZE(rtree)))
+
+/*****************************************************************************
+ * Rectangles
+ *****************************************************************************/
+
+/**
+ * Set the rectangle of a box. The dimensions absent from the box are set to
+ * an infinite range.
+ */
+static void
+rtree_rect_set(mobdbType boxtype, const void *box, RTreeRect *rect)
+{
+  for (int d = 0; d < RTREE_MAXDIMS; d++)
+  {
+    rect->min[d] = -DBL_MAX;
+    rect->max[d] = DBL_MAX;
+  }
+  const Period *p;
+  int16 flags;
+  if (boxtype == T_STBOX)
+  {
+    const STBOX *stbox = (const STBOX *) box;
+    flags = stbox->flags;
+    p = &stbox->period;
+    if (MOBDB_FLAGS_GET_X(flags))
+    {
+      rect->min[0] = stbox->xmin; rect->max[0] = stbox->xmax;
+      rect->min[1] = stbox->ymin; rect->max[1] = stbox->ymax;
+      if (MOBDB_FLAGS_GET_Z(flags) || MOBDB_FLAGS_GET_GEODETIC(flags))
+      {
+        rect->min[2] = stbox->zmin; rect->max[2] = stbox->zmax;
+      }
+    }
+  }
+  else /* boxtype == T_TBOX */
+  {
+    const TBOX *tbox = (const TBOX *) box;
+    flags = tbox->flags;
+    p = &tbox->period;
+    if (MOBDB_FLAGS_GET_X(flags))
+    {
+      rect->min[0] = datum_double(tbox->span.lower, tbox->span.basetype);
+      rect->max[0] = datum_double(tbox->span.upper, tbox->span.basetype);
+    }
+  }
+  if (MOBDB_FLAGS_GET_T(flags))
+  {
+    rect->min[3] = (double) DatumGetTimestampTz(p->lower);
+    rect->max[3] = (double) DatumGetTimestampTz(p->upper);
+  }
+  return;
+}
+
+static bool
+rtree_rect_overlaps(const RTree *rtree, const RTreeRect *r1,
+  const RTreeRect *r2)
+{
+  for (int i = 0; i < rtree->ndims; i++)
+  {
+    int d = rtree->dims[i];
+    if (r1->max[d] < r2->min[d] || r1->min[d] > r2->max[d])
+      return false;
+  }
+  return true;
+}
+
+static bool
+rtree_rect_contains(const RTree *rtree, const RTreeRect *r1,
+  const RTreeRect *r2)
+{
+  for (int i = 0; i < rtree->ndims; i++)
+  {
+    int d = rtree->dims[i];
+    if (r2->min[d] < r1->min[d] || r2->max[d] > r1->max[d])
+      return false;
+  }
+  return true;
+}
+
+static bool
+rtree_rect_eq(const RTree *rtree, const RTreeRect *r1, const RTreeRect *r2)
+{
+  for (int i = 0; i < rtree->ndims; i++)
+  {
+    int d = rtree->dims[i];
+    if (r1->min[d] != r2->min[d] || r1->max[d] != r2->max[d])
+      return false;
+  }
+  return true;
+}
+
+static void
+rtree_rect_union(const RTree *rtree, const RTreeRect *r1, const RTreeRect *r2,
+  RTreeRect *result)
+{
+  for (int i = 0; i < rtree->ndims; i++)
+  {
+    int d = rtree->dims[i];
+    result->min[d] = Min(r1->min[d], r2->min[d]);
+    result->max[d] = Max(r1->max[d], r2->max[d]);
+  }
+  return;
+}
+
+static double
+rtree_rect_area(const RTree *rtree, const RTreeRect *rect)
+{
+  double result = 1.0;
+  for (int i = 0; i < rtree->ndims; i++)
+  {
+    int d = rtree->dims[i];
+    result *= rect->max[d] - rect->min[d];
+  }
+  return result;
+}
+
+/**
+ * Return the area of the union of two rectangles
+ */
+static double
+rtree_rect_union_area(const RTree *rtree, const RTreeRect *r1,
+  const RTreeRect *r2)
+{
+  RTreeRect rect;
+  rtree_rect_union(rtree, r1, r2, &rect);
+  return rtree_rect_area(rtree, &rect);
+}
+
+/*****************************************************************************
+ * Nodes and slots
+ *****************************************************************************/
+
+/**
+ * Ensure that the tree is not memory-mapped
+ */
+static void
+ensure_rtree_writable(const RTree *rtree)
+{
+  if (rtree->mapping)
+    elog(ERROR, "The R-tree is memory-mapped and cannot be modified");
+  return;
+}
+
+/**
+ * Ensure that the tree indexes boxes of the given type
+ */
+static void
+ensure_rtree_boxtype(const RTree *rtree, mobdbType boxtype)
+{
+  if (rtree->boxtype != boxtype)
+    elog(ERROR, "The R-tree does not index boxes of type %s",
+      boxtype == T_STBOX ? "stbox" : "tbox");
+  return;
+}
+
+/**
+ * Set the flags of the tree from its first box or ensure that the box has
+ * the same dimensions as the previous ones
+ */
+static void
+rtree_set_flags(RTree *rtree, const void *box)
+{
+  int16 flags;
+  int32 srid = 0;
+  if (rtree->boxtype == T_STBOX)
+  {
+    flags = ((const STBOX *) box)->flags;
+    srid = ((const STBOX *) box)->srid;
+  }
+  else
+    flags = ((const TBOX *) box)->flags;
+  if (rtree->hasflags)
+  {
+    if ((flags & RTREE_FLAGS_MASK) != (rtree->flags & RTREE_FLAGS_MASK))
+      elog(ERROR, "The boxes of an R-tree must have the same dimensions");
+    if (rtree->boxtype == T_STBOX && MOBDB_FLAGS_GET_X(flags))
+      ensure_same_srid(rtree->srid, srid);
+    return;
+  }
+  rtree->flags = flags & RTREE_FLAGS_MASK;
+  rtree->srid = srid;
+  rtree->hasflags = true;
+  rtree->ndims = 0;
+  if (MOBDB_FLAGS_GET_X(flags))
+  {
+    rtree->dims[rtree->ndims++] = 0;
+    if (rtree->boxtype == T_STBOX)
+    {
+      rtree->dims[rtree->ndims++] = 1;
+      if (MOBDB_FLAGS_GET_Z(flags) || MOBDB_FLAGS_GET_GEODETIC(flags))
+        rtree->dims[rtree->ndims++] = 2;
+    }
+  }
+  if (MOBDB_FLAGS_GET_T(flags))
+    rtree->dims[rtree->ndims++] = 3;
+  return;
+}
+
+/**
+ * Return the number of a new node of the tree
+ */
+static int32
+rtree_node_alloc(RTree *rtree, int16 level)
+{
+  int32 result;
+  if (rtree->freenode >= 0)
+  {
+    result = rtree->freenode;
+    rtree->freenode = (int32) rtree->nodes[result].ptrs[0];
+  }
+  else
+  {
+    if (rtree->nnodes == rtree->maxnodes)
+    {
+      rtree->maxnodes *= 2;
+      rtree->nodes = repalloc(rtree->nodes,
+        sizeof(RTreeNode) * rtree->maxnodes);
+    }
+    result = rtree->nnodes++;
+  }
+  rtree->nodes[result].count = 0;
+  rtree->nodes[result].level = level;
+  return result;
+}
+
+static void
+rtree_node_free(RTree *rtree, int32 nodeno)
+{
+  rtree->nodes[nodeno].count = 0;
+  rtree->nodes[nodeno].ptrs[0] = rtree->freenode;
+  rtree->freenode = nodeno;
+  return;
+}
+
+/**
+ * Return the slot storing a new box and its identifier
+ */
+static int64
+rtree_slot_alloc(RTree *rtree, const void *box, int64 id)
+{
+  int64 result;
+  if (rtree->freeslot >= 0)
+  {
+    result = rtree->freeslot;
+    rtree->freeslot = rtree->ids[result];
+  }
+  else
+  {
+    if (rtree->nslots == rtree->maxslots)
+    {
+      rtree->maxslots *= 2;
+      rtree->boxes = repalloc(rtree->boxes,
+        RTREE_BOXSIZE(rtree) * rtree->maxslots);
+      rtree->ids = repalloc(rtree->ids, sizeof(int64) * rtree->maxslots);
+    }
+    result = rtree->nslots++;
+  }
+  memcpy(rtree->boxes + result * RTREE_BOXSIZE(rtree), box,
+    RTREE_BOXSIZE(rtree));
+  rtree->ids[result] = id;
+  return result;
+}
+
+static void
+rtree_slot_free(RTree *rtree, int64 slot)
+{
+  rtree->ids[slot] = rtree->freeslot;
+  rtree->freeslot = slot;
+  return;
+}
+
+/**
+ * Set the rectangle covering all the entries of a node
+ */
+static void
+rtree_node_rect(const RTree *rtree, int32 nodeno, RTreeRect *result)
+{
+  const RTreeNode *node = &rtree->nodes[nodeno];
+  *result = node->rects[0];
+  for (int i = 1; i < node->count; i++)
+    rtree_rect_union(rtree, result, &node->rects[i], result);
+  return;
+}
+
+/**
+ * Create an empty tree
+ */
+static RTree *
+rtree_make(mobdbType boxtype)
+{
+  RTree *result = palloc0(sizeof(RTree));
+  result->boxtype = boxtype;
+  result->maxnodes = 16;
+  result->nodes = palloc(sizeof(RTreeNode) * result->maxnodes);
+  result->freenode = -1;
+  result->maxslots = 64;
+  result->boxes = palloc(RTREE_BOXSIZE(result) * result->maxslots);
+  result->ids = palloc(sizeof(int64) * result->maxslots);
+  result->freeslot = -1;
+  result->root = rtree_node_alloc(result, 0);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Return an empty R-tree for spatiotemporal boxes.
+ */
+RTree *
+rtree_make_stbox(void)
+{
+  return rtree_make(T_STBOX);
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Return an empty R-tree for temporal boxes.
+ */
+RTree *
+rtree_make_tbox(void)
+{
+  return rtree_make(T_TBOX);
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Free an R-tree, unmapping it if it was opened from a file.
+ */
+void
+rtree_free(RTree *rtree)
+{
+  if (rtree->mapping)
+    munmap(rtree->mapping, rtree->mapsize);
+  else
+  {
+    pfree(rtree->nodes);
+    pfree(rtree->boxes);
+    pfree(rtree->ids);
+  }
+  pfree(rtree);
+  return;
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Return the number of boxes indexed by an R-tree.
+ */
+int64
+rtree_count(const RTree *rtree)
+{
+  return rtree->count;
+}
+
+/*****************************************************************************
+ * Insertion
+ *****************************************************************************/
+
+/**
+ * Split the entries of a full node and the new entry into the node and a new
+ * node using the quadratic split algorithm of Guttman
+ *
+ * @return Number of the new node
+ */
+static int32
+rtree_node_split(RTree *rtree, int32 nodeno, const RTreeRect *rect,
+  int64 ptr)
+{
+  RTreeRect rects[RTREE_MAXENTRIES + 1];
+  int64 ptrs[RTREE_MAXENTRIES + 1];
+  bool assigned[RTREE_MAXENTRIES + 1];
+  int total = RTREE_MAXENTRIES + 1;
+  int16 level = rtree->nodes[nodeno].level;
+  int32 newno = rtree_node_alloc(rtree, level);
+  RTreeNode *node = &rtree->nodes[nodeno];
+  RTreeNode *newnode = &rtree->nodes[newno];
+  memcpy(rects, node->rects, sizeof(RTreeRect) * RTREE_MAXENTRIES);
+  memcpy(ptrs, node->ptrs, sizeof(int64) * RTREE_MAXENTRIES);
+  rects[RTREE_MAXENTRIES] = *rect;
+  ptrs[RTREE_MAXENTRIES] = ptr;
+  memset(assigned, 0, sizeof(assigned));
+
+  /* Pick the seeds wasting the most area if put in the same node */
+  int seed1 = 0, seed2 = 1;
+  double worst = -DBL_MAX;
+  for (int i = 0; i < total - 1; i++)
+  {
+    double area_i = rtree_rect_area(rtree, &rects[i]);
+    for (int j = i + 1; j < total; j++)
+    {
+      double waste = rtree_rect_union_area(rtree, &rects[i], &rects[j]) -
+        area_i - rtree_rect_area(rtree, &rects[j]);
+      if (waste > worst)
+      {
+        worst = waste;
+        seed1 = i;
+        seed2 = j;
+      }
+    }
+  }
+
+  RTreeRect cover1 = rects[seed1], cover2 = rects[seed2];
+  node->count = newnode->count = 0;
+  node->rects[node->count] = rects[seed1];
+  node->ptrs[node->count++] = ptrs[seed1];
+  newnode->rects[newnode->count] = rects[seed2];
+  newnode->ptrs[newnode->count++] = ptrs[seed2];
+  assigned[seed1] = assigned[seed2] = true;
+  int remaining = total - 2;
+
+  while (remaining > 0)
+  {
+    /* Assign all the remaining entries to a node that needs them */
+    if (node->count + remaining == RTREE_MINENTRIES ||
+        newnode->count + remaining == RTREE_MINENTRIES)
+    {
+      RTreeNode *target = node->count + remaining == RTREE_MINENTRIES ?
+        node : newnode;
+      for (int i = 0; i < total; i++)
+      {
+        if (assigned[i])
+          continue;
+        target->rects[target->count] = rects[i];
+        target->ptrs[target->count++] = ptrs[i];
+        assigned[i] = true;
+      }
+      break;
+    }
+    /* Pick the entry with the greatest preference for one node */
+    int next = -1;
+    double maxdiff = -1.0, growth1 = 0.0, growth2 = 0.0;
+    double area1 = rtree_rect_area(rtree, &cover1);
+    double area2 = rtree_rect_area(rtree, &cover2);
+    for (int i = 0; i < total; i++)
+    {
+      if (assigned[i])
+        continue;
+      double d1 = rtree_rect_union_area(rtree, &cover1, &rects[i]) - area1;
+      double d2 = rtree_rect_union_area(rtree, &cover2, &rects[i]) - area2;
+      if (fabs(d1 - d2) > maxdiff)
+      {
+        maxdiff = fabs(d1 - d2);
+        next = i;
+        growth1 = d1;
+        growth2 = d2;
+      }
+    }
+    bool first = growth1 < growth2 || (growth1 == growth2 &&
+      (area1 < area2 || (area1 == area2 && node->count <= newnode->count)));
+    RTreeNode *target = first ? node : newnode;
+    RTreeRect *cover = first ? &cover1 : &cover2;
+    target->rects[target->count] = rects[next];
+    target->ptrs[target->count++] = ptrs[next];
+    rtree_rect_union(rtree, cover, &rects[next], cover);
+    assigned[next] = true;
+    remaining--;
+  }
+  return newno;
+}
+
+/**
+ * Add an entry to a node, splitting the node if it is full
+ *
+ * @return Number of the new node if the node was split, -1 otherwise
+ */
+static int32
+rtree_node_add(RTree *rtree, int32 nodeno, const RTreeRect *rect, int64 ptr)
+{
+  RTreeNode *node = &rtree->nodes[nodeno];
+  if (node->count < RTREE_MAXENTRIES)
+  {
+    node->rects[node->count] = *rect;
+    node->ptrs[node->count++] = ptr;
+    return -1;
+  }
+  return rtree_node_split(rtree, nodeno, rect, ptr);
+}
+
+/**
+ * Return the entry of an internal node needing the least enlargement to
+ * include the rectangle, ties are resolved by the smallest area
+ */
+static int
+rtree_choose_subtree(const RTree *rtree, const RTreeNode *node,
+  const RTreeRect *rect)
+{
+  int result = 0;
+  double best_growth = DBL_MAX, best_area = DBL_MAX;
+  for (int i = 0; i < node->count; i++)
+  {
+    double area = rtree_rect_area(rtree, &node->rects[i]);
+    double growth = rtree_rect_union_area(rtree, &node->rects[i], rect) -
+      area;
+    if (growth < best_growth || (growth == best_growth && area < best_area))
+    {
+      best_growth = growth;
+      best_area = area;
+      result = i;
+    }
+  }
+  return result;
+}
+
+/**
+ * Insert an entry in the node at the given level of the subtree
+ *
+ * @return Number of the new node if the root of the subtree was split,
+ * -1 otherwise
+ */
+static int32
+rtree_insert_rec(RTree *rtree, int32 nodeno, const RTreeRect *rect,
+  int64 ptr, int level)
+{
+  if (rtree->nodes[nodeno].level == level)
+    return rtree_node_add(rtree, nodeno, rect, ptr);
+  int i = rtree_choose_subtree(rtree, &rtree->nodes[nodeno], rect);
+  int32 childno = (int32) rtree->nodes[nodeno].ptrs[i];
+  int32 splitno = rtree_insert_rec(rtree, childno, rect, ptr, level);
+  /* The nodes may have been reallocated */
+  rtree_node_rect(rtree, childno, &rtree->nodes[nodeno].rects[i]);
+  if (splitno < 0)
+    return -1;
+  RTreeRect splitrect;
+  rtree_node_rect(rtree, splitno, &splitrect);
+  return rtree_node_add(rtree, nodeno, &splitrect, splitno);
+}
+
+/**
+ * Insert an entry in a node at the given level of the tree, growing the tree
+ * if the root is split
+ */
+static void
+rtree_insert_entry(RTree *rtree, const RTreeRect *rect, int64 ptr, int level)
+{
+  int32 splitno = rtree_insert_rec(rtree, rtree->root, rect, ptr, level);
+  if (splitno < 0)
+    return;
+  int32 oldroot = rtree->root;
+  int32 newroot = rtree_node_alloc(rtree, rtree->nodes[oldroot].level + 1);
+  RTreeNode *root = &rtree->nodes[newroot];
+  rtree_node_rect(rtree, oldroot, &root->rects[0]);
+  root->ptrs[0] = oldroot;
+  rtree_node_rect(rtree, splitno, &root->rects[1]);
+  root->ptrs[1] = splitno;
+  root->count = 2;
+  rtree->root = newroot;
+  return;
+}
+
+/**
+ * Insert a box and its identifier in a tree
+ */
+static void
+rtree_insert(RTree *rtree, const void *box, int64 id)
+{
+  ensure_rtree_writable(rtree);
+  rtree_set_flags(rtree, box);
+  RTreeRect rect;
+  rtree_rect_set(rtree->boxtype, box, &rect);
+  int64 slot = rtree_slot_alloc(rtree, box, id);
+  rtree_insert_entry(rtree, &rect, slot, 0);
+  rtree->count++;
+  return;
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Insert a spatiotemporal box and its identifier in an R-tree.
+ */
+void
+rtree_insert_stbox(RTree *rtree, const STBOX *box, int64 id)
+{
+  ensure_rtree_boxtype(rtree, T_STBOX);
+  rtree_insert(rtree, box, id);
+  return;
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Insert a temporal box and its identifier in an R-tree.
+ */
+void
+rtree_insert_tbox(RTree *rtree, const TBOX *box, int64 id)
+{
+  ensure_rtree_boxtype(rtree, T_TBOX);
+  rtree_insert(rtree, box, id);
+  return;
+}
+
+/*****************************************************************************
+ * Deletion
+ *****************************************************************************/
+
+/**
+ * Entry removed from an underfull node that must be reinserted
+ */
+typedef struct
+{
+  RTreeRect rect;              /**< Rectangle of the entry */
+  int64 ptr;                   /**< Slot or child node */
+  int level;                   /**< Level of the node containing the entry */
+} RTreeOrphan;
+
+/**
+ * List of entries to reinsert
+ */
+typedef struct
+{
+  RTreeOrphan *entries;
+  int count;
+  int maxcount;
+} RTreeOrphans;
+
+static void
+rtree_orphans_add(RTreeOrphans *orphans, const RTreeNode *node)
+{
+  if (orphans->count + node->count > orphans->maxcount)
+  {
+    orphans->maxcount = Max(orphans->maxcount * 2,
+      orphans->count + node->count);
+    orphans->entries = orphans->entries ?
+      repalloc(orphans->entries, sizeof(RTreeOrphan) * orphans->maxcount) :
+      palloc(sizeof(RTreeOrphan) * orphans->maxcount);
+  }
+  for (int i = 0; i < node->count; i++)
+  {
+    RTreeOrphan *orphan = &orphans->entries[orphans->count++];
+    orphan->rect = node->rects[i];
+    orphan->ptr = node->ptrs[i];
+    orphan->level = node->level;
+  }
+  return;
+}
+
+/**
+ * Remove an entry from a node by moving the last entry into its place
+ */
+static void
+rtree_node_remove(RTreeNode *node, int i)
+{
+  node->count--;
+  if (i < node->count)
+  {
+    node->rects[i] = node->rects[node->count];
+    node->ptrs[i] = node->ptrs[node->count];
+  }
+  return;
+}
+
+/**
+ * Remove the entry with the rectangle and identifier from the subtree,
+ * collecting the entries of the nodes becoming underfull
+ *
+ * @return True if the entry was found
+ */
+static bool
+rtree_delete_rec(RTree *rtree, int32 nodeno, const RTreeRect *rect,
+  int64 id, RTreeOrphans *orphans)
+{
+  RTreeNode *node = &rtree->nodes[nodeno];
+  if (node->level == 0)
+  {
+    for (int i = 0; i < node->count; i++)
+    {
+      if (rtree->ids[node->ptrs[i]] == id &&
+          rtree_rect_eq(rtree, &node->rects[i], rect))
+      {
+        rtree_slot_free(rtree, node->ptrs[i]);
+        rtree_node_remove(node, i);
+        return true;
+      }
+    }
+    return false;
+  }
+  for (int i = 0; i < node->count; i++)
+  {
+    if (! rtree_rect_contains(rtree, &node->rects[i], rect))
+      continue;
+    int32 childno = (int32) node->ptrs[i];
+    if (! rtree_delete_rec(rtree, childno, rect, id, orphans))
+      continue;
+    RTreeNode *child = &rtree->nodes[childno];
+    if (child->count < RTREE_MINENTRIES)
+    {
+      rtree_orphans_add(orphans, child);
+      rtree_node_free(rtree, childno);
+      rtree_node_remove(node, i);
+    }
+    else
+      rtree_node_rect(rtree, childno, &node->rects[i]);
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Delete a box and its identifier from a tree
+ */
+static bool
+rtree_delete(RTree *rtree, const void *box, int64 id)
+{
+  ensure_rtree_writable(rtree);
+  if (rtree->count == 0)
+    return false;
+  RTreeRect rect;
+  rtree_rect_set(rtree->boxtype, box, &rect);
+  RTreeOrphans orphans;
+  memset(&orphans, 0, sizeof(RTreeOrphans));
+  if (! rtree_delete_rec(rtree, rtree->root, &rect, id, &orphans))
+    return false;
+  rtree->count--;
+  /* Reinsert the entries of the removed nodes at their level */
+  for (int i = 0; i < orphans.count; i++)
+    rtree_insert_entry(rtree, &orphans.entries[i].rect,
+      orphans.entries[i].ptr, orphans.entries[i].level);
+  if (orphans.entries)
+    pfree(orphans.entries);
+  /* Shorten the tree while the root has a single child */
+  while (rtree->nodes[rtree->root].level > 0 &&
+    rtree->nodes[rtree->root].count == 1)
+  {
+    int32 oldroot = rtree->root;
+    rtree->root = (int32) rtree->nodes[oldroot].ptrs[0];
+    rtree_node_free(rtree, oldroot);
+  }
+  return true;
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Delete a spatiotemporal box and its identifier from an R-tree.
+ * @return True if the box was found
+ */
+bool
+rtree_delete_stbox(RTree *rtree, const STBOX *box, int64 id)
+{
+  ensure_rtree_boxtype(rtree, T_STBOX);
+  return rtree_delete(rtree, box, id);
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Delete a temporal box and its identifier from an R-tree.
+ * @return True if the box was found
+ */
+bool
+rtree_delete_tbox(RTree *rtree, const TBOX *box, int64 id)
+{
+  ensure_rtree_boxtype(rtree, T_TBOX);
+  return rtree_delete(rtree, box, id);
+}
+
+/*****************************************************************************
+ * Bulk loading
+ *****************************************************************************/
+
+/**
+ * Entry to be packed into the nodes of a level of the tree
+ */
+typedef struct
+{
+  RTreeRect rect;              /**< Rectangle of the entry */
+  int64 ptr;                   /**< Slot or child node */
+} RTreeEntry;
+
+/**
+ * Comparator of entries by the center of their rectangle on a dimension
+ */
+static int
+rtree_entry_cmp(const RTreeEntry *e1, const RTreeEntry *e2, const int *dim)
+{
+  double c1 = e1->rect.min[*dim] / 2 + e1->rect.max[*dim] / 2;
+  double c2 = e2->rect.min[*dim] / 2 + e2->rect.max[*dim] / 2;
+  return (c1 < c2) ? -1 : ((c1 > c2) ? 1 : 0);
+}
+
+/**
+ * Sort the entries according to the Sort-Tile-Recursive algorithm: sort on
+ * the first dimension, cut into slabs, and sort each slab recursively on the
+ * next dimensions
+ */
+static void
+rtree_str_sort(const RTree *rtree, RTreeEntry *entries, int64 count, int pos)
+{
+  int dim = rtree->dims[pos];
+  qsort_arg(entries, (size_t) count, sizeof(RTreeEntry),
+    (qsort_arg_comparator) &rtree_entry_cmp, &dim);
+  if (pos == rtree->ndims - 1)
+    return;
+  int64 nnodes = (count + RTREE_MAXENTRIES - 1) / RTREE_MAXENTRIES;
+  int64 nslabs = (int64) ceil(pow((double) nnodes,
+    1.0 / (rtree->ndims - pos)));
+  int64 slabsize = RTREE_MAXENTRIES * ((nnodes + nslabs - 1) / nslabs);
+  for (int64 i = 0; i < count; i += slabsize)
+    rtree_str_sort(rtree, &entries[i], Min(slabsize, count - i), pos + 1);
+  return;
+}
+
+/**
+ * Bulk load a tree with the Sort-Tile-Recursive algorithm
+ */
+static RTree *
+rtree_bulk_load(mobdbType boxtype, const void *boxes, const int64 *ids,
+  int count)
+{
+  RTree *result = rtree_make(boxtype);
+  if (count <= 0)
+    return result;
+  size_t boxsize = RTREE_BOXSIZE(result);
+  RTreeEntry *entries = palloc(sizeof(RTreeEntry) * count);
+  for (int i = 0; i < count; i++)
+  {
+    const void *box = (const char *) boxes + i * boxsize;
+    rtree_set_flags(result, box);
+    rtree_rect_set(boxtype, box, &entries[i].rect);
+    entries[i].ptr = rtree_slot_alloc(result, box, ids ? ids[i] : i);
+  }
+  result->count = count;
+
+  /* Pack the entries of each level until they fit in the root */
+  int64 nentries = count;
+  int16 level = 0;
+  rtree_node_free(result, result->root);
+  for (;;)
+  {
+    if (result->ndims > 0)
+      rtree_str_sort(result, entries, nentries, 0);
+    int64 nnodes = 0;
+    for (int64 i = 0; i < nentries; i += RTREE_MAXENTRIES)
+    {
+      int32 nodeno = rtree_node_alloc(result, level);
+      RTreeNode *node = &result->nodes[nodeno];
+      int64 n = Min(RTREE_MAXENTRIES, nentries - i);
+      for (int64 j = 0; j < n; j++)
+      {
+        node->rects[j] = entries[i + j].rect;
+        node->ptrs[j] = entries[i + j].ptr;
+      }
+      node->count = (int16) n;
+      /* The packed nodes replace the entries of the level */
+      rtree_node_rect(result, nodeno, &entries[nnodes].rect);
+      entries[nnodes++].ptr = nodeno;
+    }
+    if (nnodes == 1)
+    {
+      result->root = (int32) entries[0].ptr;
+      break;
+    }
+    nentries = nnodes;
+    level++;
+  }
+  pfree(entries);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Return an R-tree bulk loaded with spatiotemporal boxes.
+ *
+ * @param[in] boxes Array of boxes, which must have the same dimensions
+ * @param[in] ids Identifiers of the boxes, if NULL the position of the box
+ * in the array is used
+ * @param[in] count Number of boxes
+ */
+RTree *
+rtree_bulk_load_stbox(const STBOX *boxes, const int64 *ids, int count)
+{
+  return rtree_bulk_load(T_STBOX, boxes, ids, count);
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Return an R-tree bulk loaded with temporal boxes.
+ *
+ * @param[in] boxes Array of boxes, which must have the same dimensions
+ * @param[in] ids Identifiers of the boxes, if NULL the position of the box
+ * in the array is used
+ * @param[in] count Number of boxes
+ */
+RTree *
+rtree_bulk_load_tbox(const TBOX *boxes, const int64 *ids, int count)
+{
+  return rtree_bulk_load(T_TBOX, boxes, ids, count);
+}
+
+/*****************************************************************************
+ * Window queries
+ *****************************************************************************/
+
+/**
+ * Return true if two boxes of the given type overlap
+ */
+static bool
+rtree_box_overlaps(mobdbType boxtype, const void *box1, const void *box2)
+{
+  if (boxtype == T_STBOX)
+    return overlaps_stbox_stbox((const STBOX *) box1, (const STBOX *) box2);
+  return overlaps_tbox_tbox((const TBOX *) box1, (const TBOX *) box2);
+}
+
+/**
+ * Append an identifier to a result array
+ */
+static void
+rtree_result_add(int64 **result, int *count, int *maxcount, int64 id)
+{
+  if (*count == *maxcount)
+  {
+    *maxcount *= 2;
+    *result = repalloc(*result, sizeof(int64) * *maxcount);
+  }
+  (*result)[(*count)++] = id;
+  return;
+}
+
+/**
+ * Return the identifiers of the boxes of a tree overlapping a box
+ */
+static int64 *
+rtree_search(const RTree *rtree, const void *box, int *count)
+{
+  int maxcount = 64, nres = 0;
+  int64 *result = palloc(sizeof(int64) * maxcount);
+  *count = 0;
+  if (rtree->count == 0)
+    return result;
+  RTreeRect rect;
+  rtree_rect_set(rtree->boxtype, box, &rect);
+  int maxstack = 64, nstack = 0;
+  int32 *stack = palloc(sizeof(int32) * maxstack);
+  stack[nstack++] = rtree->root;
+  while (nstack > 0)
+  {
+    const RTreeNode *node = &rtree->nodes[stack[--nstack]];
+    for (int i = 0; i < node->count; i++)
+    {
+      if (! rtree_rect_overlaps(rtree, &node->rects[i], &rect))
+        continue;
+      if (node->level == 0)
+      {
+        if (rtree_box_overlaps(rtree->boxtype, box,
+            RTREE_BOX_N(rtree, node->ptrs[i])))
+          rtree_result_add(&result, &nres, &maxcount,
+            rtree->ids[node->ptrs[i]]);
+      }
+      else
+      {
+        if (nstack == maxstack)
+        {
+          maxstack *= 2;
+          stack = repalloc(stack, sizeof(int32) * maxstack);
+        }
+        stack[nstack++] = (int32) node->ptrs[i];
+      }
+    }
+  }
+  pfree(stack);
+  *count = nres;
+  return result;
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Return the identifiers of the boxes of an R-tree that overlap a
+ * spatiotemporal box.
+ * @sqlop @p &&
+ */
+int64 *
+rtree_search_stbox(const RTree *rtree, const STBOX *box, int *count)
+{
+  ensure_rtree_boxtype(rtree, T_STBOX);
+  return rtree_search(rtree, box, count);
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Return the identifiers of the boxes of an R-tree that overlap a
+ * temporal box.
+ * @sqlop @p &&
+ */
+int64 *
+rtree_search_tbox(const RTree *rtree, const TBOX *box, int *count)
+{
+  ensure_rtree_boxtype(rtree, T_TBOX);
+  return rtree_search(rtree, box, count);
+}
+
+/*****************************************************************************
+ * Nearest neighbor queries
+ *****************************************************************************/
+
+/**
+ * Element of the priority queue of the nearest neighbor search, which is
+ * either a node of the tree or a slot of a box
+ */
+typedef struct
+{
+  double dist;                 /**< Distance to the query box */
+  int64 ptr;                   /**< Node or slot */
+  bool isslot;                 /**< True for a slot */
+} RTreeKnnItem;
+
+/**
+ * Binary min-heap of the nearest neighbor search
+ */
+typedef struct
+{
+  RTreeKnnItem *items;
+  int count;
+  int maxcount;
+} RTreeKnnQueue;
+
+static void
+rtree_knn_push(RTreeKnnQueue *queue, double dist, int64 ptr, bool isslot)
+{
+  if (queue->count == queue->maxcount)
+  {
+    queue->maxcount *= 2;
+    queue->items = repalloc(queue->items,
+      sizeof(RTreeKnnItem) * queue->maxcount);
+  }
+  int i = queue->count++;
+  while (i > 0 && queue->items[(i - 1) / 2].dist > dist)
+  {
+    queue->items[i] = queue->items[(i - 1) / 2];
+    i = (i - 1) / 2;
+  }
+  queue->items[i].dist = dist;
+  queue->items[i].ptr = ptr;
+  queue->items[i].isslot = isslot;
+  return;
+}
+
+static RTreeKnnItem
+rtree_knn_pop(RTreeKnnQueue *queue)
+{
+  RTreeKnnItem result = queue->items[0];
+  RTreeKnnItem last = queue->items[--queue->count];
+  int i = 0;
+  for (;;)
+  {
+    int child = 2 * i + 1;
+    if (child >= queue->count)
+      break;
+    if (child + 1 < queue->count &&
+        queue->items[child + 1].dist < queue->items[child].dist)
+      child++;
+    if (queue->items[child].dist >= last.dist)
+      break;
+    queue->items[i] = queue->items[child];
+    i = child;
+  }
+  if (queue->count > 0)
+    queue->items[i] = last;
+  return result;
+}
+
+/**
+ * Return a lower bound of the nearest approach distance between the query
+ * box and the boxes under a node entry. As nad_stbox_stbox() and
+ * nad_tbox_tbox(), the distance is infinite when the boxes do not overlap in
+ * time and is zero when they overlap in the first (x or value) dimension.
+ */
+static double
+rtree_rect_mindist(const RTree *rtree, const RTreeRect *rect,
+  const RTreeRect *query, bool hasz, bool hast)
+{
+  if (hast && (rect->max[3] < query->min[3] || rect->min[3] > query->max[3]))
+    return DBL_MAX;
+  if (rect->max[0] >= query->min[0] && rect->min[0] <= query->max[0])
+    return 0.0;
+  int ndims = rtree->boxtype == T_TBOX ? 1 : (hasz ? 3 : 2);
+  double result = 0.0;
+  for (int d = 0; d < ndims; d++)
+  {
+    double gap = 0.0;
+    if (rect->max[d] < query->min[d])
+      gap = query->min[d] - rect->max[d];
+    else if (rect->min[d] > query->max[d])
+      gap = rect->min[d] - query->max[d];
+    result += gap * gap;
+  }
+  return sqrt(result);
+}
+
+/**
+ * Return the nearest approach distance between two boxes of the given type
+ */
+static double
+rtree_box_nad(mobdbType boxtype, const void *box1, const void *box2)
+{
+  if (boxtype == T_STBOX)
+    return nad_stbox_stbox((const STBOX *) box1, (const STBOX *) box2);
+  return nad_tbox_tbox((const TBOX *) box1, (const TBOX *) box2);
+}
+
+/**
+ * Return the identifiers of the k boxes of a tree that are nearest to a box
+ * using the best-first search algorithm
+ */
+static int64 *
+rtree_knn(const RTree *rtree, const void *box, int k, double *dists,
+  int *count)
+{
+  int16 flags = rtree->boxtype == T_STBOX ? ((const STBOX *) box)->flags :
+    ((const TBOX *) box)->flags;
+  if (! MOBDB_FLAGS_GET_X(flags) || ! MOBDB_FLAGS_GET_X(rtree->flags))
+    elog(ERROR, "The boxes must have X dimension");
+  if (rtree->boxtype == T_STBOX)
+    ensure_not_geodetic(flags);
+  bool hasz = MOBDB_FLAGS_GET_Z(flags) && MOBDB_FLAGS_GET_Z(rtree->flags);
+  bool hast = MOBDB_FLAGS_GET_T(flags) && MOBDB_FLAGS_GET_T(rtree->flags);
+
+  int64 *result = palloc(sizeof(int64) * Max(k, 1));
+  int nres = 0;
+  if (rtree->count == 0 || k <= 0)
+  {
+    *count = 0;
+    return result;
+  }
+  RTreeRect query;
+  rtree_rect_set(rtree->boxtype, box, &query);
+  RTreeKnnQueue queue;
+  queue.maxcount = 64;
+  queue.count = 0;
+  queue.items = palloc(sizeof(RTreeKnnItem) * queue.maxcount);
+  rtree_knn_push(&queue, 0.0, rtree->root, false);
+  while (queue.count > 0 && nres < k)
+  {
+    RTreeKnnItem item = rtree_knn_pop(&queue);
+    if (item.isslot)
+    {
+      if (dists)
+        dists[nres] = item.dist;
+      result[nres++] = rtree->ids[item.ptr];
+      continue;
+    }
+    const RTreeNode *node = &rtree->nodes[item.ptr];
+    for (int i = 0; i < node->count; i++)
+    {
+      double dist = rtree_rect_mindist(rtree, &node->rects[i], &query, hasz,
+        hast);
+      if (dist == DBL_MAX)
+        continue;
+      if (node->level == 0)
+      {
+        dist = rtree_box_nad(rtree->boxtype, box,
+          RTREE_BOX_N(rtree, node->ptrs[i]));
+        if (dist == DBL_MAX)
+          continue;
+      }
+      rtree_knn_push(&queue, dist, node->ptrs[i], node->level == 0);
+    }
+  }
+  pfree(queue.items);
+  *count = nres;
+  return result;
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Return the identifiers of the k boxes of an R-tree that are the
+ * nearest to a spatiotemporal box, ordered by their nearest approach
+ * distance.
+ *
+ * @param[in] rtree Tree
+ * @param[in] box Query box
+ * @param[in] k Number of neighbors
+ * @param[out] dists If not NULL, array of size k receiving the distances
+ * @param[out] count Number of neighbors found
+ * @sqlop @p |=|
+ */
+int64 *
+rtree_knn_stbox(const RTree *rtree, const STBOX *box, int k, double *dists,
+  int *count)
+{
+  ensure_rtree_boxtype(rtree, T_STBOX);
+  return rtree_knn(rtree, box, k, dists, count);
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Return the identifiers of the k boxes of an R-tree that are the
+ * nearest to a temporal box, ordered by their nearest approach distance.
+ *
+ * @param[in] rtree Tree
+ * @param[in] box Query box
+ * @param[in] k Number of neighbors
+ * @param[out] dists If not NULL, array of size k receiving the distances
+ * @param[out] count Number of neighbors found
+ * @sqlop @p |=|
+ */
+int64 *
+rtree_knn_tbox(const RTree *rtree, const TBOX *box, int k, double *dists,
+  int *count)
+{
+  ensure_rtree_boxtype(rtree, T_TBOX);
+  return rtree_knn(rtree, box, k, dists, count);
+}
+
+/*****************************************************************************
+ * Join queries
+ *****************************************************************************/
+
+/**
+ * State of a join of two trees
+ */
+typedef struct
+{
+  const RTree *rtree1;         /**< First tree */
+  const RTree *rtree2;         /**< Second tree */
+  RTree common;                /**< Dimensions common to both trees */
+  int64 *pairs;                /**< Pairs of identifiers */
+  int count;                   /**< Number of pairs */
+  int maxcount;                /**< Capacity of the array of pairs */
+} RTreeJoin;
+
+/**
+ * Join two subtrees by descending synchronously into the pairs of entries
+ * whose rectangles overlap. When the subtrees have different heights only
+ * the highest one is descended.
+ */
+static void
+rtree_join_rec(RTreeJoin *join, int32 nodeno1, int32 nodeno2)
+{
+  const RTree *rtree1 = join->rtree1, *rtree2 = join->rtree2;
+  const RTreeNode *node1 = &rtree1->nodes[nodeno1];
+  const RTreeNode *node2 = &rtree2->nodes[nodeno2];
+  if (node1->level != node2->level)
+  {
+    bool first = node1->level > node2->level;
+    const RTreeNode *node = first ? node1 : node2;
+    RTreeRect rect;
+    if (first)
+      rtree_node_rect(rtree2, nodeno2, &rect);
+    else
+      rtree_node_rect(rtree1, nodeno1, &rect);
+    for (int i = 0; i < node->count; i++)
+    {
+      if (! rtree_rect_overlaps(&join->common, &node->rects[i], &rect))
+        continue;
+      if (first)
+        rtree_join_rec(join, (int32) node->ptrs[i], nodeno2);
+      else
+        rtree_join_rec(join, nodeno1, (int32) node->ptrs[i]);
+    }
+    return;
+  }
+  for (int i = 0; i < node1->count; i++)
+  {
+    for (int j = 0; j < node2->count; j++)
+    {
+      if (! rtree_rect_overlaps(&join->common, &node1->rects[i],
+          &node2->rects[j]))
+        continue;
+      if (node1->level > 0)
+      {
+        rtree_join_rec(join, (int32) node1->ptrs[i], (int32) node2->ptrs[j]);
+        continue;
+      }
+      if (! rtree_box_overlaps(rtree1->boxtype,
+          RTREE_BOX_N(rtree1, node1->ptrs[i]),
+          RTREE_BOX_N(rtree2, node2->ptrs[j])))
+        continue;
+      if (join->count + 2 > join->maxcount)
+      {
+        join->maxcount *= 2;
+        join->pairs = repalloc(join->pairs, sizeof(int64) * join->maxcount);
+      }
+      join->pairs[join->count++] = rtree1->ids[node1->ptrs[i]];
+      join->pairs[join->count++] = rtree2->ids[node2->ptrs[j]];
+    }
+  }
+  return;
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Return the pairs of identifiers of the boxes of two R-trees that
+ * overlap.
+ *
+ * As for the box operators, the boxes are compared on their common
+ * dimensions and an error is raised when the boxes of the two trees do not
+ * have a common dimension. There is no such error if one of the trees has
+ * never been given a box.
+ *
+ * @param[in] rtree1,rtree2 Trees indexing boxes of the same type
+ * @param[out] count Number of pairs
+ * @return Array of 2 * count identifiers, the identifiers of the first tree
+ * are at the even positions
+ */
+int64 *
+rtree_join(const RTree *rtree1, const RTree *rtree2, int *count)
+{
+  ensure_rtree_boxtype(rtree2, rtree1->boxtype);
+  if (rtree1->hasflags && rtree2->hasflags)
+    ensure_common_dimension(rtree1->flags, rtree2->flags);
+  RTreeJoin join;
+  join.rtree1 = rtree1;
+  join.rtree2 = rtree2;
+  join.common.ndims = 0;
+  for (int i = 0; i < rtree1->ndims; i++)
+  {
+    for (int j = 0; j < rtree2->ndims; j++)
+    {
+      if (rtree1->dims[i] == rtree2->dims[j])
+        join.common.dims[join.common.ndims++] = rtree1->dims[i];
+    }
+  }
+  join.maxcount = 128;
+  join.count = 0;
+  join.pairs = palloc(sizeof(int64) * join.maxcount);
+  if (rtree1->count > 0 && rtree2->count > 0)
+    rtree_join_rec(&join, rtree1->root, rtree2->root);
+  *count = join.count / 2;
+  return join.pairs;
+}
+
+/*****************************************************************************
+ * Persistence
+ *****************************************************************************/
+
+/**
+ * Header of the file storing a tree, followed by the arrays of nodes, boxes,
+ * and identifiers
+ */
+typedef struct
+{
+  char magic[8];               /**< RTREE_MAGIC */
+  int32 version;               /**< RTREE_VERSION */
+  int32 boxtype;               /**< Type of the boxes */
+  int32 flags;                 /**< Flags of the boxes */
+  int32 srid;                  /**< SRID of the boxes */
+  int32 hasflags;              /**< True when the flags are known */
+  int32 ndims;                 /**< Number of dimensions used */
+  int32 dims[RTREE_MAXDIMS];   /**< Dimensions used */
+  int32 root;                  /**< Number of the root node */
+  int32 nnodes;                /**< Number of nodes */
+  int32 freenode;              /**< First node of the free list */
+  int32 padding;
+  int64 count;                 /**< Number of indexed boxes */
+  int64 nslots;                /**< Number of slots */
+  int64 freeslot;              /**< First slot of the free list */
+} RTreeFileHeader;
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Write an R-tree to a file that can be memory-mapped with
+ * rtree_open().
+ * @return True on success
+ */
+bool
+rtree_save(const RTree *rtree, const char *filename)
+{
+  RTreeFileHeader header;
+  memset(&header, 0, sizeof(RTreeFileHeader));
+  memcpy(header.magic, RTREE_MAGIC, sizeof(header.magic));
+  header.version = RTREE_VERSION;
+  header.boxtype = rtree->boxtype;
+  header.flags = rtree->flags;
+  header.srid = rtree->srid;
+  header.hasflags = rtree->hasflags;
+  header.ndims = rtree->ndims;
+  memcpy(header.dims, rtree->dims, sizeof(header.dims));
+  header.root = rtree->root;
+  header.nnodes = rtree->nnodes;
+  header.freenode = rtree->freenode;
+  header.count = rtree->count;
+  header.nslots = rtree->nslots;
+  header.freeslot = rtree->freeslot;
+
+  FILE *file = fopen(filename, "wb");
+  if (! file)
+    return false;
+  bool result =
+    fwrite(&header, sizeof(RTreeFileHeader), 1, file) == 1 &&
+    fwrite(rtree->nodes, sizeof(RTreeNode), (size_t) rtree->nnodes, file) ==
+      (size_t) rtree->nnodes &&
+    fwrite(rtree->boxes, RTREE_BOXSIZE(rtree), (size_t) rtree->nslots,
+      file) == (size_t) rtree->nslots &&
+    fwrite(rtree->ids, sizeof(int64), (size_t) rtree->nslots, file) ==
+      (size_t) rtree->nslots;
+  if (fclose(file) != 0)
+    result = false;
+  return result;
+}
+
+/**
+ * @ingroup libmeos_box_index
+ * @brief Memory-map an R-tree written with rtree_save(). The resulting tree
+ * can be queried but not modified, and must be released with rtree_free().
+ * @return NULL if the file cannot be mapped or is not a valid R-tree file
+ */
+RTree *
+rtree_open(const char *filename)
+{
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(RTreeFileHeader))
+  {
+    close(fd);
+    return NULL;
+  }
+  size_t mapsize = (size_t) st.st_size;
+  void *mapping = mmap(NULL, mapsize, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    return NULL;
+
+  const RTreeFileHeader *header = (const RTreeFileHeader *) mapping;
+  size_t boxsize = header->boxtype == T_STBOX ? sizeof(STBOX) : sizeof(TBOX);
+  if (memcmp(header->magic, RTREE_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != RTREE_VERSION ||
+      (header->boxtype != T_STBOX && header->boxtype != T_TBOX) ||
+      mapsize != sizeof(RTreeFileHeader) +
+        sizeof(RTreeNode) * (size_t) header->nnodes +
+        (boxsize + sizeof(int64)) * (size_t) header->nslots)
+  {
+    munmap(mapping, mapsize);
+    return NULL;
+  }
+
+  RTree *result = palloc0(sizeof(RTree));
+  result->boxtype = (mobdbType) header->boxtype;
+  result->flags = (int16) header->flags;
+  result->srid = header->srid;
+  result->hasflags = header->hasflags;
+  result->ndims = header->ndims;
+  memcpy(result->dims, header->dims, sizeof(result->dims));
+  result->root = header->root;
+  result->count = header->count;
+  result->nnodes = result->maxnodes = header->nnodes;
+  result->freenode = header->freenode;
+  result->nslots = result->maxslots = header->nslots;
+  result->freeslot = header->freeslot;
+  char *data = (char *) mapping + sizeof(RTreeFileHeader);
+  result->nodes = (RTreeNode *) data;
+  data += sizeof(RTreeNode) * (size_t) header->nnodes;
+  result->boxes = data;
+  data += boxsize * (size_t) header->nslots;
+  result->ids = (int64 *) data;
+  result->mapping = mapping;
+  result->mapsize = mapsize;
+  return result;
+}
+
+#endif /* MEOS */
+
+/*****************************************************************************/
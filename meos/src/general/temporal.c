@@ -3669,9 +3669,11 @@ temporal_cmp(const Temporal *temp1, const Temporal *temp2)
     return 1;
 
   /* Compare flags */
-  if (temp1->flags < temp2->flags)
+  int16 flags1 = MOBDB_FLAGS_GET_VALUE(temp1->flags);
+  int16 flags2 = MOBDB_FLAGS_GET_VALUE(temp2->flags);
+  if (flags1 < flags2)
     return -1;
-  if (temp1->flags > temp2->flags)
+  if (flags1 > flags2)
     return 1;
 
   /* Finally compare temporal type */
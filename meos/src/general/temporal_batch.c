@@ -0,0 +1,564 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Batch functions applying a MEOS function to arrays of temporal
+ * values using a pool of threads.
+ *
+ * The elements of a batch are split into one contiguous range per thread.
+ * A thread that exhausts its range steals the upper half of the remaining
+ * range of another thread, so that batches of values with very different
+ * sizes are balanced across the threads. The calling thread takes part in
+ * the computation. Nested batches, e.g., a batch function called from within
+ * a batch, are executed serially by the calling thread.
+ *
+ * The results of a batch are allocated with the allocator of the calling
+ * thread, but never from its current arena, since the latter is not shared
+ * with the worker threads.
+ *
+ * The functions applied to the elements of a batch run concurrently and thus
+ * must only use state that is local to the thread or read-only. This is the
+ * case of the functions of MEOS on temporal values and of the functions of
+ * liblwgeom that construct geometries and compute distances, which are those
+ * called by the batch functions below. It is not the case of GEOS, which is
+ * initialized with a global context on every call, of PROJ, and of the
+ * output of timestamps, which uses static buffers. The entry points of MEOS
+ * to GEOS raise an error when called from a batch, see ensure_not_in_batch().
+ * As everywhere in MEOS, an error raised by any thread terminates the
+ * process.
+ */
+
+#include "general/temporal_batch.h"
+
+#if MEOS
+
+/* C */
+#include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+/* MobilityDB */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/temporal_similarity.h"
+
+/*****************************************************************************
+ * Thread pool
+ *****************************************************************************/
+
+/** Maximum number of threads used by the batch functions */
+#define BATCH_MAX_THREADS 256
+
+/**
+ * Range of elements of a batch owned by a thread
+ */
+typedef struct
+{
+  pthread_mutex_t lock;        /**< Lock protecting the range */
+  int next;                    /**< Next element to process */
+  int end;                     /**< End of the range (exclusive) */
+} BatchRange;
+
+/**
+ * Batch being executed by the pool
+ */
+typedef struct
+{
+  batch_item_fn func;          /**< Function processing an element */
+  void *state;                 /**< State passed to the function */
+  int nworkers;                /**< Number of threads taking part */
+  BatchRange *ranges;          /**< Range of each thread */
+  meos_malloc_fn malloc_fn;    /**< Allocator of the calling thread */
+  meos_realloc_fn realloc_fn;
+  meos_free_fn free_fn;
+} BatchJob;
+
+/* Number of threads requested, 0 when not yet determined */
+static int batch_nthreads = 0;
+/* Worker threads, the calling thread is not included */
+static pthread_t *pool_threads = NULL;
+static int pool_size = 0;
+/* Synchronization between the calling thread and the workers */
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_work_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done_cond = PTHREAD_COND_INITIALIZER;
+static BatchJob *pool_job = NULL;
+static uint64 pool_generation = 0;
+static uint64 pool_start_generation = 0;
+static int pool_active = 0;
+static bool pool_shutdown = false;
+/* Only one batch is executed by the pool at a time */
+static pthread_mutex_t batch_lock = PTHREAD_MUTEX_INITIALIZER;
+/* True for the threads currently executing a batch */
+static _Thread_local bool in_batch = false;
+
+/**
+ * Pop the next element of the range of a thread, return -1 if empty
+ */
+static int
+batch_range_pop(BatchRange *range)
+{
+  int result = -1;
+  pthread_mutex_lock(&range->lock);
+  if (range->next < range->end)
+    result = range->next++;
+  pthread_mutex_unlock(&range->lock);
+  return result;
+}
+
+/**
+ * Steal the upper half of the remaining range of another thread.
+ * Return false when all the other ranges are empty.
+ */
+static bool
+batch_steal(BatchJob *job, int id)
+{
+  for (int k = 1; k < job->nworkers; k++)
+  {
+    BatchRange *victim = &job->ranges[(id + k) % job->nworkers];
+    pthread_mutex_lock(&victim->lock);
+    int remaining = victim->end - victim->next;
+    if (remaining <= 0)
+    {
+      pthread_mutex_unlock(&victim->lock);
+      continue;
+    }
+    int end = victim->end;
+    victim->end -= (remaining + 1) / 2;
+    int start = victim->end;
+    pthread_mutex_unlock(&victim->lock);
+
+    BatchRange *own = &job->ranges[id];
+    pthread_mutex_lock(&own->lock);
+    own->next = start;
+    own->end = end;
+    pthread_mutex_unlock(&own->lock);
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Process elements of a batch until all the ranges are empty
+ */
+static void
+batch_work(BatchJob *job, int id)
+{
+  in_batch = true;
+  meos_set_thread_allocator(job->malloc_fn, job->realloc_fn, job->free_fn);
+  for (;;)
+  {
+    int i = batch_range_pop(&job->ranges[id]);
+    if (i >= 0)
+      job->func(job->state, i);
+    else if (! batch_steal(job, id))
+      break;
+  }
+  in_batch = false;
+  return;
+}
+
+/**
+ * Main loop of a worker thread
+ */
+static void *
+batch_worker(void *arg)
+{
+  int id = (int) (intptr_t) arg;
+  pthread_mutex_lock(&pool_lock);
+  /* A batch may have been published before the thread started */
+  uint64 seen = pool_start_generation;
+  for (;;)
+  {
+    while (! pool_shutdown && pool_generation == seen)
+      pthread_cond_wait(&pool_work_cond, &pool_lock);
+    if (pool_shutdown)
+      break;
+    seen = pool_generation;
+    BatchJob *job = pool_job;
+    pthread_mutex_unlock(&pool_lock);
+    if (id < job->nworkers)
+    {
+      batch_work(job, id);
+      meos_set_thread_allocator(NULL, NULL, NULL);
+    }
+    pthread_mutex_lock(&pool_lock);
+    if (--pool_active == 0)
+      pthread_cond_signal(&pool_done_cond);
+  }
+  pthread_mutex_unlock(&pool_lock);
+  return NULL;
+}
+
+/**
+ * Stop and join the worker threads, including those of a pool that could
+ * only be partially started. Must be called holding batch_lock.
+ */
+static void
+batch_pool_stop(void)
+{
+  if (pool_size > 0)
+  {
+    pthread_mutex_lock(&pool_lock);
+    pool_shutdown = true;
+    pthread_cond_broadcast(&pool_work_cond);
+    pthread_mutex_unlock(&pool_lock);
+    for (int i = 0; i < pool_size; i++)
+      pthread_join(pool_threads[i], NULL);
+  }
+  free(pool_threads);
+  pool_threads = NULL;
+  pool_size = 0;
+  pool_shutdown = false;
+  return;
+}
+
+/**
+ * Return the number of online processors
+ */
+static int
+batch_num_cpus(void)
+{
+  long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+  if (ncpus < 1)
+    return 1;
+  return ncpus > BATCH_MAX_THREADS ? BATCH_MAX_THREADS : (int) ncpus;
+}
+
+/**
+ * Start the worker threads if needed. Must be called holding batch_lock.
+ */
+static void
+batch_pool_start(void)
+{
+  if (batch_nthreads == 0)
+    batch_nthreads = batch_num_cpus();
+  if (pool_size == batch_nthreads - 1)
+    return;
+  batch_pool_stop();
+  pthread_mutex_lock(&pool_lock);
+  pool_start_generation = pool_generation;
+  pthread_mutex_unlock(&pool_lock);
+  pool_threads = malloc(sizeof(pthread_t) * (batch_nthreads - 1));
+  if (! pool_threads)
+    elog(ERROR, "out of memory");
+  for (int i = 0; i < batch_nthreads - 1; i++)
+  {
+    if (pthread_create(&pool_threads[i], NULL, batch_worker,
+        (void *) (intptr_t) (i + 1)) != 0)
+    {
+      /* Join the threads already created and execute the batches in the
+       * calling thread until the number of threads is set again */
+      batch_pool_stop();
+      batch_nthreads = 1;
+      elog(WARNING, "Cannot create the threads of the batch functions, "
+        "the batches are executed by the calling thread");
+      return;
+    }
+    pool_size++;
+  }
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_batch
+ * @brief Set the number of threads used by the batch functions, including
+ * the calling thread. A value less than 1 sets the number of online
+ * processors. Reducing the number of threads stops the worker threads, which
+ * are restarted by the next batch.
+ */
+void
+meos_set_num_threads(int n)
+{
+  if (n < 1)
+    n = batch_num_cpus();
+  else if (n > BATCH_MAX_THREADS)
+    n = BATCH_MAX_THREADS;
+  pthread_mutex_lock(&batch_lock);
+  batch_nthreads = n;
+  if (pool_size > n - 1)
+    batch_pool_stop();
+  pthread_mutex_unlock(&batch_lock);
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_batch
+ * @brief Return the number of threads used by the batch functions.
+ */
+int
+meos_num_threads(void)
+{
+  pthread_mutex_lock(&batch_lock);
+  if (batch_nthreads == 0)
+    batch_nthreads = batch_num_cpus();
+  int result = batch_nthreads;
+  pthread_mutex_unlock(&batch_lock);
+  return result;
+}
+
+/**
+ * Raise an error if the calling thread is executing a batch. Must be called
+ * by the functions whose state is not thread-safe, such as those calling
+ * GEOS.
+ */
+void
+ensure_not_in_batch(void)
+{
+  if (in_batch)
+    elog(ERROR, "The function is not thread-safe and cannot be executed by the batch functions");
+  return;
+}
+
+/**
+ * Apply a function to the elements 0 .. count - 1 of a batch using the
+ * thread pool.
+ *
+ * @note The function is executed concurrently by several threads, see the
+ * restrictions at the beginning of this file.
+ *
+ * @param[in] func Function processing an element
+ * @param[in] state State passed to the function, typically the input and
+ * output arrays of the batch
+ * @param[in] count Number of elements
+ */
+void
+meos_batch_run(batch_item_fn func, void *state, int count)
+{
+  if (count <= 0)
+    return;
+  if (in_batch || count == 1 || meos_num_threads() == 1)
+  {
+    for (int i = 0; i < count; i++)
+      func(state, i);
+    return;
+  }
+
+  pthread_mutex_lock(&batch_lock);
+  batch_pool_start();
+  /* The results must not be allocated in the arena of the calling thread */
+  MeosArena arena = meos_arena_begin(NULL);
+  BatchJob job;
+  job.func = func;
+  job.state = state;
+  job.nworkers = Min(pool_size + 1, count);
+  job.ranges = palloc(sizeof(BatchRange) * job.nworkers);
+  meos_get_thread_allocator(&job.malloc_fn, &job.realloc_fn, &job.free_fn);
+  for (int i = 0; i < job.nworkers; i++)
+  {
+    pthread_mutex_init(&job.ranges[i].lock, NULL);
+    job.ranges[i].next = (int) (((int64) count * i) / job.nworkers);
+    job.ranges[i].end = (int) (((int64) count * (i + 1)) / job.nworkers);
+  }
+
+  pthread_mutex_lock(&pool_lock);
+  pool_job = &job;
+  pool_active = pool_size;
+  pool_generation++;
+  pthread_cond_broadcast(&pool_work_cond);
+  pthread_mutex_unlock(&pool_lock);
+
+  batch_work(&job, 0);
+
+  pthread_mutex_lock(&pool_lock);
+  while (pool_active > 0)
+    pthread_cond_wait(&pool_done_cond, &pool_lock);
+  pool_job = NULL;
+  pthread_mutex_unlock(&pool_lock);
+
+  for (int i = 0; i < job.nworkers; i++)
+    pthread_mutex_destroy(&job.ranges[i].lock);
+  pfree(job.ranges);
+  meos_arena_end(arena);
+  pthread_mutex_unlock(&batch_lock);
+  return;
+}
+
+/*****************************************************************************
+ * Batch functions for temporal types
+ *****************************************************************************/
+
+/**
+ * State of the batch functions with one temporal argument and a temporal
+ * result
+ */
+typedef struct
+{
+  const Temporal **temps;      /**< Input values */
+  Temporal **result;           /**< Result values */
+  double eps_dist;             /**< Tolerance of the simplification */
+  bool synchronized;           /**< Synchronized simplification */
+} TemporalSimplifyBatch;
+
+static void
+temporal_simplify_item(void *state, int i)
+{
+  TemporalSimplifyBatch *b = (TemporalSimplifyBatch *) state;
+  b->result[i] = b->temps[i] ?
+    temporal_simplify(b->temps[i], b->eps_dist, b->synchronized) : NULL;
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_batch
+ * @brief Simplify an array of temporal floats/points using a spatio-temporal
+ * extension of the Douglas-Peucker line simplification algorithm.
+ *
+ * @param[in] temps Array of temporal values, NULL elements give NULL results
+ * @param[in] count Number of elements of the array
+ * @param[in] eps_dist Epsilon distance
+ * @param[in] synchronized True when the synchronized distance is used
+ * @sqlfunc simplify()
+ */
+Temporal **
+temporal_simplify_batch(const Temporal **temps, int count, double eps_dist,
+  bool synchronized)
+{
+  TemporalSimplifyBatch state;
+  state.temps = temps;
+  state.result = palloc(sizeof(Temporal *) * count);
+  state.eps_dist = eps_dist;
+  state.synchronized = synchronized;
+  meos_batch_run(&temporal_simplify_item, &state, count);
+  return state.result;
+}
+
+/**
+ * State of the batch function for the WKB output
+ */
+typedef struct
+{
+  const Temporal **temps;      /**< Input values */
+  uint8_t **result;            /**< Result WKB buffers */
+  uint8_t variant;             /**< WKB variant */
+  size_t *sizes;               /**< Sizes of the WKB buffers */
+} TemporalWKBBatch;
+
+static void
+temporal_as_wkb_item(void *state, int i)
+{
+  TemporalWKBBatch *b = (TemporalWKBBatch *) state;
+  size_t size = 0;
+  b->result[i] = b->temps[i] ?
+    temporal_as_wkb(b->temps[i], b->variant, &size) : NULL;
+  if (b->sizes)
+    b->sizes[i] = size;
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_batch
+ * @brief Return the WKB representation of an array of temporal values.
+ *
+ * @param[in] temps Array of temporal values, NULL elements give NULL results
+ * @param[in] count Number of elements of the array
+ * @param[in] variant WKB variant
+ * @param[out] sizes If not NULL, sizes of the WKB buffers
+ * @sqlfunc asBinary()
+ */
+uint8_t **
+temporal_as_wkb_batch(const Temporal **temps, int count, uint8_t variant,
+  size_t *sizes)
+{
+  TemporalWKBBatch state;
+  state.temps = temps;
+  state.result = palloc(sizeof(uint8_t *) * count);
+  state.variant = variant;
+  state.sizes = sizes;
+  meos_batch_run(&temporal_as_wkb_item, &state, count);
+  return state.result;
+}
+
+/**
+ * State of the batch functions computing a similarity distance
+ */
+typedef struct
+{
+  const Temporal **temps1;     /**< First input values */
+  const Temporal **temps2;     /**< Second input values */
+  double *result;              /**< Result distances */
+  SimFunc simfunc;             /**< Similarity function */
+} TemporalSimilarityBatch;
+
+static void
+temporal_similarity_item(void *state, int i)
+{
+  TemporalSimilarityBatch *b = (TemporalSimilarityBatch *) state;
+  b->result[i] = (! b->temps1[i] || ! b->temps2[i]) ? -1.0 :
+    temporal_similarity(b->temps1[i], b->temps2[i], b->simfunc);
+  return;
+}
+
+/**
+ * Compute the similarity distance of the pairs of temporal values of two
+ * arrays
+ */
+static double *
+temporal_similarity_batch(const Temporal **temps1, const Temporal **temps2,
+  int count, SimFunc simfunc)
+{
+  TemporalSimilarityBatch state;
+  state.temps1 = temps1;
+  state.temps2 = temps2;
+  state.result = palloc(sizeof(double) * count);
+  state.simfunc = simfunc;
+  meos_batch_run(&temporal_similarity_item, &state, count);
+  return state.result;
+}
+
+/**
+ * @ingroup libmeos_temporal_batch
+ * @brief Compute the discrete Frechet distance of the pairs of temporal
+ * values of two arrays of the same size. The result for a pair with a NULL
+ * element is -1.
+ * @sqlfunc frechetDistance()
+ */
+double *
+temporal_frechet_distance_batch(const Temporal **temps1,
+  const Temporal **temps2, int count)
+{
+  return temporal_similarity_batch(temps1, temps2, count, FRECHET);
+}
+
+/**
+ * @ingroup libmeos_temporal_batch
+ * @brief Compute the Dynamic Time Warping distance of the pairs of temporal
+ * values of two arrays of the same size. The result for a pair with a NULL
+ * element is -1.
+ * @sqlfunc dynTimeWarpDistance()
+ */
+double *
+temporal_dyntimewarp_distance_batch(const Temporal **temps1,
+  const Temporal **temps2, int count)
+{
+  return temporal_similarity_batch(temps1, temps2, count, DYNTIMEWARP);
+}
+
+#endif /* MEOS */
+
+/*****************************************************************************/
@@ -0,0 +1,364 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Compressed representation of temporal booleans and temporal texts.
+ *
+ * Temporal booleans and temporal texts have step interpolation and their
+ * values typically change much less often than they are sampled, e.g., a
+ * status channel taking the values "IDLE" and "MOVING". A compressed
+ * sequence stores
+ * - the timestamps of the instants as a compressed timestamp set, which is
+ *   run-length encoded when the instants are regularly spaced,
+ * - the values of a temporal boolean as a bitset with one bit per instant,
+ * - the values of a temporal text as codes of one or two bytes into a
+ *   dictionary of the distinct values, each of them stored once.
+ *
+ * The instants are materialized on demand with ctsequence_inst_n, which
+ * follows the conventions of tsequence_inst_n, and the sequence is restored
+ * with tsequence_decompress.
+ */
+
+#include "general/temporal_compress.h"
+
+/* C */
+#include <assert.h>
+/* MobilityDB */
+#include <meos_internal.h>
+#include "general/temporal_util.h"
+#include "general/time_compress.h"
+
+/** Return a pointer to the variable-length data of a compressed sequence */
+#define CTSEQUENCE_DATA(cts) \
+  ((uint8 *) (cts) + double_pad(sizeof(CTSequence)))
+
+/*****************************************************************************
+ * Layout
+ *****************************************************************************/
+
+/**
+ * Ensure that a temporal sequence can be compressed
+ */
+static void
+ensure_compressible_tsequence(const TSequence *seq)
+{
+  if (seq->temptype != T_TBOOL && seq->temptype != T_TTEXT)
+    elog(ERROR, "Only temporal booleans and temporal texts can be compressed");
+  return;
+}
+
+/**
+ * Return the compressed timestamp set of a compressed sequence
+ */
+const CTimeSet *
+ctsequence_times(const CTSequence *cts)
+{
+  return (const CTimeSet *) CTSEQUENCE_DATA(cts);
+}
+
+/**
+ * Return the bitset or the codes of the values of a compressed sequence
+ */
+static const uint8 *
+ctsequence_codes(const CTSequence *cts)
+{
+  const CTimeSet *times = ctsequence_times(cts);
+  return (const uint8 *) times + double_pad(VARSIZE(times));
+}
+
+/**
+ * Return the offsets of the values of the dictionary of a compressed
+ * temporal text
+ */
+static const uint32 *
+ctsequence_offsets(const CTSequence *cts)
+{
+  return (const uint32 *) (ctsequence_codes(cts) +
+    double_pad((size_t) cts->codesize * cts->count));
+}
+
+/**
+ * Return the values of the dictionary of a compressed temporal text
+ */
+static const uint8 *
+ctsequence_dict(const CTSequence *cts)
+{
+  return (const uint8 *) ctsequence_offsets(cts) +
+    double_pad(sizeof(uint32) * cts->ndict);
+}
+
+/**
+ * Return the n-th value of a compressed sequence
+ *
+ * @note The value of a temporal text points to the dictionary and is not
+ * copied
+ */
+Datum
+ctsequence_value_n(const CTSequence *cts, int n)
+{
+  const uint8 *codes = ctsequence_codes(cts);
+  if (cts->temptype == T_TBOOL)
+    return BoolGetDatum((codes[n / 8] & (1 << (n % 8))) != 0);
+  uint32 code = (cts->codesize == 1) ? codes[n] :
+    ((const uint16 *) codes)[n];
+  return PointerGetDatum(ctsequence_dict(cts) +
+    ctsequence_offsets(cts)[code]);
+}
+
+/*****************************************************************************
+ * Compression
+ *****************************************************************************/
+
+/**
+ * Value of a temporal text and the instant at which it occurs
+ */
+typedef struct
+{
+  text *value;
+  int pos;
+} CTSequenceEntry;
+
+/**
+ * Comparator of the values of a temporal text
+ */
+static int
+ctsequence_entry_cmp(const CTSequenceEntry *e1, const CTSequenceEntry *e2)
+{
+  int result = text_cmp(e1->value, e2->value, DEFAULT_COLLATION_OID);
+  if (result != 0)
+    return result;
+  return (e1->pos < e2->pos) ? -1 : ((e1->pos > e2->pos) ? 1 : 0);
+}
+
+/**
+ * Return the codes of the values of a temporal text sequence and set in
+ * the last arguments the first instant of each distinct value, in the order
+ * of the codes, and the number of distinct values
+ */
+static uint32 *
+tsequence_dict_codes(const TSequence *seq, int *firsts, int *ndict)
+{
+  CTSequenceEntry *entries = palloc(sizeof(CTSequenceEntry) * seq->count);
+  for (int i = 0; i < seq->count; i++)
+  {
+    entries[i].value = DatumGetTextP(tinstant_value(tsequence_inst_n(seq, i)));
+    entries[i].pos = i;
+  }
+  qsort(entries, (size_t) seq->count, sizeof(CTSequenceEntry),
+    (qsort_comparator) &ctsequence_entry_cmp);
+  uint32 *result = palloc(sizeof(uint32) * seq->count);
+  int k = 0;
+  for (int i = 0; i < seq->count; i++)
+  {
+    if (i == 0 || text_cmp(entries[i - 1].value, entries[i].value,
+        DEFAULT_COLLATION_OID) != 0)
+      firsts[k++] = entries[i].pos;
+    result[entries[i].pos] = (uint32) (k - 1);
+  }
+  pfree(entries);
+  *ndict = k;
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_constructor
+ * @brief Return the compressed representation of a temporal boolean or a
+ * temporal text sequence.
+ */
+CTSequence *
+tsequence_compress(const TSequence *seq)
+{
+  ensure_compressible_tsequence(seq);
+  int count = seq->count;
+
+  /* Compress the timestamps */
+  TimestampTz *times = tsequence_timestamps(seq, &count);
+  TimestampSet *ts = timestampset_make(times, count);
+  CTimeSet *ctimes = timestampset_compress(ts);
+  pfree(times); pfree(ts);
+
+  /* Encode the values */
+  uint32 *codes = NULL;
+  int *firsts = NULL;
+  int ndict = 0;
+  uint8 codesize = 0;
+  size_t codessize, dictsize = 0;
+  if (seq->temptype == T_TBOOL)
+    codessize = double_pad((size_t) (count + 7) / 8);
+  else
+  {
+    firsts = palloc(sizeof(int) * count);
+    codes = tsequence_dict_codes(seq, firsts, &ndict);
+    if (ndict > CTSEQUENCE_MAX_DICT)
+      elog(ERROR, "Too many distinct values to compress the temporal text: %d",
+        ndict);
+    codesize = (ndict <= 256) ? 1 : 2;
+    codessize = double_pad((size_t) codesize * count);
+    dictsize = double_pad(sizeof(uint32) * ndict);
+    for (int i = 0; i < ndict; i++)
+      dictsize += double_pad(VARSIZE(DatumGetPointer(tinstant_value(
+        tsequence_inst_n(seq, firsts[i])))));
+  }
+
+  size_t memsize = double_pad(sizeof(CTSequence)) +
+    double_pad(VARSIZE(ctimes)) + codessize + dictsize;
+  CTSequence *result = palloc0(memsize);
+  SET_VARSIZE(result, memsize);
+  result->temptype = seq->temptype;
+  result->codesize = codesize;
+  result->count = count;
+  result->ndict = ndict;
+  memcpy(&result->period, &seq->period, sizeof(Period));
+  memcpy(CTSEQUENCE_DATA(result), ctimes, VARSIZE(ctimes));
+  pfree(ctimes);
+
+  uint8 *values = (uint8 *) ctsequence_codes(result);
+  if (seq->temptype == T_TBOOL)
+  {
+    for (int i = 0; i < count; i++)
+    {
+      if (DatumGetBool(tinstant_value(tsequence_inst_n(seq, i))))
+        values[i / 8] |= (uint8) (1 << (i % 8));
+    }
+    return result;
+  }
+
+  for (int i = 0; i < count; i++)
+  {
+    if (codesize == 1)
+      values[i] = (uint8) codes[i];
+    else
+      ((uint16 *) values)[i] = (uint16) codes[i];
+  }
+  uint32 *offsets = (uint32 *) ctsequence_offsets(result);
+  uint8 *dict = (uint8 *) ctsequence_dict(result);
+  size_t offset = 0;
+  for (int i = 0; i < ndict; i++)
+  {
+    const text *txt = DatumGetTextP(tinstant_value(
+      tsequence_inst_n(seq, firsts[i])));
+    offsets[i] = (uint32) offset;
+    memcpy(dict + offset, txt, VARSIZE(txt));
+    offset += double_pad(VARSIZE(txt));
+  }
+  pfree(codes); pfree(firsts);
+  return result;
+}
+
+/*****************************************************************************
+ * Decompression and accessor functions
+ *****************************************************************************/
+
+/**
+ * @ingroup libmeos_temporal_cast
+ * @brief Return the temporal sequence of a compressed sequence.
+ */
+TSequence *
+tsequence_decompress(const CTSequence *cts)
+{
+  TInstant **instants = palloc(sizeof(TInstant *) * cts->count);
+  CTimeSetIterator iter;
+  ctimeset_iterator_init(&iter, ctsequence_times(cts));
+  TimestampTz t;
+  for (int i = 0; i < cts->count; i++)
+  {
+    ctimeset_iterator_next_timestamp(&iter, &t);
+    instants[i] = tinstant_make(ctsequence_value_n(cts, i), cts->temptype, t);
+  }
+  return tsequence_make_free(instants, cts->count, cts->period.lower_inc,
+    cts->period.upper_inc, STEP, NORMALIZE_NO);
+}
+
+/**
+ * @ingroup libmeos_temporal_accessor
+ * @brief Return the size in bytes of a compressed sequence.
+ */
+int
+ctsequence_mem_size(const CTSequence *cts)
+{
+  return (int) VARSIZE(DatumGetPointer(cts));
+}
+
+/**
+ * @ingroup libmeos_temporal_accessor
+ * @brief Return the number of instants of a compressed sequence.
+ */
+int
+ctsequence_num_instants(const CTSequence *cts)
+{
+  return cts->count;
+}
+
+/**
+ * @ingroup libmeos_temporal_accessor
+ * @brief Return a copy of the n-th instant of a compressed sequence.
+ * @note n is 0-based as in tsequence_inst_n. The instant is materialized
+ * and must be freed by the caller.
+ */
+TInstant *
+ctsequence_inst_n(const CTSequence *cts, int n)
+{
+  if (n < 0 || n >= cts->count)
+    return NULL;
+  TimestampTz t;
+  ctimeset_timestamp_n(ctsequence_times(cts), n + 1, &t);
+  return tinstant_make(ctsequence_value_n(cts, n), cts->temptype, t);
+}
+
+/**
+ * @ingroup libmeos_temporal_accessor
+ * @brief Return the value of a compressed sequence at a timestamp.
+ *
+ * @param[in] cts Compressed sequence
+ * @param[in] t Timestamp
+ * @param[out] result Value, a copy for temporal texts
+ * @result Return false if the sequence is not defined at the timestamp
+ */
+bool
+ctsequence_value_at_timestamp(const CTSequence *cts, TimestampTz t,
+  Datum *result)
+{
+  if (! contains_period_timestamp(&cts->period, t))
+    return false;
+
+  /* Position the iterator at the first instant at or after t */
+  CTimeSetIterator iter;
+  ctimeset_iterator_init(&iter, ctsequence_times(cts));
+  ctimeset_iterator_seek(&iter, t);
+  int n = iter.i;
+  TimestampTz t1;
+  if (! ctimeset_iterator_next_timestamp(&iter, &t1) || t1 > t)
+    n--;
+  assert(n >= 0);
+  *result = datum_copy(ctsequence_value_n(cts, n),
+    temptype_basetype(cts->temptype));
+  return true;
+}
+
+/*****************************************************************************/
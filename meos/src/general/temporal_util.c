@@ -127,6 +127,38 @@ datum_ge(Datum l, Datum r, mobdbType type)
 
 /*****************************************************************************/
 
+/*
+ * Type-specialized comparison kernels for the span base types. They are
+ * generated once per type so that callers comparing many values of the same
+ * type, e.g., sorting functions, select the kernel once instead of
+ * dispatching on the base type for every comparison.
+ */
+
+#define DATUM_CMP_KERNEL(name, ctype, getter) \
+static inline int \
+name(Datum l, Datum r) \
+{ \
+  ctype x = getter(l); \
+  ctype y = getter(r); \
+  return (x < y) ? -1 : ((x > y) ? 1 : 0); \
+}
+
+DATUM_CMP_KERNEL(datum_cmp_int4, int32, DatumGetInt32)
+DATUM_CMP_KERNEL(datum_cmp_timestamptz, TimestampTz, DatumGetTimestampTz)
+
+#undef DATUM_CMP_KERNEL
+
+/**
+ * Comparison kernel for floats, which must take into account NaN values
+ */
+static inline int
+datum_cmp_float8(Datum l, Datum r)
+{
+  return float8_cmp_internal(DatumGetFloat8(l), DatumGetFloat8(r));
+}
+
+/*****************************************************************************/
+
 /*
  * Version of the functions where the types of both arguments may be different
  * but compatible, e.g., integer and float
@@ -138,15 +170,24 @@ datum_ge(Datum l, Datum r, mobdbType type)
 int
 datum_cmp2(Datum l, Datum r, mobdbType typel, mobdbType typer)
 {
+  /* Fast path for the usual case where both types are equal */
+  if (typel == typer)
+  {
+    switch (typel)
+    {
+      case T_TIMESTAMPTZ:
+        return datum_cmp_timestamptz(l, r);
+      case T_INT4:
+        return datum_cmp_int4(l, r);
+      case T_FLOAT8:
+        return datum_cmp_float8(l, r);
+      default:
+        break;
+    }
+  }
   ensure_span_basetype(typel);
   if (typel != typer)
     ensure_span_basetype(typer);
-  if (typel == T_TIMESTAMPTZ && typer == T_TIMESTAMPTZ)
-    return timestamptz_cmp_internal(DatumGetTimestampTz(l),
-      DatumGetTimestampTz(r));
-  if (typel == T_INT4 && typer == T_INT4)
-    return (DatumGetInt32(l) < DatumGetInt32(r)) ? -1 :
-      ((DatumGetInt32(l) > DatumGetInt32(r)) ? 1 : 0);
   if (typel == T_INT4 && typer == T_FLOAT8)
     return float8_cmp_internal((double) DatumGetInt32(l), DatumGetFloat8(r));
   if (typel == T_FLOAT8 && typer == T_INT4)
@@ -491,6 +532,69 @@ datum_sort_cmp(const Datum *l, const Datum *r, const mobdbType *type)
     return 1;
 }
 
+/*
+ * Comparator functions for datums and spans specialized for the span base
+ * types, which avoid dispatching on the base type for every comparison.
+ * Float datums are compared with the same tolerance as datum_eq and datum_lt
+ * while float spans are compared as in span_cmp.
+ */
+
+/**
+ * Comparison kernel for floats using the floating point tolerance
+ */
+static inline int
+datum_fpcmp_float8(Datum l, Datum r)
+{
+  double x = DatumGetFloat8(l);
+  double y = DatumGetFloat8(r);
+  if (MOBDB_FP_EQ(x, y))
+    return 0;
+  return MOBDB_FP_LT(x, y) ? -1 : 1;
+}
+
+#define DATUM_SORT_CMP(name, kernel) \
+static int \
+name(const Datum *l, const Datum *r) \
+{ \
+  return kernel(*l, *r); \
+}
+
+DATUM_SORT_CMP(datum_sort_cmp_int4, datum_cmp_int4)
+DATUM_SORT_CMP(datum_sort_cmp_float8, datum_fpcmp_float8)
+DATUM_SORT_CMP(datum_sort_cmp_timestamptz, datum_cmp_timestamptz)
+
+#undef DATUM_SORT_CMP
+
+/* The logic of these functions mirrors the one of span_cmp */
+#define SPAN_CMP_KERNEL(name, kernel) \
+static inline int \
+name(const Span *s1, const Span *s2) \
+{ \
+  int cmp = kernel(s1->lower, s2->lower); \
+  if (cmp != 0) \
+    return cmp; \
+  if (s1->lower_inc != s2->lower_inc) \
+    return s1->lower_inc ? -1 : 1; \
+  cmp = kernel(s1->upper, s2->upper); \
+  if (cmp != 0) \
+    return cmp; \
+  if (s1->upper_inc != s2->upper_inc) \
+    return s1->upper_inc ? 1 : -1; \
+  return 0; \
+} \
+\
+static int \
+name ## _sort(const Span **l, const Span **r) \
+{ \
+  return name(*l, *r); \
+}
+
+SPAN_CMP_KERNEL(span_cmp_int4, datum_cmp_int4)
+SPAN_CMP_KERNEL(span_cmp_float8, datum_cmp_float8)
+SPAN_CMP_KERNEL(span_cmp_timestamptz, datum_cmp_timestamptz)
+
+#undef SPAN_CMP_KERNEL
+
 /**
  * Comparator function for timestamps
  */
@@ -526,9 +630,7 @@ tinstarr_sort_cmp(const TInstant **l, const TInstant **r)
 static int
 tseqarr_sort_cmp(TSequence **l, TSequence **r)
 {
-  Period lp = (*l)->period;
-  Period rp = (*r)->period;
-  return span_cmp(&lp, &rp);
+  return span_cmp_timestamptz(&(*l)->period, &(*r)->period);
 }
 
 /*****************************************************************************/
@@ -539,8 +641,19 @@ tseqarr_sort_cmp(TSequence **l, TSequence **r)
 void
 datumarr_sort(Datum *values, int count, mobdbType type)
 {
-  qsort_arg(values, (size_t) count, sizeof(Datum),
-    (qsort_arg_comparator) &datum_sort_cmp, &type);
+  /* Select the comparator once for the whole array */
+  qsort_comparator cmp = NULL;
+  if (type == T_INT4)
+    cmp = (qsort_comparator) &datum_sort_cmp_int4;
+  else if (type == T_FLOAT8)
+    cmp = (qsort_comparator) &datum_sort_cmp_float8;
+  else if (type == T_TIMESTAMPTZ)
+    cmp = (qsort_comparator) &datum_sort_cmp_timestamptz;
+  if (cmp)
+    qsort(values, (size_t) count, sizeof(Datum), cmp);
+  else
+    qsort_arg(values, (size_t) count, sizeof(Datum),
+      (qsort_arg_comparator) &datum_sort_cmp, &type);
 }
 
 /**
@@ -579,8 +692,21 @@ double3arr_sort(double3 *triples, int count)
 void
 spanarr_sort(Span **spans, int count)
 {
-  qsort(spans, (size_t) count, sizeof(Span *),
-    (qsort_comparator) &span_sort_cmp);
+  if (count <= 1)
+    return;
+  /* Select the comparator once for the whole array, all spans in the array
+   * are assumed to have the same base type */
+  qsort_comparator cmp;
+  mobdbType basetype = spans[0]->basetype;
+  if (basetype == T_TIMESTAMPTZ)
+    cmp = (qsort_comparator) &span_cmp_timestamptz_sort;
+  else if (basetype == T_INT4)
+    cmp = (qsort_comparator) &span_cmp_int4_sort;
+  else if (basetype == T_FLOAT8)
+    cmp = (qsort_comparator) &span_cmp_float8_sort;
+  else
+    cmp = (qsort_comparator) &span_sort_cmp;
+  qsort(spans, (size_t) count, sizeof(Span *), cmp);
 }
 
 /**
@@ -0,0 +1,737 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Compressed representation of timestamp sets and period sets.
+ *
+ * The elements of a set are encoded relative to the previous one: a
+ * timestamp is encoded by its delta with respect to the previous timestamp
+ * and a period is encoded by the gap between its lower bound and the upper
+ * bound of the previous period, followed by its duration. The deltas, gaps,
+ * and durations are stored as variable-length unsigned integers. Two
+ * encodings are available:
+ * - CTIMESET_DELTA stores the encoded elements one after the other, keeps
+ *   the inclusive flags of the periods in a bitmap with two bits per
+ *   period, and samples the position of every CTIMESET_SAMPLE-th element so
+ *   that the decoding can start in the middle of the set.
+ * - CTIMESET_RLE stores runs of consecutive elements that have the same
+ *   delta, or the same gap, duration and flags, as it is the case for
+ *   periodic sets such as sampling schedules or availability calendars.
+ *   A run is decoded in constant time whatever its length.
+ *
+ * The compression chooses the run-length encoding when the set has at most
+ * one run per sample and the runs are not larger than the delta encoding,
+ * and the delta encoding otherwise. The bounding period
+ * of the set is not compressed so that the bounding box tests do not need
+ * to decode the elements. The elements are decoded lazily with an iterator.
+ */
+
+#include "general/time_compress.h"
+
+/* PostgreSQL */
+#include <postgres.h>
+/* MobilityDB */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/temporal_util.h"
+
+/** Return a pointer to the encoded data of a compressed time set */
+#define CTIMESET_DATA(cts) \
+  ((uint8 *) (cts) + double_pad(sizeof(CTimeSet)))
+
+/*****************************************************************************
+ * Variable-length integers
+ *****************************************************************************/
+
+/**
+ * Return the number of bytes of a variable-length unsigned integer
+ */
+static size_t
+varint_size(uint64 value)
+{
+  size_t result = 1;
+  while (value >= 0x80)
+  {
+    value >>= 7;
+    result++;
+  }
+  return result;
+}
+
+/**
+ * Write a variable-length unsigned integer and advance the pointer
+ */
+static void
+varint_write(uint8 **ptr, uint64 value)
+{
+  uint8 *p = *ptr;
+  while (value >= 0x80)
+  {
+    *p++ = (uint8) (value | 0x80);
+    value >>= 7;
+  }
+  *p++ = (uint8) value;
+  *ptr = p;
+  return;
+}
+
+/**
+ * Read a variable-length unsigned integer and advance the pointer
+ */
+static uint64
+varint_read(const uint8 **ptr)
+{
+  const uint8 *p = *ptr;
+  uint64 result = 0;
+  int shift = 0;
+  while (*p & 0x80)
+  {
+    result |= (uint64) (*p++ & 0x7F) << shift;
+    shift += 7;
+  }
+  result |= (uint64) (*p++) << shift;
+  *ptr = p;
+  return result;
+}
+
+/*****************************************************************************
+ * Layout
+ *****************************************************************************/
+
+/**
+ * Ensure that a compressed time set has the given set type
+ */
+static void
+ensure_ctimeset_type(const CTimeSet *cts, mobdbType settype)
+{
+  if (cts->settype != settype)
+    elog(ERROR, "The compressed time set must be a %s",
+      settype == T_TIMESTAMPSET ? "timestamp set" : "period set");
+  return;
+}
+
+static int
+ctimeset_nsamples(int count)
+{
+  return (count + CTIMESET_SAMPLE - 1) / CTIMESET_SAMPLE;
+}
+
+/**
+ * Return the samples of a delta-encoded set
+ */
+static const CTimeSetSample *
+ctimeset_samples(const CTimeSet *cts)
+{
+  return (const CTimeSetSample *) CTIMESET_DATA(cts);
+}
+
+/**
+ * Return the bitmap of the inclusive flags of a delta-encoded period set
+ */
+static const uint8 *
+ctimeset_flags(const CTimeSet *cts)
+{
+  return CTIMESET_DATA(cts) +
+    sizeof(CTimeSetSample) * ctimeset_nsamples(cts->count);
+}
+
+/**
+ * Return the encoded elements of a compressed time set
+ */
+static const uint8 *
+ctimeset_elems(const CTimeSet *cts)
+{
+  if (cts->encoding == CTIMESET_RLE)
+    return CTIMESET_DATA(cts);
+  const uint8 *result = ctimeset_flags(cts);
+  if (cts->settype == T_PERIODSET)
+    result += (2 * cts->count + 7) / 8;
+  return result;
+}
+
+/*****************************************************************************
+ * Compression
+ *****************************************************************************/
+
+/**
+ * Element of a time set given as a gap with respect to the previous element,
+ * a duration, and inclusive flags. A timestamp has a zero duration and
+ * both flags set.
+ */
+typedef struct
+{
+  uint64 gap;
+  uint64 duration;
+  uint8 flags;
+} CTimeSetElem;
+
+/**
+ * Return true if two elements are encoded in the same way
+ */
+static bool
+ctimeset_elem_eq(const CTimeSetElem *e1, const CTimeSetElem *e2)
+{
+  return e1->gap == e2->gap && e1->duration == e2->duration &&
+    e1->flags == e2->flags;
+}
+
+/**
+ * Return the number of bytes of an encoded element, without its flags
+ */
+static size_t
+ctimeset_elem_size(const CTimeSetElem *elem, bool isperiod)
+{
+  return varint_size(elem->gap) +
+    (isperiod ? varint_size(elem->duration) : 0);
+}
+
+/**
+ * Return a compressed time set from the elements of a timestamp set or a
+ * period set
+ */
+static CTimeSet *
+ctimeset_make(mobdbType settype, const Period *period,
+  const CTimeSetElem *elems, int count)
+{
+  bool isperiod = (settype == T_PERIODSET);
+  int nsamples = ctimeset_nsamples(count);
+  /* Size of the delta encoding */
+  size_t deltasize = sizeof(CTimeSetSample) * nsamples +
+    (isperiod ? (2 * count + 7) / 8 : 0);
+  for (int i = 0; i < count; i++)
+    deltasize += ctimeset_elem_size(&elems[i], isperiod);
+  /* Size of the run-length encoding */
+  size_t rlesize = 0;
+  int nruns = 0;
+  for (int i = 0; i < count; )
+  {
+    int j = i + 1;
+    while (j < count && ctimeset_elem_eq(&elems[i], &elems[j]))
+      j++;
+    rlesize += varint_size((uint64) (j - i)) +
+      ctimeset_elem_size(&elems[i], isperiod) + (isperiod ? 1 : 0);
+    nruns++;
+    i = j;
+  }
+  uint8 encoding = (nruns <= nsamples && rlesize <= deltasize) ?
+    CTIMESET_RLE : CTIMESET_DELTA;
+
+  size_t memsize = double_pad(sizeof(CTimeSet)) +
+    (encoding == CTIMESET_RLE ? rlesize : deltasize);
+  CTimeSet *result = palloc0(memsize);
+  SET_VARSIZE(result, memsize);
+  result->settype = settype;
+  result->encoding = encoding;
+  result->count = count;
+  memcpy(&result->period, period, sizeof(Period));
+
+  uint8 *ptr = (uint8 *) ctimeset_elems(result);
+  if (encoding == CTIMESET_RLE)
+  {
+    for (int i = 0; i < count; )
+    {
+      int j = i + 1;
+      while (j < count && ctimeset_elem_eq(&elems[i], &elems[j]))
+        j++;
+      varint_write(&ptr, (uint64) (j - i));
+      varint_write(&ptr, elems[i].gap);
+      if (isperiod)
+      {
+        varint_write(&ptr, elems[i].duration);
+        *ptr++ = elems[i].flags;
+      }
+      i = j;
+    }
+    return result;
+  }
+
+  CTimeSetSample *samples = (CTimeSetSample *) CTIMESET_DATA(result);
+  uint8 *flags = (uint8 *) ctimeset_flags(result);
+  const uint8 *start = ptr;
+  TimestampTz last = DatumGetTimestampTz(period->lower);
+  for (int i = 0; i < count; i++)
+  {
+    if (i % CTIMESET_SAMPLE == 0)
+    {
+      samples[i / CTIMESET_SAMPLE].last = last;
+      samples[i / CTIMESET_SAMPLE].offset = (uint32) (ptr - start);
+    }
+    varint_write(&ptr, elems[i].gap);
+    if (isperiod)
+    {
+      varint_write(&ptr, elems[i].duration);
+      flags[i / 4] |= (uint8) (elems[i].flags << (2 * (i % 4)));
+    }
+    last += (TimestampTz) (elems[i].gap + elems[i].duration);
+  }
+  return result;
+}
+
+/**
+ * @ingroup libmeos_spantime_constructor
+ * @brief Return a compressed time set from a timestamp set.
+ */
+CTimeSet *
+timestampset_compress(const TimestampSet *ts)
+{
+  CTimeSetElem *elems = palloc(sizeof(CTimeSetElem) * ts->count);
+  TimestampTz last = DatumGetTimestampTz(ts->period.lower);
+  for (int i = 0; i < ts->count; i++)
+  {
+    TimestampTz t = timestampset_time_n(ts, i);
+    elems[i].gap = (uint64) t - (uint64) last;
+    elems[i].duration = 0;
+    elems[i].flags = 3;
+    last = t;
+  }
+  CTimeSet *result = ctimeset_make(T_TIMESTAMPSET, &ts->period, elems,
+    ts->count);
+  pfree(elems);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_spantime_constructor
+ * @brief Return a compressed time set from a period set.
+ */
+CTimeSet *
+periodset_compress(const PeriodSet *ps)
+{
+  CTimeSetElem *elems = palloc(sizeof(CTimeSetElem) * ps->count);
+  TimestampTz last = DatumGetTimestampTz(ps->period.lower);
+  for (int i = 0; i < ps->count; i++)
+  {
+    const Period *p = periodset_per_n(ps, i);
+    TimestampTz lower = DatumGetTimestampTz(p->lower);
+    TimestampTz upper = DatumGetTimestampTz(p->upper);
+    elems[i].gap = (uint64) lower - (uint64) last;
+    elems[i].duration = (uint64) upper - (uint64) lower;
+    elems[i].flags = (uint8) ((p->lower_inc ? 1 : 0) | (p->upper_inc ? 2 : 0));
+    last = upper;
+  }
+  CTimeSet *result = ctimeset_make(T_PERIODSET, &ps->period, elems,
+    ps->count);
+  pfree(elems);
+  return result;
+}
+
+/*****************************************************************************
+ * Iterator
+ *****************************************************************************/
+
+/**
+ * @ingroup libmeos_spantime_accessor
+ * @brief Initialize an iterator over the elements of a compressed time set.
+ */
+void
+ctimeset_iterator_init(CTimeSetIterator *iter, const CTimeSet *cts)
+{
+  iter->cts = cts;
+  iter->ptr = ctimeset_elems(cts);
+  iter->i = 0;
+  iter->last = DatumGetTimestampTz(cts->period.lower);
+  iter->runleft = 0;
+  iter->delta = iter->duration = 0;
+  iter->flags = 3;
+  return;
+}
+
+/**
+ * Read the header of the next run of a run-length encoded set
+ */
+static void
+ctimeset_iterator_read_run(CTimeSetIterator *iter)
+{
+  iter->runleft = (int) varint_read(&iter->ptr);
+  iter->delta = varint_read(&iter->ptr);
+  if (iter->cts->settype == T_PERIODSET)
+  {
+    iter->duration = varint_read(&iter->ptr);
+    iter->flags = *iter->ptr++;
+  }
+  return;
+}
+
+/**
+ * Decode the next element of a compressed time set
+ *
+ * @return False if all the elements have been decoded
+ */
+static bool
+ctimeset_iterator_next(CTimeSetIterator *iter, TimestampTz *lower,
+  TimestampTz *upper, uint8 *flags)
+{
+  const CTimeSet *cts = iter->cts;
+  if (iter->i >= cts->count)
+    return false;
+  uint64 gap, duration = 0;
+  uint8 fl = 3;
+  if (cts->encoding == CTIMESET_RLE)
+  {
+    if (iter->runleft == 0)
+      ctimeset_iterator_read_run(iter);
+    gap = iter->delta;
+    duration = iter->duration;
+    fl = iter->flags;
+    iter->runleft--;
+  }
+  else
+  {
+    gap = varint_read(&iter->ptr);
+    if (cts->settype == T_PERIODSET)
+    {
+      duration = varint_read(&iter->ptr);
+      fl = (ctimeset_flags(cts)[iter->i / 4] >> (2 * (iter->i % 4))) & 3;
+    }
+  }
+  *lower = (TimestampTz) ((uint64) iter->last + gap);
+  *upper = (TimestampTz) ((uint64) *lower + duration);
+  *flags = fl;
+  iter->last = *upper;
+  iter->i++;
+  return true;
+}
+
+/**
+ * Position a delta-encoded iterator at a sample if it is after the current
+ * position of the iterator
+ */
+static void
+ctimeset_iterator_sample(CTimeSetIterator *iter, int k)
+{
+  if (k * CTIMESET_SAMPLE <= iter->i)
+    return;
+  const CTimeSet *cts = iter->cts;
+  const CTimeSetSample *sample = &ctimeset_samples(cts)[k];
+  iter->i = k * CTIMESET_SAMPLE;
+  iter->ptr = ctimeset_elems(cts) + sample->offset;
+  iter->last = sample->last;
+  return;
+}
+
+/**
+ * Advance an iterator so that the next element is the n-th one (0-based)
+ */
+static void
+ctimeset_iterator_skip(CTimeSetIterator *iter, int n)
+{
+  const CTimeSet *cts = iter->cts;
+  if (cts->encoding == CTIMESET_DELTA)
+  {
+    ctimeset_iterator_sample(iter, n / CTIMESET_SAMPLE);
+    TimestampTz lower, upper;
+    uint8 flags;
+    while (iter->i < n)
+      ctimeset_iterator_next(iter, &lower, &upper, &flags);
+    return;
+  }
+  /* Skip whole runs */
+  while (iter->i < n)
+  {
+    if (iter->runleft == 0)
+      ctimeset_iterator_read_run(iter);
+    int k = Min(iter->runleft, n - iter->i);
+    iter->last = (TimestampTz) ((uint64) iter->last +
+      (uint64) k * (iter->delta + iter->duration));
+    iter->i += k;
+    iter->runleft -= k;
+  }
+  return;
+}
+
+/**
+ * Advance an iterator so that the next element is the first one whose
+ * timestamp or upper bound is greater than or equal to a timestamp
+ */
+void
+ctimeset_iterator_seek(CTimeSetIterator *iter, TimestampTz t)
+{
+  const CTimeSet *cts = iter->cts;
+  if (cts->encoding == CTIMESET_DELTA)
+  {
+    /* Binary search of the last sample preceded by elements before t */
+    const CTimeSetSample *samples = ctimeset_samples(cts);
+    int first = iter->i / CTIMESET_SAMPLE + 1;
+    int last = ctimeset_nsamples(cts->count) - 1;
+    int k = first - 1;
+    while (first <= last)
+    {
+      int middle = (first + last) / 2;
+      if (samples[middle].last < t)
+      {
+        k = middle;
+        first = middle + 1;
+      }
+      else
+        last = middle - 1;
+    }
+    ctimeset_iterator_sample(iter, k);
+    /* Decode the elements until the one ending at or after t */
+    while (iter->i < cts->count)
+    {
+      CTimeSetIterator save = *iter;
+      TimestampTz lower, upper;
+      uint8 flags;
+      ctimeset_iterator_next(iter, &lower, &upper, &flags);
+      if (upper >= t)
+      {
+        *iter = save;
+        break;
+      }
+    }
+    return;
+  }
+  /* Skip the elements of each run ending before t in constant time */
+  while (iter->i < cts->count)
+  {
+    if (iter->runleft == 0)
+      ctimeset_iterator_read_run(iter);
+    uint64 step = iter->delta + iter->duration;
+    int k;
+    if (t <= iter->last)
+      k = 0;
+    else if (step == 0)
+      k = iter->runleft;
+    else
+    {
+      uint64 n = ((uint64) t - (uint64) iter->last - 1) / step;
+      k = (n < (uint64) iter->runleft) ? (int) n : iter->runleft;
+    }
+    iter->last = (TimestampTz) ((uint64) iter->last + (uint64) k * step);
+    iter->i += k;
+    iter->runleft -= k;
+    if (iter->runleft > 0)
+      break;
+  }
+  return;
+}
+
+/**
+ * @ingroup libmeos_spantime_accessor
+ * @brief Decode the next timestamp of a compressed timestamp set.
+ * @return False if all the timestamps have been decoded
+ */
+bool
+ctimeset_iterator_next_timestamp(CTimeSetIterator *iter, TimestampTz *result)
+{
+  ensure_ctimeset_type(iter->cts, T_TIMESTAMPSET);
+  TimestampTz upper;
+  uint8 flags;
+  return ctimeset_iterator_next(iter, result, &upper, &flags);
+}
+
+/**
+ * @ingroup libmeos_spantime_accessor
+ * @brief Decode the next period of a compressed period set.
+ * @return False if all the periods have been decoded
+ */
+bool
+ctimeset_iterator_next_period(CTimeSetIterator *iter, Period *result)
+{
+  ensure_ctimeset_type(iter->cts, T_PERIODSET);
+  TimestampTz lower, upper;
+  uint8 flags;
+  if (! ctimeset_iterator_next(iter, &lower, &upper, &flags))
+    return false;
+  span_set(TimestampTzGetDatum(lower), TimestampTzGetDatum(upper),
+    (flags & 1) != 0, (flags & 2) != 0, T_TIMESTAMPTZ, result);
+  return true;
+}
+
+/*****************************************************************************
+ * Decompression and accessor functions
+ *****************************************************************************/
+
+/**
+ * @ingroup libmeos_spantime_cast
+ * @brief Return the timestamp set of a compressed timestamp set.
+ */
+TimestampSet *
+timestampset_decompress(const CTimeSet *cts)
+{
+  ensure_ctimeset_type(cts, T_TIMESTAMPSET);
+  TimestampTz *times = palloc(sizeof(TimestampTz) * cts->count);
+  CTimeSetIterator iter;
+  ctimeset_iterator_init(&iter, cts);
+  int k = 0;
+  while (ctimeset_iterator_next_timestamp(&iter, &times[k]))
+    k++;
+  return timestampset_make_free(times, k);
+}
+
+/**
+ * @ingroup libmeos_spantime_cast
+ * @brief Return the period set of a compressed period set.
+ */
+PeriodSet *
+periodset_decompress(const CTimeSet *cts)
+{
+  ensure_ctimeset_type(cts, T_PERIODSET);
+  Period *periods = palloc(sizeof(Period) * cts->count);
+  const Period **ptrs = palloc(sizeof(Period *) * cts->count);
+  CTimeSetIterator iter;
+  ctimeset_iterator_init(&iter, cts);
+  int k = 0;
+  while (ctimeset_iterator_next_period(&iter, &periods[k]))
+  {
+    ptrs[k] = &periods[k];
+    k++;
+  }
+  PeriodSet *result = periodset_make(ptrs, k, NORMALIZE_NO);
+  pfree(periods); pfree(ptrs);
+  return result;
+}
+
+/**
+ * @ingroup libmeos_spantime_accessor
+ * @brief Return the size in bytes of a compressed time set.
+ */
+int
+ctimeset_mem_size(const CTimeSet *cts)
+{
+  return (int) VARSIZE(DatumGetPointer(cts));
+}
+
+/**
+ * @ingroup libmeos_spantime_accessor
+ * @brief Return the number of elements of a compressed time set.
+ */
+int
+ctimeset_num_elems(const CTimeSet *cts)
+{
+  return cts->count;
+}
+
+/**
+ * @ingroup libmeos_spantime_cast
+ * @brief Return the bounding period of a compressed time set.
+ */
+Period *
+ctimeset_to_period(const CTimeSet *cts)
+{
+  return span_copy(&cts->period);
+}
+
+/**
+ * @ingroup libmeos_spantime_accessor
+ * @brief Return the n-th timestamp of a compressed timestamp set.
+ * @note It is assumed that n is 1-based
+ */
+bool
+ctimeset_timestamp_n(const CTimeSet *cts, int n, TimestampTz *result)
+{
+  ensure_ctimeset_type(cts, T_TIMESTAMPSET);
+  if (n < 1 || n > cts->count)
+    return false;
+  CTimeSetIterator iter;
+  ctimeset_iterator_init(&iter, cts);
+  ctimeset_iterator_skip(&iter, n - 1);
+  return ctimeset_iterator_next_timestamp(&iter, result);
+}
+
+/**
+ * @ingroup libmeos_spantime_accessor
+ * @brief Return the n-th period of a compressed period set.
+ * @note It is assumed that n is 1-based
+ */
+Period *
+ctimeset_period_n(const CTimeSet *cts, int n)
+{
+  ensure_ctimeset_type(cts, T_PERIODSET);
+  if (n < 1 || n > cts->count)
+    return NULL;
+  CTimeSetIterator iter;
+  ctimeset_iterator_init(&iter, cts);
+  ctimeset_iterator_skip(&iter, n - 1);
+  Period *result = palloc(sizeof(Period));
+  ctimeset_iterator_next_period(&iter, result);
+  return result;
+}
+
+/*****************************************************************************
+ * Topological functions
+ *****************************************************************************/
+
+/**
+ * @ingroup libmeos_spantime_topo
+ * @brief Return true if a compressed time set contains a timestamp.
+ * @note Only the elements near the timestamp are decoded.
+ */
+bool
+contains_ctimeset_timestamp(const CTimeSet *cts, TimestampTz t)
+{
+  /* Bounding box test */
+  if (! contains_period_timestamp(&cts->period, t))
+    return false;
+
+  CTimeSetIterator iter;
+  ctimeset_iterator_init(&iter, cts);
+  ctimeset_iterator_seek(&iter, t);
+  TimestampTz lower, upper;
+  uint8 flags;
+  if (! ctimeset_iterator_next(&iter, &lower, &upper, &flags))
+    return false;
+  if (cts->settype == T_TIMESTAMPSET)
+    return lower == t;
+  return (lower < t || (lower == t && (flags & 1))) &&
+    (t < upper || (t == upper && (flags & 2)));
+}
+
+/**
+ * @ingroup libmeos_spantime_topo
+ * @brief Return true if a compressed time set and a period overlap.
+ * @note Only the elements near the period are decoded.
+ */
+bool
+overlaps_ctimeset_period(const CTimeSet *cts, const Period *p)
+{
+  /* Bounding box test */
+  if (! overlaps_span_span(&cts->period, p))
+    return false;
+
+  CTimeSetIterator iter;
+  ctimeset_iterator_init(&iter, cts);
+  ctimeset_iterator_seek(&iter, DatumGetTimestampTz(p->lower));
+  TimestampTz lower, upper;
+  uint8 flags;
+  while (ctimeset_iterator_next(&iter, &lower, &upper, &flags))
+  {
+    Period p1;
+    span_set(TimestampTzGetDatum(lower), TimestampTzGetDatum(upper),
+      (flags & 1) != 0, (flags & 2) != 0, T_TIMESTAMPTZ, &p1);
+    if (overlaps_span_span(&p1, p))
+      return true;
+    /* The following elements start after the period */
+    if (lower >= DatumGetTimestampTz(p->upper))
+      break;
+  }
+  return false;
+}
+
+/*****************************************************************************/
@@ -83,6 +83,172 @@ pos_period_timestamp(const Period *p, TimestampTz t)
   return DURING;
 }
 
+/*****************************************************************************
+ * Merge kernels
+ *****************************************************************************/
+
+/**
+ * Ratio between the number of elements of two sets above which the traversal
+ * of the largest set gallops instead of advancing one element at a time
+ */
+#define GALLOP_RATIO 8
+/**
+ * Number of elements below which a galloping search ends with a linear scan
+ * instead of a binary search
+ */
+#define GALLOP_SCAN 16
+
+/**
+ * Return true if the traversal of a set with a number of elements merged
+ * with another set with a number of elements must gallop
+ */
+#define GALLOP(count, othercount) ((count) > GALLOP_RATIO * (othercount))
+
+/**
+ * Return the position of the first timestamp of an array from a position
+ * that is greater than or equal to a timestamp, or greater than it when
+ * strict is true
+ *
+ * When gallop is true, the position is found with an exponential search
+ * followed by a binary search and a final scan over at most GALLOP_SCAN
+ * elements. The final scan counts the elements before the timestamp without
+ * branches so that the compiler vectorizes the comparisons of the 8-byte
+ * timestamps. Otherwise, the timestamps are scanned linearly, which is
+ * faster when merging sets of similar sizes.
+ */
+static int
+timestamparr_skip(const TimestampTz *times, int from, int count,
+  TimestampTz t, bool strict, bool gallop)
+{
+  int lo = from;
+  if (! gallop)
+  {
+    if (strict)
+      while (lo < count && times[lo] <= t)
+        lo++;
+    else
+      while (lo < count && times[lo] < t)
+        lo++;
+    return lo;
+  }
+  /* Exponential search: the timestamps before lo are before t and the one
+   * at position hi, if any, is not */
+  int hi = from, step = 1;
+  while (hi < count && (strict ? times[hi] <= t : times[hi] < t))
+  {
+    lo = hi + 1;
+    hi += step;
+    step <<= 1;
+  }
+  if (hi > count)
+    hi = count;
+  /* Binary search */
+  while (hi - lo > GALLOP_SCAN)
+  {
+    int middle = lo + (hi - lo) / 2;
+    if (strict ? times[middle] <= t : times[middle] < t)
+      lo = middle + 1;
+    else
+      hi = middle;
+  }
+  /* Branchless scan */
+  int n = 0;
+  if (strict)
+    for (int i = lo; i < hi; i++)
+      n += (times[i] <= t);
+  else
+    for (int i = lo; i < hi; i++)
+      n += (times[i] < t);
+  return lo + n;
+}
+
+/**
+ * Return true if a period is before a bound, that is, if its upper bound is
+ * less than the bound or equal to it and one of them is exclusive
+ */
+static inline bool
+period_before_bound(const Period *p, TimestampTz t, bool inc)
+{
+  TimestampTz upper = DatumGetTimestampTz(p->upper);
+  return upper < t || (upper == t && (! p->upper_inc || ! inc));
+}
+
+/**
+ * Return true if a period ends within an upper bound, that is, if its upper
+ * bound is less than the bound or equal to it and the period bound is
+ * exclusive or the bound is inclusive
+ */
+static inline bool
+period_within_bound(const Period *p, TimestampTz t, bool inc)
+{
+  TimestampTz upper = DatumGetTimestampTz(p->upper);
+  return upper < t || (upper == t && (! p->upper_inc || inc));
+}
+
+/**
+ * Return the position of the first period of a period set from a position
+ * that does not satisfy a test with respect to a bound given by a timestamp
+ * and an inclusive flag, galloping over the periods if required
+ */
+static int
+periodset_skip1(const PeriodSet *ps, int from, TimestampTz t, bool inc,
+  bool (*test)(const Period *, TimestampTz, bool), bool gallop)
+{
+  int lo = from;
+  if (! gallop)
+  {
+    while (lo < ps->count && test(periodset_per_n(ps, lo), t, inc))
+      lo++;
+    return lo;
+  }
+  int hi = from, step = 1;
+  while (hi < ps->count && test(periodset_per_n(ps, hi), t, inc))
+  {
+    lo = hi + 1;
+    hi += step;
+    step <<= 1;
+  }
+  if (hi > ps->count)
+    hi = ps->count;
+  while (lo < hi)
+  {
+    int middle = lo + (hi - lo) / 2;
+    if (test(periodset_per_n(ps, middle), t, inc))
+      lo = middle + 1;
+    else
+      hi = middle;
+  }
+  return lo;
+}
+
+/**
+ * Return the position of the first period of a period set from a position
+ * that is not before a bound given by a timestamp and an inclusive flag,
+ * galloping over the periods if required
+ *
+ * @note The bound is typically the lower bound of a span, or a timestamp
+ * with inc set to true, since the periods before such a bound cannot
+ * intersect the span or contain the timestamp.
+ */
+static int
+periodset_skip(const PeriodSet *ps, int from, TimestampTz t, bool inc,
+  bool gallop)
+{
+  return periodset_skip1(ps, from, t, inc, &period_before_bound, gallop);
+}
+
+/**
+ * Return the position of the first period of a period set from a position
+ * that does not end within an upper bound given by a timestamp and an
+ * inclusive flag, galloping over the periods if required
+ */
+static int
+periodset_skip_within(const PeriodSet *ps, int from, TimestampTz t, bool inc,
+  bool gallop)
+{
+  return periodset_skip1(ps, from, t, inc, &period_within_bound, gallop);
+}
+
 /*****************************************************************************
  * Generic operations
  *****************************************************************************/
@@ -109,49 +275,55 @@ setop_timestampset_timestampset(const TimestampSet *ts1,
   else /* setop == MINUS */
     count = ts1->count;
   TimestampTz *times = palloc(sizeof(TimestampTz) * count);
+  const TimestampTz *times1 = &ts1->elems[0];
+  const TimestampTz *times2 = &ts2->elems[0];
+  bool gallop1 = GALLOP(ts1->count, ts2->count);
+  bool gallop2 = GALLOP(ts2->count, ts1->count);
   int i = 0, j = 0, k = 0;
-  TimestampTz t1 = timestampset_time_n(ts1, 0);
-  TimestampTz t2 = timestampset_time_n(ts2, 0);
   while (i < ts1->count && j < ts2->count)
   {
-    int cmp = timestamptz_cmp_internal(t1, t2);
-    if (cmp == 0)
+    TimestampTz t1 = times1[i];
+    TimestampTz t2 = times2[j];
+    if (t1 == t2)
     {
       if (setop == UNION || setop == INTER)
         times[k++] = t1;
       i++; j++;
-      if (i == ts1->count || j == ts2->count)
-        break;
-      t1 = timestampset_time_n(ts1, i);
-      t2 = timestampset_time_n(ts2, j);
     }
-    else if (cmp < 0)
+    else if (t1 < t2)
     {
+      /* Copy the run of timestamps of the first set before t2 */
+      int next = timestamparr_skip(times1, i + 1, ts1->count, t2, false,
+        gallop1);
       if (setop == UNION || setop == MINUS)
-        times[k++] = t1;
-      i++;
-      if (i == ts1->count)
-        break;
-      else
-        t1 = timestampset_time_n(ts1, i);
+      {
+        memcpy(&times[k], &times1[i], sizeof(TimestampTz) * (next - i));
+        k += next - i;
+      }
+      i = next;
     }
     else
     {
-      if (setop == UNION || setop == MINUS)
-        times[k++] = t2;
-      j++;
-      if (j == ts2->count)
-        break;
-      else
-        t2 = timestampset_time_n(ts2, j);
+      /* Copy the run of timestamps of the second set before t1 */
+      int next = timestamparr_skip(times2, j + 1, ts2->count, t1, false,
+        gallop2);
+      if (setop == UNION)
+      {
+        memcpy(&times[k], &times2[j], sizeof(TimestampTz) * (next - j));
+        k += next - j;
+      }
+      j = next;
     }
   }
+  if (setop == UNION || setop == MINUS)
+  {
+    memcpy(&times[k], &times1[i], sizeof(TimestampTz) * (ts1->count - i));
+    k += ts1->count - i;
+  }
   if (setop == UNION)
   {
-    while (i < ts1->count)
-      times[k++] = timestampset_time_n(ts1, i++);
-    while (j < ts2->count)
-      times[k++] = timestampset_time_n(ts2, j++);
+    memcpy(&times[k], &times2[j], sizeof(TimestampTz) * (ts2->count - j));
+    k += ts2->count - j;
   }
   return timestampset_make_free(times, k);
 }
@@ -168,14 +340,24 @@ setop_timestampset_period(const TimestampSet *ts, const Period *p,
   if (! overlaps_span_span(&ts->period, p))
     return (setop == INTER) ? NULL : timestampset_copy(ts);
 
+  /* The timestamps contained in the period are contiguous */
+  const TimestampTz *times1 = &ts->elems[0];
+  int from = timestamparr_skip(times1, 0, ts->count,
+    DatumGetTimestampTz(p->lower), ! p->lower_inc, true);
+  int to = timestamparr_skip(times1, from, ts->count,
+    DatumGetTimestampTz(p->upper), p->upper_inc, true);
   TimestampTz *times = palloc(sizeof(TimestampTz) * ts->count);
-  int k = 0;
-  for (int i = 0; i < ts->count; i++)
+  int k;
+  if (setop == INTER)
   {
-    TimestampTz t = timestampset_time_n(ts, i);
-    if (((setop == INTER) && contains_period_timestamp(p, t)) ||
-      ((setop == MINUS) && !contains_period_timestamp(p, t)))
-      times[k++] = t;
+    k = to - from;
+    memcpy(times, &times1[from], sizeof(TimestampTz) * k);
+  }
+  else
+  {
+    memcpy(times, times1, sizeof(TimestampTz) * from);
+    memcpy(&times[from], &times1[to], sizeof(TimestampTz) * (ts->count - to));
+    k = from + ts->count - to;
   }
   return timestampset_make_free(times, k);
 }
@@ -193,45 +375,39 @@ setop_timestampset_periodset(const TimestampSet *ts, const PeriodSet *ps,
     return (setop == INTER) ? NULL : timestampset_copy(ts);
 
   TimestampTz *times = palloc(sizeof(TimestampTz) * ts->count);
-  TimestampTz t = timestampset_time_n(ts, 0);
-  const Period *p = periodset_per_n(ps, 0);
+  const TimestampTz *times1 = &ts->elems[0];
+  bool gallopts = GALLOP(ts->count, ps->count);
+  bool gallopps = GALLOP(ps->count, ts->count);
   int i = 0, j = 0, k = 0;
   while (i < ts->count && j < ps->count)
   {
-    if (t < (TimestampTz) p->lower)
+    /* Skip the periods before the current timestamp */
+    j = periodset_skip(ps, j, times1[i], true, gallopps);
+    if (j == ps->count)
+      break;
+    const Period *p = periodset_per_n(ps, j);
+    /* The timestamps before the period are followed by those in the period */
+    int from = timestamparr_skip(times1, i, ts->count,
+      DatumGetTimestampTz(p->lower), ! p->lower_inc, gallopts);
+    int to = timestamparr_skip(times1, from, ts->count,
+      DatumGetTimestampTz(p->upper), p->upper_inc, gallopts);
+    if (setop == INTER)
     {
-      if (setop == MINUS)
-        times[k++] = t;
-      i++;
-      if (i == ts->count)
-        break;
-      else
-        t = timestampset_time_n(ts, i);
-    }
-    else if (t > (TimestampTz) p->upper)
-    {
-      j++;
-      if (j == ps->count)
-        break;
-      else
-        p = periodset_per_n(ps, j);
+      memcpy(&times[k], &times1[from], sizeof(TimestampTz) * (to - from));
+      k += to - from;
     }
     else
     {
-      if ((setop == INTER && contains_period_timestamp(p, t)) ||
-        (setop == MINUS && !contains_period_timestamp(p, t)))
-        times[k++] = t;
-      i++;
-      if (i == ts->count)
-        break;
-      else
-        t = timestampset_time_n(ts, i);
+      memcpy(&times[k], &times1[i], sizeof(TimestampTz) * (from - i));
+      k += from - i;
     }
+    i = to;
+    j++;
   }
   if (setop == MINUS)
   {
-    for (int l = i; l < ts->count; l++)
-      times[k++] = timestampset_time_n(ts, l);
+    memcpy(&times[k], &times1[i], sizeof(TimestampTz) * (ts->count - i));
+    k += ts->count - i;
   }
   return timestampset_make_free(times, k);
 }
@@ -268,20 +444,16 @@ contains_timestampset_timestampset(const TimestampSet *ts1,
   if (! contains_span_span(&ts1->period, &ts2->period))
     return false;
 
-  int i = 0, j = 0;
-  while (j < ts2->count)
+  const TimestampTz *times1 = &ts1->elems[0];
+  bool gallop = GALLOP(ts1->count, ts2->count);
+  int i = 0;
+  for (int j = 0; j < ts2->count; j++)
   {
-    TimestampTz t1 = timestampset_time_n(ts1, i);
     TimestampTz t2 = timestampset_time_n(ts2, j);
-    int cmp = timestamptz_cmp_internal(t1, t2);
-    if (cmp == 0)
-    {
-      i++; j++;
-    }
-    else if (cmp < 0)
-      i++;
-    else
+    i = timestamparr_skip(times1, i, ts1->count, t2, false, gallop);
+    if (i == ts1->count || times1[i] != t2)
       return false;
+    i++;
   }
   return true;
 }
@@ -350,20 +522,22 @@ contains_periodset_timestampset(const PeriodSet *ps, const TimestampSet *ts)
   if (! contains_span_span(&ps->period, &ts->period))
     return false;
 
+  const TimestampTz *times = &ts->elems[0];
+  bool gallopps = GALLOP(ps->count, ts->count);
+  bool gallopts = GALLOP(ts->count, ps->count);
   int i = 0, j = 0;
   while (j < ts->count)
   {
+    TimestampTz t = times[j];
+    i = periodset_skip(ps, i, t, true, gallopps);
+    if (i == ps->count)
+      return false;
     const Period *p = periodset_per_n(ps, i);
-    TimestampTz t = timestampset_time_n(ts, j);
-    if (contains_period_timestamp(p, t))
-      j++;
-    else
-    {
-      if (t > (TimestampTz) p->upper)
-        i++;
-      else
-        return false;
-    }
+    if (! contains_period_timestamp(p, t))
+      return false;
+    /* Skip the following timestamps contained in the period */
+    j = timestamparr_skip(times, j + 1, ts->count,
+      DatumGetTimestampTz(p->upper), p->upper_inc, gallopts);
   }
   return true;
 }
@@ -409,34 +583,26 @@ contains_periodset_periodset(const PeriodSet *ps1, const PeriodSet *ps2)
   if (! contains_span_span(&ps1->period, &ps2->period))
     return false;
 
+  bool gallop1 = GALLOP(ps1->count, ps2->count);
+  bool gallop2 = GALLOP(ps2->count, ps1->count);
   int i = 0, j = 0;
-  while (i < ps1->count && j < ps2->count)
+  while (j < ps2->count)
   {
-    const Period *p1 = periodset_per_n(ps1, i);
     const Period *p2 = periodset_per_n(ps2, j);
-    if (left_span_span(p1, p2))
-      i++;
-    else if (left_span_span(p2, p1))
+    /* Skip the periods of the first set before the current period */
+    i = periodset_skip(ps1, i, DatumGetTimestampTz(p2->lower), p2->lower_inc,
+      gallop1);
+    if (i == ps1->count)
       return false;
-    else
-    {
-      /* p1 and p2 overlap */
-      if (contains_span_span(p1, p2))
-      {
-        if (p1->upper == p2->upper)
-        {
-          i++; j++;
-        }
-        else
-          j++;
-      }
-      else
-        return false;
-    }
+    const Period *p1 = periodset_per_n(ps1, i);
+    if (! contains_span_span(p1, p2))
+      return false;
+    /* The following periods of the second set ending before the end of p1
+     * start after p2 and thus are contained in p1 */
+    j = periodset_skip_within(ps2, j + 1, DatumGetTimestampTz(p1->upper),
+      p1->upper_inc, gallop2);
   }
-  /* if j == ps2->count every period in p2 is contained in a period of p1
-     but p1 may have additional periods */
-  return (j == ps2->count);
+  return true;
 }
 
 /*****************************************************************************/
@@ -558,18 +724,21 @@ overlaps_timestampset_timestampset(const TimestampSet *ts1,
   if (! overlaps_span_span(&ts1->period, &ts2->period))
     return false;
 
+  const TimestampTz *times1 = &ts1->elems[0];
+  const TimestampTz *times2 = &ts2->elems[0];
+  bool gallop1 = GALLOP(ts1->count, ts2->count);
+  bool gallop2 = GALLOP(ts2->count, ts1->count);
   int i = 0, j = 0;
   while (i < ts1->count && j < ts2->count)
   {
-    TimestampTz t1 = timestampset_time_n(ts1, i);
-    TimestampTz t2 = timestampset_time_n(ts2, j);
-    int cmp = timestamptz_cmp_internal(t1, t2);
-    if (cmp == 0)
+    TimestampTz t1 = times1[i];
+    TimestampTz t2 = times2[j];
+    if (t1 == t2)
       return true;
-    if (cmp < 0)
-      i++;
+    if (t1 < t2)
+      i = timestamparr_skip(times1, i + 1, ts1->count, t2, false, gallop1);
     else
-      j++;
+      j = timestamparr_skip(times2, j + 1, ts2->count, t1, false, gallop2);
   }
   return false;
 }
@@ -586,13 +755,11 @@ overlaps_timestampset_period(const TimestampSet *ts, const Period *p)
   if (! overlaps_span_span(p, &ts->period))
     return false;
 
-  for (int i = 0; i < ts->count; i++)
-  {
-    TimestampTz t = timestampset_time_n(ts, i);
-    if (contains_period_timestamp(p, t))
-      return true;
-  }
-  return false;
+  /* Find the first timestamp that is not before the period */
+  int i = timestamparr_skip(&ts->elems[0], 0, ts->count,
+    DatumGetTimestampTz(p->lower), ! p->lower_inc, true);
+  return (i < ts->count &&
+    contains_period_timestamp(p, timestampset_time_n(ts, i)));
 }
 
 /**
@@ -607,17 +774,22 @@ overlaps_timestampset_periodset(const TimestampSet *ts, const PeriodSet *ps)
   if (! overlaps_span_span(&ps->period, &ts->period))
     return false;
 
+  const TimestampTz *times = &ts->elems[0];
+  bool gallopts = GALLOP(ts->count, ps->count);
+  bool gallopps = GALLOP(ps->count, ts->count);
   int i = 0, j = 0;
   while (i < ts->count && j < ps->count)
   {
-    TimestampTz t = timestampset_time_n(ts, i);
+    TimestampTz t = times[i];
+    j = periodset_skip(ps, j, t, true, gallopps);
+    if (j == ps->count)
+      break;
     const Period *p = periodset_per_n(ps, j);
     if (contains_period_timestamp(p, t))
       return true;
-    else if (t > (TimestampTz) p->upper)
-      j++;
-    else
-      i++;
+    /* The timestamp is before the period, skip the timestamps before it */
+    i = timestamparr_skip(times, i + 1, ts->count,
+      DatumGetTimestampTz(p->lower), ! p->lower_inc, gallopts);
   }
   return false;
 }
@@ -693,6 +865,8 @@ overlaps_periodset_periodset(const PeriodSet *ps1, const PeriodSet *ps2)
   if (! overlaps_span_span(&ps1->period, &ps2->period))
     return false;
 
+  bool gallop1 = GALLOP(ps1->count, ps2->count);
+  bool gallop2 = GALLOP(ps2->count, ps1->count);
   int i = 0, j = 0;
   while (i < ps1->count && j < ps2->count)
   {
@@ -700,16 +874,13 @@ overlaps_periodset_periodset(const PeriodSet *ps1, const PeriodSet *ps2)
     const Period *p2 = periodset_per_n(ps2, j);
     if (overlaps_span_span(p1, p2))
       return true;
-    int cmp = timestamptz_cmp_internal(DatumGetTimestampTz(p1->upper),
-      DatumGetTimestampTz(p2->upper));
-    if (cmp == 0)
-    {
-      i++; j++;
-    }
-    else if (cmp < 0)
-      i++;
+    /* Skip the periods of the set whose current period is before */
+    if (left_span_span(p1, p2))
+      i = periodset_skip(ps1, i + 1, DatumGetTimestampTz(p2->lower),
+        p2->lower_inc, gallop1);
     else
-      j++;
+      j = periodset_skip(ps2, j + 1, DatumGetTimestampTz(p1->lower),
+        p1->lower_inc, gallop2);
   }
   return false;
 }
@@ -1873,23 +2044,30 @@ union_periodset_periodset(const PeriodSet *ps1, const PeriodSet *ps2)
   if (overlaps_periodset_periodset(ps1, ps2))
     mustfree = palloc(sizeof(Period *) * Max(ps1->count, ps2->count));
 
+  bool gallop1 = GALLOP(ps1->count, ps2->count);
+  bool gallop2 = GALLOP(ps2->count, ps1->count);
   int i = 0, j = 0, k = 0, l = 0;
   while (i < ps1->count && j < ps2->count)
   {
     const Period *p1 = periodset_per_n(ps1, i);
     const Period *p2 = periodset_per_n(ps2, j);
-    /* The periods do not overlap, copy the earliest period */
+    /* The periods do not overlap, copy the run of periods of the set with
+     * the earliest period */
     if (! overlaps_span_span(p1, p2))
     {
       if (left_span_span(p1, p2))
       {
-        periods[k++] = (Period *) p1;
-        i++;
+        int next = periodset_skip(ps1, i + 1, DatumGetTimestampTz(p2->lower),
+          p2->lower_inc, gallop1);
+        while (i < next)
+          periods[k++] = (Period *) periodset_per_n(ps1, i++);
       }
       else
       {
-        periods[k++] = (Period *) p2;
-        j++;
+        int next = periodset_skip(ps2, j + 1, DatumGetTimestampTz(p1->lower),
+          p1->lower_inc, gallop2);
+        while (j < next)
+          periods[k++] = (Period *) periodset_per_n(ps2, j++);
       }
     }
     else
@@ -2196,11 +2374,26 @@ intersection_periodset_periodset(const PeriodSet *ps1, const PeriodSet *ps2)
   periodset_find_timestamp(ps2, p.lower, &loc2);
   Period **periods = palloc(sizeof(Period *) *
     (ps1->count + ps2->count - loc1 - loc2));
+  bool gallop1 = GALLOP(ps1->count, ps2->count);
+  bool gallop2 = GALLOP(ps2->count, ps1->count);
   int i = loc1, j = loc2, k = 0;
   while (i < ps1->count && j < ps2->count)
   {
     const Period *p1 = periodset_per_n(ps1, i);
     const Period *p2 = periodset_per_n(ps2, j);
+    /* Skip the periods that do not intersect the other set */
+    if (left_span_span(p1, p2))
+    {
+      i = periodset_skip(ps1, i + 1, DatumGetTimestampTz(p2->lower),
+        p2->lower_inc, gallop1);
+      continue;
+    }
+    if (left_span_span(p2, p1))
+    {
+      j = periodset_skip(ps2, j + 1, DatumGetTimestampTz(p1->lower),
+        p1->lower_inc, gallop2);
+      continue;
+    }
     Period *inter = intersection_span_span(p1, p2);
     if (inter != NULL)
       periods[k++] = inter;
@@ -2739,17 +2932,25 @@ minus_periodset_periodset(const PeriodSet *ps1, const PeriodSet *ps2)
     return periodset_copy(ps1);
 
   Period **periods = palloc(sizeof(const Period *) * (ps1->count + ps2->count));
+  bool gallop1 = GALLOP(ps1->count, ps2->count);
+  bool gallop2 = GALLOP(ps2->count, ps1->count);
   int i = 0, j = 0, k = 0;
   while (i < ps1->count && j < ps2->count)
   {
     const Period *p1 = periodset_per_n(ps1, i);
     const Period *p2 = periodset_per_n(ps2, j);
-    /* The periods do not overlap, copy the first period */
-    if (! overlaps_span_span(p1, p2))
+    /* The periods do not overlap, copy the run of periods of the first set
+     * before p2 or skip the periods of the second set before p1 */
+    if (left_span_span(p1, p2))
     {
-      periods[k++] = span_copy(p1);
-      i++;
+      int next = periodset_skip(ps1, i + 1, DatumGetTimestampTz(p2->lower),
+        p2->lower_inc, gallop1);
+      while (i < next)
+        periods[k++] = span_copy(periodset_per_n(ps1, i++));
     }
+    else if (left_span_span(p2, p1))
+      j = periodset_skip(ps2, j + 1, DatumGetTimestampTz(p1->lower),
+        p1->lower_inc, gallop2);
     else
     {
       /* Find all periods in ps2 that overlap with p1
@@ -2770,7 +2971,13 @@ minus_periodset_periodset(const PeriodSet *ps1, const PeriodSet *ps2)
       k += minus_period_periodset1(&periods[k], p1,
         ps2, j, to);
       i++;
-      j = l;
+      /* The last overlapping period may also overlap the next period of
+       * the first set if it extends beyond p1 */
+      if (l > j && ! period_before_bound(periodset_per_n(ps2, l - 1),
+          DatumGetTimestampTz(p1->upper), p1->upper_inc))
+        j = l - 1;
+      else
+        j = l;
     }
   }
   /* Copy the sequences after the period set */
@@ -150,6 +150,352 @@ tnumber_div_tp_at_timestamp(const TInstant *start1, const TInstant *end1,
     value, t);
 }
 
+/*****************************************************************************
+ * Fast paths on arrays of values
+ *****************************************************************************/
+
+/**
+ * Copy the values of a temporal sequence number into an array of floats
+ */
+static void
+tnumberseq_float_values(const TSequence *seq, double *values)
+{
+  bool isfloat = (seq->temptype == T_TFLOAT);
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = tsequence_inst_n(seq, i);
+    values[i] = isfloat ? DatumGetFloat8(tinstant_value(inst)) :
+      (double) DatumGetInt32(tinstant_value(inst));
+  }
+  return;
+}
+
+/**
+ * Copy the values of a temporal sequence integer into an array of integers
+ */
+static void
+tintseq_int_values(const TSequence *seq, int *values)
+{
+  for (int i = 0; i < seq->count; i++)
+    values[i] = DatumGetInt32(tinstant_value(tsequence_inst_n(seq, i)));
+  return;
+}
+
+/**
+ * Apply an arithmetic operator to two arrays of floats
+ */
+MOBDB_SIMD_CLONES
+static void
+arithop_float_float_kernel(const double *values1, const double *values2,
+  double *result, int count, TArithmetic oper)
+{
+  int i;
+  if (oper == ADD)
+    for (i = 0; i < count; i++)
+      result[i] = values1[i] + values2[i];
+  else if (oper == SUB)
+    for (i = 0; i < count; i++)
+      result[i] = values1[i] - values2[i];
+  else if (oper == MULT)
+    for (i = 0; i < count; i++)
+      result[i] = values1[i] * values2[i];
+  else /* oper == DIV */
+    for (i = 0; i < count; i++)
+      result[i] = values1[i] / values2[i];
+  return;
+}
+
+/**
+ * Apply an arithmetic operator to an array of floats and a float
+ *
+ * @param[in] invert True when the float is the first argument of the operator
+ */
+MOBDB_SIMD_CLONES
+static void
+arithop_float_number_kernel(const double *values, double value,
+  double *result, int count, TArithmetic oper, bool invert)
+{
+  int i;
+  if (oper == ADD)
+    for (i = 0; i < count; i++)
+      result[i] = values[i] + value;
+  else if (oper == SUB && ! invert)
+    for (i = 0; i < count; i++)
+      result[i] = values[i] - value;
+  else if (oper == SUB)
+    for (i = 0; i < count; i++)
+      result[i] = value - values[i];
+  else if (oper == MULT)
+    for (i = 0; i < count; i++)
+      result[i] = values[i] * value;
+  else if (! invert) /* oper == DIV */
+    for (i = 0; i < count; i++)
+      result[i] = values[i] / value;
+  else /* oper == DIV && invert */
+    for (i = 0; i < count; i++)
+      result[i] = value / values[i];
+  return;
+}
+
+/**
+ * Apply an arithmetic operator to two arrays of integers
+ *
+ * @note The integer division is not vectorized by current compilers
+ */
+MOBDB_SIMD_CLONES
+static void
+arithop_int_int_kernel(const int *values1, const int *values2, int *result,
+  int count, TArithmetic oper)
+{
+  int i;
+  if (oper == ADD)
+    for (i = 0; i < count; i++)
+      result[i] = values1[i] + values2[i];
+  else if (oper == SUB)
+    for (i = 0; i < count; i++)
+      result[i] = values1[i] - values2[i];
+  else if (oper == MULT)
+    for (i = 0; i < count; i++)
+      result[i] = values1[i] * values2[i];
+  else /* oper == DIV */
+    for (i = 0; i < count; i++)
+      result[i] = values1[i] / values2[i];
+  return;
+}
+
+/**
+ * Apply an arithmetic operator to an array of integers and an integer
+ *
+ * @param[in] invert True when the integer is the first argument of the
+ * operator
+ */
+MOBDB_SIMD_CLONES
+static void
+arithop_int_number_kernel(const int *values, int value, int *result,
+  int count, TArithmetic oper, bool invert)
+{
+  int i;
+  if (oper == ADD)
+    for (i = 0; i < count; i++)
+      result[i] = values[i] + value;
+  else if (oper == SUB && ! invert)
+    for (i = 0; i < count; i++)
+      result[i] = values[i] - value;
+  else if (oper == SUB)
+    for (i = 0; i < count; i++)
+      result[i] = value - values[i];
+  else if (oper == MULT)
+    for (i = 0; i < count; i++)
+      result[i] = values[i] * value;
+  else if (! invert) /* oper == DIV */
+    for (i = 0; i < count; i++)
+      result[i] = values[i] / value;
+  else /* oper == DIV && invert */
+    for (i = 0; i < count; i++)
+      result[i] = value / values[i];
+  return;
+}
+
+/**
+ * Construct a temporal sequence number from the timestamps and the bounds of
+ * a sequence and an array of values
+ *
+ * @param[in] seq Sequence providing the timestamps and the bounds
+ * @param[in] values Array of integers or floats depending on the result type
+ * @param[in] restype Temporal type of the result
+ * @param[in] linear True when the result has linear interpolation
+ * @note A step sequence is normalized only if two consecutive values are
+ * equal, which is the only case in which its normalization removes instants.
+ * Linear sequences are always normalized since the arithmetic may make three
+ * consecutive values collinear.
+ */
+static TSequence *
+tnumberseq_from_values(const TSequence *seq, const void *values,
+  mobdbType restype, bool linear)
+{
+  const int *ivalues = (const int *) values;
+  const double *fvalues = (const double *) values;
+  bool isint = (restype == T_TINT);
+  bool normalize = linear;
+  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  for (int i = 0; i < seq->count; i++)
+  {
+    Datum value;
+    if (isint)
+    {
+      value = Int32GetDatum(ivalues[i]);
+      if (i > 0 && ivalues[i] == ivalues[i - 1])
+        normalize = true;
+    }
+    else
+    {
+      value = Float8GetDatum(fvalues[i]);
+      if (i > 0 && fvalues[i] == fvalues[i - 1])
+        normalize = true;
+    }
+    instants[i] = tinstant_make(value, restype, tsequence_inst_n(seq, i)->t);
+  }
+  return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
+    seq->period.upper_inc, linear, normalize);
+}
+
+/**
+ * Apply an arithmetic operator to a temporal sequence number and a number
+ * by a single pass over the array of values of the sequence
+ */
+static TSequence *
+arithop_tnumberseq_number(const TSequence *seq, Datum value,
+  mobdbType basetype, TArithmetic oper, bool invert, mobdbType restype)
+{
+  TSequence *result;
+  if (restype == T_TINT)
+  {
+    int *values = palloc(sizeof(int) * seq->count);
+    int *resvalues = palloc(sizeof(int) * seq->count);
+    tintseq_int_values(seq, values);
+    arithop_int_number_kernel(values, DatumGetInt32(value), resvalues,
+      seq->count, oper, invert);
+    result = tnumberseq_from_values(seq, resvalues, restype, STEP);
+    pfree(values); pfree(resvalues);
+  }
+  else
+  {
+    double *values = palloc(sizeof(double) * seq->count);
+    double *resvalues = palloc(sizeof(double) * seq->count);
+    tnumberseq_float_values(seq, values);
+    arithop_float_number_kernel(values, datum_double(value, basetype),
+      resvalues, seq->count, oper, invert);
+    result = tnumberseq_from_values(seq, resvalues, restype,
+      MOBDB_FLAGS_GET_LINEAR(seq->flags));
+    pfree(values); pfree(resvalues);
+  }
+  return result;
+}
+
+/**
+ * Apply an arithmetic operator to a temporal number and a number when the
+ * temporal number is a sequence or a sequence set
+ */
+static Temporal *
+arithop_tnumber_number_fast(const Temporal *temp, Datum value,
+  mobdbType basetype, TArithmetic oper, bool invert, mobdbType restype)
+{
+  if (temp->subtype == TSEQUENCE)
+    return (Temporal *) arithop_tnumberseq_number((TSequence *) temp, value,
+      basetype, oper, invert, restype);
+
+  /* temp->subtype == TSEQUENCESET */
+  const TSequenceSet *ss = (const TSequenceSet *) temp;
+  TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
+  for (int i = 0; i < ss->count; i++)
+    sequences[i] = arithop_tnumberseq_number(tsequenceset_seq_n(ss, i),
+      value, basetype, oper, invert, restype);
+  return (Temporal *) tsequenceset_make_free(sequences, ss->count, NORMALIZE);
+}
+
+/**
+ * Return true if two temporal sequence numbers have the same interpolation,
+ * the same bounds, and the same timestamps, in which case arithmetic
+ * operators can be applied instant by instant without synchronization
+ */
+static bool
+tnumberseq_same_instants(const TSequence *seq1, const TSequence *seq2)
+{
+  if (seq1->count != seq2->count ||
+      MOBDB_FLAGS_GET_LINEAR(seq1->flags) !=
+        MOBDB_FLAGS_GET_LINEAR(seq2->flags) ||
+      seq1->period.lower_inc != seq2->period.lower_inc ||
+      seq1->period.upper_inc != seq2->period.upper_inc)
+    return false;
+  for (int i = 0; i < seq1->count; i++)
+  {
+    if (tsequence_inst_n(seq1, i)->t != tsequence_inst_n(seq2, i)->t)
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Apply an arithmetic operator to two temporal sequence numbers with the
+ * same instants by a single pass over their arrays of values
+ */
+static TSequence *
+arithop_tnumberseq_tnumberseq(const TSequence *seq1, const TSequence *seq2,
+  TArithmetic oper, mobdbType restype)
+{
+  TSequence *result;
+  if (restype == T_TINT)
+  {
+    int *values1 = palloc(sizeof(int) * seq1->count);
+    int *values2 = palloc(sizeof(int) * seq1->count);
+    int *resvalues = palloc(sizeof(int) * seq1->count);
+    tintseq_int_values(seq1, values1);
+    tintseq_int_values(seq2, values2);
+    arithop_int_int_kernel(values1, values2, resvalues, seq1->count, oper);
+    result = tnumberseq_from_values(seq1, resvalues, restype, STEP);
+    pfree(values1); pfree(values2); pfree(resvalues);
+  }
+  else
+  {
+    double *values1 = palloc(sizeof(double) * seq1->count);
+    double *values2 = palloc(sizeof(double) * seq1->count);
+    double *resvalues = palloc(sizeof(double) * seq1->count);
+    tnumberseq_float_values(seq1, values1);
+    tnumberseq_float_values(seq2, values2);
+    arithop_float_float_kernel(values1, values2, resvalues, seq1->count,
+      oper);
+    result = tnumberseq_from_values(seq1, resvalues, restype,
+      MOBDB_FLAGS_GET_LINEAR(seq1->flags));
+    pfree(values1); pfree(values2); pfree(resvalues);
+  }
+  return result;
+}
+
+/**
+ * Apply an arithmetic operator to two temporal numbers if they are both
+ * sequences or both sequence sets whose composing sequences have the same
+ * instants. Return NULL otherwise, in which case the temporal numbers must
+ * be synchronized.
+ *
+ * @note Multiplication and division of linear sequences may have turning
+ * points between the instants and therefore are not handled here
+ */
+static Temporal *
+arithop_tnumber_tnumber_fast(const Temporal *temp1, const Temporal *temp2,
+  TArithmetic oper, mobdbType restype)
+{
+  if (temp1->subtype != temp2->subtype ||
+      (temp1->subtype != TSEQUENCE && temp1->subtype != TSEQUENCESET) ||
+      ((oper == MULT || oper == DIV) && MOBDB_FLAGS_GET_LINEAR(temp1->flags)))
+    return NULL;
+
+  if (temp1->subtype == TSEQUENCE)
+  {
+    if (! tnumberseq_same_instants((TSequence *) temp1, (TSequence *) temp2))
+      return NULL;
+    return (Temporal *) arithop_tnumberseq_tnumberseq((TSequence *) temp1,
+      (TSequence *) temp2, oper, restype);
+  }
+
+  /* temp1->subtype == TSEQUENCESET */
+  const TSequenceSet *ss1 = (const TSequenceSet *) temp1;
+  const TSequenceSet *ss2 = (const TSequenceSet *) temp2;
+  if (ss1->count != ss2->count || ss1->totalcount != ss2->totalcount)
+    return NULL;
+  for (int i = 0; i < ss1->count; i++)
+  {
+    if (! tnumberseq_same_instants(tsequenceset_seq_n(ss1, i),
+        tsequenceset_seq_n(ss2, i)))
+      return NULL;
+  }
+  TSequence **sequences = palloc(sizeof(TSequence *) * ss1->count);
+  for (int i = 0; i < ss1->count; i++)
+    sequences[i] = arithop_tnumberseq_tnumberseq(tsequenceset_seq_n(ss1, i),
+      tsequenceset_seq_n(ss2, i), oper, restype);
+  return (Temporal *) tsequenceset_make_free(sequences, ss1->count,
+    NORMALIZE);
+}
+
 /*****************************************************************************
  * Generic functions
  *****************************************************************************/
@@ -187,6 +533,13 @@ arithop_tnumber_number(const Temporal *temp, Datum value, mobdbType basetype,
     }
   }
 
+  mobdbType restype = (temp->temptype == T_TINT && basetype == T_INT4) ?
+    T_TINT : T_TFLOAT;
+  /* Sequences are computed directly on their arrays of values */
+  if (temp->subtype == TSEQUENCE || temp->subtype == TSEQUENCESET)
+    return arithop_tnumber_number_fast(temp, value, basetype, oper, invert,
+      restype);
+
   LiftedFunctionInfo lfinfo;
   memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
   lfinfo.func = (varfunc) func;
@@ -194,8 +547,7 @@ arithop_tnumber_number(const Temporal *temp, Datum value, mobdbType basetype,
   lfinfo.args = true;
   lfinfo.argtype[0] = temptype_basetype(temp->temptype);
   lfinfo.argtype[1] = basetype;
-  lfinfo.restype = (temp->temptype == T_TINT && basetype == T_INT4) ?
-    T_TINT : T_TFLOAT;
+  lfinfo.restype = restype;
   /* This parameter is not used for tnumber <op> base */
   lfinfo.reslinear = false;
   lfinfo.invert = invert;
@@ -234,6 +586,14 @@ arithop_tnumber_tnumber(const Temporal *temp1, const Temporal *temp2,
       elog(ERROR, "Division by zero");
   }
 
+  mobdbType restype = (temp1->temptype == T_TINT &&
+    temp2->temptype == T_TINT) ? T_TINT : T_TFLOAT;
+  /* Temporal numbers with the same instants need no synchronization */
+  Temporal *result = arithop_tnumber_tnumber_fast(temp1, temp2, oper,
+    restype);
+  if (result != NULL)
+    return result;
+
   LiftedFunctionInfo lfinfo;
   memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
   lfinfo.func = (varfunc) func;
@@ -241,15 +601,14 @@ arithop_tnumber_tnumber(const Temporal *temp1, const Temporal *temp2,
   lfinfo.args = true;
   lfinfo.argtype[0] = temptype_basetype(temp1->temptype);
   lfinfo.argtype[1] = temptype_basetype(temp2->temptype);
-  lfinfo.restype = (temp1->temptype == T_TINT && temp2->temptype == T_TINT) ?
-    T_TINT : T_TFLOAT;
+  lfinfo.restype = restype;
   lfinfo.reslinear = linear1 || linear2;
   lfinfo.invert = INVERT_NO;
   lfinfo.discont = CONTINUOUS;
   lfinfo.tpfunc_base = NULL;
   lfinfo.tpfunc = (oper == MULT || oper == DIV) && linear1 && linear2 ?
     tpfunc : NULL;
-  Temporal *result = tfunc_temporal_temporal(temp1, temp2, &lfinfo);
+  result = tfunc_temporal_temporal(temp1, temp2, &lfinfo);
   return result;
 }
 
@@ -54,6 +54,7 @@
 #include "general/temporaltypes.h"
 #include "general/temporal_boxops.h"
 #include "general/temporal_parser.h"
+#include "general/temporal_util.h"
 #include "general/timestampset.h"
 #include "point/tpoint_boxops.h"
 #include "point/tpoint_parser.h"
@@ -251,6 +252,180 @@ tsequence_inst_n(const TSequence *seq, int index)
       (tsequence_offsets_ptr(seq))[index]);
 }
 
+/**
+ * Return the number of blocks of a temporal sequence of the given type and
+ * number of instants
+ */
+static int
+tsequence_count_blocks(mobdbType temptype, int count)
+{
+  if (count < TSEQUENCE_BLOCK_MIN ||
+      (! tnumber_type(temptype) && ! tgeo_type(temptype)))
+    return 0;
+  return (count - 2) / TSEQUENCE_BLOCK_SIZE + 1;
+}
+
+/**
+ * @ingroup libmeos_int_temporal_accessor
+ * @brief Return the number of blocks of the block directory of a temporal
+ * sequence, 0 if the sequence has no block directory.
+ *
+ * The block @p b summarizes the segments between the instants
+ * @p b * TSEQUENCE_BLOCK_SIZE and @p (b + 1) * TSEQUENCE_BLOCK_SIZE, or the
+ * last instant, by their bounding box.
+ */
+int
+tsequence_num_blocks(const TSequence *seq)
+{
+  if (! MOBDB_FLAGS_GET_BLOCKS(seq->flags))
+    return 0;
+  return tsequence_count_blocks(seq->temptype, seq->count);
+}
+
+/**
+ * @ingroup libmeos_int_temporal_accessor
+ * @brief Return the bounding box of the n-th block of a temporal sequence.
+ * @note The block directory is stored after the composing instants
+ */
+const void *
+tsequence_block_bbox(const TSequence *seq, int b)
+{
+  int nblocks = tsequence_num_blocks(seq);
+  assert(b >= 0 && b < nblocks);
+  return ((char *) seq) + VARSIZE(seq) - (nblocks - b) * seq->bboxsize;
+}
+
+/**
+ * @ingroup libmeos_int_temporal_accessor
+ * @brief Set the numbers of the first and last instants of the n-th block
+ * of a temporal sequence.
+ */
+void
+tsequence_block_range(const TSequence *seq, int b, int *first, int *last)
+{
+  *first = b * TSEQUENCE_BLOCK_SIZE;
+  *last = Min(*first + TSEQUENCE_BLOCK_SIZE, seq->count - 1);
+  return;
+}
+
+/**
+ * @ingroup libmeos_int_temporal_accessor
+ * @brief Return true if the value dimension of the n-th block of a temporal
+ * sequence overlaps the one of a box, that is, a TBOX for temporal numbers
+ * and an STBOX for temporal points.
+ * @note The time dimension and the SRID of the block boxes are not tested
+ * since they are not maintained when the sequence is shifted or its SRID is
+ * set
+ */
+bool
+tsequence_block_overlaps(const TSequence *seq, int b, const void *box)
+{
+  if (tnumber_type(seq->temptype))
+  {
+    const TBOX *box1 = (const TBOX *) tsequence_block_bbox(seq, b);
+    const TBOX *box2 = (const TBOX *) box;
+    return DatumGetFloat8(box1->span.lower) <=
+        DatumGetFloat8(box2->span.upper) &&
+      DatumGetFloat8(box2->span.lower) <= DatumGetFloat8(box1->span.upper);
+  }
+  const STBOX *box1 = (const STBOX *) tsequence_block_bbox(seq, b);
+  const STBOX *box2 = (const STBOX *) box;
+  if (box1->xmax < box2->xmin || box2->xmax < box1->xmin ||
+      box1->ymax < box2->ymin || box2->ymax < box1->ymin)
+    return false;
+  /* Geodetic boxes always have Z coordinates */
+  if ((MOBDB_FLAGS_GET_Z(box1->flags) ||
+        MOBDB_FLAGS_GET_GEODETIC(box1->flags)) &&
+      (MOBDB_FLAGS_GET_Z(box2->flags) ||
+        MOBDB_FLAGS_GET_GEODETIC(box2->flags)) &&
+      (box1->zmax < box2->zmin || box2->zmax < box1->zmin))
+    return false;
+  return true;
+}
+
+/**
+ * @ingroup libmeos_int_temporal_accessor
+ * @brief Return the time covered by the runs of consecutive blocks of a
+ * temporal sequence whose bounding box overlaps the value dimension of a box,
+ * or NULL if no block overlaps the box.
+ *
+ * Restricting the sequence to the result before the segment-level work of a
+ * restriction function avoids examining the segments that cannot satisfy it.
+ * @pre The sequence has a block directory
+ */
+PeriodSet *
+tsequence_blocks_time(const TSequence *seq, const void *box)
+{
+  int nblocks = tsequence_num_blocks(seq);
+  assert(nblocks > 0);
+  Period *periods = palloc(sizeof(Period) * nblocks);
+  const Period **ptrs = palloc(sizeof(Period *) * nblocks);
+  int k = 0, run = -1, first, last;
+  for (int b = 0; b <= nblocks; b++)
+  {
+    if (b < nblocks && tsequence_block_overlaps(seq, b, box))
+    {
+      if (run < 0)
+        run = b;
+      continue;
+    }
+    if (run < 0)
+      continue;
+    /* Add the period of the run of blocks ending in the previous block */
+    tsequence_block_range(seq, run, &first, &last);
+    int first1 = first;
+    tsequence_block_range(seq, b - 1, &first, &last);
+    span_set(TimestampTzGetDatum(tsequence_inst_n(seq, first1)->t),
+      TimestampTzGetDatum(tsequence_inst_n(seq, last)->t),
+      (first1 == 0) ? seq->period.lower_inc : true,
+      (last == seq->count - 1) ? seq->period.upper_inc : true,
+      T_TIMESTAMPTZ, &periods[k]);
+    ptrs[k] = &periods[k];
+    k++;
+    run = -1;
+  }
+  PeriodSet *result = (k == 0) ? NULL :
+    periodset_make(ptrs, k, NORMALIZE_NO);
+  pfree(periods); pfree(ptrs);
+  return result;
+}
+
+/**
+ * Compute the block directory of a temporal sequence from its instants
+ */
+static void
+tsequence_compute_blocks(TSequence *seq, const TInstant **instants)
+{
+  int nblocks = tsequence_num_blocks(seq);
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  for (int b = 0; b < nblocks; b++)
+  {
+    int first, last;
+    tsequence_block_range(seq, b, &first, &last);
+    tsequence_compute_bbox(&instants[first], last - first + 1, true, true,
+      linear, (void *) tsequence_block_bbox(seq, b));
+  }
+  return;
+}
+
+/**
+ * @brief Recompute the bounding box and the block directory of a temporal
+ * sequence whose values have been modified in place.
+ */
+void
+tsequence_recompute_bbox(TSequence *seq)
+{
+  int count;
+  const TInstant **instants = tsequence_instants(seq, &count);
+  tsequence_compute_bbox(instants, count, seq->period.lower_inc,
+    seq->period.upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags),
+    TSEQUENCE_BBOX_PTR(seq));
+  if (MOBDB_FLAGS_GET_BLOCKS(seq->flags))
+    tsequence_compute_blocks(seq, instants);
+  pfree(instants);
+  return;
+}
+
 /**
  * Ensure the validity of the arguments when creating a temporal sequence
  */
@@ -360,7 +535,16 @@ tinstarr_normalize(const TInstant **instants, bool linear, int count,
  * -------------------------------------
  * @endcode
  * where the `X` are unused bytes added for double padding, `offset_0` and
- * `offset_1` are offsets for the corresponding instants
+ * `offset_1` are offsets for the corresponding instants.
+ *
+ * Temporal numbers and temporal points with at least TSEQUENCE_BLOCK_MIN
+ * instants are followed by a block directory, which keeps the bounding box
+ * of every TSEQUENCE_BLOCK_SIZE segments
+ * @code
+ * ---------------------------------------------------
+ * ... | ( TInstant_n )_X | ( bbox_0 )_X | ( bbox_1 )_X | ...
+ * ---------------------------------------------------
+ * @endcode
  *
  * @pre The validity of the arguments has been tested before
  */
@@ -386,6 +570,10 @@ tsequence_make1(const TInstant **instants, int count, bool lower_inc,
     memsize += double_pad(VARSIZE(norminsts[i]));
   /* Size of the struct and the offset array */
   memsize += double_pad(sizeof(TSequence)) + newcount * sizeof(size_t);
+  /* Size of the block directory */
+  int nblocks = (bboxsize == 0) ? 0 :
+    tsequence_count_blocks(instants[0]->temptype, newcount);
+  memsize += nblocks * bboxsize;
   /* Create the temporal sequence */
   TSequence *result = palloc0(memsize);
   SET_VARSIZE(result, memsize);
@@ -433,6 +621,12 @@ tsequence_make1(const TInstant **instants, int count, bool lower_inc,
     (tsequence_offsets_ptr(result))[i] = pos;
     pos += double_pad(VARSIZE(norminsts[i]));
   }
+  /* Compute the block directory */
+  if (nblocks > 0)
+  {
+    MOBDB_FLAGS_SET_BLOCKS(result->flags, true);
+    tsequence_compute_blocks(result, (const TInstant **) norminsts);
+  }
   if (normalize && count > 1)
     pfree(norminsts);
   return result;
@@ -1492,6 +1686,94 @@ tsequence_copy(const TSequence *seq)
   return result;
 }
 
+/**
+ * @ingroup libmeos_int_temporal_transf
+ * @brief Compact in place a temporal sequence keeping only some of its
+ * instants.
+ *
+ * The instants kept are shifted towards the beginning of the sequence and
+ * the bounding box and the block directory are recomputed from them. The
+ * size of the sequence is reduced accordingly but its memory is not
+ * reallocated.
+ *
+ * @param[in,out] seq Temporal sequence owned by the caller
+ * @param[in] keep Positions of the instants kept in increasing order
+ * @param[in] count Number of elements in the array
+ * @param[in] lower_inc,upper_inc True when the bounds of the result are
+ * inclusive
+ * @param[in] normalize True when the result must be normalized
+ * @pre The instants kept define a valid sequence with the given bounds
+ */
+void
+tsequence_compact(TSequence *seq, const int *keep, int count, bool lower_inc,
+  bool upper_inc, bool normalize)
+{
+  assert(count > 0 && count <= seq->count);
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  size_t *offsets = tsequence_offsets_ptr(seq);
+  char *olddata = ((char *) offsets) + seq->count * sizeof(size_t);
+  /* Keep the offsets of the instants kept, keep[i] >= i */
+  for (int i = 0; i < count; i++)
+    offsets[i] = offsets[keep[i]];
+  /* Shift the instants kept, the new position of an instant is never after
+   * its old one nor after the old position of the next instants */
+  char *newdata = ((char *) offsets) + count * sizeof(size_t);
+  size_t pos = 0;
+  for (int i = 0; i < count; i++)
+  {
+    const TInstant *inst = (const TInstant *) (olddata + offsets[i]);
+    size_t size = VARSIZE(inst);
+    memmove(newdata + pos, inst, size);
+    offsets[i] = pos;
+    pos += double_pad(size);
+  }
+  seq->count = count;
+
+  const TInstant **instants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+    instants[i] = tsequence_inst_n(seq, i);
+  if (normalize && count > 2)
+  {
+    int newcount;
+    TInstant **norminsts = tinstarr_normalize(instants, linear, count,
+      &newcount);
+    if (newcount < count)
+    {
+      /* The normalized instants are a subset of the instants */
+      int *keep2 = palloc(sizeof(int) * newcount);
+      int j = 0;
+      for (int i = 0; i < count && j < newcount; i++)
+      {
+        if (instants[i] == norminsts[j])
+          keep2[j++] = i;
+      }
+      pfree(norminsts); pfree(instants);
+      tsequence_compact(seq, keep2, newcount, lower_inc, upper_inc, false);
+      pfree(keep2);
+      return;
+    }
+    pfree(norminsts);
+  }
+
+  /* Recompute the bounding box */
+  if (seq->bboxsize != 0)
+    tsequence_compute_bbox(instants, count, lower_inc, upper_inc, linear,
+      TSEQUENCE_BBOX_PTR(seq));
+  else
+    span_set(TimestampTzGetDatum(instants[0]->t),
+      TimestampTzGetDatum(instants[count - 1]->t), lower_inc, upper_inc,
+      T_TIMESTAMPTZ, &seq->period);
+  /* Recompute the block directory after the instants */
+  int nblocks = (seq->bboxsize == 0) ? 0 :
+    tsequence_count_blocks(seq->temptype, count);
+  SET_VARSIZE(seq, (newdata - (char *) seq) + pos + nblocks * seq->bboxsize);
+  MOBDB_FLAGS_SET_BLOCKS(seq->flags, nblocks > 0);
+  if (nblocks > 0)
+    tsequence_compute_blocks(seq, instants);
+  pfree(instants);
+  return;
+}
+
 /*****************************************************************************/
 
 /**
@@ -1726,6 +2008,8 @@ tfloatseq_to_tintseq(const TSequence *seq)
     inst->temptype = T_TINT;
     inst->value = Int32GetDatum((double)DatumGetFloat8(tinstant_value(inst)));
   }
+  /* The conversion truncates the values of the bounding boxes */
+  tsequence_recompute_bbox(result);
   return result;
 }
 
@@ -2460,25 +2744,20 @@ tsequence_value_at_timestamp(const TSequence *seq, TimestampTz t, bool strict,
  *****************************************************************************/
 
 /**
- * @ingroup libmeos_int_temporal_ever
- * @brief Return true if a temporal sequence is ever equal to a base value.
- * @sqlop @p ?=
+ * Return true if a temporal sequence restricted to the instants between two
+ * positions is ever equal to a base value
  */
-bool
-tsequence_ever_eq(const TSequence *seq, Datum value)
+static bool
+tsequence_ever_eq1(const TSequence *seq, int from, int to, Datum value)
 {
   int i;
   Datum value1;
   mobdbType basetype = temptype_basetype(seq->temptype);
 
-  /* Bounding box test */
-  if (! temporal_bbox_ev_al_eq((Temporal *) seq, value, EVER))
-    return false;
-
   /* Stepwise interpolation or instantaneous sequence */
   if (! MOBDB_FLAGS_GET_LINEAR(seq->flags) || seq->count == 1)
   {
-    for (i = 0; i < seq->count; i++)
+    for (i = from; i <= to; i++)
     {
       value1 = tinstant_value(tsequence_inst_n(seq, i));
       if (datum_eq(value1, value, basetype))
@@ -2488,10 +2767,10 @@ tsequence_ever_eq(const TSequence *seq, Datum value)
   }
 
   /* Linear interpolation*/
-  const TInstant *inst1 = tsequence_inst_n(seq, 0);
+  const TInstant *inst1 = tsequence_inst_n(seq, from);
   value1 = tinstant_value(inst1);
-  bool lower_inc = seq->period.lower_inc;
-  for (i = 1; i < seq->count; i++)
+  bool lower_inc = (from == 0) ? seq->period.lower_inc : true;
+  for (i = from + 1; i <= to; i++)
   {
     const TInstant *inst2 = tsequence_inst_n(seq, i);
     Datum value2 = tinstant_value(inst2);
@@ -2520,6 +2799,55 @@ tsequence_ever_eq(const TSequence *seq, Datum value)
   return false;
 }
 
+/**
+ * Set the box of a base value that is compared against the block directory
+ * of a temporal sequence and return a pointer to it, that is, a TBOX for
+ * temporal numbers and an STBOX for temporal points.
+ */
+static void *
+tsequence_value_box(const TSequence *seq, Datum value, TBOX *tbox,
+  STBOX *stbox)
+{
+  if (tnumber_type(seq->temptype))
+  {
+    number_set_tbox(value, temptype_basetype(seq->temptype), tbox);
+    return tbox;
+  }
+  geo_set_stbox(DatumGetGserializedP(value), stbox);
+  return stbox;
+}
+
+/**
+ * @ingroup libmeos_int_temporal_ever
+ * @brief Return true if a temporal sequence is ever equal to a base value.
+ * @note Only the blocks whose bounding box contains the value are scanned
+ * @sqlop @p ?=
+ */
+bool
+tsequence_ever_eq(const TSequence *seq, Datum value)
+{
+  /* Bounding box test */
+  if (! temporal_bbox_ev_al_eq((Temporal *) seq, value, EVER))
+    return false;
+
+  int nblocks = tsequence_num_blocks(seq);
+  if (nblocks == 0)
+    return tsequence_ever_eq1(seq, 0, seq->count - 1, value);
+
+  TBOX tbox;
+  STBOX stbox;
+  void *box = tsequence_value_box(seq, value, &tbox, &stbox);
+  for (int b = 0; b < nblocks; b++)
+  {
+    int first, last;
+    tsequence_block_range(seq, b, &first, &last);
+    if (tsequence_block_overlaps(seq, b, box) &&
+        tsequence_ever_eq1(seq, first, last, value))
+      return true;
+  }
+  return false;
+}
+
 /**
  * @ingroup libmeos_int_temporal_ever
  * @brief Return true if a temporal sequence is always equal to a base value.
@@ -2592,7 +2920,7 @@ tlinearseq_always_lt1(Datum value1, Datum value2, mobdbType basetype,
 {
   /* Constant segment */
   if (datum_eq(value1, value2, basetype))
-    return datum_lt(value1, value1, basetype);
+    return datum_lt(value1, value, basetype);
   /* Increasing segment */
   if (datum_lt(value1, value2, basetype))
     return datum_lt(value2, value, basetype) ||
@@ -2605,19 +2933,28 @@ tlinearseq_always_lt1(Datum value1, Datum value2, mobdbType basetype,
 /*****************************************************************************/
 
 /**
- * @ingroup libmeos_int_temporal_ever
- * @brief Return true if a temporal sequence is ever less than a base value.
- * @sqlop @p ?<
+ * Return the minimum and maximum values of the n-th block of a temporal
+ * sequence number
  */
-bool
-tsequence_ever_lt(const TSequence *seq, Datum value)
+static void
+tnumberseq_block_minmax(const TSequence *seq, int b, double *min,
+  double *max)
 {
-  /* Bounding box test */
-  if (! temporal_bbox_ev_al_lt_le((Temporal *) seq, value, EVER))
-    return false;
+  const TBOX *box = (const TBOX *) tsequence_block_bbox(seq, b);
+  *min = DatumGetFloat8(box->span.lower);
+  *max = DatumGetFloat8(box->span.upper);
+  return;
+}
 
+/**
+ * Return true if a temporal sequence restricted to the instants between two
+ * positions is ever less than a base value
+ */
+static bool
+tsequence_ever_lt1(const TSequence *seq, int from, int to, Datum value)
+{
   mobdbType basetype = temptype_basetype(seq->temptype);
-  for (int i = 0; i < seq->count; i++)
+  for (int i = from; i <= to; i++)
   {
     Datum valueinst = tinstant_value(tsequence_inst_n(seq, i));
     if (datum_lt(valueinst, value, basetype))
@@ -2628,17 +2965,42 @@ tsequence_ever_lt(const TSequence *seq, Datum value)
 
 /**
  * @ingroup libmeos_int_temporal_ever
- * @brief Return true if a temporal sequence is ever less than or equal to a
- * base value
- * @sqlop @p ?<=
+ * @brief Return true if a temporal sequence is ever less than a base value.
+ * @note Only the blocks whose minimum value is less than the value are
+ * scanned
+ * @sqlop @p ?<
  */
 bool
-tsequence_ever_le(const TSequence *seq, Datum value)
+tsequence_ever_lt(const TSequence *seq, Datum value)
 {
   /* Bounding box test */
   if (! temporal_bbox_ev_al_lt_le((Temporal *) seq, value, EVER))
     return false;
 
+  int nblocks = tnumber_type(seq->temptype) ? tsequence_num_blocks(seq) : 0;
+  if (nblocks == 0)
+    return tsequence_ever_lt1(seq, 0, seq->count - 1, value);
+
+  double d = datum_double(value, temptype_basetype(seq->temptype));
+  for (int b = 0; b < nblocks; b++)
+  {
+    int first, last;
+    double min, max;
+    tsequence_block_range(seq, b, &first, &last);
+    tnumberseq_block_minmax(seq, b, &min, &max);
+    if (min < d && tsequence_ever_lt1(seq, first, last, value))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * Return true if a temporal sequence restricted to the instants between two
+ * positions is ever less than or equal to a base value
+ */
+static bool
+tsequence_ever_le1(const TSequence *seq, int from, int to, Datum value)
+{
   Datum value1;
   int i;
   mobdbType basetype = temptype_basetype(seq->temptype);
@@ -2646,7 +3008,7 @@ tsequence_ever_le(const TSequence *seq, Datum value)
   /* Stepwise interpolation or instantaneous sequence */
   if (! MOBDB_FLAGS_GET_LINEAR(seq->flags) || seq->count == 1)
   {
-    for (i = 0; i < seq->count; i++)
+    for (i = from; i <= to; i++)
     {
       value1 = tinstant_value(tsequence_inst_n(seq, i));
       if (datum_le(value1, value, basetype))
@@ -2656,9 +3018,9 @@ tsequence_ever_le(const TSequence *seq, Datum value)
   }
 
   /* Linear interpolation */
-  value1 = tinstant_value(tsequence_inst_n(seq, 0));
-  bool lower_inc = seq->period.lower_inc;
-  for (i = 1; i < seq->count; i++)
+  value1 = tinstant_value(tsequence_inst_n(seq, from));
+  bool lower_inc = (from == 0) ? seq->period.lower_inc : true;
+  for (i = from + 1; i <= to; i++)
   {
     Datum value2 = tinstant_value(tsequence_inst_n(seq, i));
     bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
@@ -2673,16 +3035,43 @@ tsequence_ever_le(const TSequence *seq, Datum value)
 
 /**
  * @ingroup libmeos_int_temporal_ever
- * @brief Return true if a temporal sequence is always less than a base value.
- * @sqlop @p %<
+ * @brief Return true if a temporal sequence is ever less than or equal to a
+ * base value
+ * @note Only the blocks whose minimum value is less than or equal to the
+ * value are scanned
+ * @sqlop @p ?<=
  */
 bool
-tsequence_always_lt(const TSequence *seq, Datum value)
+tsequence_ever_le(const TSequence *seq, Datum value)
 {
   /* Bounding box test */
-  if (! temporal_bbox_ev_al_lt_le((Temporal *) seq, value, ALWAYS))
+  if (! temporal_bbox_ev_al_lt_le((Temporal *) seq, value, EVER))
     return false;
 
+  int nblocks = tnumber_type(seq->temptype) ? tsequence_num_blocks(seq) : 0;
+  if (nblocks == 0)
+    return tsequence_ever_le1(seq, 0, seq->count - 1, value);
+
+  double d = datum_double(value, temptype_basetype(seq->temptype));
+  for (int b = 0; b < nblocks; b++)
+  {
+    int first, last;
+    double min, max;
+    tsequence_block_range(seq, b, &first, &last);
+    tnumberseq_block_minmax(seq, b, &min, &max);
+    if (min <= d && tsequence_ever_le1(seq, first, last, value))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * Return true if a temporal sequence restricted to the instants between two
+ * positions is always less than a base value
+ */
+static bool
+tsequence_always_lt1(const TSequence *seq, int from, int to, Datum value)
+{
   Datum value1;
   int i;
   mobdbType basetype = temptype_basetype(seq->temptype);
@@ -2690,7 +3079,7 @@ tsequence_always_lt(const TSequence *seq, Datum value)
   /* Stepwise interpolation or instantaneous sequence */
   if (! MOBDB_FLAGS_GET_LINEAR(seq->flags) || seq->count == 1)
   {
-    for (i = 0; i < seq->count; i++)
+    for (i = from; i <= to; i++)
     {
       value1 = tinstant_value(tsequence_inst_n(seq, i));
       if (! datum_lt(value1, value, basetype))
@@ -2700,9 +3089,9 @@ tsequence_always_lt(const TSequence *seq, Datum value)
   }
 
   /* Linear interpolation */
-  value1 = tinstant_value(tsequence_inst_n(seq, 0));
-  bool lower_inc = seq->period.lower_inc;
-  for (i = 1; i < seq->count; i++)
+  value1 = tinstant_value(tsequence_inst_n(seq, from));
+  bool lower_inc = (from == 0) ? seq->period.lower_inc : true;
+  for (i = from + 1; i <= to; i++)
   {
     Datum value2 = tinstant_value(tsequence_inst_n(seq, i));
     bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
@@ -2715,6 +3104,37 @@ tsequence_always_lt(const TSequence *seq, Datum value)
   return true;
 }
 
+/**
+ * @ingroup libmeos_int_temporal_ever
+ * @brief Return true if a temporal sequence is always less than a base value.
+ * @note The blocks whose maximum value is less than the value are not
+ * scanned
+ * @sqlop @p %<
+ */
+bool
+tsequence_always_lt(const TSequence *seq, Datum value)
+{
+  /* Bounding box test */
+  if (! temporal_bbox_ev_al_lt_le((Temporal *) seq, value, ALWAYS))
+    return false;
+
+  int nblocks = tnumber_type(seq->temptype) ? tsequence_num_blocks(seq) : 0;
+  if (nblocks == 0)
+    return tsequence_always_lt1(seq, 0, seq->count - 1, value);
+
+  double d = datum_double(value, temptype_basetype(seq->temptype));
+  for (int b = 0; b < nblocks; b++)
+  {
+    int first, last;
+    double min, max;
+    tsequence_block_range(seq, b, &first, &last);
+    tnumberseq_block_minmax(seq, b, &min, &max);
+    if (max >= d && ! tsequence_always_lt1(seq, first, last, value))
+      return false;
+  }
+  return true;
+}
+
 /**
  * @ingroup libmeos_int_temporal_ever
  * @brief Return true if a temporal sequence is always less than or equal to a
@@ -2751,6 +3171,25 @@ tsequence_always_le(const TSequence *seq, Datum value)
  * Restriction Functions
  *****************************************************************************/
 
+/**
+ * Return the subsequence of a temporal sequence between the instants
+ * @p first and @p last, which is used for copying a run of blocks that are
+ * not affected by a minus restriction to the result.
+ * @note The upper bound is exclusive unless @p last is the last instant of
+ * the sequence since the segment starting at @p last is processed separately
+ */
+static TSequence *
+tsequence_blocks_subseq(const TSequence *seq, int first, int last)
+{
+  Period p;
+  span_set(TimestampTzGetDatum(tsequence_inst_n(seq, first)->t),
+    TimestampTzGetDatum(tsequence_inst_n(seq, last)->t),
+    (first == 0) ? seq->period.lower_inc : true,
+    (last == seq->count - 1) ? seq->period.upper_inc : false,
+    T_TIMESTAMPTZ, &p);
+  return tsequence_at_period(seq, &p);
+}
+
 /**
  * Restrict a segment of a temporal sequence to (the complement of) a base
  * value.
@@ -2884,6 +3323,31 @@ tsegment_restrict_value(const TInstant *inst1, const TInstant *inst2,
   }
 }
 
+/**
+ * Restrict the segments of a temporal sequence between the instants
+ * @p from and @p to to (the complement of) a base value
+ */
+static int
+tsequence_restrict_value2(const TSequence *seq, int from, int to,
+  Datum value, bool atfunc, TSequence **result)
+{
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  const TInstant *inst1 = tsequence_inst_n(seq, from);
+  bool lower_inc = (from == 0) ? seq->period.lower_inc : true;
+  int k = 0;
+  for (int i = from + 1; i <= to; i++)
+  {
+    const TInstant *inst2 = tsequence_inst_n(seq, i);
+    bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
+    /* Each iteration adds between 0 and 2 sequences */
+    k += tsegment_restrict_value(inst1, inst2, linear, lower_inc, upper_inc,
+      value, atfunc, &result[k]);
+    inst1 = inst2;
+    lower_inc = true;
+  }
+  return k;
+}
+
 /**
  * Restrict a temporal sequence to (the complement of) a base value
  *
@@ -2928,20 +3392,35 @@ tsequence_restrict_value1(const TSequence *seq, Datum value, bool atfunc,
   }
 
   /* General case */
-  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
-  inst1 = tsequence_inst_n(seq, 0);
-  bool lower_inc = seq->period.lower_inc;
-  int k = 0;
-  for (int i = 1; i < seq->count; i++)
+  int nblocks = tsequence_num_blocks(seq);
+  if (nblocks == 0)
+    return tsequence_restrict_value2(seq, 0, seq->count - 1, value, atfunc,
+      result);
+
+  /* Skip the blocks whose bounding box does not contain the value, for the
+   * minus function they are copied as a whole to the result */
+  TBOX tbox;
+  STBOX stbox;
+  void *box = tsequence_value_box(seq, value, &tbox, &stbox);
+  int k = 0, skip = -1;
+  for (int b = 0; b < nblocks; b++)
   {
-    const TInstant *inst2 = tsequence_inst_n(seq, i);
-    bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-    /* Each iteration adds between 0 and 2 sequences */
-    k += tsegment_restrict_value(inst1, inst2, linear, lower_inc, upper_inc,
-      value, atfunc, &result[k]);
-    inst1 = inst2;
-    lower_inc = true;
+    int first, last;
+    tsequence_block_range(seq, b, &first, &last);
+    if (! tsequence_block_overlaps(seq, b, box))
+    {
+      if (skip < 0)
+        skip = first;
+      continue;
+    }
+    if (skip >= 0 && ! atfunc)
+      result[k++] = tsequence_blocks_subseq(seq, skip, first);
+    skip = -1;
+    k += tsequence_restrict_value2(seq, first, last, value, atfunc,
+      &result[k]);
   }
+  if (skip >= 0 && ! atfunc)
+    result[k++] = tsequence_blocks_subseq(seq, skip, seq->count - 1);
   return k;
 }
 
@@ -3010,20 +3489,38 @@ tsequence_at_values1(const TSequence *seq, const Datum *values, int count,
     return 0;
 
   /* General case */
+  int nblocks = tsequence_num_blocks(seq);
   bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
-  inst1 = tsequence_inst_n(seq, 0);
-  bool lower_inc = seq->period.lower_inc;
   int k = 0;
-  for (int i = 1; i < seq->count; i++)
+  for (int b = 0; b < Max(nblocks, 1); b++)
   {
-    inst2 = tsequence_inst_n(seq, i);
-    bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-    for (int j = 0; j < count1; j++)
-      /* Each iteration adds between 0 and 2 sequences */
-      k += tsegment_restrict_value(inst1, inst2, linear, lower_inc,
-        upper_inc, values1[j], REST_AT, &result[k]);
-    inst1 = inst2;
-    lower_inc = true;
+    int first = 0, last = seq->count - 1;
+    if (nblocks > 0)
+    {
+      /* Skip the blocks whose bounding box does not contain any value */
+      tsequence_block_range(seq, b, &first, &last);
+      TBOX tbox;
+      STBOX stbox;
+      bool found = false;
+      for (int j = 0; j < count1 && ! found; j++)
+        found = tsequence_block_overlaps(seq, b,
+          tsequence_value_box(seq, values1[j], &tbox, &stbox));
+      if (! found)
+        continue;
+    }
+    inst1 = tsequence_inst_n(seq, first);
+    bool lower_inc = (first == 0) ? seq->period.lower_inc : true;
+    for (int i = first + 1; i <= last; i++)
+    {
+      inst2 = tsequence_inst_n(seq, i);
+      bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
+      for (int j = 0; j < count1; j++)
+        /* Each iteration adds between 0 and 2 sequences */
+        k += tsegment_restrict_value(inst1, inst2, linear, lower_inc,
+          upper_inc, values1[j], REST_AT, &result[k]);
+      inst1 = inst2;
+      lower_inc = true;
+    }
   }
   if (k > 1)
     tseqarr_sort(result, k);
@@ -3325,6 +3822,30 @@ tnumberseq_restrict_span1(const TInstant *inst1, const TInstant *inst2,
   return k;
 }
 
+/**
+ * Restrict the segments of a temporal number between the instants @p from
+ * and @p to to (the complement of) a span
+ */
+static int
+tnumberseq_restrict_span3(const TSequence *seq, int from, int to,
+  const Span *span, bool atfunc, TSequence **result)
+{
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  const TInstant *inst1 = tsequence_inst_n(seq, from);
+  bool lower_inc = (from == 0) ? seq->period.lower_inc : true;
+  int k = 0;
+  for (int i = from + 1; i <= to; i++)
+  {
+    const TInstant *inst2 = tsequence_inst_n(seq, i);
+    bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
+    k += tnumberseq_restrict_span1(inst1, inst2, linear, lower_inc, upper_inc,
+      span, atfunc, &result[k]);
+    inst1 = inst2;
+    lower_inc = true;
+  }
+  return k;
+}
+
 /**
  * Restrict a temporal number to (the complement of) a span
  *
@@ -3355,7 +3876,7 @@ tnumberseq_restrict_span2(const TSequence *seq, const Span *span, bool atfunc,
     }
   }
 
-  const TInstant *inst1, *inst2;
+  const TInstant *inst1;
 
   /* Instantaneous sequence */
   if (seq->count == 1)
@@ -3372,19 +3893,32 @@ tnumberseq_restrict_span2(const TSequence *seq, const Span *span, bool atfunc,
   }
 
   /* General case */
-  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
-  inst1 = tsequence_inst_n(seq, 0);
-  bool lower_inc = seq->period.lower_inc;
-  int k = 0;
-  for (int i = 1; i < seq->count; i++)
+  int nblocks = tsequence_num_blocks(seq);
+  if (nblocks == 0)
+    return tnumberseq_restrict_span3(seq, 0, seq->count - 1, span, atfunc,
+      result);
+
+  /* Skip the blocks whose bounding box does not overlap the span, for the
+   * minus function they are copied as a whole to the result */
+  int k = 0, skip = -1;
+  for (int b = 0; b < nblocks; b++)
   {
-    inst2 = tsequence_inst_n(seq, i);
-    bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-    k += tnumberseq_restrict_span1(inst1, inst2, linear, lower_inc, upper_inc,
-      span, atfunc, &result[k]);
-    inst1 = inst2;
-    lower_inc = true;
+    int first, last;
+    tsequence_block_range(seq, b, &first, &last);
+    if (! tsequence_block_overlaps(seq, b, &box2))
+    {
+      if (skip < 0)
+        skip = first;
+      continue;
+    }
+    if (skip >= 0 && ! atfunc)
+      result[k++] = tsequence_blocks_subseq(seq, skip, first);
+    skip = -1;
+    k += tnumberseq_restrict_span3(seq, first, last, span, atfunc,
+      &result[k]);
   }
+  if (skip >= 0 && ! atfunc)
+    result[k++] = tsequence_blocks_subseq(seq, skip, seq->count - 1);
   return k;
 }
 
@@ -3480,20 +4014,40 @@ tnumberseq_restrict_spans1(const TSequence *seq, Span **normspans,
   if (atfunc)
   {
     /* AT function */
-    inst1 = tsequence_inst_n(seq, 0);
-    bool lower_inc = seq->period.lower_inc;
+    int nblocks = tsequence_num_blocks(seq);
     int k = 0;
-    for (int i = 1; i < seq->count; i++)
+    for (int b = 0; b < Max(nblocks, 1); b++)
     {
-      inst2 = tsequence_inst_n(seq, i);
-      bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-      for (int j = 0; j < newcount; j++)
+      int first = 0, last = seq->count - 1;
+      if (nblocks > 0)
       {
-        k += tnumberseq_restrict_span1(inst1, inst2, linear, lower_inc,
-          upper_inc, newspans[j], REST_AT, &result[k]);
+        /* Skip the blocks whose bounding box does not overlap any span */
+        tsequence_block_range(seq, b, &first, &last);
+        TBOX box;
+        bool found = false;
+        for (int j = 0; j < newcount && ! found; j++)
+        {
+          span_set_tbox(newspans[j], &box);
+          found = tsequence_block_overlaps(seq, b, &box);
+        }
+        if (! found)
+          continue;
+      }
+      inst1 = tsequence_inst_n(seq, first);
+      bool lower_inc = (first == 0) ? seq->period.lower_inc : true;
+      for (int i = first + 1; i <= last; i++)
+      {
+        inst2 = tsequence_inst_n(seq, i);
+        bool upper_inc = (i == seq->count - 1) ?
+          seq->period.upper_inc : false;
+        for (int j = 0; j < newcount; j++)
+        {
+          k += tnumberseq_restrict_span1(inst1, inst2, linear, lower_inc,
+            upper_inc, newspans[j], REST_AT, &result[k]);
+        }
+        inst1 = inst2;
+        lower_inc = true;
       }
-      inst1 = inst2;
-      lower_inc = true;
     }
     if (bboxtest)
       pfree(newspans);
@@ -4265,35 +4819,115 @@ tsequence_intersects_periodset(const TSequence *seq, const PeriodSet *ps)
  * Local aggregate functions
  *****************************************************************************/
 
+/** Number of instants gathered into dense arrays by the integral */
+#define TNUMBERSEQ_BLOCK 256
+/** Minimum number of segments for which the kernels use partial sums */
+#define TNUMBERSEQ_LANES_MIN 32
+
+/**
+ * Gather the values of consecutive instants of a temporal sequence number
+ * and the durations of the segments between them into dense arrays
+ */
+static void
+tnumberseq_gather(const TSequence *seq, int from, int count, double *values,
+  double *durations)
+{
+  const TInstant *inst = tsequence_inst_n(seq, from);
+  TimestampTz t = inst->t;
+  bool isfloat = (seq->temptype == T_TFLOAT);
+  for (int i = 0; i < count; i++)
+  {
+    if (i > 0)
+    {
+      inst = tsequence_inst_n(seq, from + i);
+      durations[i - 1] = (double) (inst->t - t);
+      t = inst->t;
+    }
+    values[i] = isfloat ? DatumGetFloat8(inst->value) :
+      (double) DatumGetInt32(inst->value);
+  }
+  return;
+}
+
+/**
+ * Return twice the integral of segments with linear interpolation, i.e., the
+ * sum of the trapezoids without halving them
+ *
+ * @note Long arrays are summed in four independent partial sums, which the
+ * compiler maps to vector registers
+ */
+MOBDB_SIMD_CLONES
+static double
+integral_linear_kernel(const double *values, const double *durations,
+  int count)
+{
+  double result = 0;
+  int i = 0;
+  if (count >= TNUMBERSEQ_LANES_MIN)
+  {
+    double sum[4] = {0, 0, 0, 0};
+    for (; i + 4 <= count; i += 4)
+    {
+      for (int j = 0; j < 4; j++)
+        sum[j] += (values[i + j] + values[i + j + 1]) * durations[i + j];
+    }
+    result = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+  }
+  for (; i < count; i++)
+    result += (values[i] + values[i + 1]) * durations[i];
+  return result;
+}
+
+/**
+ * Return the integral of segments with step interpolation
+ *
+ * @note Long arrays are summed in four independent partial sums, which the
+ * compiler maps to vector registers
+ */
+MOBDB_SIMD_CLONES
+static double
+integral_step_kernel(const double *values, const double *durations,
+  int count)
+{
+  double result = 0;
+  int i = 0;
+  if (count >= TNUMBERSEQ_LANES_MIN)
+  {
+    double sum[4] = {0, 0, 0, 0};
+    for (; i + 4 <= count; i += 4)
+    {
+      for (int j = 0; j < 4; j++)
+        sum[j] += values[i + j] * durations[i + j];
+    }
+    result = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+  }
+  for (; i < count; i++)
+    result += values[i] * durations[i];
+  return result;
+}
+
 /**
  * @ingroup libmeos_int_temporal_agg
  * @brief Return the integral (area under the curve) of a temporal sequence
  * number.
+ *
+ * @note The values and the durations of the segments are gathered in blocks
+ * into dense arrays on which the integration kernels operate
  */
 double
 tnumberseq_integral(const TSequence *seq)
 {
+  double values[TNUMBERSEQ_BLOCK], durations[TNUMBERSEQ_BLOCK - 1];
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
   double result = 0;
-  const TInstant *inst1 = tsequence_inst_n(seq, 0);
-  for (int i = 1; i < seq->count; i++)
+  /* Consecutive blocks share an instant so that no segment is lost */
+  for (int from = 0; from < seq->count - 1; from += TNUMBERSEQ_BLOCK - 1)
   {
-    const TInstant *inst2 = tsequence_inst_n(seq, i);
-    if (MOBDB_FLAGS_GET_LINEAR(seq->flags))
-    {
-      /* Linear interpolation */
-      double min = Min(DatumGetFloat8(tinstant_value(inst1)),
-        DatumGetFloat8(tinstant_value(inst2)));
-      double max = Max(DatumGetFloat8(tinstant_value(inst1)),
-        DatumGetFloat8(tinstant_value(inst2)));
-      result += (max + min) * (double) (inst2->t - inst1->t) / 2.0;
-    }
-    else
-    {
-      /* Step interpolation */
-      result += datum_double(tinstant_value(inst1),
-        temptype_basetype(inst1->temptype)) * (double) (inst2->t - inst1->t);
-    }
-    inst1 = inst2;
+    int count = Min(TNUMBERSEQ_BLOCK, seq->count - from);
+    tnumberseq_gather(seq, from, count, values, durations);
+    result += linear ?
+      integral_linear_kernel(values, durations, count - 1) / 2.0 :
+      integral_step_kernel(values, durations, count - 1);
   }
   return result;
 }
@@ -4334,7 +4968,9 @@ tsequence_eq(const TSequence *seq1, const TSequence *seq2)
 {
   assert(seq1->temptype == seq2->temptype);
   /* If number of sequences, flags, or periods are not equal */
-  if (seq1->count != seq2->count || seq1->flags != seq2->flags ||
+  if (seq1->count != seq2->count ||
+      MOBDB_FLAGS_GET_VALUE(seq1->flags) !=
+        MOBDB_FLAGS_GET_VALUE(seq2->flags) ||
       ! span_eq(&seq1->period, &seq2->period))
     return false;
 
@@ -4384,9 +5020,11 @@ tsequence_cmp(const TSequence *seq1, const TSequence *seq2)
    * composing instant tests above */
 
   /* Compare flags  */
-  if (seq1->flags < seq2->flags)
+  int16 flags1 = MOBDB_FLAGS_GET_VALUE(seq1->flags);
+  int16 flags2 = MOBDB_FLAGS_GET_VALUE(seq2->flags);
+  if (flags1 < flags2)
     return -1;
-  if (seq1->flags > seq2->flags)
+  if (flags1 > flags2)
     return 1;
 
   /* The two values are equal */
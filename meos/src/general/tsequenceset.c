@@ -97,6 +97,76 @@ tsequenceset_seq_n(const TSequenceSet *ss, int index)
       (tsequenceset_offsets_ptr(ss))[index]);
 }
 
+/**
+ * Return a pointer to the instant index of a temporal sequence set
+ *
+ * The index is made of two arrays of integers with one element per sequence,
+ * keeping the number of distinct instants and the number of distinct
+ * timestamps of the sequences up to and including the sequence.
+ * @note The instant index is stored after the composing sequences
+ */
+static int32 *
+tsequenceset_index_ptr(const TSequenceSet *ss)
+{
+  assert(MOBDB_FLAGS_GET_INDEX(ss->flags));
+  return (int32 *)(((char *) ss) + VARSIZE(ss) -
+    double_pad(2 * ss->count * sizeof(int32)));
+}
+
+/**
+ * Compute the instant index of a temporal sequence set
+ */
+static void
+tsequenceset_compute_index(TSequenceSet *ss)
+{
+  int32 *instcount = tsequenceset_index_ptr(ss);
+  int32 *tscount = instcount + ss->count;
+  const TInstant *last = NULL;
+  int ninsts = 0, ntimes = 0;
+  for (int i = 0; i < ss->count; i++)
+  {
+    const TSequence *seq = tsequenceset_seq_n(ss, i);
+    const TInstant *first = tsequence_inst_n(seq, 0);
+    ninsts += seq->count;
+    ntimes += seq->count;
+    if (last)
+    {
+      if (tinstant_eq(last, first))
+        ninsts--;
+      if (last->t == first->t)
+        ntimes--;
+    }
+    instcount[i] = ninsts;
+    tscount[i] = ntimes;
+    last = tsequence_inst_n(seq, seq->count - 1);
+  }
+  return;
+}
+
+/**
+ * Return the position of the sequence of a temporal sequence set containing
+ * the n-th distinct element (0-based) using binary search on the cumulative
+ * counts of the instant index
+ *
+ * @param[in] counts Cumulative counts of the distinct instants or timestamps
+ * @param[in] count Number of sequences
+ * @param[in] n Position of the element
+ */
+static int
+tsequenceset_index_find(const int32 *counts, int count, int n)
+{
+  int first = 0, last = count - 1;
+  while (first < last)
+  {
+    int middle = (first + last) / 2;
+    if (counts[middle] > n)
+      last = middle;
+    else
+      first = middle + 1;
+  }
+  return first;
+}
+
 /**
  * Return the location of a timestamp in a temporal sequence set using
  * binary search
@@ -189,6 +259,15 @@ tsequenceset_make_valid(const TSequence **sequences, int count)
  * where the `_X` are unused bytes added for double padding, `offset_0` and
  * `offset_1` are offsets for the corresponding sequences.
  *
+ * Temporal sequence sets with at least TSEQUENCESET_INDEX_MIN sequences are
+ * followed by an instant index, which keeps for every sequence the number
+ * of distinct instants and timestamps up to the sequence
+ * @code
+ * ----------------------------------------------------------------
+ * ... | ( TSequence_n )_X | instcount_0 | ... | tscount_0 | ... |_X
+ * ----------------------------------------------------------------
+ * @endcode
+ *
  * @param[in] sequences Array of sequences
  * @param[in] count Number of elements in the array
  * @param[in] normalize True when the resulting value should be normalized.
@@ -222,6 +301,10 @@ tsequenceset_make1(const TSequence **sequences, int count, bool normalize)
   }
   /* Size of the struct and the offset array */
   memsize += double_pad(sizeof(TSequenceSet)) + newcount * sizeof(size_t);
+  /* Size of the instant index */
+  bool index = (newcount >= TSEQUENCESET_INDEX_MIN);
+  if (index)
+    memsize += double_pad(2 * newcount * sizeof(int32));
   /* Create the temporal sequence set */
   TSequenceSet *result = palloc0(memsize);
   SET_VARSIZE(result, memsize);
@@ -265,6 +348,12 @@ tsequenceset_make1(const TSequence **sequences, int count, bool normalize)
     (tsequenceset_offsets_ptr(result))[i] = pos;
     pos += double_pad(VARSIZE(normseqs[i]));
   }
+  /* Compute the instant index */
+  if (index)
+  {
+    MOBDB_FLAGS_SET_INDEX(result->flags, true);
+    tsequenceset_compute_index(result);
+  }
   if (normalize && count > 1)
     pfree_array((void **) normseqs, newcount);
   return result;
@@ -920,6 +1009,8 @@ tsequenceset_segments(const TSequenceSet *ss, int *count)
 int
 tsequenceset_num_instants(const TSequenceSet *ss)
 {
+  if (MOBDB_FLAGS_GET_INDEX(ss->flags))
+    return tsequenceset_index_ptr(ss)[ss->count - 1];
   const TInstant *lastinst;
   bool first = true;
   int result = 0;
@@ -952,6 +1043,16 @@ tsequenceset_inst_n(const TSequenceSet *ss, int n)
 
   /* Continue the search 0-based */
   n--;
+  if (MOBDB_FLAGS_GET_INDEX(ss->flags))
+  {
+    const int32 *instcount = tsequenceset_index_ptr(ss);
+    if (n >= instcount[ss->count - 1])
+      return NULL;
+    int i = tsequenceset_index_find(instcount, ss->count, n);
+    const TSequence *seq = tsequenceset_seq_n(ss, i);
+    return tsequence_inst_n(seq, n - (instcount[i] - seq->count));
+  }
+
   const TInstant *prev, *next;
   bool first = true, found = false;
   int i = 0, count = 0, prevcount = 0;
@@ -1034,6 +1135,8 @@ tsequenceset_end_timestamp(const TSequenceSet *ss)
 int
 tsequenceset_num_timestamps(const TSequenceSet *ss)
 {
+  if (MOBDB_FLAGS_GET_INDEX(ss->flags))
+    return tsequenceset_index_ptr(ss)[2 * ss->count - 1];
   TimestampTz lasttime;
   bool first = true;
   int result = 0;
@@ -1071,6 +1174,17 @@ tsequenceset_timestamp_n(const TSequenceSet *ss, int n, TimestampTz *result)
 
   /* Continue the search 0-based */
   n--;
+  if (MOBDB_FLAGS_GET_INDEX(ss->flags))
+  {
+    const int32 *tscount = tsequenceset_index_ptr(ss) + ss->count;
+    if (n >= tscount[ss->count - 1])
+      return false;
+    int i = tsequenceset_index_find(tscount, ss->count, n);
+    const TSequence *seq = tsequenceset_seq_n(ss, i);
+    *result = tsequence_inst_n(seq, n - (tscount[i] - seq->count))->t;
+    return true;
+  }
+
   TimestampTz prev, next;
   bool first = true;
   int i = 0, count = 0, prevcount = 0;
@@ -1277,7 +1391,16 @@ tfloatseqset_to_tintseqset(const TSequenceSet *ss)
       inst->temptype = T_TINT;
       inst->value = Int32GetDatum((double)DatumGetFloat8(tinstant_value(inst)));
     }
+    /* The conversion truncates the values of the bounding boxes */
+    tsequence_recompute_bbox(seq);
   }
+  const TSequence **sequences = tsequenceset_sequences_p(result);
+  tsequenceset_compute_bbox(sequences, result->count,
+    TSEQUENCESET_BBOX_PTR(result));
+  pfree(sequences);
+  /* The truncation may make equal the boundary instants of the sequences */
+  if (MOBDB_FLAGS_GET_INDEX(result->flags))
+    tsequenceset_compute_index(result);
   return result;
 }
 
@@ -1416,6 +1539,10 @@ tsequenceset_shift_tscale(const TSequenceSet *ss, const Interval *shift,
         inst->t = p2.lower + (inst->t - p2.lower) * scale;
     }
   }
+  /* Scaling rounds the timestamps, which may make equal the boundary
+   * timestamps of consecutive sequences */
+  if (duration != NULL && MOBDB_FLAGS_GET_INDEX(result->flags))
+    tsequenceset_compute_index(result);
   return result;
 }
 
@@ -2625,7 +2752,8 @@ tsequenceset_eq(const TSequenceSet *ss1, const TSequenceSet *ss2)
 {
   assert(ss1->temptype == ss2->temptype);
   /* If number of sequences or flags are not equal */
-  if (ss1->count != ss2->count || ss1->flags != ss2->flags)
+  if (ss1->count != ss2->count ||
+      MOBDB_FLAGS_GET_VALUE(ss1->flags) != MOBDB_FLAGS_GET_VALUE(ss2->flags))
     return false;
 
   /* If bounding boxes are not equal */
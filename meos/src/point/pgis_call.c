@@ -49,6 +49,9 @@
 #include <lwgeom_geos.h>
 /* MobilityDB */
 #include "general/temporal.h"
+#if MEOS
+  #include "general/temporal_batch.h"
+#endif /* MEOS */
 #include "point/tpoint_spatialfuncs.h"
 
 /* To avoid including lwgeom_functions_analytic.h */
@@ -791,6 +794,10 @@ static char
 MOBDB_call_geos(const GSERIALIZED *geom1, const GSERIALIZED *geom2,
   char (*func)(const GEOSGeometry *g1, const GEOSGeometry *g2))
 {
+#if MEOS
+  /* GEOS is initialized with a global context */
+  ensure_not_in_batch();
+#endif /* MEOS */
   initGEOS(lwnotice, lwgeom_geos_error);
 
   GEOSGeometry *g1;
@@ -911,6 +918,10 @@ PGIS_relate_pattern(const GSERIALIZED *geom1, const GSERIALIZED *geom2,
 
   /* TODO handle empty */
 
+#if MEOS
+  /* GEOS is initialized with a global context */
+  ensure_not_in_batch();
+#endif /* MEOS */
   initGEOS(lwnotice, lwgeom_geos_error);
 
   GEOSGeometry *g1 = POSTGIS2GEOS(geom1);
@@ -988,6 +999,10 @@ PGIS_union_geometry_array(GSERIALIZED **gsarr, int nelems)
   GEOSGeometry *g = NULL;
   GEOSGeometry *g_union = NULL;
 
+#if MEOS
+  /* GEOS is initialized with a global context */
+  ensure_not_in_batch();
+#endif /* MEOS */
   initGEOS(lwnotice, lwgeom_geos_error);
 
   /* Collect the non-empty inputs and stuff them into a GEOS collection */
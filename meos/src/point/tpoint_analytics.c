@@ -46,6 +46,9 @@
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/lifting.h"
+#if MEOS
+#include "general/temporal_batch.h"
+#endif /* MEOS */
 #include "general/tsequence.h"
 #include "point/geography_funcs.h"
 #include "point/tpoint.h"
@@ -771,32 +774,30 @@ geo_to_tpoint(const GSERIALIZED *geo)
  ***********************************************************************/
 
 /**
- * Finds a split when simplifying the temporal sequence point using a
- * spatio-temporal extension of the Douglas-Peucker line simplification
- * algorithm.
+ * Finds a split when simplifying the temporal sequence float using a
+ * Douglas-Peucker-like simplification algorithm, considering only the
+ * instants k1 .. k2 - 1 between the reference instants
  *
  * @param[in] seq Temporal sequence
  * @param[in] i1,i2 Indexes of the reference instants
+ * @param[in] k1,k2 Range of the instants considered
  * @param[out] split Location of the split
  * @param[out] dist Distance at the split
  */
 static void
-tfloatseq_findsplit(const TSequence *seq, int i1, int i2, int *split,
-  double *dist)
+tfloatseq_findsplit(const TSequence *seq, int i1, int i2, int k1, int k2,
+  int *split, double *dist)
 {
   *split = i1;
   *dist = -1;
-  if (i1 + 1 >= i2)
-    return;
-
   const TInstant *start = tsequence_inst_n(seq, i1);
   const TInstant *end = tsequence_inst_n(seq, i2);
   double value1 = DatumGetFloat8(tinstant_value(start));
   double value2 = DatumGetFloat8(tinstant_value(end));
   double duration2 = (double) (end->t - start->t);
-  /* Loop for every instant between i1 and i2 */
+  /* Loop for every instant between k1 and k2 */
   const TInstant *inst1 = start;
-  for (int k = i1 + 1; k < i2; k++)
+  for (int k = k1; k < k2; k++)
   {
     const TInstant *inst2 = tsequence_inst_n(seq, k);
     double value = DatumGetFloat8(tinstant_value(inst2));
@@ -945,17 +946,19 @@ dist3d_pt_seg(POINT3DZ *p, POINT3DZ *A, POINT3DZ *B)
 /**
  * Finds a split when simplifying the temporal sequence point using a
  * spatio-temporal extension of the Douglas-Peucker line simplification
- * algorithm.
+ * algorithm, considering only the instants k1 .. k2 - 1 between the
+ * reference instants
  *
  * @param[in] seq Temporal sequence
  * @param[in] i1,i2 Indexes of the reference instants
+ * @param[in] k1,k2 Range of the instants considered
  * @param[in] synchronized True when using the Synchronized Euclidean Distance
  * @param[out] split Location of the split
  * @param[out] dist Distance at the split
  */
 static void
-tpointseq_findsplit(const TSequence *seq, int i1, int i2, bool synchronized,
-  int *split, double *dist)
+tpointseq_findsplit(const TSequence *seq, int i1, int i2, int k1, int k2,
+  bool synchronized, int *split, double *dist)
 {
   POINT2D p2k, p2_sync, p2a, p2b;
   POINT3DZ p3k, p3_sync, p3a, p3b;
@@ -965,8 +968,6 @@ tpointseq_findsplit(const TSequence *seq, int i1, int i2, bool synchronized,
   double d = -1;
   *split = i1;
   *dist = -1;
-  if (i1 + 1 >= i2)
-    return;
 
   /* Initialization of values wrt instants i1 and i2 */
   const TInstant *start = tsequence_inst_n(seq, i1);
@@ -982,8 +983,8 @@ tpointseq_findsplit(const TSequence *seq, int i1, int i2, bool synchronized,
     p2b = datum_point2d(tinstant_value(end));
   }
 
-  /* Loop for every instant between i1 and i2 */
-  for (int k = i1 + 1; k < i2; k++)
+  /* Loop for every instant between k1 and k2 */
+  for (int k = k1; k < k2; k++)
   {
     double d_tmp;
     const TInstant *inst = tsequence_inst_n(seq, k);
@@ -1024,6 +1025,104 @@ tpointseq_findsplit(const TSequence *seq, int i1, int i2, bool synchronized,
   return;
 }
 
+/**
+ * Finds a split in the instants k1 .. k2 - 1 when simplifying the temporal
+ * sequence float/point
+ */
+static void
+tsequence_findsplit_range(const TSequence *seq, int i1, int i2, int k1,
+  int k2, bool synchronized, int *split, double *dist)
+{
+  if (seq->temptype == T_TFLOAT)
+    /* There is no synchronized distance for temporal floats */
+    tfloatseq_findsplit(seq, i1, i2, k1, k2, split, dist);
+  else /* tgeo_type(seq->temptype) */
+    tpointseq_findsplit(seq, i1, i2, k1, k2, synchronized, split, dist);
+  return;
+}
+
+#if MEOS
+/** Minimum number of instants between the reference instants for scanning
+ * them in parallel */
+#define SIMPLIFY_PARALLEL_MIN 65536
+/** Number of instants scanned by each element of a parallel scan */
+#define SIMPLIFY_CHUNK_SIZE 16384
+
+/**
+ * State of the parallel scan of the instants between two reference instants
+ */
+typedef struct
+{
+  const TSequence *seq;        /**< Sequence simplified */
+  int i1;                      /**< Index of the first reference instant */
+  int i2;                      /**< Index of the second reference instant */
+  bool synchronized;           /**< True for the synchronized distance */
+  int *splits;                 /**< Split found in each chunk */
+  double *dists;               /**< Distance at the split of each chunk */
+} SimplifyScanBatch;
+
+static void
+tsequence_findsplit_item(void *state, int i)
+{
+  SimplifyScanBatch *b = (SimplifyScanBatch *) state;
+  int k1 = b->i1 + 1 + i * SIMPLIFY_CHUNK_SIZE;
+  int k2 = Min(k1 + SIMPLIFY_CHUNK_SIZE, b->i2);
+  tsequence_findsplit_range(b->seq, b->i1, b->i2, k1, k2, b->synchronized,
+    &b->splits[i], &b->dists[i]);
+  return;
+}
+#endif /* MEOS */
+
+/**
+ * Finds a split when simplifying the temporal sequence float/point
+ *
+ * In MEOS, the instants between reference instants that are far apart, as
+ * in the top levels of the recursion for long sequences, are scanned in
+ * chunks by the thread pool of the batch functions. The chunks are combined
+ * in order keeping the first maximum, so that the result is the same as
+ * the one of the serial scan.
+ */
+static void
+tsequence_findsplit(const TSequence *seq, int i1, int i2, bool synchronized,
+  int *split, double *dist)
+{
+  *split = i1;
+  *dist = -1;
+  if (i1 + 1 >= i2)
+    return;
+
+#if MEOS
+  if (i2 - i1 - 1 >= SIMPLIFY_PARALLEL_MIN)
+  {
+    int nchunks = (i2 - i1 - 1 + SIMPLIFY_CHUNK_SIZE - 1) /
+      SIMPLIFY_CHUNK_SIZE;
+    SimplifyScanBatch state;
+    state.seq = seq;
+    state.i1 = i1;
+    state.i2 = i2;
+    state.synchronized = synchronized;
+    state.splits = palloc(sizeof(int) * nchunks);
+    state.dists = palloc(sizeof(double) * nchunks);
+    meos_batch_run(&tsequence_findsplit_item, &state, nchunks);
+    for (int i = 0; i < nchunks; i++)
+    {
+      if (state.dists[i] > *dist)
+      {
+        *split = state.splits[i];
+        *dist = state.dists[i];
+      }
+    }
+    pfree(state.splits);
+    pfree(state.dists);
+    return;
+  }
+#endif /* MEOS */
+
+  tsequence_findsplit_range(seq, i1, i2, i1 + 1, i2, synchronized, split,
+    dist);
+  return;
+}
+
 /*****************************************************************************/
 
 static TSequence *
@@ -1063,11 +1162,7 @@ tsequence_simplify(const TSequence *seq, double eps_dist, bool synchronized,
   outlist[outn++] = 0;
   do
   {
-    if (seq->temptype == T_TFLOAT)
-      /* There is no synchronized distance for temporal floats */
-      tfloatseq_findsplit(seq, i1, stack[sp], &split, &dist);
-    else /* tgeo_type(seq->temptype) */
-      tpointseq_findsplit(seq, i1, stack[sp], synchronized, &split, &dist);
+    tsequence_findsplit(seq, i1, stack[sp], synchronized, &split, &dist);
     bool dosplit = (dist >= 0 &&
       (dist > eps_dist || outn + sp + 1 < minpts));
     if (dosplit)
@@ -1174,7 +1269,7 @@ tpointinstset_remove_repeated_points(const TInstantSet *is, double tolerance,
     const POINT2D *pt = datum_point2d_p(tinstant_value(inst));
 
     /* Don't drop points if we are running short of points */
-    if (is->count - k > min_points + i)
+    if (is->count - i > min_points - k)
     {
       if (tolerance > 0.0)
       {
@@ -1206,35 +1301,42 @@ tpointinstset_remove_repeated_points(const TInstantSet *is, double tolerance,
     last = pt;
   }
   /* Construct the result */
-  TInstantSet *result = tinstantset_make(instants, is->count, MERGE_NO);
+  TInstantSet *result = tinstantset_make(instants, k, MERGE_NO);
   pfree(instants);
   return result;
 }
 
 /**
- * Return a temporal point with consecutive equal points removed.
+ * Remove in place the consecutive equal points of a temporal point.
  * Equality test only on x and y dimensions of input.
+ *
+ * @param[in,out] seq Temporal point owned by the caller, which is compacted
+ * @param[in] tolerance Distance under which two points are considered equal
+ * @param[in] min_points Minimum number of points kept
  */
 static TSequence *
-tpointseq_remove_repeated_points(const TSequence *seq, double tolerance,
+tpointseq_remove_repeated_points_inplace(TSequence *seq, double tolerance,
   int min_points)
 {
   /* No-op on short inputs */
   if (seq->count <= min_points)
-    return tsequence_copy(seq);
+    return seq;
 
   double tolsq = tolerance * tolerance;
   double dsq = FLT_MAX;
 
-  const TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
-  instants[0] = tsequence_inst_n(seq, 0);
-  const POINT2D *last = datum_point2d_p(tinstant_value(instants[0]));
+  int *keep = palloc(sizeof(int) * seq->count);
+  keep[0] = 0;
+  const POINT2D *last = datum_point2d_p(tinstant_value(
+    tsequence_inst_n(seq, 0)));
   int k = 1;
+  /* True when two consecutive points kept may be equal */
+  bool maybe_equal = false;
   for (int i = 1; i < seq->count; i++)
   {
     bool last_point = (i == seq->count - 1);
-    const TInstant *inst = tsequence_inst_n(seq, i);
-    const POINT2D *pt = datum_point2d_p(tinstant_value(inst));
+    const POINT2D *pt = datum_point2d_p(tinstant_value(
+      tsequence_inst_n(seq, i)));
 
     /* Don't drop points if we are running short of points */
     if (seq->count - i > min_points - k)
@@ -1261,18 +1363,46 @@ tpointseq_remove_repeated_points(const TSequence *seq, double tolerance,
       if (last_point && k > 1 && tolerance > 0.0 && dsq <= tolsq)
       {
         k--;
+        maybe_equal = true;
       }
     }
+    else
+      maybe_equal = true;
 
     /* Save the point */
-    instants[k++] = inst;
+    keep[k++] = i;
     last = pt;
   }
-  /* Construct the result */
-  TSequence *result = tsequence_make(instants, k, seq->period.lower_inc,
-    seq->period.upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE);
-  pfree(instants);
-  return result;
+
+  /* The last point is always kept. The exclusive upper bound of a step
+   * sequence also requires the point before it, which has the same value */
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  if (! linear && ! seq->period.upper_inc && k > 1 &&
+    keep[k - 2] != seq->count - 2)
+  {
+    keep[k - 1] = seq->count - 2;
+    keep[k++] = seq->count - 1;
+    maybe_equal = true;
+  }
+
+  /* Compact the sequence. A step sequence whose consecutive points are all
+   * different is already normalized */
+  tsequence_compact(seq, keep, k, seq->period.lower_inc,
+    seq->period.upper_inc, linear || maybe_equal);
+  pfree(keep);
+  return seq;
+}
+
+/**
+ * Return a temporal point with consecutive equal points removed.
+ * Equality test only on x and y dimensions of input.
+ */
+static TSequence *
+tpointseq_remove_repeated_points(const TSequence *seq, double tolerance,
+  int min_points)
+{
+  return tpointseq_remove_repeated_points_inplace(tsequence_copy(seq),
+    tolerance, min_points);
 }
 
 /**
@@ -1489,29 +1619,42 @@ point_grid(Datum value, bool hasz, const gridspec *grid, POINT4D *p)
 }
 
 /**
- * Stick a temporal point to the given grid specification.
+ * Write in place the coordinates of a point
+ */
+static void
+point_set_coords(Datum value, bool hasz, const POINT4D *p)
+{
+  if (hasz)
+  {
+    POINT3DZ *point = (POINT3DZ *) datum_point3dz_p(value);
+    point->x = p->x;
+    point->y = p->y;
+    point->z = p->z;
+  }
+  else
+  {
+    POINT2D *point = (POINT2D *) datum_point2d_p(value);
+    point->x = p->x;
+    point->y = p->y;
+  }
+  return;
+}
+
+/**
+ * Stick in place a temporal point to the given grid specification.
  */
 static TInstant *
-tpointinst_grid(const TInstant *inst, const gridspec *grid)
+tpointinst_grid_inplace(TInstant *inst, const gridspec *grid)
 {
   bool hasz = MOBDB_FLAGS_GET_Z(inst->flags);
   if (grid->xsize == 0 && grid->ysize == 0 && (hasz ? grid->zsize == 0 : 1))
-    return tinstant_copy(inst);
+    return inst;
 
-  int srid = tpointinst_srid(inst);
   Datum value = tinstant_value(inst);
   POINT4D p;
   point_grid(value, hasz, grid, &p);
-  /* Write rounded values into the next instant */
-  LWPOINT *lwpoint = hasz ?
-    lwpoint_make3dz(srid, p.x, p.y, p.z) : lwpoint_make2d(srid, p.x, p.y);
-  GSERIALIZED *gs = geo_serialize((LWGEOM *) lwpoint);
-  lwpoint_free(lwpoint);
-  /* Construct the result */
-  TInstant *result = tinstant_make(PointerGetDatum(gs), T_TGEOMPOINT, inst->t);
-  /* We cannot lwpoint_free(lwpoint) */
-  pfree(gs);
-  return result;
+  point_set_coords(value, hasz, &p);
+  return inst;
 }
 
 /**
@@ -1523,15 +1666,15 @@ tpointinstset_grid(const TInstantSet *is, const gridspec *grid)
   bool hasz = MOBDB_FLAGS_GET_Z(is->flags);
   int srid = tpointinstset_srid(is);
   TInstant **instants = palloc(sizeof(TInstant *) * is->count);
+  POINT4D p, prev_p;
   int k = 0;
   for (int i = 0; i < is->count; i++)
   {
-    POINT4D p, prev_p;
     const TInstant *inst = tinstantset_inst_n(is, i);
     Datum value = tinstant_value(inst);
     point_grid(value, hasz, grid, &p);
     /* Skip duplicates */
-    if (i > 1 && prev_p.x == p.x && prev_p.y == p.y &&
+    if (k > 0 && prev_p.x == p.x && prev_p.y == p.y &&
       (hasz ? prev_p.z == p.z : 1))
       continue;
 
@@ -1549,45 +1692,58 @@ tpointinstset_grid(const TInstantSet *is, const gridspec *grid)
 }
 
 /**
- * Stick a temporal point to the given grid specification.
+ * Stick in place a temporal point to the given grid specification.
+ *
+ * @param[in,out] seq Temporal point owned by the caller, which is compacted
+ * or freed when the result is NULL
+ * @param[in] grid Grid specification
+ * @param[in] filter_pts True when a sequence reduced to a single point is
+ * removed
  */
 static TSequence *
-tpointseq_grid(const TSequence *seq, const gridspec *grid, bool filter_pts)
+tpointseq_grid_inplace(TSequence *seq, const gridspec *grid, bool filter_pts)
 {
   bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
-  int srid = tpointseq_srid(seq);
-  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
-  int k = 0;
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  /* The exclusive upper bound of a step sequence requires its last instant,
+   * which has the same value as the previous one */
+  bool keep_last = ! linear && ! seq->period.upper_inc;
+  int *keep = palloc(sizeof(int) * seq->count);
+  POINT4D p, prev_p;
+  int k = 0, npoints = 0;
   for (int i = 0; i < seq->count; i++)
   {
-    POINT4D p, prev_p;
-    const TInstant *inst = tsequence_inst_n(seq, i);
-    Datum value = tinstant_value(inst);
+    Datum value = tinstant_value(tsequence_inst_n(seq, i));
     point_grid(value, hasz, grid, &p);
     /* Skip duplicates */
-    if (i > 1 && prev_p.x == p.x && prev_p.y == p.y &&
-      (hasz ? prev_p.z == p.z : 1))
+    bool dup = k > 0 && prev_p.x == p.x && prev_p.y == p.y &&
+      (hasz ? prev_p.z == p.z : 1);
+    if (dup && (! keep_last || i < seq->count - 1))
       continue;
 
-    /* Write rounded values into the next instant */
-    LWPOINT *lwpoint = hasz ?
-      lwpoint_make3dz(srid, p.x, p.y, p.z) : lwpoint_make2d(srid, p.x, p.y);
-    GSERIALIZED *gs = geo_serialize((LWGEOM *) lwpoint);
-    instants[k++] = tinstant_make(PointerGetDatum(gs), T_TGEOMPOINT, inst->t);
-    lwpoint_free(lwpoint);
-    pfree(gs);
+    /* Write rounded values into the instant */
+    point_set_coords(value, hasz, &p);
+    keep[k++] = i;
+    if (! dup)
+      npoints++;
     memcpy(&prev_p, &p, sizeof(POINT4D));
   }
-  if (filter_pts && k == 1)
+  if (filter_pts && npoints == 1)
   {
-    pfree_array((void **) instants, 1);
+    pfree(keep);
+    pfree(seq);
     return NULL;
   }
 
-  /* Construct the result */
-  return tsequence_make_free(instants, k, k > 1 ? seq->period.lower_inc : true,
-    k > 1 ? seq->period.upper_inc : true, MOBDB_FLAGS_GET_LINEAR(seq->flags),
-    NORMALIZE);
+  /* Compact the sequence */
+  bool lower_inc = (k > 1) ? seq->period.lower_inc : true;
+  bool upper_inc = (k > 1) ? seq->period.upper_inc : true;
+  /* Consecutive points kept are different, apart from the last two of a
+   * step sequence with exclusive upper bound, and thus only a linear
+   * sequence may need to be normalized */
+  tsequence_compact(seq, keep, k, lower_inc, upper_inc, linear);
+  pfree(keep);
+  return seq;
 }
 
 /**
@@ -1600,7 +1756,8 @@ tpointseqset_grid(const TSequenceSet *ss, const gridspec *grid, bool filter_pts)
   TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
   for (int i = 0; i < ss->count; i++)
   {
-    TSequence *seq = tpointseq_grid(tsequenceset_seq_n(ss, i), grid, filter_pts);
+    TSequence *seq = tpointseq_grid_inplace(
+      tsequence_copy(tsequenceset_seq_n(ss, i)), grid, filter_pts);
     if (seq != NULL)
       sequences[k++] = seq;
   }
@@ -1608,26 +1765,31 @@ tpointseqset_grid(const TSequenceSet *ss, const gridspec *grid, bool filter_pts)
 }
 
 /**
- * Stick a temporal point to the given grid specification.
+ * Stick in place a temporal point to the given grid specification.
  *
  * Only the x, y, and possible z dimensions are gridded, the timestamp is
  * kept unmodified. Two consecutive instants falling on the same grid cell
  * are collapsed into one single instant.
+ *
+ * @note The argument, which must be owned by the caller, is either
+ * modified in place and returned, or freed
  */
 static Temporal *
-tpoint_grid(const Temporal *temp, const gridspec *grid, bool filter_pts)
+tpoint_grid(Temporal *temp, const gridspec *grid, bool filter_pts)
 {
   Temporal *result;
   ensure_valid_tempsubtype(temp->subtype);
   if (temp->subtype == TINSTANT)
-    result = (Temporal *) tpointinst_grid((TInstant *) temp, grid);
+    return (Temporal *) tpointinst_grid_inplace((TInstant *) temp, grid);
+  else if (temp->subtype == TSEQUENCE)
+    return (Temporal *) tpointseq_grid_inplace((TSequence *) temp, grid,
+      filter_pts);
   else if (temp->subtype == TINSTANTSET)
     result = (Temporal *) tpointinstset_grid((TInstantSet *) temp, grid);
-  else if (temp->subtype == TSEQUENCE)
-    result = (Temporal *) tpointseq_grid((TSequence *) temp, grid, filter_pts);
   else /* temp->subtype == TSEQUENCESET */
     result = (Temporal *) tpointseqset_grid((TSequenceSet *) temp, grid,
       filter_pts);
+  pfree(temp);
   return result;
 }
 
@@ -1674,9 +1836,9 @@ tpoint_mvt(const Temporal *tpoint, const STBOX *box, uint32_t extent,
   Temporal *tpoint3 = tpoint_affine(tpoint2, &affine);
   pfree(tpoint2);
 
-  /* Snap to integer precision, removing duplicate and single points */
+  /* Snap in place to integer precision, removing duplicate and single
+   * points */
   Temporal *tpoint4 = tpoint_grid(tpoint3, &grid, true);
-  pfree(tpoint3);
   if (tpoint4 == NULL || !clip_geom)
     return tpoint4;
 
@@ -1692,9 +1854,7 @@ tpoint_mvt(const Temporal *tpoint, const STBOX *box, uint32_t extent,
   if (tpoint5 == NULL)
     return NULL;
   /* We need to grid again the result of the clipping */
-  Temporal *result = tpoint_grid(tpoint5, &grid, true);
-  pfree(tpoint5);
-  return result;
+  return tpoint_grid(tpoint5, &grid, true);
 }
 
 /*****************************************************************************/
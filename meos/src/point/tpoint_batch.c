@@ -0,0 +1,346 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Batch functions for temporal point types.
+ *
+ * The functions apply a MEOS function to arrays of temporal points using the
+ * thread pool of the batch functions. The arrays of arguments, such as the
+ * boxes or the geometries, have either one element that is applied to all
+ * temporal points or as many elements as the array of temporal points.
+ */
+
+#include "general/temporal_batch.h"
+
+#if MEOS
+
+/* C */
+#include <assert.h>
+/* MobilityDB */
+#include <meos.h>
+#include <meos_internal.h>
+
+/* Element of an argument array with either 1 or count elements */
+#define BATCH_ARG(arr, nargs, i)  ((arr)[(nargs) == 1 ? 0 : (i)])
+
+/*****************************************************************************
+ * Restriction functions
+ *****************************************************************************/
+
+/**
+ * State of the batch functions restricting temporal points to boxes
+ */
+typedef struct
+{
+  const Temporal **temps;      /**< Input values */
+  const STBOX **boxes;         /**< Boxes */
+  int nboxes;                  /**< Number of boxes */
+  bool atfunc;                 /**< True for at, false for minus */
+  Temporal **result;           /**< Result values */
+} TPointStboxBatch;
+
+static void
+tpoint_restrict_stbox_item(void *state, int i)
+{
+  TPointStboxBatch *b = (TPointStboxBatch *) state;
+  const STBOX *box = BATCH_ARG(b->boxes, b->nboxes, i);
+  if (! b->temps[i] || ! box)
+    b->result[i] = NULL;
+  else
+    b->result[i] = b->atfunc ? tpoint_at_stbox(b->temps[i], box) :
+      tpoint_minus_stbox(b->temps[i], box);
+  return;
+}
+
+/**
+ * Restrict an array of temporal points to (the complement of) boxes
+ */
+static Temporal **
+tpoint_restrict_stbox_batch(const Temporal **temps, int count,
+  const STBOX **boxes, int nboxes, bool atfunc)
+{
+  if (nboxes != 1 && nboxes != count)
+    elog(ERROR, "The number of boxes must be 1 or the number of temporal points");
+  TPointStboxBatch state;
+  state.temps = temps;
+  state.boxes = boxes;
+  state.nboxes = nboxes;
+  state.atfunc = atfunc;
+  state.result = palloc(sizeof(Temporal *) * count);
+  meos_batch_run(&tpoint_restrict_stbox_item, &state, count);
+  return state.result;
+}
+
+/**
+ * @ingroup libmeos_temporal_batch
+ * @brief Restrict an array of temporal points to spatiotemporal boxes. The
+ * result for a NULL temporal point or box is NULL.
+ *
+ * @param[in] temps Array of temporal points
+ * @param[in] count Number of temporal points
+ * @param[in] boxes Array of boxes
+ * @param[in] nboxes Number of boxes, either 1 or count
+ * @sqlfunc atStbox()
+ */
+Temporal **
+tpoint_at_stbox_batch(const Temporal **temps, int count, const STBOX **boxes,
+  int nboxes)
+{
+  return tpoint_restrict_stbox_batch(temps, count, boxes, nboxes, REST_AT);
+}
+
+/**
+ * @ingroup libmeos_temporal_batch
+ * @brief Restrict an array of temporal points to the complement of
+ * spatiotemporal boxes. The result for a NULL temporal point or box is NULL.
+ *
+ * @param[in] temps Array of temporal points
+ * @param[in] count Number of temporal points
+ * @param[in] boxes Array of boxes
+ * @param[in] nboxes Number of boxes, either 1 or count
+ * @sqlfunc minusStbox()
+ */
+Temporal **
+tpoint_minus_stbox_batch(const Temporal **temps, int count,
+  const STBOX **boxes, int nboxes)
+{
+  return tpoint_restrict_stbox_batch(temps, count, boxes, nboxes, REST_MINUS);
+}
+
+/*****************************************************************************
+ * Distance functions
+ *****************************************************************************/
+
+/**
+ * State of the batch distance functions
+ */
+typedef struct
+{
+  const Temporal **temps1;     /**< First input values */
+  const Temporal **temps2;     /**< Second input values, may be NULL */
+  const GSERIALIZED **geos;    /**< Geometries, may be NULL */
+  int ngeos;                   /**< Number of geometries */
+  Temporal **result;           /**< Result values of the temporal distance */
+  double *nad;                 /**< Result values of the NAD */
+} TPointDistanceBatch;
+
+static void
+distance_tpoint_tpoint_item(void *state, int i)
+{
+  TPointDistanceBatch *b = (TPointDistanceBatch *) state;
+  b->result[i] = (! b->temps1[i] || ! b->temps2[i]) ? NULL :
+    distance_tpoint_tpoint(b->temps1[i], b->temps2[i]);
+  return;
+}
+
+static void
+distance_tpoint_geo_item(void *state, int i)
+{
+  TPointDistanceBatch *b = (TPointDistanceBatch *) state;
+  const GSERIALIZED *gs = BATCH_ARG(b->geos, b->ngeos, i);
+  b->result[i] = (! b->temps1[i] || ! gs) ? NULL :
+    distance_tpoint_geo(b->temps1[i], gs);
+  return;
+}
+
+static void
+nad_tpoint_tpoint_item(void *state, int i)
+{
+  TPointDistanceBatch *b = (TPointDistanceBatch *) state;
+  b->nad[i] = (! b->temps1[i] || ! b->temps2[i]) ? -1.0 :
+    nad_tpoint_tpoint(b->temps1[i], b->temps2[i]);
+  return;
+}
+
+static void
+nad_tpoint_geo_item(void *state, int i)
+{
+  TPointDistanceBatch *b = (TPointDistanceBatch *) state;
+  const GSERIALIZED *gs = BATCH_ARG(b->geos, b->ngeos, i);
+  b->nad[i] = (! b->temps1[i] || ! gs) ? -1.0 :
+    nad_tpoint_geo(b->temps1[i], gs);
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_batch
+ * @brief Return the temporal distance of the pairs of temporal points of two
+ * arrays of the same size. The result for a pair of points that do not
+ * intersect in time or with a NULL element is NULL.
+ * @sqlfunc distance()
+ */
+Temporal **
+distance_tpoint_tpoint_batch(const Temporal **temps1, const Temporal **temps2,
+  int count)
+{
+  TPointDistanceBatch state;
+  state.temps1 = temps1;
+  state.temps2 = temps2;
+  state.result = palloc(sizeof(Temporal *) * count);
+  meos_batch_run(&distance_tpoint_tpoint_item, &state, count);
+  return state.result;
+}
+
+/**
+ * @ingroup libmeos_temporal_batch
+ * @brief Return the temporal distance between an array of temporal points
+ * and geometries. The result for a NULL temporal point or geometry is NULL.
+ *
+ * @param[in] temps Array of temporal points
+ * @param[in] count Number of temporal points
+ * @param[in] geos Array of geometries
+ * @param[in] ngeos Number of geometries, either 1 or count
+ * @sqlfunc distance()
+ */
+Temporal **
+distance_tpoint_geo_batch(const Temporal **temps, int count,
+  const GSERIALIZED **geos, int ngeos)
+{
+  if (ngeos != 1 && ngeos != count)
+    elog(ERROR, "The number of geometries must be 1 or the number of temporal points");
+  TPointDistanceBatch state;
+  state.temps1 = temps;
+  state.geos = geos;
+  state.ngeos = ngeos;
+  state.result = palloc(sizeof(Temporal *) * count);
+  meos_batch_run(&distance_tpoint_geo_item, &state, count);
+  return state.result;
+}
+
+/**
+ * @ingroup libmeos_temporal_batch
+ * @brief Return the nearest approach distance of the pairs of temporal points
+ * of two arrays of the same size. The result for a pair with a NULL element
+ * is -1.
+ * @sqlfunc nearestApproachDistance()
+ */
+double *
+nad_tpoint_tpoint_batch(const Temporal **temps1, const Temporal **temps2,
+  int count)
+{
+  TPointDistanceBatch state;
+  state.temps1 = temps1;
+  state.temps2 = temps2;
+  state.nad = palloc(sizeof(double) * count);
+  meos_batch_run(&nad_tpoint_tpoint_item, &state, count);
+  return state.nad;
+}
+
+/**
+ * @ingroup libmeos_temporal_batch
+ * @brief Return the nearest approach distance between an array of temporal
+ * points and geometries. The result for a NULL temporal point or geometry
+ * is -1.
+ *
+ * @param[in] temps Array of temporal points
+ * @param[in] count Number of temporal points
+ * @param[in] geos Array of geometries
+ * @param[in] ngeos Number of geometries, either 1 or count
+ * @sqlfunc nearestApproachDistance()
+ */
+double *
+nad_tpoint_geo_batch(const Temporal **temps, int count,
+  const GSERIALIZED **geos, int ngeos)
+{
+  if (ngeos != 1 && ngeos != count)
+    elog(ERROR, "The number of geometries must be 1 or the number of temporal points");
+  TPointDistanceBatch state;
+  state.temps1 = temps;
+  state.geos = geos;
+  state.ngeos = ngeos;
+  state.nad = palloc(sizeof(double) * count);
+  meos_batch_run(&nad_tpoint_geo_item, &state, count);
+  return state.nad;
+}
+
+/*****************************************************************************
+ * Spatial accessor functions
+ *****************************************************************************/
+
+/**
+ * State of the batch spatial accessor functions
+ */
+typedef struct
+{
+  const Temporal **temps;      /**< Input values */
+  double *length;              /**< Result values of the length */
+  Temporal **result;           /**< Result values of the speed */
+} TPointAccessorBatch;
+
+static void
+tpoint_length_item(void *state, int i)
+{
+  TPointAccessorBatch *b = (TPointAccessorBatch *) state;
+  b->length[i] = b->temps[i] ? tpoint_length(b->temps[i]) : -1.0;
+  return;
+}
+
+static void
+tpoint_speed_item(void *state, int i)
+{
+  TPointAccessorBatch *b = (TPointAccessorBatch *) state;
+  b->result[i] = b->temps[i] ? tpoint_speed(b->temps[i]) : NULL;
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_batch
+ * @brief Return the length traversed by an array of temporal points. The
+ * result for a NULL temporal point is -1.
+ * @sqlfunc length()
+ */
+double *
+tpoint_length_batch(const Temporal **temps, int count)
+{
+  TPointAccessorBatch state;
+  state.temps = temps;
+  state.length = palloc(sizeof(double) * count);
+  meos_batch_run(&tpoint_length_item, &state, count);
+  return state.length;
+}
+
+/**
+ * @ingroup libmeos_temporal_batch
+ * @brief Return the speed of an array of temporal points. The result for a
+ * NULL temporal point is NULL.
+ * @sqlfunc speed()
+ */
+Temporal **
+tpoint_speed_batch(const Temporal **temps, int count)
+{
+  TPointAccessorBatch state;
+  state.temps = temps;
+  state.result = palloc(sizeof(Temporal *) * count);
+  meos_batch_run(&tpoint_speed_item, &state, count);
+  return state.result;
+}
+
+#endif /* MEOS */
+
+/*****************************************************************************/
@@ -0,0 +1,456 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Online compression of temporal points.
+ *
+ * Contrary to the Douglas-Peucker simplification in file tpoint_analytics.c,
+ * which requires the complete sequence, the compressors in this file decide
+ * which instants to keep while the instants are appended, and thus can be
+ * applied at ingestion time. Two methods are provided
+ * - Dead reckoning, which keeps an instant when its position deviates from
+ *   the position predicted from the last kept instant and its velocity by
+ *   more than a distance threshold.
+ * - SQUISH-E, which keeps the instants in a buffer of bounded capacity and
+ *   removes the instants whose removal introduces the lowest synchronized
+ *   Euclidean distance, as long as this distance is below a threshold.
+ *
+ * @see J. Muckell et al. Compression of trajectory data: a comprehensive
+ * evaluation and new approach. GeoInformatica 18(3), 2014.
+ * @see G. Trajcevski et al. On-line data reduction and the quality of
+ * history in moving objects databases. MobiDE 2006.
+ */
+
+#include "point/tpoint_compress.h"
+
+/* C */
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+/* MobilityDB */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/temporal_util.h"
+#include "point/tpoint_spatialfuncs.h"
+
+/*****************************************************************************
+ * Utility functions
+ *****************************************************************************/
+
+/**
+ * Get the coordinates of a temporal point instant, the Z coordinate is set
+ * to 0 for 2D points
+ */
+static void
+tpointinst_coords(const TInstant *inst, bool hasz, POINT3DZ *p)
+{
+  Datum value = tinstant_value(inst);
+  if (hasz)
+    *p = *datum_point3dz_p(value);
+  else
+  {
+    const POINT2D *p2d = datum_point2d_p(value);
+    p->x = p2d->x;
+    p->y = p2d->y;
+    p->z = 0;
+  }
+  return;
+}
+
+/**
+ * Return the synchronized Euclidean distance of an instant with respect to
+ * the segment defined by two instants, that is, the distance between the
+ * instant and the position of the segment at the timestamp of the instant
+ */
+static double
+tpointinst_sed(const TInstant *inst, const TInstant *start,
+  const TInstant *end, bool hasz)
+{
+  POINT3DZ p, a, b;
+  tpointinst_coords(inst, hasz, &p);
+  tpointinst_coords(start, hasz, &a);
+  tpointinst_coords(end, hasz, &b);
+  double ratio = (double) (inst->t - start->t) / (double) (end->t - start->t);
+  double dx = a.x + (b.x - a.x) * ratio - p.x;
+  double dy = a.y + (b.y - a.y) * ratio - p.y;
+  double dz = a.z + (b.z - a.z) * ratio - p.z;
+  return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/**
+ * Add an instant to the output of a compressor, the compressor takes the
+ * ownership of the instant
+ */
+static void
+compressor_output(TPointCompressor *comp, TInstant *inst)
+{
+  if (comp->noutput == comp->maxoutput)
+  {
+    comp->maxoutput *= 2;
+    comp->output = repalloc(comp->output,
+      sizeof(TInstant *) * comp->maxoutput);
+  }
+  comp->output[comp->noutput++] = inst;
+  return;
+}
+
+/*****************************************************************************
+ * Dead reckoning
+ *****************************************************************************/
+
+/**
+ * Set the velocity of a dead reckoning compressor from two instants
+ */
+static void
+deadreckoning_set_velocity(TPointCompressor *comp, const TInstant *inst1,
+  const TInstant *inst2)
+{
+  POINT3DZ p1, p2;
+  tpointinst_coords(inst1, comp->hasz, &p1);
+  tpointinst_coords(inst2, comp->hasz, &p2);
+  double duration = (double) (inst2->t - inst1->t);
+  comp->vx = (p2.x - p1.x) / duration;
+  comp->vy = (p2.y - p1.y) / duration;
+  comp->vz = (p2.z - p1.z) / duration;
+  comp->hasvelocity = true;
+  return;
+}
+
+/**
+ * Append an instant to a dead reckoning compressor
+ *
+ * The buffer contains the last instant received when it was not kept. The
+ * velocity at the last kept instant is estimated from the instant received
+ * before it, or from the next instant for the first instant of the stream.
+ */
+static void
+deadreckoning_append(TPointCompressor *comp, const TInstant *inst)
+{
+  const TInstant *anchor = comp->output[comp->noutput - 1];
+  if (! comp->hasvelocity)
+  {
+    deadreckoning_set_velocity(comp, anchor, inst);
+    if (comp->nbuffer > 0)
+      pfree(comp->buffer[0]);
+    comp->buffer[0] = tinstant_copy(inst);
+    comp->nbuffer = 1;
+    return;
+  }
+
+  /* Compare the position with the one predicted from the anchor */
+  POINT3DZ a, p;
+  tpointinst_coords(anchor, comp->hasz, &a);
+  tpointinst_coords(inst, comp->hasz, &p);
+  double duration = (double) (inst->t - anchor->t);
+  double dx = a.x + comp->vx * duration - p.x;
+  double dy = a.y + comp->vy * duration - p.y;
+  double dz = a.z + comp->vz * duration - p.z;
+  if (sqrt(dx * dx + dy * dy + dz * dz) > comp->eps_dist)
+  {
+    /* Keep the instant with the velocity from the previous instant */
+    const TInstant *prev = comp->nbuffer > 0 ? comp->buffer[0] : anchor;
+    deadreckoning_set_velocity(comp, prev, inst);
+    if (comp->nbuffer > 0)
+    {
+      pfree(comp->buffer[0]);
+      comp->nbuffer = 0;
+    }
+    compressor_output(comp, tinstant_copy(inst));
+  }
+  else
+  {
+    if (comp->nbuffer > 0)
+      pfree(comp->buffer[0]);
+    comp->buffer[0] = tinstant_copy(inst);
+    comp->nbuffer = 1;
+  }
+  return;
+}
+
+/**
+ * Keep the last instant received by a dead reckoning compressor
+ */
+static void
+deadreckoning_finish(TPointCompressor *comp)
+{
+  if (comp->nbuffer > 0)
+  {
+    compressor_output(comp, comp->buffer[0]);
+    comp->nbuffer = 0;
+  }
+  return;
+}
+
+/*****************************************************************************
+ * SQUISH-E
+ *****************************************************************************/
+
+/**
+ * Set the priority of an instant of the buffer of a SQUISH-E compressor,
+ * that is, the synchronized Euclidean distance introduced by its removal
+ * plus the error inherited from the instants previously removed next to it
+ */
+static void
+squish_set_priority(TPointCompressor *comp, int i)
+{
+  assert(i > 0 && i < comp->nbuffer - 1);
+  comp->priority[i] = comp->pi[i] + tpointinst_sed(comp->buffer[i],
+    comp->buffer[i - 1], comp->buffer[i + 1], comp->hasz);
+  return;
+}
+
+/**
+ * Return the position of the instant of the buffer of a SQUISH-E compressor
+ * with the lowest priority, or -1 if no instant can be removed
+ *
+ * @note The buffer is bounded and small, a linear scan is faster than the
+ * maintenance of a priority queue
+ */
+static int
+squish_min_priority(const TPointCompressor *comp)
+{
+  int result = -1;
+  double min = DBL_MAX;
+  for (int i = 1; i < comp->nbuffer - 1; i++)
+  {
+    if (comp->priority[i] < min)
+    {
+      min = comp->priority[i];
+      result = i;
+    }
+  }
+  return result;
+}
+
+/**
+ * Remove an instant from the buffer of a SQUISH-E compressor and update the
+ * priority of its neighbors
+ */
+static void
+squish_remove(TPointCompressor *comp, int i)
+{
+  assert(i > 0 && i < comp->nbuffer - 1);
+  double priority = comp->priority[i];
+  comp->pi[i - 1] = Max(comp->pi[i - 1], priority);
+  comp->pi[i + 1] = Max(comp->pi[i + 1], priority);
+  pfree(comp->buffer[i]);
+  int nmove = comp->nbuffer - i - 1;
+  memmove(&comp->buffer[i], &comp->buffer[i + 1], sizeof(TInstant *) * nmove);
+  memmove(&comp->priority[i], &comp->priority[i + 1], sizeof(double) * nmove);
+  memmove(&comp->pi[i], &comp->pi[i + 1], sizeof(double) * nmove);
+  comp->nbuffer--;
+  if (i - 1 > 0)
+    squish_set_priority(comp, i - 1);
+  if (i < comp->nbuffer - 1)
+    squish_set_priority(comp, i);
+  return;
+}
+
+/**
+ * Make room in the full buffer of a SQUISH-E compressor
+ *
+ * The instant with the lowest priority is removed if its priority is below
+ * the threshold. Otherwise the oldest instant of the buffer after the start
+ * point is kept and becomes the new start point of the buffer, which bounds
+ * the error of the compressed sequence by the threshold.
+ */
+static void
+squish_reduce(TPointCompressor *comp)
+{
+  int i = squish_min_priority(comp);
+  if (i > 0 && comp->priority[i] <= comp->eps_dist)
+  {
+    squish_remove(comp, i);
+    return;
+  }
+  /* The start point of the buffer is owned by the output */
+  compressor_output(comp, comp->buffer[1]);
+  int nmove = comp->nbuffer - 1;
+  memmove(&comp->buffer[0], &comp->buffer[1], sizeof(TInstant *) * nmove);
+  memmove(&comp->priority[0], &comp->priority[1], sizeof(double) * nmove);
+  memmove(&comp->pi[0], &comp->pi[1], sizeof(double) * nmove);
+  comp->nbuffer--;
+  comp->priority[0] = DBL_MAX;
+  return;
+}
+
+/**
+ * Append an instant to a SQUISH-E compressor
+ */
+static void
+squish_append(TPointCompressor *comp, const TInstant *inst)
+{
+  if (comp->nbuffer == comp->bufsize)
+    squish_reduce(comp);
+  int n = comp->nbuffer++;
+  comp->buffer[n] = tinstant_copy(inst);
+  comp->priority[n] = DBL_MAX;
+  comp->pi[n] = 0;
+  if (n >= 2)
+    squish_set_priority(comp, n - 1);
+  return;
+}
+
+/**
+ * Remove from the buffer of a SQUISH-E compressor the instants whose
+ * priority is below the threshold and keep the other ones
+ */
+static void
+squish_finish(TPointCompressor *comp)
+{
+  int i;
+  while ((i = squish_min_priority(comp)) > 0 &&
+      comp->priority[i] <= comp->eps_dist)
+    squish_remove(comp, i);
+  for (i = 1; i < comp->nbuffer; i++)
+    compressor_output(comp, comp->buffer[i]);
+  comp->nbuffer = 0;
+  return;
+}
+
+/*****************************************************************************
+ * Compressor functions
+ *****************************************************************************/
+
+/**
+ * @ingroup libmeos_temporal_analytics
+ * @brief Return an online compressor of temporal points.
+ *
+ * @param[in] method Compression method
+ * @param[in] eps_dist Distance threshold
+ * @param[in] bufsize Capacity of the buffer, only used by SQUISH-E
+ */
+TPointCompressor *
+tpoint_compressor_make(CompressMethod method, double eps_dist, int bufsize)
+{
+  if (eps_dist < 0)
+    elog(ERROR, "The distance threshold must be non-negative");
+  if (method == COMPRESS_SQUISHE && bufsize < COMPRESS_MIN_BUFSIZE)
+    elog(ERROR, "The buffer size must be at least %d", COMPRESS_MIN_BUFSIZE);
+  TPointCompressor *result = palloc0(sizeof(TPointCompressor));
+  result->method = method;
+  result->eps_dist = eps_dist;
+  result->bufsize = (method == COMPRESS_SQUISHE) ? bufsize : 1;
+  result->maxoutput = 64;
+  result->output = palloc(sizeof(TInstant *) * result->maxoutput);
+  result->buffer = palloc(sizeof(TInstant *) * result->bufsize);
+  if (method == COMPRESS_SQUISHE)
+  {
+    result->priority = palloc(sizeof(double) * result->bufsize);
+    result->pi = palloc(sizeof(double) * result->bufsize);
+  }
+  return result;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics
+ * @brief Append an instant to an online compressor of temporal points.
+ *
+ * The instants must be appended in increasing timestamp order. The instant
+ * is copied if it is kept by the compressor.
+ */
+void
+tpoint_compressor_append(TPointCompressor *comp, const TInstant *inst)
+{
+  ensure_not_geodetic(inst->flags);
+  if (comp->noutput == 0)
+  {
+    comp->hasz = MOBDB_FLAGS_GET_Z(inst->flags) != 0;
+    comp->srid = tpointinst_srid(inst);
+    TInstant *copy = tinstant_copy(inst);
+    compressor_output(comp, copy);
+    if (comp->method == COMPRESS_SQUISHE)
+    {
+      /* The first instant is the start point of the buffer */
+      comp->buffer[0] = copy;
+      comp->priority[0] = DBL_MAX;
+      comp->pi[0] = 0;
+      comp->nbuffer = 1;
+    }
+    return;
+  }
+
+  ensure_same_srid(comp->srid, tpointinst_srid(inst));
+  ensure_same_dimensionality(comp->output[0]->flags, inst->flags);
+  const TInstant *last = (comp->nbuffer > 0) ?
+    comp->buffer[comp->nbuffer - 1] : comp->output[comp->noutput - 1];
+  if (last->t >= inst->t)
+    elog(ERROR, "The instants must be appended in increasing timestamp order");
+
+  if (comp->method == COMPRESS_DEADRECKONING)
+    deadreckoning_append(comp, inst);
+  else /* comp->method == COMPRESS_SQUISHE */
+    squish_append(comp, inst);
+  return;
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics
+ * @brief Return the temporal sequence point with linear interpolation made
+ * of the instants kept by an online compressor, or NULL if no instant was
+ * appended.
+ *
+ * No instant can be appended to the compressor after this call.
+ */
+TSequence *
+tpoint_compressor_finish(TPointCompressor *comp)
+{
+  if (comp->method == COMPRESS_DEADRECKONING)
+    deadreckoning_finish(comp);
+  else /* comp->method == COMPRESS_SQUISHE */
+    squish_finish(comp);
+  if (comp->noutput == 0)
+    return NULL;
+  return tsequence_make((const TInstant **) comp->output, comp->noutput,
+    true, true, LINEAR, NORMALIZE);
+}
+
+/**
+ * @ingroup libmeos_temporal_analytics
+ * @brief Free an online compressor of temporal points.
+ */
+void
+tpoint_compressor_free(TPointCompressor *comp)
+{
+  /* The start point of the SQUISH-E buffer is owned by the output */
+  int first = (comp->method == COMPRESS_SQUISHE) ? 1 : 0;
+  for (int i = first; i < comp->nbuffer; i++)
+    pfree(comp->buffer[i]);
+  pfree_array((void **) comp->output, comp->noutput);
+  pfree(comp->buffer);
+  if (comp->method == COMPRESS_SQUISHE)
+  {
+    pfree(comp->priority);
+    pfree(comp->pi);
+  }
+  pfree(comp);
+  return;
+}
+
+/*****************************************************************************/
@@ -410,6 +410,256 @@ distance_tpoint_geo(const Temporal *temp, const GSERIALIZED *geo)
   return result;
 }
 
+/*****************************************************************************
+ * Temporal distance between linear geometric sequences
+ *****************************************************************************/
+
+/**
+ * Coordinates of two synchronized temporal point sequences, stored as one
+ * array per coordinate so that the loops over the segments are vectorized
+ * by the compiler
+ */
+typedef struct
+{
+  int count;                   /**< Number of synchronized instants */
+  TimestampTz *t;              /**< Timestamps */
+  double *x1, *y1, *z1;        /**< Coordinates of the first sequence */
+  double *x2, *y2, *z2;        /**< Coordinates of the second sequence */
+} SyncCoords;
+
+/**
+ * Get the coordinates of a temporal sequence point at a timestamp
+ *
+ * @param[in] seq Temporal sequence
+ * @param[in] i Index of the segment containing the timestamp, or of the last
+ * instant if the timestamp is the last one of the sequence
+ * @param[in] t Timestamp
+ * @param[in] hasz True when the points have Z coordinates
+ * @param[out] x,y,z Coordinates
+ * @note Same computation as function tsegment_value_at_timestamp
+ */
+static void
+tpointseq_coords_at(const TSequence *seq, int i, TimestampTz t, bool hasz,
+  double *x, double *y, double *z)
+{
+  const TInstant *inst1 = tsequence_inst_n(seq, i);
+  POINT3DZ p1, p2;
+  if (hasz)
+    p1 = *datum_point3dz_p(tinstant_value(inst1));
+  else
+  {
+    p1.z = 0;
+    memcpy(&p1, datum_point2d_p(tinstant_value(inst1)), sizeof(POINT2D));
+  }
+  if (inst1->t == t)
+  {
+    *x = p1.x; *y = p1.y; *z = p1.z;
+    return;
+  }
+  const TInstant *inst2 = tsequence_inst_n(seq, i + 1);
+  if (hasz)
+    p2 = *datum_point3dz_p(tinstant_value(inst2));
+  else
+  {
+    p2.z = 0;
+    memcpy(&p2, datum_point2d_p(tinstant_value(inst2)), sizeof(POINT2D));
+  }
+  long double ratio = (long double) (t - inst1->t) /
+    (long double) (inst2->t - inst1->t);
+  *x = p1.x + ((long double) (p2.x - p1.x) * ratio);
+  *y = p1.y + ((long double) (p2.y - p1.y) * ratio);
+  *z = p1.z + ((long double) (p2.z - p1.z) * ratio);
+  return;
+}
+
+/**
+ * Synchronize two temporal sequence points on their common period
+ *
+ * @param[in] seq1,seq2 Temporal sequences
+ * @param[in] inter Common period of the sequences
+ * @param[in] hasz True when the points have Z coordinates
+ * @param[out] sync Synchronized coordinates
+ */
+static void
+tpointseq_sync_coords(const TSequence *seq1, const TSequence *seq2,
+  const Period *inter, bool hasz, SyncCoords *sync)
+{
+  int n = seq1->count + seq2->count;
+  sync->t = palloc(sizeof(TimestampTz) * n);
+  double *coords = palloc(sizeof(double) * n * 6);
+  sync->x1 = coords; sync->y1 = coords + n; sync->z1 = coords + 2 * n;
+  sync->x2 = coords + 3 * n; sync->y2 = coords + 4 * n;
+  sync->z2 = coords + 5 * n;
+
+  TimestampTz lower = DatumGetTimestampTz(inter->lower);
+  TimestampTz upper = DatumGetTimestampTz(inter->upper);
+  int i = 0, j = 0, k = 0;
+  while (i < seq1->count - 1 && tsequence_inst_n(seq1, i + 1)->t <= lower)
+    i++;
+  while (j < seq2->count - 1 && tsequence_inst_n(seq2, j + 1)->t <= lower)
+    j++;
+  TimestampTz t = lower;
+  for (;;)
+  {
+    sync->t[k] = t;
+    tpointseq_coords_at(seq1, i, t, hasz, &sync->x1[k], &sync->y1[k],
+      &sync->z1[k]);
+    tpointseq_coords_at(seq2, j, t, hasz, &sync->x2[k], &sync->y2[k],
+      &sync->z2[k]);
+    k++;
+    if (t == upper)
+      break;
+    /* Since t < upper both sequences have a next instant */
+    TimestampTz t1 = tsequence_inst_n(seq1, i + 1)->t;
+    TimestampTz t2 = tsequence_inst_n(seq2, j + 1)->t;
+    t = Min(t1, t2);
+    if (t1 == t)
+      i++;
+    if (t2 == t)
+      j++;
+  }
+  sync->count = k;
+  return;
+}
+
+/**
+ * Return the distance at the turning point of a synchronized segment, if any
+ *
+ * @param[in] sync Synchronized coordinates
+ * @param[in] k Index of the end instant of the segment
+ * @param[in] hasz True when the points have Z coordinates
+ * @param[out] value Distance at the turning point
+ * @param[out] t Timestamp of the turning point
+ * @note Same computation as function tgeompoint_min_dist_at_timestamp
+ */
+static bool
+sync_coords_min_dist_at_timestamp(const SyncCoords *sync, int k, bool hasz,
+  double *value, TimestampTz *t)
+{
+  double fraction;
+  bool found;
+  if (hasz)
+  {
+    POINT3DZ p1 = {sync->x1[k - 1], sync->y1[k - 1], sync->z1[k - 1]};
+    POINT3DZ p2 = {sync->x1[k], sync->y1[k], sync->z1[k]};
+    POINT3DZ p3 = {sync->x2[k - 1], sync->y2[k - 1], sync->z2[k - 1]};
+    POINT3DZ p4 = {sync->x2[k], sync->y2[k], sync->z2[k]};
+    found = point3d_min_dist(&p1, &p2, &p3, &p4, &fraction);
+  }
+  else
+  {
+    POINT2D p1 = {sync->x1[k - 1], sync->y1[k - 1]};
+    POINT2D p2 = {sync->x1[k], sync->y1[k]};
+    POINT2D p3 = {sync->x2[k - 1], sync->y2[k - 1]};
+    POINT2D p4 = {sync->x2[k], sync->y2[k]};
+    found = point2d_min_dist(&p1, &p2, &p3, &p4, &fraction);
+  }
+  if (! found || fraction <= MOBDB_EPSILON ||
+      fraction >= (1.0 - MOBDB_EPSILON))
+    return false;
+
+  TimestampTz t1 = sync->t[k - 1], t2 = sync->t[k];
+  long double duration = (long double) (t2 - t1);
+  *t = t1 + (TimestampTz) (duration * fraction);
+  double x1, y1, z1, x2, y2, z2;
+  if (*t == t2)
+  {
+    x1 = sync->x1[k]; y1 = sync->y1[k]; z1 = sync->z1[k];
+    x2 = sync->x2[k]; y2 = sync->y2[k]; z2 = sync->z2[k];
+  }
+  else
+  {
+    long double ratio = (long double) (*t - t1) / duration;
+    x1 = sync->x1[k - 1] + ((long double) (sync->x1[k] - sync->x1[k - 1]) * ratio);
+    y1 = sync->y1[k - 1] + ((long double) (sync->y1[k] - sync->y1[k - 1]) * ratio);
+    z1 = sync->z1[k - 1] + ((long double) (sync->z1[k] - sync->z1[k - 1]) * ratio);
+    x2 = sync->x2[k - 1] + ((long double) (sync->x2[k] - sync->x2[k - 1]) * ratio);
+    y2 = sync->y2[k - 1] + ((long double) (sync->y2[k] - sync->y2[k - 1]) * ratio);
+    z2 = sync->z2[k - 1] + ((long double) (sync->z2[k] - sync->z2[k - 1]) * ratio);
+  }
+  double dx = x2 - x1, dy = y2 - y1, dz = z2 - z1;
+  *value = hasz ? sqrt(dx * dx + dy * dy + dz * dz) : sqrt(dx * dx + dy * dy);
+  return true;
+}
+
+/**
+ * Return the temporal distance between two temporal geometric sequence
+ * points with linear interpolation
+ *
+ * The distances at the synchronized instants and a conservative test of
+ * whether a segment may have a turning point are computed in loops without
+ * branches over the coordinate arrays. The turning points are then only
+ * computed for the candidate segments, in extended precision as in the
+ * lifted computation, so that the result is the same.
+ *
+ * @param[in] seq1,seq2 Temporal sequences
+ * @param[in] inter Common period of the sequences
+ * @pre The common period is not instantaneous
+ */
+static TSequence *
+distance_tpointseq_tpointseq_linear(const TSequence *seq1,
+  const TSequence *seq2, const Period *inter)
+{
+  bool hasz = MOBDB_FLAGS_GET_Z(seq1->flags);
+  SyncCoords sync;
+  tpointseq_sync_coords(seq1, seq2, inter, hasz, &sync);
+  int n = sync.count;
+
+  /* Distances at the synchronized instants */
+  double *dist = palloc(sizeof(double) * n);
+  for (int k = 0; k < n; k++)
+  {
+    double dx = sync.x2[k] - sync.x1[k];
+    double dy = sync.y2[k] - sync.y1[k];
+    double dz = sync.z2[k] - sync.z1[k];
+    dist[k] = hasz ? sqrt(dx * dx + dy * dy + dz * dz) :
+      sqrt(dx * dx + dy * dy);
+  }
+
+  /* Segments that may have a turning point. The fraction of the turning
+   * point is -dot0 / sq where dot0 is the dot product of the difference
+   * vector at the start of the segment and its variation sq. A margin much
+   * larger than the rounding errors of the test is added to the bounds. */
+  bool *cand = palloc(sizeof(bool) * n);
+  for (int k = 1; k < n; k++)
+  {
+    double vx = (sync.x2[k] - sync.x2[k - 1]) - (sync.x1[k] - sync.x1[k - 1]);
+    double vy = (sync.y2[k] - sync.y2[k - 1]) - (sync.y1[k] - sync.y1[k - 1]);
+    double vz = (sync.z2[k] - sync.z2[k - 1]) - (sync.z1[k] - sync.z1[k - 1]);
+    double dx = sync.x2[k - 1] - sync.x1[k - 1];
+    double dy = sync.y2[k - 1] - sync.y1[k - 1];
+    double dz = sync.z2[k - 1] - sync.z1[k - 1];
+    double dot0 = dx * vx + dy * vy + dz * vz;
+    double sq = vx * vx + vy * vy + vz * vz;
+    double abssum =
+      (fabs(sync.x1[k - 1]) + fabs(sync.x2[k - 1])) * fabs(vx) +
+      (fabs(sync.y1[k - 1]) + fabs(sync.y2[k - 1])) * fabs(vy) +
+      (fabs(sync.z1[k - 1]) + fabs(sync.z2[k - 1])) * fabs(vz);
+    double margin = MOBDB_EPSILON * sq + 1e-12 * abssum;
+    cand[k] = (vx != 0 || vy != 0 || vz != 0) && dot0 < margin &&
+      dot0 + sq > -margin;
+  }
+
+  TInstant **instants = palloc(sizeof(TInstant *) * n * 2);
+  int count = 0;
+  for (int k = 0; k < n; k++)
+  {
+    double value;
+    TimestampTz t;
+    if (k > 0 && cand[k] &&
+        sync_coords_min_dist_at_timestamp(&sync, k, hasz, &value, &t))
+      instants[count++] = tinstant_make(Float8GetDatum(value), T_TFLOAT, t);
+    instants[count++] = tinstant_make(Float8GetDatum(dist[k]), T_TFLOAT,
+      sync.t[k]);
+  }
+  pfree(sync.t); pfree(sync.x1);
+  pfree(dist); pfree(cand);
+  return tsequence_make_free(instants, count, inter->lower_inc,
+    inter->upper_inc, LINEAR, NORMALIZE);
+}
+
+/*****************************************************************************/
+
 /**
  * @ingroup libmeos_temporal_dist
  * @brief Return the temporal distance between two temporal points.
@@ -421,6 +671,22 @@ distance_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
   ensure_same_srid(tpoint_srid(temp1), tpoint_srid(temp2));
   ensure_same_dimensionality(temp1->flags, temp2->flags);
 
+  /* Dedicated kernel for linear geometric sequences */
+  if (temp1->subtype == TSEQUENCE && temp2->subtype == TSEQUENCE &&
+      MOBDB_FLAGS_GET_LINEAR(temp1->flags) &&
+      MOBDB_FLAGS_GET_LINEAR(temp2->flags) &&
+      ! MOBDB_FLAGS_GET_GEODETIC(temp1->flags))
+  {
+    const TSequence *seq1 = (const TSequence *) temp1;
+    const TSequence *seq2 = (const TSequence *) temp2;
+    Period inter;
+    if (! inter_span_span(&seq1->period, &seq2->period, &inter))
+      return NULL;
+    if (inter.lower != inter.upper)
+      return (Temporal *) distance_tpointseq_tpointseq_linear(seq1, seq2,
+        &inter);
+  }
+
   LiftedFunctionInfo lfinfo;
   memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
   lfinfo.func = (varfunc) pt_distance_fn(temp1->flags);
@@ -754,6 +1020,167 @@ nai_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
  * Nearest approach distance (NAD)
  *****************************************************************************/
 
+/**
+ * Pair of parts of the arguments of a nearest approach distance
+ */
+typedef struct
+{
+  int i;                       /**< Part of the first argument */
+  int j;                       /**< Part of the second argument */
+  double boxdist;              /**< Distance between the boxes of the parts */
+} NADPair;
+
+/**
+ * Comparator of pairs of parts on the distance between their boxes
+ */
+static int
+nadpair_cmp(const void *a, const void *b)
+{
+  double d1 = ((const NADPair *) a)->boxdist;
+  double d2 = ((const NADPair *) b)->boxdist;
+  return (d1 < d2) ? -1 : ((d1 > d2) ? 1 : 0);
+}
+
+/**
+ * Return the gap between two intervals of values, 0 if they intersect
+ */
+static double
+interval_gap(double min1, double max1, double min2, double max2)
+{
+  double gap = Max(min1 - max2, min2 - max1);
+  return Max(gap, 0.0);
+}
+
+/**
+ * Return the distance between the spatial extent of a spatiotemporal box and
+ * the planar extent given by its bounds, which is a lower bound of the
+ * distance between the geometries they contain
+ */
+static double
+stbox_extent_distance(const STBOX *box, double xmin, double xmax,
+  double ymin, double ymax, double zmin, double zmax, bool hasz)
+{
+  double dx = interval_gap(box->xmin, box->xmax, xmin, xmax);
+  double dy = interval_gap(box->ymin, box->ymax, ymin, ymax);
+  double dz = hasz ? interval_gap(box->zmin, box->zmax, zmin, zmax) : 0.0;
+  return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/**
+ * Return the parts of a temporal point in which the nearest approach
+ * distance is decomposed and their bounding boxes, that is, the composing
+ * sequences of a temporal sequence set and the value itself otherwise
+ */
+static const Temporal **
+tpoint_nad_parts(const Temporal *temp, STBOX **boxes, int *count)
+{
+  const Temporal **result;
+  if (temp->subtype == TSEQUENCESET)
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    *count = ss->count;
+    result = palloc(sizeof(Temporal *) * ss->count);
+    for (int i = 0; i < ss->count; i++)
+      result[i] = (const Temporal *) tsequenceset_seq_n(ss, i);
+  }
+  else
+  {
+    *count = 1;
+    result = palloc(sizeof(Temporal *));
+    result[0] = temp;
+  }
+  *boxes = palloc(sizeof(STBOX) * *count);
+  for (int i = 0; i < *count; i++)
+    temporal_set_bbox(result[i], &(*boxes)[i]);
+  return result;
+}
+
+/**
+ * Return the nearest approach distance between a temporal point and a
+ * geometry with planar coordinates
+ *
+ * The composing sequences of the temporal point and the parts of the
+ * geometry are paired and the pairs are visited by increasing distance of
+ * their bounding boxes. The pairs whose box distance is not less than the
+ * best distance found so far are pruned, and the trajectories of the
+ * sequences are only computed for the pairs that survive. The traversal
+ * stops when a zero distance is found.
+ */
+static double
+nad_tpoint_geom(const Temporal *temp, const GSERIALIZED *gs)
+{
+  bool hasz = MOBDB_FLAGS_GET_Z(temp->flags);
+  int ntparts;
+  STBOX *tboxes;
+  const Temporal **tparts = tpoint_nad_parts(temp, &tboxes, &ntparts);
+
+  /* Parts of the geometry with their boxes */
+  LWGEOM *geo = lwgeom_from_gserialized(gs);
+  int ngparts = lwgeom_is_collection(geo) ?
+    (int) ((LWCOLLECTION *) geo)->ngeoms : 1;
+  LWGEOM **gparts = palloc(sizeof(LWGEOM *) * ngparts);
+  GBOX *gboxes = palloc(sizeof(GBOX) * ngparts);
+  int k = 0;
+  for (int i = 0; i < ngparts; i++)
+  {
+    LWGEOM *part = lwgeom_is_collection(geo) ?
+      ((LWCOLLECTION *) geo)->geoms[i] : geo;
+    if (lwgeom_calculate_gbox(part, &gboxes[k]) == LW_SUCCESS)
+      gparts[k++] = part;
+  }
+  ngparts = k;
+
+  NADPair *pairs = palloc(sizeof(NADPair) * Max(ntparts * ngparts, 1));
+  int npairs = 0;
+  for (int i = 0; i < ntparts; i++)
+  {
+    for (int j = 0; j < ngparts; j++)
+    {
+      pairs[npairs].i = i;
+      pairs[npairs].j = j;
+      pairs[npairs++].boxdist = stbox_extent_distance(&tboxes[i],
+        gboxes[j].xmin, gboxes[j].xmax, gboxes[j].ymin, gboxes[j].ymax,
+        gboxes[j].zmin, gboxes[j].zmax, hasz);
+    }
+  }
+  qsort(pairs, npairs, sizeof(NADPair), &nadpair_cmp);
+
+  /* The trajectories of the parts are computed on demand */
+  GSERIALIZED **trajs = palloc0(sizeof(GSERIALIZED *) * ntparts);
+  LWGEOM **lwtrajs = palloc0(sizeof(LWGEOM *) * ntparts);
+  double result = DBL_MAX;
+  for (k = 0; k < npairs && result > 0.0; k++)
+  {
+    if (pairs[k].boxdist >= result)
+      break;
+    int i = pairs[k].i;
+    if (! lwtrajs[i])
+    {
+      trajs[i] = tpoint_trajectory(tparts[i]);
+      lwtrajs[i] = lwgeom_from_gserialized(trajs[i]);
+    }
+    double dist = hasz ?
+      lwgeom_mindistance3d(lwtrajs[i], gparts[pairs[k].j]) :
+      lwgeom_mindistance2d(lwtrajs[i], gparts[pairs[k].j]);
+    if (dist < result)
+      result = dist;
+  }
+
+  for (int i = 0; i < ntparts; i++)
+  {
+    if (lwtrajs[i])
+    {
+      lwgeom_free(lwtrajs[i]);
+      pfree(trajs[i]);
+    }
+  }
+  pfree(trajs); pfree(lwtrajs); pfree(pairs);
+  pfree(gparts); pfree(gboxes); lwgeom_free(geo);
+  pfree(tparts); pfree(tboxes);
+  /* As for the distance between geometries, return -1 for empty parts */
+  return (result < FLT_MAX) ? result : -1;
+}
+
 /**
  * @ingroup libmeos_temporal_dist
  * @brief Return the nearest approach distance between a temporal point
@@ -767,6 +1194,8 @@ nad_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
     return -1;
   ensure_same_srid(tpoint_srid(temp), gserialized_get_srid(gs));
   ensure_same_dimensionality_tpoint_gs(temp, gs);
+  if (! MOBDB_FLAGS_GET_GEODETIC(temp->flags))
+    return nad_tpoint_geom(temp, gs);
   datum_func2 func = distance_fn(temp->flags);
   Datum traj = PointerGetDatum(tpoint_trajectory(temp));
   double result = DatumGetFloat8(func(traj, PointerGetDatum(gs)));
@@ -871,6 +1300,76 @@ nad_tpoint_stbox(const Temporal *temp, const STBOX *box)
   return result;
 }
 
+/**
+ * Return the nearest approach distance between two temporal points with
+ * planar coordinates
+ *
+ * The composing sequences of the temporal points whose periods overlap are
+ * paired and the pairs are visited by increasing distance of their bounding
+ * boxes. The temporal distance is only computed for the pairs whose box
+ * distance is less than the best distance found so far, and the traversal
+ * stops when a zero distance is found.
+ */
+static double
+nad_tpoint_tpoint_geom(const Temporal *temp1, const Temporal *temp2)
+{
+  bool hasz = MOBDB_FLAGS_GET_Z(temp1->flags);
+  int count1, count2;
+  STBOX *boxes1, *boxes2;
+  const Temporal **parts1 = tpoint_nad_parts(temp1, &boxes1, &count1);
+  const Temporal **parts2 = tpoint_nad_parts(temp2, &boxes2, &count2);
+
+  /* Pairs of parts whose periods overlap, the parts are ordered by time */
+  NADPair *pairs = palloc(sizeof(NADPair) * (count1 + count2));
+  int maxpairs = count1 + count2, npairs = 0, start = 0;
+  for (int i = 0; i < count1; i++)
+  {
+    const Period *p1 = &boxes1[i].period;
+    while (start < count2 && DatumGetTimestampTz(boxes2[start].period.upper) <
+        DatumGetTimestampTz(p1->lower))
+      start++;
+    for (int j = start; j < count2 &&
+        DatumGetTimestampTz(boxes2[j].period.lower) <=
+        DatumGetTimestampTz(p1->upper); j++)
+    {
+      if (! overlaps_span_span(p1, &boxes2[j].period))
+        continue;
+      if (npairs == maxpairs)
+      {
+        maxpairs *= 2;
+        pairs = repalloc(pairs, sizeof(NADPair) * maxpairs);
+      }
+      const STBOX *box2 = &boxes2[j];
+      pairs[npairs].i = i;
+      pairs[npairs].j = j;
+      pairs[npairs++].boxdist = stbox_extent_distance(&boxes1[i],
+        box2->xmin, box2->xmax, box2->ymin, box2->ymax, box2->zmin,
+        box2->zmax, hasz);
+    }
+  }
+  qsort(pairs, npairs, sizeof(NADPair), &nadpair_cmp);
+
+  double result = DBL_MAX;
+  for (int k = 0; k < npairs && result > 0.0; k++)
+  {
+    if (pairs[k].boxdist >= result)
+      break;
+    Temporal *dist = distance_tpoint_tpoint(parts1[pairs[k].i],
+      parts2[pairs[k].j]);
+    if (dist == NULL)
+      continue;
+    double d = DatumGetFloat8(temporal_min_value(dist));
+    pfree(dist);
+    if (d < result)
+      result = d;
+  }
+
+  pfree(pairs);
+  pfree(parts1); pfree(boxes1);
+  pfree(parts2); pfree(boxes2);
+  return (result == DBL_MAX) ? -1 : result;
+}
+
 /**
  * @ingroup libmeos_temporal_dist
  * @brief Return the nearest approach distance between the temporal points
@@ -881,6 +1380,8 @@ nad_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
 {
   ensure_same_srid(tpoint_srid(temp1), tpoint_srid(temp2));
   ensure_same_dimensionality(temp1->flags, temp2->flags);
+  if (! MOBDB_FLAGS_GET_GEODETIC(temp1->flags))
+    return nad_tpoint_tpoint_geom(temp1, temp2);
   Temporal *dist = distance_tpoint_tpoint(temp1, temp2);
   if (dist == NULL)
     return -1;
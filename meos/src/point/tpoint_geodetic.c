@@ -0,0 +1,249 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Geodetic acceleration structures for temporal geography points.
+ *
+ * The PostGIS functions on geographies deserialize their arguments and set
+ * up the spheroid and the geodetic points on every call. The functions in
+ * this file compute these values once per sequence and share them between
+ * the segments of the sequence, and provide a fast path for the distance
+ * thresholds between two geography points.
+ */
+
+#include "point/tpoint_geodetic.h"
+
+/* C */
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+/* MobilityDB */
+#include <meos.h>
+#include <meos_internal.h>
+#include "point/tpoint_spatialfuncs.h"
+
+/* Tolerance used by PostGIS for the distance between geographies */
+#define GEOD_FP_TOLERANCE 1e-12
+
+/*
+ * Parameters of the local tangent plane approximation of the distance.
+ * For points up to 100 km apart and with latitudes within +/- 80 degrees
+ * the relative error of the approximation with respect to the distance on
+ * the WGS84 spheroid, sampled against Vincenty's formulae, is below 4e-4.
+ * The margin used to decide a distance threshold with the approximation is
+ * set far above this bound.
+ */
+#define GEOD_APPROX_MAX_DIST    1.0e5
+#define GEOD_APPROX_MAX_LAT     80.0
+#define GEOD_APPROX_MARGIN      1.0e-2
+#define WGS84_FLATTENING        (1.0 / WGS84_INVERSE_FLATTENING)
+#define WGS84_ECCENTRICITY_SQ   (WGS84_FLATTENING * (2.0 - WGS84_FLATTENING))
+
+/*****************************************************************************
+ * Distance between geography points
+ *****************************************************************************/
+
+/**
+ * Return the distance in meters between two geodetic points on a spheroid
+ * @note Same computation as the point/point case of the PostGIS function
+ * lwgeom_distance_spheroid with the default tolerance
+ */
+static double
+geodetic_point_distance(const GEOGRAPHIC_POINT *g1,
+  const GEOGRAPHIC_POINT *g2, const SPHEROID *s)
+{
+  /* Sphere special case, axes equal */
+  double result = s->radius * sphere_distance(g1, g2);
+  if (s->a == s->b)
+    return result;
+  /* Below tolerance, actual distance isn't of interest */
+  if (result < 0.95 * GEOD_FP_TOLERANCE)
+    return result;
+  return spheroid_distance(g1, g2, s);
+}
+
+/**
+ * Return the distance between two geography points
+ * @note Same result as function geog_distance without deserializing the
+ * points nor computing their bounding boxes
+ */
+Datum
+pt_distance_geog(Datum geog1, Datum geog2)
+{
+  const POINT2D *p1 = datum_point2d_p(geog1);
+  const POINT2D *p2 = datum_point2d_p(geog2);
+  SPHEROID s;
+  spheroid_init(&s, WGS84_MAJOR_AXIS, WGS84_MINOR_AXIS);
+  GEOGRAPHIC_POINT g1, g2;
+  geographic_point_init(p1->x, p1->y, &g1);
+  geographic_point_init(p2->x, p2->y, &g2);
+  return Float8GetDatum(geodetic_point_distance(&g1, &g2, &s));
+}
+
+/**
+ * Determine whether two geography points are within a distance using a
+ * local tangent plane approximation of the WGS84 spheroid
+ *
+ * The distance is approximated in the plane tangent to the spheroid at the
+ * mean latitude of the points, scaled by the meridian and prime vertical
+ * radii of curvature at this latitude.
+ *
+ * @param[in] p1,p2 Points in degrees
+ * @param[in] dist Distance in meters
+ * @param[out] result Result when it can be decided
+ * @return False when the points are too far away or too close to the poles
+ * for the approximation, or when their distance is too close to the
+ * threshold to decide the result with the approximation
+ */
+bool
+geog_point_dwithin_approx(const POINT2D *p1, const POINT2D *p2, double dist,
+  bool *result)
+{
+  if (fabs(p1->y) > GEOD_APPROX_MAX_LAT || fabs(p2->y) > GEOD_APPROX_MAX_LAT)
+    return false;
+  double lat = deg2rad((p1->y + p2->y) / 2.0);
+  double sinlat = sin(lat);
+  double w = 1.0 - WGS84_ECCENTRICITY_SQ * sinlat * sinlat;
+  /* Meridian and prime vertical radii of curvature */
+  double m = WGS84_MAJOR_AXIS * (1.0 - WGS84_ECCENTRICITY_SQ) / (w * sqrt(w));
+  double n = WGS84_MAJOR_AXIS / sqrt(w);
+  /* Longitude difference normalized to [-pi, pi] */
+  double dlon = deg2rad(p2->x - p1->x);
+  if (dlon > M_PI)
+    dlon -= 2.0 * M_PI;
+  else if (dlon < -M_PI)
+    dlon += 2.0 * M_PI;
+  double dx = n * cos(lat) * dlon;
+  double dy = m * deg2rad(p2->y - p1->y);
+  double d = sqrt(dx * dx + dy * dy);
+  if (d > GEOD_APPROX_MAX_DIST)
+    return false;
+  if (d < dist * (1.0 - GEOD_APPROX_MARGIN))
+  {
+    *result = true;
+    return true;
+  }
+  if (d > dist * (1.0 + GEOD_APPROX_MARGIN))
+  {
+    *result = false;
+    return true;
+  }
+  return false;
+}
+
+/*****************************************************************************
+ * Geodetic cache of a temporal sequence
+ *****************************************************************************/
+
+/**
+ * Return the geodetic cache of a temporal geography point sequence
+ */
+GeodSeqCache *
+geodseq_cache_make(const TSequence *seq)
+{
+  assert(MOBDB_FLAGS_GET_GEODETIC(seq->flags));
+  bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
+  GeodSeqCache *result = palloc(sizeof(GeodSeqCache));
+  spheroid_init(&result->s, WGS84_MAJOR_AXIS, WGS84_MINOR_AXIS);
+  result->count = seq->count;
+  result->points = palloc(sizeof(GEOGRAPHIC_POINT) * seq->count);
+  result->z = hasz ? palloc(sizeof(double) * seq->count) : NULL;
+  result->seglength = palloc(sizeof(double) * seq->count);
+  for (int i = 0; i < seq->count; i++)
+  {
+    Datum value = tinstant_value(tsequence_inst_n(seq, i));
+    if (hasz)
+    {
+      const POINT3DZ *p = datum_point3dz_p(value);
+      geographic_point_init(p->x, p->y, &result->points[i]);
+      result->z[i] = p->z;
+    }
+    else
+    {
+      const POINT2D *p = datum_point2d_p(value);
+      geographic_point_init(p->x, p->y, &result->points[i]);
+    }
+    result->seglength[i] = -1.0;
+  }
+  return result;
+}
+
+/**
+ * Free the geodetic cache of a temporal geography point sequence
+ */
+void
+geodseq_cache_free(GeodSeqCache *cache)
+{
+  pfree(cache->points);
+  if (cache->z)
+    pfree(cache->z);
+  pfree(cache->seglength);
+  pfree(cache);
+  return;
+}
+
+/**
+ * Return the length on the spheroid of the n-th segment of the sequence,
+ * that is, the distance between its n-th and (n+1)-th points
+ * @note As for the distance between geographies, the Z values are ignored
+ */
+double
+geodseq_cache_seglength(GeodSeqCache *cache, int i)
+{
+  assert(i >= 0 && i < cache->count - 1);
+  if (cache->seglength[i] < 0.0)
+    cache->seglength[i] = geodetic_point_distance(&cache->points[i],
+      &cache->points[i + 1], &cache->s);
+  return cache->seglength[i];
+}
+
+/**
+ * Return the length of the trajectory of the sequence
+ * @note Same computation as the PostGIS function ptarray_length_spheroid,
+ * which takes into account the Z values, except that the segments shorter
+ * than the tolerance are measured on the sphere
+ */
+double
+geodseq_cache_length(GeodSeqCache *cache)
+{
+  double result = 0.0;
+  for (int i = 0; i < cache->count - 1; i++)
+  {
+    double seglength = geodseq_cache_seglength(cache, i);
+    if (cache->z)
+    {
+      double dz = cache->z[i + 1] - cache->z[i];
+      seglength = sqrt(dz * dz + seglength * seglength);
+    }
+    result += seglength;
+  }
+  return result;
+}
+
+/*****************************************************************************/
@@ -51,6 +51,7 @@
 #include "general/tnumber_mathfuncs.h"
 #include "point/pgis_call.h"
 #include "point/tpoint_boxops.h"
+#include "point/tpoint_geodetic.h"
 #include "point/tpoint_spatialrels.h"
 
 /*****************************************************************************
@@ -255,7 +256,7 @@ pt_distance_fn(int16 flags)
 {
   datum_func2 result;
   if (MOBDB_FLAGS_GET_GEODETIC(flags))
-    result = &geog_distance;
+    result = &pt_distance_geog;
   else
     result = MOBDB_FLAGS_GET_Z(flags) ?
       &pt_distance3d : &pt_distance2d;
@@ -1707,6 +1708,47 @@ lwline_make(Datum value1, Datum value2)
 
 /*****************************************************************************/
 
+/**
+ * Append the coordinates of a temporal point instant to a point array
+ * constructed with enough capacity, copying them directly from the
+ * serialized point
+ *
+ * @param[in] pa Point array
+ * @param[in] npoints Number of points already in the point array
+ * @param[in] inst Temporal instant
+ * @param[in] dedup True when the point is not appended if it is equal to
+ * the last one of the point array
+ * @result Number of points in the point array
+ */
+static uint32_t
+ptarray_append_tpointinst(POINTARRAY *pa, uint32_t npoints,
+  const TInstant *inst, bool dedup)
+{
+  const GSERIALIZED *gs = DatumGetGserializedP(tinstant_value(inst));
+  size_t ptsize = ptarray_point_size(pa);
+  uint8_t *pt = getPoint_internal(pa, npoints);
+  memcpy(pt, GS_POINT_PTR(gs), ptsize);
+  /* Same test as in lwpoint_same */
+  if (dedup && npoints > 0 && memcmp(pt - ptsize, pt, ptsize) == 0)
+    return npoints;
+  return npoints + 1;
+}
+
+/**
+ * Return the bounding box of the trajectory of a temporal point computed
+ * from its spatiotemporal box, or NULL for geographies since their boxes
+ * must also cover the great circle arcs between the points
+ */
+static GBOX *
+tpoint_trajectory_gbox(const STBOX *box)
+{
+  if (MOBDB_FLAGS_GET_GEODETIC(box->flags))
+    return NULL;
+  GBOX *result = palloc(sizeof(GBOX));
+  stbox_set_gbox(box, result);
+  return result;
+}
+
 /**
  * @ingroup libmeos_int_temporal_spatial_accessor
  * @brief Compute the trajectory of a temporal instant set point
@@ -1722,19 +1764,55 @@ tpointinstset_trajectory(const TInstantSet *is)
   if (is->count == 1)
     return DatumGetGserializedP(tinstant_value_copy(tinstantset_inst_n(is, 0)));
 
-  LWGEOM **points = palloc(sizeof(LWGEOM *) * is->count);
+  /* Copy the coordinates into a single point array */
+  POINTARRAY *pa = ptarray_construct(MOBDB_FLAGS_GET_Z(is->flags), 0,
+    (uint32_t) is->count);
+  uint32_t npoints = 0;
   for (int i = 0; i < is->count; i++)
+    npoints = ptarray_append_tpointinst(pa, npoints, tinstantset_inst_n(is, i),
+      false);
+  LWMPOINT *mpoint = lwmpoint_construct(tpointinstset_srid(is), pa);
+  FLAGS_SET_GEODETIC(mpoint->flags, MOBDB_FLAGS_GET_GEODETIC(is->flags));
+  GSERIALIZED *result = geo_serialize((LWGEOM *) mpoint);
+  lwmpoint_free(mpoint);
+  ptarray_free(pa);
+  return result;
+}
+
+/**
+ * Return the trajectory of a temporal sequence point with at least two
+ * instants as a point, a line, or a multipoint
+ *
+ * The coordinates of the instants are copied into a single point array
+ * removing consecutive duplicates on the fly, without constructing an
+ * LWPOINT for each instant.
+ */
+static LWGEOM *
+tpointseq_trajectory_lwgeom(const TSequence *seq)
+{
+  assert(seq->count > 1);
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  int srid = tpointseq_srid(seq);
+  POINTARRAY *pa = ptarray_construct(MOBDB_FLAGS_GET_Z(seq->flags), 0,
+    (uint32_t) seq->count);
+  uint32_t npoints = 0;
+  for (int i = 0; i < seq->count; i++)
+    npoints = ptarray_append_tpointinst(pa, npoints, tsequence_inst_n(seq, i),
+      true);
+  pa->npoints = npoints;
+
+  LWGEOM *result;
+  if (npoints == 1)
+    result = (LWGEOM *) lwpoint_construct(srid, NULL, pa);
+  else if (linear)
+    result = (LWGEOM *) lwline_construct(srid,
+      tpoint_trajectory_gbox(TSEQUENCE_BBOX_PTR(seq)), pa);
+  else
   {
-    Datum value = tinstant_value(tinstantset_inst_n(is, i));
-    GSERIALIZED *gsvalue = DatumGetGserializedP(value);
-    points[i] = lwgeom_from_gserialized(gsvalue);
+    result = (LWGEOM *) lwmpoint_construct(srid, pa);
+    ptarray_free(pa);
   }
-  LWGEOM *lwgeom = lwpointarr_make_trajectory(points, is->count, STEP);
-  GSERIALIZED *result = geo_serialize(lwgeom);
-  pfree(lwgeom);
-  for (int i = 0; i < is->count; i++)
-    lwpoint_free((LWPOINT *) points[i]);
-  pfree(points);
+  FLAGS_SET_GEODETIC(result->flags, MOBDB_FLAGS_GET_GEODETIC(seq->flags));
   return result;
 }
 
@@ -1755,27 +1833,9 @@ tpointseq_trajectory(const TSequence *seq)
   if (seq->count == 1)
     return DatumGetGserializedP(tinstant_value_copy(tsequence_inst_n(seq, 0)));
 
-  LWPOINT **points = palloc(sizeof(LWPOINT *) * seq->count);
-  /* Remove two consecutive points if they are equal */
-  Datum value = tinstant_value(tsequence_inst_n(seq, 0));
-  GSERIALIZED *gs = DatumGetGserializedP(value);
-  points[0] = lwgeom_as_lwpoint(lwgeom_from_gserialized(gs));
-  int k = 1;
-  for (int i = 1; i < seq->count; i++)
-  {
-    value = tinstant_value(tsequence_inst_n(seq, i));
-    gs = DatumGetGserializedP(value);
-    LWPOINT *lwpoint = lwgeom_as_lwpoint(lwgeom_from_gserialized(gs));
-    if (! lwpoint_same(lwpoint, points[k - 1]))
-      points[k++] = lwpoint;
-  }
-  LWGEOM *lwgeom = lwpointarr_make_trajectory((LWGEOM **) points, k,
-    MOBDB_FLAGS_GET_LINEAR(seq->flags));
+  LWGEOM *lwgeom = tpointseq_trajectory_lwgeom(seq);
   GSERIALIZED *result = geo_serialize(lwgeom);
-  pfree(lwgeom);
-  for (int i = 0; i < k; i++)
-    lwpoint_free(points[i]);
-  pfree(points);
+  lwgeom_free(lwgeom);
   return result;
 }
 
@@ -1792,65 +1852,69 @@ tpointseqset_trajectory(const TSequenceSet *ss)
   if (ss->count == 1)
     return tpointseq_trajectory(tsequenceset_seq_n(ss, 0));
 
+  int srid = tpointseqset_srid(ss);
   bool geodetic = MOBDB_FLAGS_GET_GEODETIC(ss->flags);
+  LWGEOM **pieces = palloc(sizeof(LWGEOM *) * ss->count);
   LWPOINT **points = palloc(sizeof(LWPOINT *) * ss->totalcount);
-  LWGEOM **geoms = palloc(sizeof(LWGEOM *) * ss->count);
+  LWGEOM **geoms = palloc(sizeof(LWGEOM *) * (ss->count + 1));
   int k = 0, l = 0;
   for (int i = 0; i < ss->count; i++)
   {
-    GSERIALIZED *traj = tpointseq_trajectory(tsequenceset_seq_n(ss, i));
-    int geotype = gserialized_get_type(traj);
-    if (geotype == POINTTYPE)
-      points[l++] = lwgeom_as_lwpoint(lwgeom_from_gserialized(traj));
-    else if (geotype == MULTIPOINTTYPE)
+    const TSequence *seq = tsequenceset_seq_n(ss, i);
+    if (seq->count == 1)
+    {
+      /* The point array of the instant is owned by the piece */
+      POINTARRAY *pa = ptarray_construct(MOBDB_FLAGS_GET_Z(ss->flags), 0, 1);
+      ptarray_append_tpointinst(pa, 0, tsequence_inst_n(seq, 0), false);
+      pieces[i] = (LWGEOM *) lwpoint_construct(srid, NULL, pa);
+    }
+    else
+      pieces[i] = tpointseq_trajectory_lwgeom(seq);
+    if (pieces[i]->type == POINTTYPE)
+      points[l++] = (LWPOINT *) pieces[i];
+    else if (pieces[i]->type == MULTIPOINTTYPE)
     {
-      LWMPOINT *lwmpoint = lwgeom_as_lwmpoint(lwgeom_from_gserialized(traj));
-      int count = lwmpoint->ngeoms;
-      for (int m = 0; m < count; m++)
+      LWMPOINT *lwmpoint = (LWMPOINT *) pieces[i];
+      for (uint32_t m = 0; m < lwmpoint->ngeoms; m++)
         points[l++] = lwmpoint->geoms[m];
     }
-    /* gserialized_get_type(traj) == LINETYPE */
+    /* pieces[i]->type == LINETYPE */
     else
-      geoms[k++] = lwgeom_from_gserialized(traj);
+      geoms[k++] = pieces[i];
   }
-  GSERIALIZED *result;
+  /* The trajectory has the same bounding box as the sequence set */
+  GBOX *box = tpoint_trajectory_gbox(TSEQUENCESET_BBOX_PTR(ss));
+  LWGEOM *coll;
   if (k == 0)
-  {
     /* Only points */
-    LWGEOM *lwgeom = lwpointarr_make_trajectory((LWGEOM **) points, l, STEP);
-    result = geo_serialize(lwgeom);
-    pfree(lwgeom);
-  }
+    coll = (LWGEOM *) lwcollection_construct(MULTIPOINTTYPE, srid, box,
+      (uint32_t) l, (LWGEOM **) points);
   else if (l == 0)
-  {
     /* Only lines */
     /* k > 1 since otherwise it is a singleton sequence set and this case
      * was taken care at the begining of the function */
-    // TODO add the bounding box instead of ask PostGIS to compute it again
-    LWGEOM *coll = (LWGEOM *) lwcollection_construct(MULTILINETYPE,
-      geoms[0]->srid, NULL, (uint32_t) k, geoms);
-    FLAGS_SET_GEODETIC(coll->flags, geodetic);
-    result = geo_serialize(coll);
-    /* We cannot lwgeom_free(geoms[i] or lwgeom_free(coll) */
-  }
+    coll = (LWGEOM *) lwcollection_construct(MULTILINETYPE, srid, box,
+      (uint32_t) k, geoms);
   else
   {
     /* Both points and lines */
     if (l == 1)
       geoms[k++] = (LWGEOM *) points[0];
     else
-    {
-      geoms[k++] = (LWGEOM *) lwcollection_construct(MULTIPOINTTYPE,
-        points[0]->srid, NULL, (uint32_t) l, (LWGEOM **) points);
-      /* We cannot lwpoint_free(points[i]); */
-    }
-    // TODO add the bounding box instead of ask PostGIS to compute it again
-    LWGEOM *coll = (LWGEOM *) lwcollection_construct(COLLECTIONTYPE,
-      geoms[0]->srid, NULL, (uint32_t) k, geoms);
-    FLAGS_SET_GEODETIC(coll->flags, geodetic);
-    result = geo_serialize(coll);
+      geoms[k++] = (LWGEOM *) lwcollection_construct(MULTIPOINTTYPE, srid,
+        NULL, (uint32_t) l, (LWGEOM **) points);
+    coll = (LWGEOM *) lwcollection_construct(COLLECTIONTYPE, srid, box,
+      (uint32_t) k, geoms);
   }
-  pfree(points); pfree(geoms);
+  FLAGS_SET_Z(coll->flags, MOBDB_FLAGS_GET_Z(ss->flags));
+  FLAGS_SET_GEODETIC(coll->flags, geodetic);
+  GSERIALIZED *result = geo_serialize(coll);
+  /* The components of the collections are shared with the pieces */
+  for (int i = 0; i < ss->count; i++)
+    lwgeom_free(pieces[i]);
+  if (box)
+    pfree(box);
+  pfree(pieces); pfree(points); pfree(geoms);
   return result;
 }
 
@@ -2379,10 +2443,9 @@ tpointseq_length(const TSequence *seq)
   }
   else
   {
-    /* We are sure that the trajectory is a line */
-    GSERIALIZED *traj = tpointseq_trajectory(seq);
-    double result = PGIS_geography_length(traj, true);
-    pfree(traj);
+    GeodSeqCache *cache = geodseq_cache_make(seq);
+    double result = geodseq_cache_length(cache);
+    geodseq_cache_free(cache);
     return result;
   }
 }
@@ -2461,6 +2524,8 @@ tpointseq_cumulative_length(const TSequence *seq, double prevlength)
   /* Linear interpolation */
   {
     datum_func2 func = pt_distance_fn(seq->flags);
+    GeodSeqCache *cache = MOBDB_FLAGS_GET_GEODETIC(seq->flags) ?
+      geodseq_cache_make(seq) : NULL;
     inst1 = tsequence_inst_n(seq, 0);
     Datum value1 = tinstant_value(inst1);
     double length = prevlength;
@@ -2470,11 +2535,14 @@ tpointseq_cumulative_length(const TSequence *seq, double prevlength)
       const TInstant *inst2 = tsequence_inst_n(seq, i);
       Datum value2 = tinstant_value(inst2);
       if (! datum_point_eq(value1, value2))
-        length += DatumGetFloat8(func(value1, value2));
+        length += cache ? geodseq_cache_seglength(cache, i - 1) :
+          DatumGetFloat8(func(value1, value2));
       instants[i] = tinstant_make(Float8GetDatum(length), T_TFLOAT, inst2->t);
       inst1 = inst2;
       value1 = value2;
     }
+    if (cache)
+      geodseq_cache_free(cache);
   }
   return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
     seq->period.upper_inc, linear, NORMALIZE);
@@ -2542,6 +2610,8 @@ tpointseq_speed(const TSequence *seq)
   /* General case */
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
   datum_func2 func = pt_distance_fn(seq->flags);
+  GeodSeqCache *cache = MOBDB_FLAGS_GET_GEODETIC(seq->flags) ?
+    geodseq_cache_make(seq) : NULL;
   const TInstant *inst1 = tsequence_inst_n(seq, 0);
   Datum value1 = tinstant_value(inst1);
   double speed;
@@ -2550,12 +2620,15 @@ tpointseq_speed(const TSequence *seq)
     const TInstant *inst2 = tsequence_inst_n(seq, i + 1);
     Datum value2 = tinstant_value(inst2);
     speed = datum_point_eq(value1, value2) ? 0.0 :
-      DatumGetFloat8(func(value1, value2)) /
-        ((double)(inst2->t - inst1->t) / 1000000.0);
+      (cache ? geodseq_cache_seglength(cache, i) :
+        DatumGetFloat8(func(value1, value2))) /
+          ((double)(inst2->t - inst1->t) / 1000000.0);
     instants[i] = tinstant_make(Float8GetDatum(speed), T_TFLOAT, inst1->t);
     inst1 = inst2;
     value1 = value2;
   }
+  if (cache)
+    geodseq_cache_free(cache);
   instants[seq->count - 1] = tinstant_make(Float8GetDatum(speed), T_TFLOAT,
     seq->period.upper);
   /* The resulting sequence has step interpolation */
@@ -2928,6 +3001,225 @@ tpoint_azimuth(const Temporal *temp)
   return result;
 }
 
+/*****************************************************************************
+ * Motion metrics
+ *****************************************************************************/
+
+/**
+ * Compute in a single pass over the segments of a temporal sequence point
+ * with linear interpolation its length, cumulative length, speed, and azimuth
+ *
+ * @param[in] seq Temporal value
+ * @param[in,out] cumul Cumulative length traversed before the sequence,
+ * updated with the length traversed at the end of the sequence
+ * @param[out] cumlength Cumulative length, not computed when NULL
+ * @param[out] speed Speed, not computed when NULL
+ * @param[out] azimuth Array on which the pointers of the newly constructed
+ * azimuth sequences are stored, not computed when NULL
+ * @param[out] naz Number of elements in the azimuth array
+ * @result Length traversed by the sequence
+ */
+static double
+tpointseq_motion_metrics1(const TSequence *seq, double *cumul,
+  TSequence **cumlength, TSequence **speed, TSequence **azimuth, int *naz)
+{
+  assert(MOBDB_FLAGS_GET_LINEAR(seq->flags));
+  if (speed)
+    *speed = NULL;
+  if (azimuth)
+    *naz = 0;
+
+  /* Instantaneous sequence */
+  if (seq->count == 1)
+  {
+    if (cumlength)
+      *cumlength = tpointseq_cumulative_length(seq, *cumul);
+    return 0.0;
+  }
+
+  /* General case */
+  datum_func2 distfunc = pt_distance_fn(seq->flags);
+  GeodSeqCache *cache = MOBDB_FLAGS_GET_GEODETIC(seq->flags) ?
+    geodseq_cache_make(seq) : NULL;
+  datum_func2 azfunc = MOBDB_FLAGS_GET_GEODETIC(seq->flags) ?
+    &geog_azimuth : &geom_azimuth;
+  TInstant **lengthinsts = cumlength ?
+    palloc(sizeof(TInstant *) * seq->count) : NULL;
+  TInstant **speedinsts = speed ?
+    palloc(sizeof(TInstant *) * seq->count) : NULL;
+  TInstant **azinsts = azimuth ?
+    palloc(sizeof(TInstant *) * seq->count) : NULL;
+  const TInstant *inst1 = tsequence_inst_n(seq, 0);
+  Datum value1 = tinstant_value(inst1);
+  double length = 0.0, speed1 = 0.0;
+  Datum az = 0; /* Make the compiler quiet */
+  int k = 0;
+  bool lower_inc = seq->period.lower_inc, upper_inc = false;
+  if (cumlength)
+    lengthinsts[0] = tinstant_make(Float8GetDatum(*cumul), T_TFLOAT,
+      inst1->t);
+  for (int i = 1; i < seq->count; i++)
+  {
+    const TInstant *inst2 = tsequence_inst_n(seq, i);
+    Datum value2 = tinstant_value(inst2);
+    bool moving = ! datum_point_eq(value1, value2);
+    double dist = ! moving ? 0.0 : cache ?
+      geodseq_cache_seglength(cache, i - 1) :
+      DatumGetFloat8(distfunc(value1, value2));
+    length += dist;
+    *cumul += dist;
+    if (cumlength)
+      lengthinsts[i] = tinstant_make(Float8GetDatum(*cumul), T_TFLOAT,
+        inst2->t);
+    if (speed)
+    {
+      speed1 = moving ?
+        dist / ((double)(inst2->t - inst1->t) / 1000000.0) : 0.0;
+      speedinsts[i - 1] = tinstant_make(Float8GetDatum(speed1), T_TFLOAT,
+        inst1->t);
+    }
+    if (azimuth)
+    {
+      /* Same splitting of the azimuth as in tpointseq_azimuth1 */
+      upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
+      if (moving)
+      {
+        az = azfunc(value1, value2);
+        azinsts[k++] = tinstant_make(az, T_TFLOAT, inst1->t);
+      }
+      else
+      {
+        if (k != 0)
+        {
+          azinsts[k++] = tinstant_make(az, T_TFLOAT, inst1->t);
+          azimuth[(*naz)++] = tsequence_make_free(azinsts, k, lower_inc,
+            true, STEP, NORMALIZE);
+          azinsts = palloc(sizeof(TInstant *) * seq->count);
+          k = 0;
+        }
+        lower_inc = true;
+      }
+    }
+    inst1 = inst2;
+    value1 = value2;
+  }
+  if (cache)
+    geodseq_cache_free(cache);
+
+  if (cumlength)
+    *cumlength = tsequence_make_free(lengthinsts, seq->count,
+      seq->period.lower_inc, seq->period.upper_inc, LINEAR, NORMALIZE);
+  if (speed)
+  {
+    speedinsts[seq->count - 1] = tinstant_make(Float8GetDatum(speed1),
+      T_TFLOAT, seq->period.upper);
+    /* The resulting sequence has step interpolation */
+    *speed = tsequence_make_free(speedinsts, seq->count,
+      seq->period.lower_inc, seq->period.upper_inc, STEP, NORMALIZE);
+  }
+  if (azimuth)
+  {
+    if (k != 0)
+    {
+      azinsts[k++] = tinstant_make(az, T_TFLOAT, inst1->t);
+      azimuth[(*naz)++] = tsequence_make_free(azinsts, k, lower_inc,
+        upper_inc, STEP, NORMALIZE);
+    }
+    else
+      pfree(azinsts);
+  }
+  return length;
+}
+
+/**
+ * @ingroup libmeos_temporal_spatial_accessor
+ * @brief Return in a single pass over a temporal point its length,
+ * cumulative length, speed, and azimuth.
+ *
+ * The results are the same as those of the functions tpoint_length,
+ * tpoint_cumulative_length, tpoint_speed, and tpoint_azimuth, except that
+ * the speed of a temporal point with step interpolation is NULL instead of
+ * raising an error.
+ *
+ * @param[in] temp Temporal point
+ * @param[out] length Length, not computed when NULL
+ * @param[out] cumlength Cumulative length, not computed when NULL
+ * @param[out] speed Speed, not computed when NULL. The result is NULL when
+ * the temporal point does not have a speed
+ * @param[out] azimuth Azimuth, not computed when NULL. The result is NULL
+ * when the temporal point does not have an azimuth
+ * @sqlfunc motionMetrics()
+ */
+void
+tpoint_motion_metrics(const Temporal *temp, double *length,
+  Temporal **cumlength, Temporal **speed, Temporal **azimuth)
+{
+  ensure_valid_tempsubtype(temp->subtype);
+  if (length)
+    *length = 0.0;
+  if (speed)
+    *speed = NULL;
+  if (azimuth)
+    *azimuth = NULL;
+  if (temp->subtype == TINSTANT || temp->subtype == TINSTANTSET ||
+    ! MOBDB_FLAGS_GET_LINEAR(temp->flags))
+  {
+    if (cumlength)
+      *cumlength = tpoint_cumulative_length(temp);
+    return;
+  }
+
+  double cumul = 0.0, len = 0.0;
+  if (temp->subtype == TSEQUENCE)
+  {
+    const TSequence *seq = (const TSequence *) temp;
+    TSequence **azseqs = azimuth ?
+      palloc(sizeof(TSequence *) * seq->count) : NULL;
+    int naz = 0;
+    len = tpointseq_motion_metrics1(seq, &cumul, (TSequence **) cumlength,
+      (TSequence **) speed, azseqs, &naz);
+    if (azimuth)
+      /* Resulting sequence set has step interpolation */
+      *azimuth = (Temporal *) tsequenceset_make_free(azseqs, naz, NORMALIZE);
+  }
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    TSequence **lengthseqs = cumlength ?
+      palloc(sizeof(TSequence *) * ss->count) : NULL;
+    TSequence **speedseqs = speed ?
+      palloc(sizeof(TSequence *) * ss->count) : NULL;
+    TSequence **azseqs = azimuth ?
+      palloc(sizeof(TSequence *) * ss->totalcount) : NULL;
+    int nspeed = 0, naz = 0;
+    for (int i = 0; i < ss->count; i++)
+    {
+      const TSequence *seq = tsequenceset_seq_n(ss, i);
+      int naz1;
+      len += tpointseq_motion_metrics1(seq, &cumul,
+        cumlength ? &lengthseqs[i] : NULL,
+        speed ? &speedseqs[nspeed] : NULL,
+        azimuth ? &azseqs[naz] : NULL, &naz1);
+      if (speed && speedseqs[nspeed] != NULL)
+        nspeed++;
+      if (azimuth)
+        naz += naz1;
+    }
+    if (cumlength)
+      *cumlength = (Temporal *) tsequenceset_make_free(lengthseqs, ss->count,
+        NORMALIZE_NO);
+    /* The resulting sequence sets have step interpolation */
+    if (speed)
+      *speed = (Temporal *) tsequenceset_make_free(speedseqs, nspeed,
+        NORMALIZE);
+    if (azimuth)
+      *azimuth = (Temporal *) tsequenceset_make_free(azseqs, naz, NORMALIZE);
+  }
+  if (length)
+    *length = len;
+  return;
+}
+
 /*****************************************************************************
  * Temporal bearing
  *****************************************************************************/
@@ -3337,10 +3629,166 @@ seg2d_intersection(const POINT2D a, const POINT2D b, const POINT2D c,
  * Non self-intersecting (a.k.a. simple) functions
  *****************************************************************************/
 
+/**
+ * Hash table of the cells of a uniform grid used for finding the
+ * self-intersections of a temporal point. Each entry associates an element,
+ * i.e., an instant or a segment, with a cell. The entries of all cells
+ * hashing to the same bucket are chained, the verification of the candidates
+ * filters out the elements of other cells. The table is emptied in constant
+ * time by incrementing its generation.
+ */
+typedef struct
+{
+  int nbuckets;    /**< Number of buckets, a power of 2 */
+  int *heads;      /**< First entry of each bucket */
+  int *gens;       /**< Generation in which each bucket was last used */
+  int gen;         /**< Current generation */
+  int *elems;      /**< Element of each entry */
+  int *next;       /**< Next entry in the same bucket, -1 if none */
+  int count;       /**< Number of entries */
+  int maxcount;    /**< Allocated number of entries */
+} CellHash;
+
+/**
+ * Initialize a cell hash table for a number of elements
+ */
+static void
+cellhash_init(CellHash *h, int count)
+{
+  h->nbuckets = 16;
+  while (h->nbuckets < count * 2)
+    h->nbuckets <<= 1;
+  h->heads = palloc(sizeof(int) * h->nbuckets);
+  h->gens = palloc0(sizeof(int) * h->nbuckets);
+  h->gen = 1;
+  h->maxcount = Max(count, 16);
+  h->elems = palloc(sizeof(int) * h->maxcount);
+  h->next = palloc(sizeof(int) * h->maxcount);
+  h->count = 0;
+  return;
+}
+
+/**
+ * Free the arrays of a cell hash table
+ */
+static void
+cellhash_free(CellHash *h)
+{
+  pfree(h->heads); pfree(h->gens); pfree(h->elems); pfree(h->next);
+  return;
+}
+
+/**
+ * Remove all entries of a cell hash table
+ */
+static void
+cellhash_reset(CellHash *h)
+{
+  h->gen++;
+  h->count = 0;
+  return;
+}
+
+/**
+ * Return the bucket of a cell of a cell hash table
+ */
+static int
+cellhash_bucket(const CellHash *h, int64 cx, int64 cy, int64 cz)
+{
+  uint64 key = (uint64) cx * UINT64CONST(0x9E3779B97F4A7C15) ^
+    (uint64) cy * UINT64CONST(0xC2B2AE3D27D4EB4F) ^
+    (uint64) cz * UINT64CONST(0x165667B19E3779F9);
+  key ^= key >> 29;
+  return (int) (key & (uint64) (h->nbuckets - 1));
+}
+
+/**
+ * Return the first entry of the bucket of a cell, -1 if the bucket is empty
+ */
+static int
+cellhash_first(const CellHash *h, int64 cx, int64 cy, int64 cz)
+{
+  int b = cellhash_bucket(h, cx, cy, cz);
+  return (h->gens[b] == h->gen) ? h->heads[b] : -1;
+}
+
+/**
+ * Add an element to a cell of a cell hash table
+ */
+static void
+cellhash_insert(CellHash *h, int64 cx, int64 cy, int64 cz, int elem)
+{
+  if (h->count == h->maxcount)
+  {
+    h->maxcount *= 2;
+    h->elems = repalloc(h->elems, sizeof(int) * h->maxcount);
+    h->next = repalloc(h->next, sizeof(int) * h->maxcount);
+  }
+  int b = cellhash_bucket(h, cx, cy, cz);
+  h->elems[h->count] = elem;
+  h->next[h->count] = (h->gens[b] == h->gen) ? h->heads[b] : -1;
+  h->heads[b] = h->count++;
+  h->gens[b] = h->gen;
+  return;
+}
+
+/**
+ * Size of the cells used for hashing points, which must be greater than the
+ * tolerance used for comparing coordinates
+ */
+#define POINT_CELL_SIZE 1e-6
+
+/**
+ * Set the range of cells of a coordinate that may contain a point equal to it
+ * up to the floating-point tolerance
+ */
+static void
+point_cell_range(double coord, int64 *lower, int64 *upper)
+{
+  double pos = coord / POINT_CELL_SIZE;
+  double cell = floor(pos);
+  *lower = *upper = (int64) cell;
+  if (pos - cell < FP_TOLERANCE / POINT_CELL_SIZE)
+    (*lower)--;
+  if (cell + 1.0 - pos < FP_TOLERANCE / POINT_CELL_SIZE)
+    (*upper)++;
+  return;
+}
+
+/**
+ * Return true if a point has an equal point in a cell hash table of
+ * instants
+ */
+static bool
+pointhash_contains(const CellHash *h, const Temporal *temp, Datum value,
+  const POINT4D *p, bool hasz)
+{
+  int64 x1, x2, y1, y2, z1 = 0, z2 = 0;
+  point_cell_range(p->x, &x1, &x2);
+  point_cell_range(p->y, &y1, &y2);
+  if (hasz)
+    point_cell_range(p->z, &z1, &z2);
+  for (int64 cx = x1; cx <= x2; cx++)
+    for (int64 cy = y1; cy <= y2; cy++)
+      for (int64 cz = z1; cz <= z2; cz++)
+        for (int e = cellhash_first(h, cx, cy, cz); e >= 0; e = h->next[e])
+        {
+          const TInstant *inst = tinstarr_inst_n(temp, h->elems[e]);
+          if (datum_point_eq(tinstant_value(inst), value))
+            return true;
+        }
+  return false;
+}
+
 /**
  * Split a temporal point of subtype instant set or sequence with stepwise
  * interpolation into an array of non self-intersecting pieces
  *
+ * The pieces are built from left to right and a piece ends at the first
+ * instant whose point is equal to a previous point of the piece. The points
+ * of the current piece are kept in a hash table so that every instant is
+ * tested in expected constant time.
+ *
  * @param[in] temp Temporal point
  * @param[out] count Number of elements in the resulting array
  * @result Boolean array determining the instant numbers at which the
@@ -3356,49 +3804,169 @@ tpoint_instarr_find_splits(const Temporal *temp, int *count)
   int count1 = (temp->subtype == TINSTANTSET) ?
     ((TInstantSet *) temp)->count : ((TSequence *) temp)->count;
   assert(count1 > 1);
+  bool hasz = MOBDB_FLAGS_GET_Z(temp->flags);
   /* bitarr is an array of bool for collecting the splits */
   bool *bitarr = palloc0(sizeof(bool) * count1);
   int numsplits = 0;
-  int start = 0, end = count1 - 1;
-  while (start < count1 - 1)
+  CellHash h;
+  cellhash_init(&h, count1);
+  POINT4D p;
+  for (int i = 0; i < count1; i++)
   {
-    const TInstant *inst1 = tinstarr_inst_n(temp, start);
-    Datum value1 = tinstant_value(inst1);
-    /* Find intersections in the piece defined by start and end in a
-     * breadth-first search */
-    int j = start, k = start + 1;
-    while (k <= end)
+    Datum value = tinstant_value(tinstarr_inst_n(temp, i));
+    datum_point4d(value, &p);
+    if (i > 0 && pointhash_contains(&h, temp, value, &p, hasz))
     {
-      const TInstant *inst2 = tinstarr_inst_n(temp, k);
-      Datum value2 = tinstant_value(inst2);
-      if (datum_point_eq(value1, value2))
-      {
-        /* Set the new end */
-        end = k;
-        bitarr[end] = true;
-        numsplits++;
-        break;
-      }
-      if (j < k - 1)
-        j++;
-      else
-      {
-        k++;
-        j = start;
-      }
+      /* The point closes a loop, start a new piece with it */
+      bitarr[i] = true;
+      numsplits++;
+      cellhash_reset(&h);
     }
-    /* Process the next split */
-    start = end;
+    cellhash_insert(&h, (int64) floor(p.x / POINT_CELL_SIZE),
+      (int64) floor(p.y / POINT_CELL_SIZE),
+      hasz ? (int64) floor(p.z / POINT_CELL_SIZE) : 0, i);
   }
+  cellhash_free(&h);
   *count = numsplits;
   return bitarr;
 }
 
+/**
+ * Maximum number of grid cells per dimension covered by a segment in a
+ * segment grid, longer segments are kept apart and tested against every
+ * segment
+ */
+#define SEGGRID_MAX_CELLS 16
+
+/**
+ * Uniform grid of the segments of the current piece of a temporal point
+ * sequence used for finding self-intersections
+ */
+typedef struct
+{
+  const POINT2D *points; /**< Points of the sequence */
+  double size;           /**< Size of the cells */
+  CellHash cells;        /**< Segments of the piece per cell */
+  int *large;            /**< Segments covering too many cells */
+  int nlarge;            /**< Number of large segments */
+  int first;             /**< First segment of the piece */
+  int *stamps;           /**< Last segment tested against each segment */
+} SegGrid;
+
+/**
+ * Set the range of cells of a segment grid covered by a segment, return
+ * false if the segment covers too many cells
+ */
+static bool
+seggrid_cells(const SegGrid *grid, int i, int64 *x1, int64 *y1, int64 *x2,
+  int64 *y2)
+{
+  const POINT2D *p1 = &grid->points[i], *p2 = &grid->points[i + 1];
+  /* Enlarge the box with the tolerance used for testing the boxes */
+  *x1 = (int64) floor((Min(p1->x, p2->x) - FP_TOLERANCE) / grid->size);
+  *x2 = (int64) floor((Max(p1->x, p2->x) + FP_TOLERANCE) / grid->size);
+  *y1 = (int64) floor((Min(p1->y, p2->y) - FP_TOLERANCE) / grid->size);
+  *y2 = (int64) floor((Max(p1->y, p2->y) + FP_TOLERANCE) / grid->size);
+  return (*x2 - *x1 < SEGGRID_MAX_CELLS && *y2 - *y1 < SEGGRID_MAX_CELLS);
+}
+
+/**
+ * Start a new piece in a segment grid
+ */
+static void
+seggrid_reset(SegGrid *grid, int first)
+{
+  cellhash_reset(&grid->cells);
+  grid->nlarge = 0;
+  grid->first = first;
+  return;
+}
+
+/**
+ * Add a segment to the current piece of a segment grid
+ */
+static void
+seggrid_insert(SegGrid *grid, int i)
+{
+  int64 x1, y1, x2, y2;
+  if (! seggrid_cells(grid, i, &x1, &y1, &x2, &y2))
+  {
+    grid->large[grid->nlarge++] = i;
+    return;
+  }
+  for (int64 cx = x1; cx <= x2; cx++)
+    for (int64 cy = y1; cy <= y2; cy++)
+      cellhash_insert(&grid->cells, cx, cy, 0, i);
+  return;
+}
+
+/**
+ * Return true if two segments of a temporal point sequence intersect,
+ * excluding the common point of consecutive segments
+ * @pre i < j
+ */
+static bool
+tpointseq_segments_intersect(const POINT2D *points, int i, int j)
+{
+  /* If the bounding boxes of the segments do not intersect */
+  if (! lw_seg_interact(points[i], points[i + 1], points[j], points[j + 1]))
+    return false;
+  POINT2D p;
+  int intertype = seg2d_intersection(points[i], points[i + 1],
+    points[j], points[j + 1], &p);
+  return (intertype > 0 &&
+    /* Exclude the case when two consecutive segments that
+     * necessarily touch each other in their common point */
+    (intertype != MOBDB_SEG_TOUCH || j != i + 1 ||
+     p.x != points[j].x || p.y != points[j].y));
+}
+
+/**
+ * Return true if a segment intersects a segment of the current piece of a
+ * segment grid
+ */
+static bool
+seggrid_intersects(SegGrid *grid, int j)
+{
+  int64 x1, y1, x2, y2;
+  if (! seggrid_cells(grid, j, &x1, &y1, &x2, &y2))
+  {
+    /* Test a large segment against all the segments of the piece */
+    for (int i = grid->first; i < j; i++)
+      if (tpointseq_segments_intersect(grid->points, i, j))
+        return true;
+    return false;
+  }
+  for (int k = 0; k < grid->nlarge; k++)
+    if (tpointseq_segments_intersect(grid->points, grid->large[k], j))
+      return true;
+  for (int64 cx = x1; cx <= x2; cx++)
+    for (int64 cy = y1; cy <= y2; cy++)
+      for (int e = cellhash_first(&grid->cells, cx, cy, 0); e >= 0;
+        e = grid->cells.next[e])
+      {
+        int i = grid->cells.elems[e];
+        /* A segment may be found in several cells */
+        if (grid->stamps[i] == j)
+          continue;
+        grid->stamps[i] = j;
+        if (tpointseq_segments_intersect(grid->points, i, j))
+          return true;
+      }
+  return false;
+}
+
 /**
  * Split a temporal point sequence with linear interpolation into an array
  * of non self-intersecting pieces. The function works only on 2D even if
  * the input points are in 3D
  *
+ * The pieces are built from left to right and a piece ends at the first
+ * segment that intersects a previous segment of the piece. The segments of
+ * the current piece are kept in a uniform grid whose cells have the size of
+ * the average segment, so that every segment is only tested against the
+ * segments that are close to it.
+ *
  * @param[in] seq Temporal point
  * @param[out] count Number of elements in the resulting array
  * @result Boolean array determining the instant numbers at which the
@@ -3415,9 +3983,12 @@ tpointseq_linear_find_splits(const TSequence *seq, int *count)
   bool *bitarr = palloc0(sizeof(bool) * seq->count);
   points[0] = datum_point2d(tinstant_value(tsequence_inst_n(seq, 0)));
   int numsplits = 0;
+  double extent = 0.0;
   for (int i = 1; i < seq->count; i++)
   {
     points[i] = datum_point2d(tinstant_value(tsequence_inst_n(seq, i)));
+    extent += Max(fabs(points[i].x - points[i - 1].x),
+      fabs(points[i].y - points[i - 1].y));
     /* If stationary segment we need to split the sequence */
     if (points[i - 1].x == points[i].x && points[i - 1].y == points[i].y)
     {
@@ -3434,6 +4005,17 @@ tpointseq_linear_find_splits(const TSequence *seq, int *count)
     }
   }
 
+  SegGrid grid;
+  grid.points = points;
+  grid.size = extent / (seq->count - 1);
+  if (grid.size <= 0.0)
+    grid.size = 1.0;
+  cellhash_init(&grid.cells, seq->count);
+  grid.large = palloc(sizeof(int) * seq->count);
+  grid.stamps = palloc(sizeof(int) * seq->count);
+  for (int i = 0; i < seq->count; i++)
+    grid.stamps[i] = -1;
+
   /* Loop for every split due to stationary segments while adding
    * additional splits due to intersecting segments */
   int start = 0;
@@ -3447,44 +4029,27 @@ tpointseq_linear_find_splits(const TSequence *seq, int *count)
       start = end;
       continue;
     }
-    /* Find intersections in the piece defined by start and end in a
-     * breadth-first search */
-    int i = start, j = start + 1;
-    while (j < end)
+    /* Find the first segment of the piece defined by start and end that
+     * intersects a previous segment of the piece */
+    seggrid_reset(&grid, start);
+    seggrid_insert(&grid, start);
+    for (int j = start + 1; j < end; j++)
     {
-      /* If the bounding boxes of the segments intersect */
-      if (lw_seg_interact(points[i], points[i + 1],
-          points[j], points[j + 1]))
+      if (seggrid_intersects(&grid, j))
       {
-        /* Candidate for intersection */
-        POINT2D p;
-        int intertype = seg2d_intersection(points[i], points[i + 1],
-          points[j], points[j + 1], &p);
-        if (intertype > 0 &&
-          /* Exclude the case when two consecutive segments that
-           * necessarily touch each other in their common point */
-          (intertype != MOBDB_SEG_TOUCH || j != i + 1 ||
-           p.x != points[j].x || p.y != points[j].y))
-        {
-          /* Set the new end */
-          end = j;
-          bitarr[end] = true;
-          numsplits++;
-          break;
-        }
-      }
-      if (i < j - 1)
-        i++;
-      else
-      {
-        j++;
-        i = start;
+        /* Set the new end */
+        end = j;
+        bitarr[end] = true;
+        numsplits++;
+        break;
       }
+      seggrid_insert(&grid, j);
     }
     /* Process the next split */
     start = end;
   }
-  pfree(points);
+  cellhash_free(&grid.cells);
+  pfree(grid.large); pfree(grid.stamps); pfree(points);
   *count = numsplits;
   return bitarr;
 }
@@ -4347,10 +4912,44 @@ tpointseq_at_geometry(const TSequence *seq, const GSERIALIZED *gs, int *count)
     *count = 1;
     return result;
   }
-  if (MOBDB_FLAGS_GET_LINEAR(seq->flags))
-    return tpointseq_linear_at_geometry(seq, gs, count);
-  else
-    return tpointseq_step_at_geometry(seq, gs, count);
+
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  STBOX box;
+  if (tsequence_num_blocks(seq) == 0 || ! geo_set_stbox(gs, &box))
+    return linear ? tpointseq_linear_at_geometry(seq, gs, count) :
+      tpointseq_step_at_geometry(seq, gs, count);
+
+  /* Restrict the sequence to the runs of blocks whose bounding box overlaps
+   * the one of the geometry and compute the intersection of each run. Since
+   * the intersection is computed in 2D the Z dimension is not tested. */
+  MOBDB_FLAGS_SET_Z(box.flags, false);
+  PeriodSet *ps = tsequence_blocks_time(seq, &box);
+  if (ps == NULL)
+  {
+    *count = 0;
+    return NULL;
+  }
+  TSequence **runs = palloc(sizeof(TSequence *) * ps->count);
+  int nruns = tsequence_at_periodset(seq, ps, runs);
+  pfree(ps);
+  TSequence ***sequences = palloc(sizeof(TSequence **) * nruns);
+  int *countseqs = palloc0(sizeof(int) * nruns);
+  int totalcount = 0;
+  for (int i = 0; i < nruns; i++)
+  {
+    sequences[i] = linear ?
+      tpointseq_linear_at_geometry(runs[i], gs, &countseqs[i]) :
+      tpointseq_step_at_geometry(runs[i], gs, &countseqs[i]);
+    totalcount += countseqs[i];
+  }
+  pfree_array((void **) runs, nruns);
+  *count = totalcount;
+  if (totalcount == 0)
+  {
+    pfree(sequences); pfree(countseqs);
+    return NULL;
+  }
+  return tseqarr2_to_tseqarr(sequences, countseqs, nruns, totalcount);
 }
 
 /**
@@ -4681,6 +5280,27 @@ tpoint_at_stbox1(const Temporal *temp, const STBOX *box, bool upper_inc)
   }
   else
     temp1 = (Temporal *) temp;
+  bool free1 = hast;
+
+  /* Restrict a long sequence to the runs of blocks whose bounding box
+   * overlaps the box before splitting it into coordinates. The block boxes of
+   * geodetic points are in geocentric coordinates and thus are not used. */
+  if (hasx && temp1->subtype == TSEQUENCE &&
+      ! MOBDB_FLAGS_GET_GEODETIC(temp1->flags) &&
+      tsequence_num_blocks((TSequence *) temp1) > 0)
+  {
+    PeriodSet *ps = tsequence_blocks_time((TSequence *) temp1, box);
+    Temporal *temp2 = (ps == NULL) ? NULL :
+      temporal_restrict_periodset(temp1, ps, REST_AT);
+    if (ps != NULL)
+      pfree(ps);
+    if (hast)
+      pfree(temp1);
+    if (temp2 == NULL)
+      return NULL;
+    temp1 = temp2;
+    free1 = true;
+  }
 
   Temporal *result = NULL;
   if (hasx)
@@ -4727,7 +5347,7 @@ tpoint_at_stbox1(const Temporal *temp, const STBOX *box, bool upper_inc)
   }
   else
     result = temp1;
-  if (hasx && hast)
+  if (hasx && free1)
     pfree(temp1);
   return result;
 }
@@ -53,6 +53,7 @@
 #include "general/lifting.h"
 #include "general/temporal_util.h"
 #include "point/pgis_call.h"
+#include "point/tpoint_geodetic.h"
 #include "point/tpoint_spatialfuncs.h"
 #include "point/tpoint_tempspatialrels.h"
 
@@ -166,8 +167,19 @@ geom_dwithin3d(Datum geom1, Datum geom2, Datum dist)
 Datum
 geog_dwithin(Datum geog1, Datum geog2, Datum dist)
 {
-  return BoolGetDatum(PGIS_geography_dwithin(DatumGetGserializedP(geog1),
-    DatumGetGserializedP(geog2), DatumGetFloat8(dist), true));
+  const GSERIALIZED *gs1 = DatumGetGserializedP(geog1);
+  const GSERIALIZED *gs2 = DatumGetGserializedP(geog2);
+  /* Decide the result for two points far from the distance threshold
+   * with the local tangent plane approximation */
+  bool result;
+  if (gserialized_get_type(gs1) == POINTTYPE &&
+      gserialized_get_type(gs2) == POINTTYPE &&
+      ! gserialized_is_empty(gs1) && ! gserialized_is_empty(gs2) &&
+      geog_point_dwithin_approx(gserialized_point2d_p(gs1),
+        gserialized_point2d_p(gs2), DatumGetFloat8(dist), &result))
+    return BoolGetDatum(result);
+  return BoolGetDatum(PGIS_geography_dwithin((GSERIALIZED *) gs1,
+    (GSERIALIZED *) gs2, DatumGetFloat8(dist), true));
 }
 
 /*****************************************************************************/
@@ -0,0 +1,59 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Minimal support for the unit tests of the MEOS library.
+ *
+ * Each test program checks a number of conditions with the macro
+ * MEOS_TEST_CHECK, which reports the failed ones, and returns the result of
+ * MEOS_TEST_RESULT as exit status, so that CTest reports the program as
+ * failed if any of the conditions is false.
+ */
+
+#ifndef __MEOS_TEST_H__
+#define __MEOS_TEST_H__
+
+#include <stdio.h>
+
+/* Number of failed conditions of the test program */
+static int meos_test_failures = 0;
+
+#define MEOS_TEST_CHECK(cond) \
+  do { \
+    if (! (cond)) \
+    { \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, \
+        #cond); \
+      meos_test_failures++; \
+    } \
+  } while (0)
+
+#define MEOS_TEST_RESULT() (meos_test_failures == 0 ? 0 : 1)
+
+#endif /* __MEOS_TEST_H__ */
@@ -0,0 +1,164 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Tests of the interval index over periods.
+ *
+ * The temporal count computed by the index is compared with the result of
+ * the tcount aggregate over the same periods, and with the number of periods
+ * containing a timestamp given by the index.
+ */
+
+#include <stdlib.h>
+#include "meos.h"
+#include "meos_test.h"
+
+/**
+ * Return an interval index built from periods given as strings
+ */
+static PeriodIndex *
+period_index_from_strings(char **periods, int count)
+{
+  Period *array = malloc(sizeof(Period) * count);
+  for (int i = 0; i < count; i++)
+  {
+    Period *p = period_in(periods[i]);
+    array[i] = *p;
+    free(p);
+  }
+  PeriodIndex *result = period_index_make(array, NULL, count);
+  free(array);
+  return result;
+}
+
+/**
+ * Check that the temporal count of an interval index is the result of the
+ * tcount aggregate over its periods, given as a string
+ */
+static void
+check_tcount(char **periods, int count, char *expected)
+{
+  PeriodIndex *idx = period_index_from_strings(periods, count);
+  Temporal *tcount = (Temporal *) period_index_tcount(idx);
+  Temporal *temp = tint_in(expected);
+  bool equal = temporal_eq(tcount, temp);
+  if (! equal)
+  {
+    char *str = tint_out(tcount);
+    fprintf(stderr, "tcount: %s, expected: %s\n", str, expected);
+    free(str);
+  }
+  MEOS_TEST_CHECK(equal);
+  free(tcount); free(temp);
+  period_index_free(idx);
+  return;
+}
+
+/**
+ * Check the temporal count of random periods against the number of periods
+ * containing a timestamp, and check that it is normalized
+ */
+static void
+check_tcount_random(int count, unsigned int seed)
+{
+  srand(seed);
+  TimestampTz base = pg_timestamptz_in("2000-01-01", -1);
+  Period *periods = malloc(sizeof(Period) * count);
+  for (int i = 0; i < count; i++)
+  {
+    int lower = rand() % 48, length = rand() % 6;
+    bool lower_inc = length == 0 || rand() % 2 == 0;
+    bool upper_inc = length == 0 || rand() % 2 == 0;
+    Period *p = period_make(base + lower * USECS_PER_HOUR,
+      base + (lower + length) * USECS_PER_HOUR, lower_inc, upper_inc);
+    periods[i] = *p;
+    free(p);
+  }
+  PeriodIndex *idx = period_index_make(periods, NULL, count);
+  Temporal *tcount = (Temporal *) period_index_tcount(idx);
+  /* Check the bounds and the middle of the hours */
+  for (int i = -2; i < 110; i++)
+  {
+    TimestampTz t = base + i * USECS_PER_HOUR / 2;
+    int value;
+    if (! tint_value_at_timestamp(tcount, t, true, &value))
+      value = 0;
+    MEOS_TEST_CHECK(value == period_index_stab_count(idx, t));
+  }
+  /* The input of the output of a temporal value is normalized */
+  char *str = tint_out(tcount);
+  Temporal *temp = tint_in(str);
+  MEOS_TEST_CHECK(temporal_eq(tcount, temp));
+  free(str); free(temp); free(tcount); free(periods);
+  period_index_free(idx);
+  return;
+}
+
+int
+main(void)
+{
+  meos_initialize();
+
+  /* Empty index */
+  PeriodIndex *idx = period_index_make(NULL, NULL, 0);
+  MEOS_TEST_CHECK(period_index_tcount(idx) == NULL);
+  period_index_free(idx);
+
+  /* The expected values are those of the tcount aggregate */
+  char *p1[] = {"[2000-01-01, 2000-01-05]"};
+  check_tcount(p1, 1, "{[1@2000-01-01, 1@2000-01-05]}");
+  char *p2[] = {"[2000-01-01, 2000-01-05]", "[2000-01-03, 2000-01-07]"};
+  check_tcount(p2, 2,
+    "{[1@2000-01-01, 2@2000-01-03, 2@2000-01-05], (1@2000-01-05, 1@2000-01-07]}");
+  char *p3[] = {"[2000-01-01, 2000-01-03)", "[2000-01-03, 2000-01-05]"};
+  check_tcount(p3, 2, "{[1@2000-01-01, 1@2000-01-05]}");
+  char *p4[] = {"[2000-01-01, 2000-01-03]", "(2000-01-03, 2000-01-05]"};
+  check_tcount(p4, 2, "{[1@2000-01-01, 1@2000-01-05]}");
+  char *p5[] = {"[2000-01-01, 2000-01-03)", "(2000-01-03, 2000-01-05]"};
+  check_tcount(p5, 2,
+    "{[1@2000-01-01, 1@2000-01-03), (1@2000-01-03, 1@2000-01-05]}");
+  char *p6[] = {"[2000-01-01, 2000-01-03]", "[2000-01-03, 2000-01-05]"};
+  check_tcount(p6, 2,
+    "{[1@2000-01-01, 2@2000-01-03], (1@2000-01-03, 1@2000-01-05]}");
+  char *p7[] = {"[2000-01-01, 2000-01-05]", "[2000-01-03, 2000-01-03]"};
+  check_tcount(p7, 2,
+    "{[1@2000-01-01, 2@2000-01-03], (1@2000-01-03, 1@2000-01-05]}");
+  char *p8[] = {"[2000-01-04, 2000-01-05]", "[2000-01-01, 2000-01-02]"};
+  check_tcount(p8, 2,
+    "{[1@2000-01-01, 1@2000-01-02], [1@2000-01-04, 1@2000-01-05]}");
+  char *p9[] = {"(2000-01-01, 2000-01-05)", "(2000-01-01, 2000-01-03)",
+    "[2000-01-03, 2000-01-05)"};
+  check_tcount(p9, 3, "{(2@2000-01-01, 2@2000-01-05)}");
+
+  for (unsigned int seed = 1; seed <= 10; seed++)
+    check_tcount_random(100, seed);
+
+  meos_finish();
+  return MEOS_TEST_RESULT();
+}
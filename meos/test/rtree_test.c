@@ -0,0 +1,351 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Tests of the in-memory R-tree.
+ *
+ * The results of the window, nearest neighbor, and join queries on trees
+ * built by insertion and by bulk loading, after deletions, and after saving
+ * and reopening a tree, are compared with the results of scanning all the
+ * boxes with the functions of the box types.
+ *
+ * When given the argument join_no_common_dimension, the program joins two
+ * trees whose boxes have no common dimension, which must raise an error.
+ */
+
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "meos.h"
+#include "meos_test.h"
+
+#define NBOXES 2000
+#define NQUERIES 50
+
+/**
+ * Comparator of identifiers
+ */
+static int
+int64_cmp(const void *a, const void *b)
+{
+  int64 l = *(const int64 *) a, r = *(const int64 *) b;
+  return (l > r) - (l < r);
+}
+
+/**
+ * Comparator of distances
+ */
+static int
+double_cmp(const void *a, const void *b)
+{
+  double l = *(const double *) a, r = *(const double *) b;
+  return (l > r) - (l < r);
+}
+
+/**
+ * Comparator of pairs of identifiers
+ */
+static int
+pair_cmp(const void *a, const void *b)
+{
+  int result = int64_cmp(a, b);
+  return result ? result : int64_cmp((const int64 *) a + 1,
+    (const int64 *) b + 1);
+}
+
+/**
+ * Return a random number in [0, max)
+ */
+static double
+random_double(double max)
+{
+  return max * rand() / ((double) RAND_MAX + 1.0);
+}
+
+/**
+ * Set a random spatiotemporal box in a 1000 x 1000 square during 100 hours
+ */
+static void
+random_stbox(bool hasx, bool hast, STBOX *box)
+{
+  TimestampTz base = pg_timestamptz_in("2000-01-01", -1);
+  double x = random_double(1000.0), y = random_double(1000.0);
+  double size = random_double(20.0);
+  Period *p = NULL;
+  if (hast)
+  {
+    TimestampTz t = base + (TimestampTz) random_double(100.0) * USECS_PER_HOUR;
+    p = period_make(t, t + (TimestampTz) random_double(5.0) * USECS_PER_HOUR,
+      true, true);
+  }
+  stbox_set(p, hasx, false, false, 0, x, x + size, y, y + size, 0.0, 0.0,
+    box);
+  free(p);
+  return;
+}
+
+/**
+ * Set a random temporal box with values in [0, 1000) during 100 hours
+ */
+static void
+random_tbox(TBOX *box)
+{
+  TimestampTz base = pg_timestamptz_in("2000-01-01", -1);
+  TimestampTz t = base + (TimestampTz) random_double(100.0) * USECS_PER_HOUR;
+  Period *p = period_make(t,
+    t + (TimestampTz) random_double(5.0) * USECS_PER_HOUR, true, true);
+  double x = random_double(1000.0);
+  Span *s = floatspan_make(x, x + random_double(20.0), true, true);
+  tbox_set(p, s, box);
+  free(p); free(s);
+  return;
+}
+
+/**
+ * Return true if a box of the given type overlaps another one
+ */
+static bool
+box_overlaps(bool stbox, const void *box1, const void *box2)
+{
+  return stbox ?
+    overlaps_stbox_stbox((const STBOX *) box1, (const STBOX *) box2) :
+    overlaps_tbox_tbox((const TBOX *) box1, (const TBOX *) box2);
+}
+
+/**
+ * Return the nearest approach distance between two boxes of the given type
+ */
+static double
+box_nad(bool stbox, const void *box1, const void *box2)
+{
+  return stbox ?
+    nad_stbox_stbox((const STBOX *) box1, (const STBOX *) box2) :
+    nad_tbox_tbox((const TBOX *) box1, (const TBOX *) box2);
+}
+
+/**
+ * Check the window and nearest neighbor queries of a tree against a scan of
+ * the boxes whose flag in the array alive is true
+ */
+static void
+check_queries(const RTree *rtree, bool stbox, const void *boxes,
+  const bool *alive, const void *queries)
+{
+  size_t size = stbox ? sizeof(STBOX) : sizeof(TBOX);
+  int64 *expected = malloc(sizeof(int64) * NBOXES);
+  double *dists = malloc(sizeof(double) * NBOXES);
+  int64 nalive = 0;
+  for (int i = 0; i < NBOXES; i++)
+    nalive += alive[i];
+  MEOS_TEST_CHECK(rtree_count(rtree) == nalive);
+  for (int q = 0; q < NQUERIES; q++)
+  {
+    const void *query = (const char *) queries + q * size;
+    /* Window query */
+    int count, nexp = 0;
+    int64 *ids = stbox ? rtree_search_stbox(rtree, query, &count) :
+      rtree_search_tbox(rtree, query, &count);
+    for (int i = 0; i < NBOXES; i++)
+    {
+      if (alive[i] && box_overlaps(stbox, query,
+          (const char *) boxes + i * size))
+        expected[nexp++] = i;
+    }
+    qsort(ids, count, sizeof(int64), int64_cmp);
+    MEOS_TEST_CHECK(count == nexp &&
+      memcmp(ids, expected, sizeof(int64) * count) == 0);
+    free(ids);
+    /* Nearest neighbor query, the distances are compared since the
+     * identifiers of the neighbors at the same distance may differ */
+    int ndists = 0;
+    for (int i = 0; i < NBOXES; i++)
+    {
+      if (! alive[i])
+        continue;
+      double dist = box_nad(stbox, query, (const char *) boxes + i * size);
+      if (dist != DBL_MAX)
+        dists[ndists++] = dist;
+    }
+    qsort(dists, ndists, sizeof(double), double_cmp);
+    int k = q % 10 + 1;
+    double knndists[10];
+    ids = stbox ? rtree_knn_stbox(rtree, query, k, knndists, &count) :
+      rtree_knn_tbox(rtree, query, k, knndists, &count);
+    MEOS_TEST_CHECK(count == (ndists < k ? ndists : k) &&
+      memcmp(knndists, dists, sizeof(double) * count) == 0);
+    for (int i = 0; i < count; i++)
+      MEOS_TEST_CHECK(box_nad(stbox, query,
+        (const char *) boxes + ids[i] * size) == knndists[i]);
+    free(ids);
+  }
+  free(expected); free(dists);
+  return;
+}
+
+/**
+ * Check the join of two trees against a scan of all the pairs of boxes
+ */
+static void
+check_join(const RTree *rtree1, const RTree *rtree2, const STBOX *boxes1,
+  const STBOX *boxes2, int count2)
+{
+  int count;
+  int64 *pairs = rtree_join(rtree1, rtree2, &count);
+  int64 *expected = malloc(sizeof(int64) * 2 * NBOXES * count2);
+  int nexp = 0;
+  for (int i = 0; i < NBOXES; i++)
+  {
+    for (int j = 0; j < count2; j++)
+    {
+      if (overlaps_stbox_stbox(&boxes1[i], &boxes2[j]))
+      {
+        expected[nexp * 2] = i;
+        expected[nexp++ * 2 + 1] = j;
+      }
+    }
+  }
+  qsort(pairs, count, sizeof(int64) * 2, pair_cmp);
+  MEOS_TEST_CHECK(count == nexp &&
+    memcmp(pairs, expected, sizeof(int64) * 2 * count) == 0);
+  free(pairs); free(expected);
+  return;
+}
+
+int
+main(int argc, char **argv)
+{
+  meos_initialize();
+  srand(1);
+
+  if (argc > 1 && strcmp(argv[1], "join_no_common_dimension") == 0)
+  {
+    STBOX box1, box2;
+    random_stbox(true, false, &box1);
+    random_stbox(false, true, &box2);
+    RTree *rtree1 = rtree_make_stbox(), *rtree2 = rtree_make_stbox();
+    rtree_insert_stbox(rtree1, &box1, 0);
+    rtree_insert_stbox(rtree2, &box2, 0);
+    int count;
+    rtree_join(rtree1, rtree2, &count);
+    return 0;
+  }
+
+  STBOX *boxes = malloc(sizeof(STBOX) * NBOXES);
+  STBOX *queries = malloc(sizeof(STBOX) * NQUERIES);
+  int64 *ids = malloc(sizeof(int64) * NBOXES);
+  bool *alive = malloc(sizeof(bool) * NBOXES);
+  for (int i = 0; i < NBOXES; i++)
+  {
+    random_stbox(true, true, &boxes[i]);
+    ids[i] = i;
+    alive[i] = true;
+  }
+  for (int i = 0; i < NQUERIES; i++)
+  {
+    random_stbox(true, true, &queries[i]);
+    /* Larger query windows */
+    queries[i].xmax += 50.0;
+    queries[i].ymax += 50.0;
+  }
+
+  /* Empty tree */
+  RTree *rtree = rtree_make_stbox();
+  int count;
+  int64 *res = rtree_search_stbox(rtree, &queries[0], &count);
+  MEOS_TEST_CHECK(count == 0);
+  free(res);
+
+  /* Tree built by insertion */
+  for (int i = 0; i < NBOXES; i++)
+    rtree_insert_stbox(rtree, &boxes[i], i);
+  check_queries(rtree, true, boxes, alive, queries);
+
+  /* Tree built by bulk loading */
+  RTree *rtree1 = rtree_bulk_load_stbox(boxes, ids, NBOXES);
+  check_queries(rtree1, true, boxes, alive, queries);
+
+  /* Join of the trees with a tree of boxes without time, which are compared
+   * on their spatial dimensions */
+  STBOX boxes2[100];
+  for (int i = 0; i < 100; i++)
+    random_stbox(true, false, &boxes2[i]);
+  RTree *rtree2 = rtree_bulk_load_stbox(boxes2, ids, 100);
+  check_join(rtree, rtree2, boxes, boxes2, 100);
+  check_join(rtree1, rtree2, boxes, boxes2, 100);
+  rtree_free(rtree2);
+
+  /* Deletion of every other box, a box that is not in the tree is not
+   * deleted */
+  for (int i = 0; i < NBOXES; i += 2)
+  {
+    MEOS_TEST_CHECK(rtree_delete_stbox(rtree, &boxes[i], i));
+    alive[i] = false;
+  }
+  MEOS_TEST_CHECK(! rtree_delete_stbox(rtree, &boxes[0], 0));
+  MEOS_TEST_CHECK(! rtree_delete_stbox(rtree, &boxes[2], 1));
+  check_queries(rtree, true, boxes, alive, queries);
+
+  /* Tree saved to a file and memory-mapped back */
+  char filename[] = "/tmp/meos_rtree_test_XXXXXX";
+  int fd = mkstemp(filename);
+  MEOS_TEST_CHECK(fd >= 0);
+  close(fd);
+  MEOS_TEST_CHECK(rtree_save(rtree, filename));
+  RTree *rtree3 = rtree_open(filename);
+  MEOS_TEST_CHECK(rtree3 != NULL);
+  if (rtree3)
+  {
+    check_queries(rtree3, true, boxes, alive, queries);
+    rtree_free(rtree3);
+  }
+  unlink(filename);
+  rtree_free(rtree); rtree_free(rtree1);
+
+  /* Tree of temporal boxes */
+  TBOX *tboxes = malloc(sizeof(TBOX) * NBOXES);
+  TBOX *tqueries = malloc(sizeof(TBOX) * NQUERIES);
+  for (int i = 0; i < NBOXES; i++)
+  {
+    random_tbox(&tboxes[i]);
+    alive[i] = true;
+  }
+  for (int i = 0; i < NQUERIES; i++)
+    random_tbox(&tqueries[i]);
+  rtree = rtree_make_tbox();
+  for (int i = 0; i < NBOXES; i++)
+    rtree_insert_tbox(rtree, &tboxes[i], i);
+  check_queries(rtree, false, tboxes, alive, tqueries);
+  rtree_free(rtree);
+
+  free(boxes); free(queries); free(ids); free(alive);
+  free(tboxes); free(tqueries);
+  meos_finish();
+  return MEOS_TEST_RESULT();
+}
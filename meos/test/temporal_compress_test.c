@@ -0,0 +1,232 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2022, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Tests of the compressed representation of temporal booleans and
+ * temporal texts.
+ *
+ * Sequences are compressed and decompressed back, and the instants and the
+ * values at timestamps of the compressed sequences are compared with those
+ * of the original ones. The temporal booleans cover bitsets whose number of
+ * instants is or is not a multiple of 8, the temporal texts cover
+ * dictionaries whose codes take one or two bytes, including the largest
+ * dictionary allowed.
+ *
+ * When given the argument too_many_values, the program compresses a
+ * temporal text with more distinct values than allowed, which must raise an
+ * error.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "meos.h"
+#include "meos_internal.h"
+#include "general/temporal_compress.h"
+#include "general/temporal_util.h"
+#include "meos_test.h"
+
+/**
+ * Return a step sequence with the given values. The instants are regularly
+ * spaced when the argument regular is true, which is run-length encoded in
+ * the compressed timestamps, and irregularly spaced otherwise.
+ */
+static TSequence *
+make_sequence(mobdbType temptype, const Datum *values, int count,
+  bool regular, bool upper_inc)
+{
+  TimestampTz t = pg_timestamptz_in("2000-01-01", -1);
+  TInstant **instants = malloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+  {
+    instants[i] = tinstant_make(values[i], temptype, t);
+    t += regular ? USECS_PER_MINUTE : USECS_PER_SEC * (1 + i % 7);
+  }
+  return tsequence_make_free(instants, count, true, upper_inc, STEP,
+    NORMALIZE);
+}
+
+/**
+ * Check that a sequence is restored by its compressed representation and
+ * that the accessors of the latter give the same results as those of the
+ * former
+ */
+static void
+check_roundtrip(const TSequence *seq)
+{
+  mobdbType basetype = temptype_basetype(seq->temptype);
+  CTSequence *cts = tsequence_compress(seq);
+  TSequence *seq1 = tsequence_decompress(cts);
+  MEOS_TEST_CHECK(temporal_eq((Temporal *) seq, (Temporal *) seq1));
+  MEOS_TEST_CHECK(ctsequence_num_instants(cts) == seq->count);
+  MEOS_TEST_CHECK(ctsequence_inst_n(cts, -1) == NULL);
+  MEOS_TEST_CHECK(ctsequence_inst_n(cts, seq->count) == NULL);
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = tsequence_inst_n(seq, i);
+    TInstant *inst1 = ctsequence_inst_n(cts, i);
+    MEOS_TEST_CHECK(tinstant_eq(inst, inst1));
+    free(inst1);
+    /* Values at the instant and in the middle of the following segment */
+    TimestampTz t = inst->t;
+    for (int j = 0; j < 2; j++)
+    {
+      Datum value, value1;
+      bool found = temporal_value_at_timestamp((Temporal *) seq, t, true,
+        &value);
+      bool found1 = ctsequence_value_at_timestamp(cts, t, &value1);
+      MEOS_TEST_CHECK(found == found1);
+      if (found && found1)
+      {
+        MEOS_TEST_CHECK(datum_eq(value, value1, basetype));
+        if (basetype == T_TEXT)
+        {
+          free(DatumGetPointer(value));
+          free(DatumGetPointer(value1));
+        }
+      }
+      if (i == seq->count - 1)
+        break;
+      t += (tsequence_inst_n(seq, i + 1)->t - inst->t) / 2;
+    }
+  }
+  /* Timestamps outside of the sequence */
+  Datum value;
+  MEOS_TEST_CHECK(! ctsequence_value_at_timestamp(cts,
+    DatumGetTimestampTz(seq->period.lower) - 1, &value));
+  MEOS_TEST_CHECK(! ctsequence_value_at_timestamp(cts,
+    DatumGetTimestampTz(seq->period.upper) + 1, &value));
+  free(seq1); free(cts);
+  return;
+}
+
+/**
+ * Check the compression of temporal booleans with a given number of
+ * instants
+ */
+static void
+check_tbool(int count)
+{
+  Datum *values = malloc(sizeof(Datum) * count);
+  for (int i = 0; i < count; i++)
+    values[i] = BoolGetDatum(rand() % 2 == 0);
+  for (int regular = 0; regular < 2; regular++)
+  {
+    TSequence *seq = make_sequence(T_TBOOL, values, count, regular, true);
+    check_roundtrip(seq);
+    free(seq);
+  }
+  /* An exclusive upper bound requires the last two values to be equal */
+  if (count > 1)
+  {
+    values[count - 1] = values[count - 2];
+    TSequence *seq = make_sequence(T_TBOOL, values, count, true, false);
+    check_roundtrip(seq);
+    free(seq);
+  }
+  free(values);
+  return;
+}
+
+/**
+ * Return an array of count texts taking ndict distinct values, where
+ * consecutive values are different when there is more than one
+ */
+static Datum *
+make_texts(int count, int ndict)
+{
+  Datum *result = malloc(sizeof(Datum) * count);
+  for (int i = 0; i < count; i++)
+  {
+    char str[32];
+    sprintf(str, "value %d", i % ndict);
+    result[i] = PointerGetDatum(cstring2text(str));
+  }
+  return result;
+}
+
+/**
+ * Check the compression of temporal texts with a given number of instants
+ * and of distinct values
+ */
+static void
+check_ttext(int count, int ndict)
+{
+  Datum *values = make_texts(count, ndict);
+  for (int regular = 0; regular < 2; regular++)
+  {
+    TSequence *seq = make_sequence(T_TTEXT, values, count, regular, true);
+    check_roundtrip(seq);
+    /* The codes take one byte up to 256 distinct values */
+    CTSequence *cts = tsequence_compress(seq);
+    MEOS_TEST_CHECK(cts->ndict == ndict);
+    MEOS_TEST_CHECK(cts->codesize == (ndict <= 256 ? 1 : 2));
+    free(cts); free(seq);
+  }
+  for (int i = 0; i < count; i++)
+    free(DatumGetPointer(values[i]));
+  free(values);
+  return;
+}
+
+int
+main(int argc, char **argv)
+{
+  meos_initialize();
+  srand(1);
+
+  if (argc > 1 && strcmp(argv[1], "too_many_values") == 0)
+  {
+    Datum *values = make_texts(CTSEQUENCE_MAX_DICT + 1,
+      CTSEQUENCE_MAX_DICT + 1);
+    TSequence *seq = make_sequence(T_TTEXT, values,
+      CTSEQUENCE_MAX_DICT + 1, true, true);
+    tsequence_compress(seq);
+    return 0;
+  }
+
+  /* Bitsets whose last byte is partially or totally used */
+  int counts[] = {1, 2, 7, 8, 9, 15, 16, 17, 1000};
+  for (int i = 0; i < (int) (sizeof(counts) / sizeof(int)); i++)
+    check_tbool(counts[i]);
+
+  /* Dictionaries around the size limit of the one-byte codes and of the
+   * largest dictionary */
+  check_ttext(1, 1);
+  check_ttext(10, 1);
+  check_ttext(10, 2);
+  check_ttext(512, 255);
+  check_ttext(512, 256);
+  check_ttext(512, 257);
+  check_ttext(1000, 1000);
+  check_ttext(CTSEQUENCE_MAX_DICT, CTSEQUENCE_MAX_DICT);
+
+  meos_finish();
+  return MEOS_TEST_RESULT();
+}
@@ -195,6 +195,22 @@ CREATE FUNCTION azimuth(tgeogpoint)
   AS 'MODULE_PATHNAME', 'Tpoint_azimuth'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE TYPE motion_metrics AS (
+  length float,
+  cumulativeLength tfloat,
+  speed tfloat,
+  azimuth tfloat
+);
+
+CREATE FUNCTION motionMetrics(tgeompoint)
+  RETURNS motion_metrics
+  AS 'MODULE_PATHNAME', 'Tpoint_motion_metrics'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION motionMetrics(tgeogpoint)
+  RETURNS motion_metrics
+  AS 'MODULE_PATHNAME', 'Tpoint_motion_metrics'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
 
 -- The following two functions are meant to be included in PostGIS one day
@@ -175,3 +175,36 @@ CREATE AGGREGATE merge(tgeogpoint) (
 );
 
 /*****************************************************************************/
+
+CREATE FUNCTION tpoint_compress_transfn(internal, tgeompoint, text, float)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tpoint_compress_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tpoint_compress_transfn(internal, tgeompoint, text, float,
+    integer)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tpoint_compress_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tpoint_compress_finalfn(internal)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'Tpoint_compress_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/* The instants must be aggregated in timestamp order, e.g.,
+ * compress(inst, 'squishe', 10 ORDER BY t) */
+CREATE AGGREGATE compress(tgeompoint, text, float) (
+  SFUNC = tpoint_compress_transfn,
+  STYPE = internal,
+  FINALFUNC = tpoint_compress_finalfn,
+  FINALFUNC_MODIFY = READ_WRITE,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE compress(tgeompoint, text, float, integer) (
+  SFUNC = tpoint_compress_transfn,
+  STYPE = internal,
+  FINALFUNC = tpoint_compress_finalfn,
+  FINALFUNC_MODIFY = READ_WRITE,
+  PARALLEL = SAFE
+);
+
+/*****************************************************************************/
@@ -37,4 +37,23 @@ CREATE FUNCTION create_trip(record[], timestamptz, boolean, text)
   AS 'MODULE_PATHNAME', 'create_trip'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+/*
+ * The edges of the road network are records of the form
+ * (geom, source, target, maxSpeed, category). The arguments are the
+ * edges, the first and last vehicles, the number of days, the first day,
+ * the seed, whether GPS errors are simulated, and the message level.
+ */
+CREATE TYPE generated_trip AS (
+  vehicle integer,
+  day date,
+  seqno integer,
+  trip tgeompoint
+);
+
+CREATE FUNCTION create_trips(record[], integer, integer, integer, date,
+    bigint DEFAULT 0, boolean DEFAULT false, text DEFAULT 'minimal')
+  RETURNS SETOF generated_trip
+  AS 'MODULE_PATHNAME', 'create_trips'
+  LANGUAGE C VOLATILE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
@@ -40,21 +40,24 @@
  * period, tint, ...), currently 33.
  *
  * There are currently 3,392 operators, each of which is identified by an Oid.
- * To avoid enumerating all of these operators in the Oid cache, we use a
- * two-dimensional array containing all possible combinations of
- * operator/left argument/right argument (currently 23 * 40 * 40 = 36,800 cells).
- * The invalid combinations will be initialized to 0.
+ * Since a backend typically uses only a few of them, the Oid of an operator
+ * is looked up in the catalog the first time the combination of
+ * operator/left argument/right argument is requested and is then kept in a
+ * hash table local to the backend. Combinations for which no operator is
+ * defined are cached with an invalid Oid. The caches are reset when the
+ * catalog entries of types or operators are invalidated, e.g., when the
+ * extension is updated.
  */
 
 #include "general/temporal_catalog.h"
 
 /* PostgreSQL */
 #include <postgres.h>
-#include <access/heapam.h>
-#include <access/htup_details.h>
-#include <access/tableam.h>
 #include <catalog/namespace.h>
-#include <utils/rel.h>
+#include <nodes/value.h>
+#include <utils/hsearch.h>
+#include <utils/inval.h>
+#include <utils/syscache.h>
 /* MEOS */
 #include "general/temporaltypes.h"
 #if NPOINT
@@ -150,8 +153,8 @@ const char *_op_names[] =
 };
 
 /**
- * Global variable that states whether the type and operator Oid caches
- * has been initialized.
+ * Global variable that states whether the type Oid cache has been
+ * initialized.
  */
 bool _oid_cache_ready = false;
 
@@ -161,16 +164,37 @@ bool _oid_cache_ready = false;
 Oid _type_oids[sizeof(_type_names) / sizeof(char *)];
 
 /**
- * Global 3-dimensional array that keeps the Oids of the operators
- * used in MobilityDB. The first dimension corresponds to the operator
- * class (e.g., <=), the second and third dimensions correspond,
- * respectively, to the left and right arguments of the operator.
- * A value 0 is stored in the cell of the array if the operator class
- * is not defined for the left and right types.
+ * Key of the operator Oid cache composed of the operator class (e.g., <=)
+ * and the left and right arguments of the operator.
  */
-Oid _op_oids[sizeof(_op_names) / sizeof(char *)]
-  [sizeof(_type_names) / sizeof(char *)]
-  [sizeof(_type_names) / sizeof(char *)];
+typedef struct
+{
+  int32 oper;       /**< Operator class */
+  int32 ltype;      /**< Left argument type */
+  int32 rtype;      /**< Right argument type */
+} OperOidKey;
+
+/**
+ * Entry of the operator Oid cache. An invalid Oid is stored if the operator
+ * class is not defined for the left and right types.
+ */
+typedef struct
+{
+  OperOidKey key;   /**< Hash key, must be first */
+  Oid oid;          /**< Oid of the operator */
+} OperOidEntry;
+
+/**
+ * Global hash table that keeps the Oids of the operators used in MobilityDB
+ * that have been requested by the backend, NULL if it has not been created.
+ */
+static HTAB *_op_oids = NULL;
+
+/**
+ * Global variable that states whether the invalidation callbacks of the
+ * caches have been registered.
+ */
+static bool _oid_callbacks_ready = false;
 
 /*****************************************************************************
  * Catalog functions
@@ -185,69 +209,73 @@ internal_type(const char *typname)
 }
 
 /**
- * Populate the Oid cache for types
+ * Push a search path containing the public schema in which the extension
+ * is installed
  */
 static void
-populate_typeoid_cache()
+push_mobilitydb_search_path(void)
 {
-  int n = sizeof(_type_names) / sizeof(char *);
-  for (int i = 0; i < n; i++)
+  Oid namespaceId = LookupNamespaceNoError("public");
+  OverrideSearchPath* overridePath = GetOverrideSearchPath(CurrentMemoryContext);
+  overridePath->schemas = lcons_oid(namespaceId, overridePath->schemas);
+  PushOverrideSearchPath(overridePath);
+  return;
+}
+
+/**
+ * Reset the Oid caches when the catalog entries of types or operators are
+ * invalidated
+ */
+static void
+oid_cache_invalidate(Datum arg __attribute__((unused)),
+  int cacheid __attribute__((unused)), uint32 hashvalue __attribute__((unused)))
+{
+  _oid_cache_ready = false;
+  if (_op_oids != NULL)
   {
-    if (! internal_type(_type_names[i]))
-    {
-      _type_oids[i] = TypenameGetTypid(_type_names[i]);
-      if (!_type_oids[i])
-        ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-          errmsg("No Oid for type %s", _type_names[i])));
-    }
+    hash_destroy(_op_oids);
+    _op_oids = NULL;
   }
   return;
 }
 
 /**
- * Populate the Oid cache for operators
+ * Register the callbacks that reset the Oid caches, which are kept across
+ * transactions, when the catalog entries of types or operators change
  */
 static void
-populate_operoid_cache()
+register_oid_cache_callbacks(void)
 {
-  Oid namespaceId = LookupNamespaceNoError("public");
-  OverrideSearchPath* overridePath = GetOverrideSearchPath(CurrentMemoryContext);
-  overridePath->schemas = lcons_oid(namespaceId, overridePath->schemas);
-  PushOverrideSearchPath(overridePath);
+  if (! _oid_callbacks_ready)
+  {
+    CacheRegisterSyscacheCallback(TYPEOID, oid_cache_invalidate, (Datum) 0);
+    CacheRegisterSyscacheCallback(OPEROID, oid_cache_invalidate, (Datum) 0);
+    _oid_callbacks_ready = true;
+  }
+  return;
+}
 
+/**
+ * Populate the Oid cache for types
+ */
+static void
+populate_typeoid_cache()
+{
+  register_oid_cache_callbacks();
+  push_mobilitydb_search_path();
   PG_TRY();
   {
-    populate_typeoid_cache();
-    memset(_op_oids, 0, sizeof(_op_oids));
-    /*
-     * This fetches the pre-computed operator cache from the catalog where
-     * it is stored in a table. See the fill_opcache function below.
-     */
-    Oid catalog = RelnameGetRelid("mobilitydb_opcache");
-#if POSTGRESQL_VERSION_NUMBER < 130000
-    Relation rel = heap_open(catalog, AccessShareLock);
-#else
-    Relation rel = table_open(catalog, AccessShareLock);
-#endif
-    TupleDesc tupDesc = rel->rd_att;
-    ScanKeyData scandata;
-    TableScanDesc scan = table_beginscan_catalog(rel, 0, &scandata);
-    HeapTuple tuple = heap_getnext(scan, ForwardScanDirection);
-    while (HeapTupleIsValid(tuple))
+    int n = sizeof(_type_names) / sizeof(char *);
+    for (int i = 0; i < n; i++)
     {
-      bool isnull = false;
-      int32 i = DatumGetInt32(heap_getattr(tuple, 1, tupDesc, &isnull));
-      int32 j = DatumGetInt32(heap_getattr(tuple, 2, tupDesc, &isnull));
-      int32 k = DatumGetInt32(heap_getattr(tuple, 3, tupDesc, &isnull));
-      _op_oids[i][j][k] = DatumGetObjectId(heap_getattr(tuple, 4, tupDesc, &isnull));
-      tuple = heap_getnext(scan, ForwardScanDirection);
+      if (! internal_type(_type_names[i]))
+      {
+        _type_oids[i] = TypenameGetTypid(_type_names[i]);
+        if (!_type_oids[i])
+          ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+            errmsg("No Oid for type %s", _type_names[i])));
+      }
     }
-    heap_endscan(scan);
-#if POSTGRESQL_VERSION_NUMBER < 130000
-    heap_close(rel, AccessShareLock);
-#else
-    table_close(rel, AccessShareLock);
-#endif
     PopOverrideSearchPath();
     _oid_cache_ready = true;
   }
@@ -257,54 +285,55 @@ populate_operoid_cache()
     PG_RE_THROW();
   }
   PG_END_TRY();
+  return;
 }
 
-PG_FUNCTION_INFO_V1(fill_opcache);
 /**
- * Function executed during the `CREATE EXTENSION` to precompute the
- * operator cache and store it as a table in the catalog
+ * Create the hash table of the operator Oid cache
  */
-PGDLLEXPORT Datum
-fill_opcache(PG_FUNCTION_ARGS __attribute__((unused)))
+static void
+create_operoid_cache(void)
 {
-  Oid catalog = RelnameGetRelid("mobilitydb_opcache");
-#if POSTGRESQL_VERSION_NUMBER < 130000
-  Relation rel = heap_open(catalog, AccessExclusiveLock);
-#else
-  Relation rel = table_open(catalog, AccessExclusiveLock);
-#endif
-  TupleDesc tupDesc = rel->rd_att;
+  HASHCTL ctl;
+  memset(&ctl, 0, sizeof(ctl));
+  ctl.keysize = sizeof(OperOidKey);
+  ctl.entrysize = sizeof(OperOidEntry);
+  /* The table is allocated in the TopMemoryContext */
+  _op_oids = hash_create("MobilityDB operator Oid cache", 64, &ctl,
+    HASH_ELEM | HASH_BLOBS);
+  register_oid_cache_callbacks();
+  return;
+}
 
-  bool isnull[] = {false, false, false, false};
-  Datum data[] = {0, 0, 0, 0};
+/**
+ * Look up in the catalog the Oid of an operator, return an invalid Oid if
+ * the operator class is not defined for the left and right types
+ */
+static Oid
+lookup_operoid(CachedOp oper, mobdbType lt, mobdbType rt)
+{
+  Oid ltypid = type_oid(lt);
+  Oid rtypid = type_oid(rt);
+  /* Internal types do not have operators */
+  if (ltypid == InvalidOid || rtypid == InvalidOid)
+    return InvalidOid;
 
-  populate_typeoid_cache();
-  int32 m = sizeof(_op_names) / sizeof(char *);
-  int32 n = sizeof(_type_names) / sizeof(char *);
-  for (int32 i = 0; i < m; i++)
+  Oid result = InvalidOid;
+  push_mobilitydb_search_path();
+  PG_TRY();
   {
-    List* lst = list_make1(makeString((char *) _op_names[i]));
-    for (int32 j = 0; j < n; j++)
-      for (int32 k = 0; k < n; k++)
-      {
-        data[3] = ObjectIdGetDatum(OpernameGetOprid(lst, _type_oids[j], _type_oids[k]));
-        if (data[3] != InvalidOid)
-        {
-          data[0] = Int32GetDatum(i);
-          data[1] = Int32GetDatum(j);
-          data[2] = Int32GetDatum(k);
-          HeapTuple t = heap_form_tuple(tupDesc, data, isnull);
-          simple_heap_insert(rel, t);
-        }
-      }
+    List* lst = list_make1(makeString((char *) _op_names[oper]));
+    result = OpernameGetOprid(lst, ltypid, rtypid);
     pfree(lst);
+    PopOverrideSearchPath();
   }
-#if POSTGRESQL_VERSION_NUMBER < 130000
-  heap_close(rel, AccessExclusiveLock);
-#else
-  table_close(rel, AccessExclusiveLock);
-#endif
-  PG_RETURN_VOID();
+  PG_CATCH();
+  {
+    PopOverrideSearchPath();
+    PG_RE_THROW();
+  }
+  PG_END_TRY();
+  return result;
 }
 
 /**
@@ -316,7 +345,7 @@ Oid
 type_oid(mobdbType type)
 {
   if (!_oid_cache_ready)
-    populate_operoid_cache();
+    populate_typeoid_cache();
   return _type_oids[type];
 }
 
@@ -330,9 +359,25 @@ type_oid(mobdbType type)
 Oid
 oper_oid(CachedOp oper, mobdbType lt, mobdbType rt)
 {
-  if (!_oid_cache_ready)
-    populate_operoid_cache();
-  return _op_oids[oper][lt][rt];
+  OperOidKey key;
+  key.oper = (int32) oper;
+  key.ltype = (int32) lt;
+  key.rtype = (int32) rt;
+  OperOidEntry *entry;
+  if (_op_oids != NULL)
+  {
+    entry = (OperOidEntry *) hash_search(_op_oids, &key, HASH_FIND, NULL);
+    if (entry != NULL)
+      return entry->oid;
+  }
+  /* The lookup may process invalidation messages that reset the cache,
+   * therefore the entry is only created after it */
+  Oid result = lookup_operoid(oper, lt, rt);
+  if (_op_oids == NULL)
+    create_operoid_cache();
+  entry = (OperOidEntry *) hash_search(_op_oids, &key, HASH_ENTER, NULL);
+  entry->oid = result;
+  return result;
 }
 
 /**
@@ -344,7 +389,7 @@ mobdbType
 oid_type(Oid typid)
 {
   if (!_oid_cache_ready)
-    populate_operoid_cache();
+    populate_typeoid_cache();
   int n = sizeof(_type_names) / sizeof(char *);
   for (int i = 0; i < n; i++)
   {
@@ -30,7 +30,8 @@
 /**
  * @brief Aggregate functions for temporal points.
  *
- * The only functions currently provided are extent and temporal centroid.
+ * The functions currently provided are extent, temporal centroid, and online
+ * compression.
  */
 
 #include "pg_point/tpoint_aggfuncs.h"
@@ -42,9 +43,11 @@
 #include <meos_internal.h>
 #include "general/temporaltypes.h"
 #include "general/doublen.h"
+#include "general/temporal_util.h"
 #include "pg_general/skiplist.h"
 #include "pg_general/temporal_aggfuncs.h"
 #include "point/tpoint.h"
+#include "point/tpoint_compress.h"
 #include "point/tpoint_spatialfuncs.h"
 
 /*****************************************************************************
@@ -427,3 +430,92 @@ Tpoint_tcentroid_finalfn(PG_FUNCTION_ARGS)
 }
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Online compression
+ *****************************************************************************/
+
+/**
+ * Return the online compression method from its name
+ */
+static CompressMethod
+get_compress_method(const text *txt)
+{
+  char *name = text2cstring(txt);
+  CompressMethod result;
+  if (strcasecmp(name, "deadreckoning") == 0)
+    result = COMPRESS_DEADRECKONING;
+  else if (strcasecmp(name, "squishe") == 0)
+    result = COMPRESS_SQUISHE;
+  else
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("Unknown compression method: %s", name)));
+  pfree(name);
+  return result;
+}
+
+PG_FUNCTION_INFO_V1(Tpoint_compress_transfn);
+/**
+ * Transition function for online compression of temporal point values
+ *
+ * The instants of the values are appended to the compressor in the order in
+ * which the values are aggregated, which must be the order of their
+ * timestamps.
+ */
+PGDLLEXPORT Datum
+Tpoint_compress_transfn(PG_FUNCTION_ARGS)
+{
+  MemoryContext ctx;
+  if (! AggCheckCallContext(fcinfo, &ctx))
+    ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+      errmsg("Operation not supported")));
+  TPointCompressor *state = PG_ARGISNULL(0) ? NULL :
+    (TPointCompressor *) PG_GETARG_POINTER(0);
+  if (PG_ARGISNULL(1))
+  {
+    if (! state)
+      PG_RETURN_NULL();
+    PG_RETURN_POINTER(state);
+  }
+  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+
+  MemoryContext oldctx = MemoryContextSwitchTo(ctx);
+  if (! state)
+  {
+    if (PG_ARGISNULL(2) || PG_ARGISNULL(3) ||
+        (PG_NARGS() > 4 && PG_ARGISNULL(4)))
+      ereport(ERROR, (errcode(ERRCODE_NULL_VALUE_NOT_ALLOWED),
+        errmsg("The compression parameters cannot be null")));
+    CompressMethod method = get_compress_method(PG_GETARG_TEXT_P(2));
+    double eps_dist = PG_GETARG_FLOAT8(3);
+    int bufsize = PG_NARGS() > 4 ? PG_GETARG_INT32(4) :
+      COMPRESS_DEFAULT_BUFSIZE;
+    state = tpoint_compressor_make(method, eps_dist, bufsize);
+  }
+  int count;
+  const TInstant **instants = temporal_instants(temp, &count);
+  for (int i = 0; i < count; i++)
+    tpoint_compressor_append(state, instants[i]);
+  pfree(instants);
+  MemoryContextSwitchTo(oldctx);
+
+  PG_FREE_IF_COPY(temp, 1);
+  PG_RETURN_POINTER(state);
+}
+
+PG_FUNCTION_INFO_V1(Tpoint_compress_finalfn);
+/**
+ * Final function for online compression of temporal point values
+ */
+PGDLLEXPORT Datum
+Tpoint_compress_finalfn(PG_FUNCTION_ARGS)
+{
+  /* The final function is strict, we do not need to test for null values */
+  TPointCompressor *state = (TPointCompressor *) PG_GETARG_POINTER(0);
+  TSequence *result = tpoint_compressor_finish(state);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************/
@@ -34,11 +34,17 @@
  * https://github.com/MobilityDB/MobilityDB-BerlinMOD
  */
 
+/* C */
+#include <assert.h>
+#include <float.h>
 /* PostgreSQL */
 #include <postgres.h>
 #include <access/htup_details.h>
 #include <access/tupdesc.h>    /* for * () */
 #include <executor/executor.h>  /* for GetAttributeByName() */
+#include <funcapi.h>
+#include <utils/date.h>
+#include <utils/datetime.h>
 #include <utils/typcache.h>
 #include <utils/float.h>
 #include <utils/lsyscache.h>
@@ -109,7 +115,8 @@ pt_angle(POINT2D p1, POINT2D p2, POINT2D p3)
  */
 static TSequence *
 create_trip_internal(LWLINE **lines, const double *maxSpeeds, const int *categories,
-  uint32_t noEdges, TimestampTz startTime, bool disturbData, int verbosity)
+  uint32_t noEdges, TimestampTz startTime, bool disturbData, int verbosity,
+  gsl_rng *rng)
 {
   /* CONSTANT PARAMETERS */
 
@@ -198,9 +205,6 @@ create_trip_internal(LWLINE **lines, const double *maxSpeeds, const int *categor
   int noAccel = 0, noDecel = 0, noStop = 0;
   double twSumSpeed = 0.0, totalTravelTime = 0.0, totalWaitTime = 0.0;
 
-  if (!_gsl_initizalized)
-    initialize_gsl();
-
   /* First Pass: Compute the number of instants of the result */
 
   for (i = 0; i < noEdges; i++)
@@ -292,9 +296,9 @@ create_trip_internal(LWLINE **lines, const double *maxSpeeds, const int *categor
           /* If the current speed is not considered as a stop, with
            * a probability proportional to 1/maxSpeedEdge apply a
            * deceleration event (p=90%) or a stop event (p=10%) */
-          if (gsl_rng_uniform(_rng) <= P_EVENT_C / maxSpeedEdge)
+          if (gsl_rng_uniform(rng) <= P_EVENT_C / maxSpeedEdge)
           {
-            if (gsl_rng_uniform(_rng) <= P_EVENT_P)
+            if (gsl_rng_uniform(rng) <= P_EVENT_P)
             {
               /* Apply stop event */
               curSpeed = 0.0;
@@ -306,7 +310,7 @@ create_trip_internal(LWLINE **lines, const double *maxSpeeds, const int *categor
             else
             {
               /* Apply deceleration event */
-              curSpeed = curSpeed * gsl_ran_binomial(_rng, 0.5, 20) / 20.0;
+              curSpeed = curSpeed * gsl_ran_binomial(rng, 0.5, 20) / 20.0;
               noDecel++;
               if (verbosity == 3)
                 ereport(INFO, (errcode(ERRCODE_SUCCESSFUL_COMPLETION),
@@ -352,7 +356,7 @@ create_trip_internal(LWLINE **lines, const double *maxSpeeds, const int *categor
         /* If speed is zero add a wait time */
         if (curSpeed < P_EPSILON_SPEED)
         {
-          waitTime = gsl_ran_exponential(_rng, P_DEST_EXPMU);
+          waitTime = gsl_ran_exponential(rng, P_DEST_EXPMU);
           if (waitTime < P_EPSILON)
             waitTime = P_DEST_EXPMU;
           t = t + (int) (waitTime * 1e6); /* microseconds */
@@ -371,9 +375,9 @@ create_trip_internal(LWLINE **lines, const double *maxSpeeds, const int *categor
             curPos.y = p1.y + ((p2.y - p1.y) * fraction * (k + 1));
             if (disturbData)
             {
-              dx = (2.0 * P_GPS_STEPMAXERR * gsl_rng_uniform(_rng)) -
+              dx = (2.0 * P_GPS_STEPMAXERR * gsl_rng_uniform(rng)) -
                 P_GPS_STEPMAXERR;
-              dy = (2.0 * P_GPS_STEPMAXERR * gsl_rng_uniform(_rng)) -
+              dy = (2.0 * P_GPS_STEPMAXERR * gsl_rng_uniform(rng)) -
                 P_GPS_STEPMAXERR;
               errx += dx;
               erry += dy;
@@ -413,10 +417,10 @@ create_trip_internal(LWLINE **lines, const double *maxSpeeds, const int *categor
     if (curSpeed > P_EPSILON_SPEED && i < noEdges - 1)
     {
       int nextCategory = categories[i + 1];
-      if (gsl_rng_uniform(_rng) <= P_DEST_STOPPROB[category][nextCategory])
+      if (gsl_rng_uniform(rng) <= P_DEST_STOPPROB[category][nextCategory])
       {
         curSpeed = 0.0;
-        waitTime = gsl_ran_exponential(_rng, P_DEST_EXPMU);
+        waitTime = gsl_ran_exponential(rng, P_DEST_EXPMU);
         if (waitTime < P_EPSILON)
           waitTime = P_DEST_EXPMU;
         t = t + (int) (waitTime * 1e6); /* microseconds */
@@ -456,12 +460,25 @@ create_trip_internal(LWLINE **lines, const double *maxSpeeds, const int *categor
         errmsg("    ------------------------------------------")));
   }
 
-  for (i = 0; i < noEdges; i++)
-    lwgeom_free(lwline_as_lwgeom(lines[i]));
-  pfree(lines);
   return result;
 }
 
+/**
+ * Return the verbosity level corresponding to a message level,
+ * 'minimal' by default
+ */
+static int
+datagen_verbosity(const char *msgstr)
+{
+  if (strcmp(msgstr, "medium") == 0)
+    return 1;
+  else if (strcmp(msgstr, "verbose") == 0)
+    return 2;
+  else if (strcmp(msgstr, "debug") == 0)
+    return 3;
+  return 0;
+}
+
 PG_FUNCTION_INFO_V1(create_trip);
 /**
  * Create a trip using the BerlinMOD data generator.
@@ -482,7 +499,6 @@ create_trip(PG_FUNCTION_ARGS)
   bool disturbData = PG_GETARG_BOOL(2);
   text *messages = PG_GETARG_TEXT_PP(3);
   char *msgstr = text2cstring(messages);
-  int32 msg = 0; /* 'minimal' by default */
   Datum *datums;
   bool *nulls;
   int count;
@@ -575,20 +591,633 @@ create_trip(PG_FUNCTION_ARGS)
     }
   }
 
-  if (strcmp(msgstr, "minimal") == 0)
-    msg = 0;
-  else if (strcmp(msgstr, "medium") == 0)
-    msg = 1;
-  else if (strcmp(msgstr, "verbose") == 0)
-    msg = 2;
-  else if (strcmp(msgstr, "debug") == 0)
-    msg = 3;
-
+  if (!_gsl_initizalized)
+    initialize_gsl();
   TSequence *result = create_trip_internal(lines, maxSpeeds, categories,
-    (uint32_t) count, t, disturbData, msg);
+    (uint32_t) count, t, disturbData, datagen_verbosity(msgstr), _rng);
 
+  for (int i = 0; i < count; i++)
+    lwgeom_free(lwline_as_lwgeom(lines[i]));
+  pfree(lines);
   PG_FREE_IF_COPY(array, 0);
   PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Generation of trips for a fleet of vehicles on a road network
+ *****************************************************************************/
+
+/**
+ * Road network used for generating trips. The nodes are identified by their
+ * position in the sorted array of node identifiers and the edges incident to
+ * a node are kept in compressed sparse row format.
+ */
+typedef struct
+{
+  int nnodes;            /**< Number of nodes */
+  int nedges;            /**< Number of edges */
+  int64 *nodeids;        /**< Sorted identifiers of the nodes */
+  int *source;           /**< Source node of each edge */
+  int *target;           /**< Target node of each edge */
+  double *cost;          /**< Travel time of each edge */
+  double *maxSpeeds;     /**< Maximum speed of each edge */
+  int *categories;       /**< Road category of each edge */
+  LWLINE **lines;        /**< Geometry of each edge */
+  LWLINE **rlines;       /**< Reversed geometry of each edge */
+  int *adjstart;         /**< Start of the incident edges of each node */
+  int *adjedges;         /**< Incident edges of the nodes */
+} RoadNetwork;
+
+/**
+ * Maximum number of trips of a vehicle in a day
+ */
+#define MAX_DAY_TRIPS 4
+
+/**
+ * State of the trip generator that persists across multiple calls of the
+ * function
+ */
+typedef struct
+{
+  RoadNetwork *net;      /**< Road network */
+  gsl_rng *rng;          /**< Random number generator */
+  MemoryContext dayctx;  /**< Memory context of the trips of a day */
+  uint64 seed;           /**< Seed of the generation */
+  int vehicle;           /**< Current vehicle */
+  int lastVehicle;       /**< Last vehicle to generate */
+  int ndays;             /**< Number of days */
+  int day;               /**< Current day */
+  DateADT startDate;     /**< First day */
+  bool disturbData;      /**< True when GPS errors are simulated */
+  int verbosity;         /**< Verbosity level */
+  int home;              /**< Home node of the current vehicle */
+  int work;              /**< Work node of the current vehicle */
+  int *path;             /**< Path from home to work of the current vehicle */
+  int pathlen;           /**< Number of edges of the path */
+  int ntrips;            /**< Number of trips of the current day */
+  int trip;              /**< Next trip of the current day to output */
+  TSequence *trips[MAX_DAY_TRIPS]; /**< Trips of the current day */
+} TripGenState;
+
+/**
+ * Compare two node identifiers
+ */
+static int
+int64_cmp(const void *a, const void *b)
+{
+  int64 l = *(const int64 *) a;
+  int64 r = *(const int64 *) b;
+  return (l < r) ? -1 : ((l > r) ? 1 : 0);
+}
+
+/**
+ * Return the position of a node identifier in the road network
+ */
+static int
+roadnet_node(const RoadNetwork *net, int64 id)
+{
+  int64 *pos = bsearch(&id, net->nodeids, net->nnodes, sizeof(int64),
+    int64_cmp);
+  assert(pos != NULL);
+  return (int) (pos - net->nodeids);
+}
+
+/**
+ * Return an integer attribute of an edge record, which may be either an
+ * integer or a big integer
+ */
+static int64
+edge_int_attr(HeapTupleHeader td, Oid typid, int attno)
+{
+  bool isNull;
+  Datum value = GetAttributeByNum(td, attno, &isNull);
+  if (isNull)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("Elements of the record cannot be NULL")));
+  return (typid == INT8OID) ? DatumGetInt64(value) :
+    (int64) DatumGetInt32(value);
+}
+
+/**
+ * Build a road network from an array of records of the form
+ * `(geom, source, target, maxSpeed, category)`
+ */
+static RoadNetwork *
+roadnet_make(ArrayType *array)
+{
+  ensure_non_empty_array(array);
+  if (ARR_NDIM(array) > 1)
+    ereport(ERROR, (errcode(ERRCODE_ARRAY_SUBSCRIPT_ERROR),
+      errmsg("1-dimensional array needed")));
+  Datum *datums;
+  bool *nulls;
+  int count;
+  int16 elemWidth;
+  Oid elemTypid = ARR_ELEMTYPE(array);
+  bool elemTypeByVal, isNull;
+  char elemAlignmentCode;
+  get_typlenbyvalalign(elemTypid, &elemWidth, &elemTypeByVal,
+    &elemAlignmentCode);
+  deconstruct_array(array, elemTypid, elemWidth, elemTypeByVal,
+    elemAlignmentCode, &datums, &nulls, &count);
+  for (int i = 0; i < count; i++)
+  {
+    if (nulls[i])
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("Elements of the array cannot be NULL")));
+  }
+
+  /* Verify the type of the attributes */
+  HeapTupleHeader td = DatumGetHeapTupleHeader(datums[0]);
+  TupleDesc tupdesc = lookup_rowtype_tupdesc(HeapTupleHeaderGetTypeId(td),
+    HeapTupleHeaderGetTypMod(td));
+  if (tupdesc->natts != 5 ||
+      TupleDescAttr(tupdesc, 0)->atttypid != type_oid(T_GEOMETRY) ||
+      (TupleDescAttr(tupdesc, 1)->atttypid != INT4OID &&
+        TupleDescAttr(tupdesc, 1)->atttypid != INT8OID) ||
+      (TupleDescAttr(tupdesc, 2)->atttypid != INT4OID &&
+        TupleDescAttr(tupdesc, 2)->atttypid != INT8OID) ||
+      TupleDescAttr(tupdesc, 3)->atttypid != FLOAT8OID ||
+      TupleDescAttr(tupdesc, 4)->atttypid != INT4OID)
+  {
+    ReleaseTupleDesc(tupdesc);
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The edges must be records of the form (geometry, integer, integer, double precision, integer)")));
+  }
+  Oid sourcetypid = TupleDescAttr(tupdesc, 1)->atttypid;
+  Oid targettypid = TupleDescAttr(tupdesc, 2)->atttypid;
+  ReleaseTupleDesc(tupdesc);
+
+  RoadNetwork *net = palloc0(sizeof(RoadNetwork));
+  net->nedges = count;
+  int64 *sourceids = palloc(sizeof(int64) * count);
+  int64 *targetids = palloc(sizeof(int64) * count);
+  net->cost = palloc(sizeof(double) * count);
+  net->maxSpeeds = palloc(sizeof(double) * count);
+  net->categories = palloc(sizeof(int) * count);
+  net->lines = palloc(sizeof(LWLINE *) * count);
+  net->rlines = palloc(sizeof(LWLINE *) * count);
+  for (int i = 0; i < count; i++)
+  {
+    td = DatumGetHeapTupleHeader(datums[i]);
+    /* First attribute: linestring */
+    Datum geom = GetAttributeByNum(td, 1, &isNull);
+    if (isNull)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("Elements of the record cannot be NULL")));
+    GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(geom);
+    if (gserialized_get_type(gs) != LINETYPE)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("Geometry must be a linestring")));
+    /* The deserialized line points into the array, which may be a copy
+     * freed after the first call of the function, so it is copied */
+    LWGEOM *lwgeom = lwgeom_from_gserialized(gs);
+    net->lines[i] = lwgeom_as_lwline(lwgeom_clone_deep(lwgeom));
+    lwgeom_free(lwgeom);
+    PG_FREE_IF_COPY_P(gs, DatumGetPointer(geom));
+    LWGEOM *rgeom = lwgeom_clone_deep(lwline_as_lwgeom(net->lines[i]));
+    lwgeom_reverse_in_place(rgeom);
+    net->rlines[i] = lwgeom_as_lwline(rgeom);
+    /* Second and third attributes: source and target nodes */
+    sourceids[i] = edge_int_attr(td, sourcetypid, 2);
+    targetids[i] = edge_int_attr(td, targettypid, 3);
+    /* Fourth attribute: maximum speed */
+    net->maxSpeeds[i] = DatumGetFloat8(GetAttributeByNum(td, 4, &isNull));
+    if (isNull || net->maxSpeeds[i] <= 0.0)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The maximum speed of the edges must be positive")));
+    /* Fifth attribute: category */
+    net->categories[i] = DatumGetInt32(GetAttributeByNum(td, 5, &isNull));
+    if (isNull || net->categories[i] < 0 || net->categories[i] > 2)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The category of the edges must be 0, 1, or 2")));
+    /* Travel time at maximum speed */
+    net->cost[i] = lwgeom_length_2d(lwline_as_lwgeom(net->lines[i])) /
+      net->maxSpeeds[i];
+  }
+
+  /* Collect the distinct node identifiers */
+  int64 *ids = palloc(sizeof(int64) * count * 2);
+  memcpy(ids, sourceids, sizeof(int64) * count);
+  memcpy(ids + count, targetids, sizeof(int64) * count);
+  qsort(ids, count * 2, sizeof(int64), int64_cmp);
+  int nnodes = 1;
+  for (int i = 1; i < count * 2; i++)
+  {
+    if (ids[i] != ids[nnodes - 1])
+      ids[nnodes++] = ids[i];
+  }
+  net->nnodes = nnodes;
+  net->nodeids = ids;
+
+  /* Compute the incident edges of each node */
+  net->source = palloc(sizeof(int) * count);
+  net->target = palloc(sizeof(int) * count);
+  net->adjstart = palloc0(sizeof(int) * (nnodes + 1));
+  for (int i = 0; i < count; i++)
+  {
+    net->source[i] = roadnet_node(net, sourceids[i]);
+    net->target[i] = roadnet_node(net, targetids[i]);
+    net->adjstart[net->source[i] + 1]++;
+    net->adjstart[net->target[i] + 1]++;
+  }
+  for (int i = 0; i < nnodes; i++)
+    net->adjstart[i + 1] += net->adjstart[i];
+  int *fill = palloc(sizeof(int) * nnodes);
+  memcpy(fill, net->adjstart, sizeof(int) * nnodes);
+  net->adjedges = palloc(sizeof(int) * count * 2);
+  for (int i = 0; i < count; i++)
+  {
+    net->adjedges[fill[net->source[i]]++] = i;
+    net->adjedges[fill[net->target[i]]++] = i;
+  }
+  pfree(fill); pfree(sourceids); pfree(targetids);
+  return net;
+}
+
+/**
+ * Entry of the priority queue of the shortest path computation
+ */
+typedef struct
+{
+  double cost;
+  int node;
+} PathQueueElem;
+
+/**
+ * Push an element into the binary heap of the shortest path computation
+ */
+static void
+pathqueue_push(PathQueueElem *heap, int *count, double cost, int node)
+{
+  int i = (*count)++;
+  while (i > 0 && heap[(i - 1) / 2].cost > cost)
+  {
+    heap[i] = heap[(i - 1) / 2];
+    i = (i - 1) / 2;
+  }
+  heap[i].cost = cost;
+  heap[i].node = node;
+  return;
+}
+
+/**
+ * Pop the element with minimum cost from the binary heap of the shortest path
+ * computation
+ */
+static PathQueueElem
+pathqueue_pop(PathQueueElem *heap, int *count)
+{
+  PathQueueElem result = heap[0];
+  PathQueueElem last = heap[--(*count)];
+  int i = 0;
+  while (2 * i + 1 < *count)
+  {
+    int child = 2 * i + 1;
+    if (child + 1 < *count && heap[child + 1].cost < heap[child].cost)
+      child++;
+    if (last.cost <= heap[child].cost)
+      break;
+    heap[i] = heap[child];
+    i = child;
+  }
+  heap[i] = last;
+  return result;
+}
+
+/**
+ * Compute the fastest path between two nodes of a road network using the
+ * Dijkstra algorithm
+ *
+ * @param[in] net Road network
+ * @param[in] from,to Source and target nodes
+ * @param[out] path Edges of the path, where the edge @p e is encoded as
+ * @p e + 1 when it is traversed from its source to its target and as
+ * @p -(e + 1) otherwise
+ * @result Number of edges of the path, -1 if the nodes are not connected
+ */
+static int
+roadnet_shortest_path(const RoadNetwork *net, int from, int to, int **path)
+{
+  double *dist = palloc(sizeof(double) * net->nnodes);
+  int *prev = palloc(sizeof(int) * net->nnodes);
+  for (int i = 0; i < net->nnodes; i++)
+  {
+    dist[i] = DBL_MAX;
+    prev[i] = 0;
+  }
+  /* Each edge relaxation pushes at most one element */
+  PathQueueElem *heap = palloc(sizeof(PathQueueElem) *
+    (net->nedges * 2 + 1));
+  int count = 0;
+  dist[from] = 0.0;
+  pathqueue_push(heap, &count, 0.0, from);
+  while (count > 0)
+  {
+    PathQueueElem elem = pathqueue_pop(heap, &count);
+    if (elem.node == to)
+      break;
+    if (elem.cost > dist[elem.node])
+      continue;
+    for (int i = net->adjstart[elem.node]; i < net->adjstart[elem.node + 1];
+      i++)
+    {
+      int e = net->adjedges[i];
+      bool forward = (net->source[e] == elem.node);
+      int next = forward ? net->target[e] : net->source[e];
+      double cost = elem.cost + net->cost[e];
+      if (cost < dist[next])
+      {
+        dist[next] = cost;
+        prev[next] = forward ? e + 1 : -(e + 1);
+        pathqueue_push(heap, &count, cost, next);
+      }
+    }
+  }
+  pfree(heap);
+
+  int result = -1;
+  if (dist[to] < DBL_MAX)
+  {
+    /* Walk the path backwards from the target */
+    result = 0;
+    for (int node = to; node != from; result++)
+    {
+      int e = abs(prev[node]) - 1;
+      node = (prev[node] > 0) ? net->source[e] : net->target[e];
+    }
+    *path = palloc(sizeof(int) * Max(result, 1));
+    int k = result;
+    for (int node = to; node != from; )
+    {
+      int e = abs(prev[node]) - 1;
+      (*path)[--k] = prev[node];
+      node = (prev[node] > 0) ? net->source[e] : net->target[e];
+    }
+  }
+  pfree(dist); pfree(prev);
+  return result;
+}
+
+/**
+ * Generate a trip following a path of a road network
+ *
+ * @param[in] state State of the generator
+ * @param[in] path Edges of the path, as returned by roadnet_shortest_path
+ * @param[in] count Number of edges of the path
+ * @param[in] reverse True when the path is followed from its end
+ * @param[in] t Start time of the trip
+ */
+static TSequence *
+tripgen_trip(TripGenState *state, const int *path, int count, bool reverse,
+  TimestampTz t)
+{
+  const RoadNetwork *net = state->net;
+  LWLINE **lines = palloc(sizeof(LWLINE *) * count);
+  double *maxSpeeds = palloc(sizeof(double) * count);
+  int *categories = palloc(sizeof(int) * count);
+  for (int i = 0; i < count; i++)
+  {
+    int code = reverse ? - path[count - 1 - i] : path[i];
+    int e = abs(code) - 1;
+    lines[i] = (code > 0) ? net->lines[e] : net->rlines[e];
+    maxSpeeds[i] = net->maxSpeeds[e];
+    categories[i] = net->categories[e];
+  }
+  TSequence *result = create_trip_internal(lines, maxSpeeds, categories,
+    (uint32_t) count, t, state->disturbData, state->verbosity, state->rng);
+  pfree(lines); pfree(maxSpeeds); pfree(categories);
+  return result;
+}
+
+/**
+ * Seed the random number generator from the seed of the generation, a
+ * vehicle, and a day, so that the trips of a vehicle do not depend on the
+ * other vehicles generated by the same call
+ */
+static void
+tripgen_reseed(TripGenState *state, int vehicle, int day)
+{
+  /* SplitMix64 mixing of the three components */
+  uint64 z = state->seed + (uint64) vehicle * UINT64CONST(0x9E3779B97F4A7C15) +
+    (uint64) (day + 1) * UINT64CONST(0xBF58476D1CE4E5B9);
+  z = (z ^ (z >> 30)) * UINT64CONST(0xBF58476D1CE4E5B9);
+  z = (z ^ (z >> 27)) * UINT64CONST(0x94D049BB133111EB);
+  z = z ^ (z >> 31);
+  gsl_rng_set(state->rng, (unsigned long) z);
+  return;
+}
+
+/**
+ * Maximum number of attempts for choosing connected nodes
+ */
+#define MAX_NODE_TRIES 100
+
+/**
+ * Choose the home and work nodes of the current vehicle and compute the path
+ * between them
+ */
+static void
+tripgen_vehicle(TripGenState *state)
+{
+  const RoadNetwork *net = state->net;
+  if (state->path != NULL)
+  {
+    pfree(state->path);
+    state->path = NULL;
+  }
+  tripgen_reseed(state, state->vehicle, -1);
+  for (int i = 0; i < MAX_NODE_TRIES; i++)
+  {
+    state->home = (int) gsl_rng_uniform_int(state->rng, net->nnodes);
+    state->work = (int) gsl_rng_uniform_int(state->rng, net->nnodes);
+    if (state->home == state->work)
+      continue;
+    state->pathlen = roadnet_shortest_path(net, state->home, state->work,
+      &state->path);
+    if (state->pathlen > 0)
+      return;
+  }
+  ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+    errmsg("Cannot find connected home and work nodes for vehicle %d",
+      state->vehicle)));
+}
+
+/**
+ * Generate the trips of the current vehicle for the current day
+ *
+ * On weekdays a vehicle goes from home to work in the morning and back in
+ * the afternoon. On weekends, with some probability it makes a leisure trip
+ * to a random destination and comes back home after some time.
+ */
+static void
+tripgen_day(TripGenState *state)
+{
+  /* Mean departure times and their standard deviation in hours */
+  double P_MORNING = 8.0, P_AFTERNOON = 17.0, P_LEISURE = 10.0;
+  double P_DEVIATION = 0.5;
+  /* Probability and mean duration in hours of a leisure trip */
+  double P_LEISURE_PROB = 0.4, P_LEISURE_STAY = 2.0;
+
+  MemoryContextReset(state->dayctx);
+  MemoryContext oldcontext = MemoryContextSwitchTo(state->dayctx);
+  tripgen_reseed(state, state->vehicle, state->day);
+  DateADT date = state->startDate + state->day;
+  TimestampTz midnight = DatumGetTimestampTz(DirectFunctionCall1(
+    date_timestamptz, DateADTGetDatum(date)));
+  int dow = j2day(date + POSTGRES_EPOCH_JDATE);
+  state->ntrips = state->trip = 0;
+
+  if (dow != 0 && dow != 6)
+  {
+    /* Weekday */
+    TimestampTz t = midnight + (TimestampTz) ((P_MORNING +
+      gsl_ran_gaussian(state->rng, P_DEVIATION)) * USECS_PER_HOUR);
+    state->trips[state->ntrips++] = tripgen_trip(state, state->path,
+      state->pathlen, false, t);
+    t = midnight + (TimestampTz) ((P_AFTERNOON +
+      gsl_ran_gaussian(state->rng, P_DEVIATION)) * USECS_PER_HOUR);
+    t = Max(t, tsequence_end_timestamp(state->trips[0]) + USECS_PER_MINUTE);
+    state->trips[state->ntrips++] = tripgen_trip(state, state->path,
+      state->pathlen, true, t);
+    MemoryContextSwitchTo(oldcontext);
+    return;
+  }
+
+  /* Weekend */
+  int *path;
+  int dest = (int) gsl_rng_uniform_int(state->rng, state->net->nnodes);
+  int count = (gsl_rng_uniform(state->rng) > P_LEISURE_PROB ||
+    dest == state->home) ? -1 :
+    roadnet_shortest_path(state->net, state->home, dest, &path);
+  if (count <= 0)
+  {
+    MemoryContextSwitchTo(oldcontext);
+    return;
+  }
+  TimestampTz t = midnight + (TimestampTz) ((P_LEISURE +
+    gsl_ran_gaussian(state->rng, P_DEVIATION)) * USECS_PER_HOUR);
+  state->trips[state->ntrips++] = tripgen_trip(state, path, count, false, t);
+  t = tsequence_end_timestamp(state->trips[0]) + (TimestampTz)
+    (gsl_ran_exponential(state->rng, P_LEISURE_STAY) * USECS_PER_HOUR);
+  state->trips[state->ntrips++] = tripgen_trip(state, path, count, true, t);
+  MemoryContextSwitchTo(oldcontext);
+  return;
+}
+
+/**
+ * Free the random number generator of the trip generator when the memory
+ * context of the function is reset, including on error
+ */
+static void
+tripgen_free_rng(void *arg)
+{
+  gsl_rng_free((gsl_rng *) arg);
+  return;
+}
+
+PG_FUNCTION_INFO_V1(create_trips);
+/**
+ * Generate the trips of a fleet of vehicles on a road network during a
+ * number of days, one row per trip.
+ *
+ * The random number generator is reseeded for every vehicle and day from the
+ * seed given as argument. Therefore, the trips of a vehicle only depend on
+ * the seed and on the vehicle number, and a large dataset can be generated in
+ * parallel by several sessions or workers, each of them generating a
+ * disjoint range of vehicles.
+ *
+ * @note This function replaces the orchestration of the function create_trip
+ * by the PL/pgSQL code of the BerlinMOD generator
+ */
+PGDLLEXPORT Datum
+create_trips(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  TripGenState *state;
+  bool isnull[4] = {0,0,0,0}; /* needed to say no value is null */
+  Datum tuple_arr[4]; /* used to construct the composite return value */
+  HeapTuple tuple;
+  Datum result; /* the actual composite return value */
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    /* Get input parameters */
+    ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+    int32 first = PG_GETARG_INT32(1);
+    int32 last = PG_GETARG_INT32(2);
+    int32 ndays = PG_GETARG_INT32(3);
+    DateADT startDate = PG_GETARG_DATEADT(4);
+    int64 seed = PG_GETARG_INT64(5);
+    bool disturbData = PG_GETARG_BOOL(6);
+    char *msgstr = text2cstring(PG_GETARG_TEXT_PP(7));
+    if (first < 1 || last < first)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The range of vehicles must be a non-empty range of positive integers")));
+    if (ndays < 1)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The number of days must be positive")));
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    /* Create function state */
+    state = palloc0(sizeof(TripGenState));
+    state->net = roadnet_make(array);
+    state->rng = gsl_rng_alloc(gsl_rng_default);
+    state->dayctx = AllocSetContextCreate(funcctx->multi_call_memory_ctx,
+      "Trip generator", ALLOCSET_DEFAULT_SIZES);
+    MemoryContextCallback *cb = palloc(sizeof(MemoryContextCallback));
+    cb->func = tripgen_free_rng;
+    cb->arg = state->rng;
+    MemoryContextRegisterResetCallback(funcctx->multi_call_memory_ctx, cb);
+    state->seed = (uint64) seed;
+    state->vehicle = first;
+    state->lastVehicle = last;
+    state->ndays = ndays;
+    state->day = -1;
+    state->startDate = startDate;
+    state->disturbData = disturbData;
+    state->verbosity = datagen_verbosity(msgstr);
+    tripgen_vehicle(state);
+    funcctx->user_fctx = state;
+    /* Build a tuple description for the function output */
+    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
+    BlessTupleDesc(funcctx->tuple_desc);
+    MemoryContextSwitchTo(oldcontext);
+    PG_FREE_IF_COPY(array, 0);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  /* Get state */
+  state = funcctx->user_fctx;
+  /* Advance to the next day with trips */
+  while (state->trip == state->ntrips)
+  {
+    if (++state->day == state->ndays)
+    {
+      if (state->vehicle == state->lastVehicle)
+        SRF_RETURN_DONE(funcctx);
+      state->vehicle++;
+      state->day = 0;
+      MemoryContext oldcontext =
+        MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+      tripgen_vehicle(state);
+      MemoryContextSwitchTo(oldcontext);
+    }
+    tripgen_day(state);
+  }
+  /* Form tuple and return */
+  tuple_arr[0] = Int32GetDatum(state->vehicle);
+  tuple_arr[1] = DateADTGetDatum(state->startDate + state->day);
+  tuple_arr[2] = Int32GetDatum(state->trip + 1);
+  tuple_arr[3] = PointerGetDatum(state->trips[state->trip++]);
+  tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
+  result = HeapTupleGetDatum(tuple);
+  SRF_RETURN_NEXT(funcctx, result);
+}
+
 /*****************************************************************************/
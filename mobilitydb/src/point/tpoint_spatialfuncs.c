@@ -36,11 +36,13 @@
 /* C */
 #include <assert.h>
 /* PostgreSQL */
+#include <funcapi.h>
 #include <utils/float.h>
 /* PostGIS */
 #include <liblwgeom.h>
 #include <liblwgeom_internal.h>
 #include <lwgeodetic.h>
+#include <lwgeom_transform.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
@@ -218,15 +220,81 @@ datum_transform(Datum value, Datum srid)
     InvalidOid, value, srid);
 }
 
+/**
+ * @brief Transform an array of temporal point instants into another spatial
+ * reference system.
+ *
+ * The coordinates of all instants are gathered into a single point array
+ * that is reprojected with one call to PROJ. The transformed coordinates are
+ * then written into copies of the instants, so that no geometry is
+ * constructed or serialized for each instant. The projection is obtained
+ * with GetLWPROJ from the libpgcommon library bundled with MobilityDB, whose
+ * backend-wide PROJ cache is owned by MobilityDB and is not shared with the
+ * cache of the PostGIS library.
+ * @pre The instants have the same SRID and dimensionality
+ */
+static TInstant **
+tpointinstarr_transform(const TInstant **instants, int count, int srid)
+{
+  int srid_from = tpointinst_srid(instants[0]);
+  if (srid_from == SRID_UNKNOWN)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("Input geometry has unknown (%d) SRID", srid_from)));
+  if (srid == SRID_UNKNOWN)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("%d is an invalid target SRID", srid)));
+
+  TInstant **result = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+    result[i] = tinstant_copy(instants[i]);
+  /* Input and output SRID are equal, return the copy without transform */
+  if (srid_from == srid)
+    return result;
+
+  LWPROJ *pj;
+  if (GetLWPROJ(srid_from, srid, &pj) == LW_FAILURE)
+    ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+      errmsg("Failure reading projections from spatial_ref_sys")));
+  bool hasz = MOBDB_FLAGS_GET_Z(instants[0]->flags);
+  POINTARRAY *pa = ptarray_construct(hasz, false, (uint32_t) count);
+  POINT4D p;
+  for (int i = 0; i < count; i++)
+  {
+    datum_point4d(tinstant_value(instants[i]), &p);
+    ptarray_set_point4d(pa, (uint32_t) i, &p);
+  }
+  if (ptarray_transform(pa, pj) == LW_FAILURE)
+    ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+      errmsg("Transform: failed to do transform")));
+  for (int i = 0; i < count; i++)
+  {
+    GSERIALIZED *gs = DatumGetGserializedP(&result[i]->value);
+    gserialized_set_srid(gs, srid);
+    getPoint4d_p(pa, (uint32_t) i, &p);
+    if (hasz)
+    {
+      POINT3DZ *point = (POINT3DZ *) datum_point3dz_p(PointerGetDatum(gs));
+      point->x = p.x; point->y = p.y; point->z = p.z;
+    }
+    else
+    {
+      POINT2D *point = (POINT2D *) datum_point2d_p(PointerGetDatum(gs));
+      point->x = p.x; point->y = p.y;
+    }
+  }
+  ptarray_free(pa);
+  return result;
+}
+
 /**
  * @brief Transform a temporal point into another spatial reference system
  */
 TInstant *
 tpointinst_transform(const TInstant *inst, int srid)
 {
-  Datum geo = datum_transform(tinstant_value(inst), Int32GetDatum(srid));
-  TInstant *result = tinstant_make(geo, inst->temptype, inst->t);
-  pfree(DatumGetPointer(geo));
+  TInstant **instants = tpointinstarr_transform(&inst, 1, srid);
+  TInstant *result = instants[0];
+  pfree(instants);
   return result;
 }
 
@@ -236,35 +304,11 @@ tpointinst_transform(const TInstant *inst, int srid)
 TInstantSet *
 tpointinstset_transform(const TInstantSet *is, int srid)
 {
-  /* Singleton instant set */
-  if (is->count == 1)
-  {
-    TInstant *inst = tpointinst_transform(tinstantset_inst_n(is, 0),
-      Int32GetDatum(srid));
-    TInstantSet *result = tinstantset_make((const TInstant **) &inst, 1,
-      MERGE_NO);
-    pfree(inst);
-    return result;
-  }
-
-  /* General case */
-  Datum multipoint = PointerGetDatum(tpointinstset_trajectory(is));
-  Datum transf = datum_transform(multipoint, srid);
-  GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(transf);
-  LWMPOINT *lwmpoint = lwgeom_as_lwmpoint(lwgeom_from_gserialized(gs));
-  TInstant **instants = palloc(sizeof(TInstant *) * is->count);
-  for (int i = 0; i < is->count; i++)
-  {
-    Datum point = PointerGetDatum(geo_serialize((LWGEOM *) (lwmpoint->geoms[i])));
-    const TInstant *inst = tinstantset_inst_n(is, i);
-    instants[i] = tinstant_make(point, inst->temptype, inst->t);
-    pfree(DatumGetPointer(point));
-  }
-  PG_FREE_IF_COPY_P(gs, DatumGetPointer(transf));
-  pfree(DatumGetPointer(transf)); pfree(DatumGetPointer(multipoint));
-  lwmpoint_free(lwmpoint);
-
-  return tinstantset_make_free(instants, is->count, MERGE_NO);
+  int count;
+  const TInstant **instants = tinstantset_instants(is, &count);
+  TInstant **newinstants = tpointinstarr_transform(instants, count, srid);
+  pfree(instants);
+  return tinstantset_make_free(newinstants, count, MERGE_NO);
 }
 
 /**
@@ -273,121 +317,47 @@ tpointinstset_transform(const TInstantSet *is, int srid)
 TSequence *
 tpointseq_transform(const TSequence *seq, int srid)
 {
-  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
-
-  /* Instantaneous sequence */
-  if (seq->count == 1)
-  {
-    TInstant *inst = tpointinst_transform(tsequence_inst_n(seq, 0),
-      Int32GetDatum(srid));
-    TSequence *result = tinstant_to_tsequence(inst, linear);
-    pfree(inst);
-    return result;
-  }
-
-  /* General case */
-  LWGEOM **points = palloc(sizeof(LWGEOM *) * seq->count);
-  for (int i = 0; i < seq->count; i++)
-  {
-    Datum value = tinstant_value(tsequence_inst_n(seq, i));
-    GSERIALIZED *gsvalue = DatumGetGserializedP(value);
-    points[i] = lwgeom_from_gserialized(gsvalue);
-  }
-  /* Last parameter set to STEP to force the function to return multipoint */
-  LWGEOM *lwgeom = lwpointarr_make_trajectory(points, seq->count, STEP);
-  Datum multipoint = PointerGetDatum(geo_serialize(lwgeom));
-  pfree(lwgeom);
-  Datum transf = datum_transform(multipoint, srid);
-  GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(transf);
-  LWMPOINT *lwmpoint = lwgeom_as_lwmpoint(lwgeom_from_gserialized(gs));
-  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
-  for (int i = 0; i < seq->count; i++)
-  {
-    Datum point = PointerGetDatum(geo_serialize((LWGEOM *) (lwmpoint->geoms[i])));
-    const TInstant *inst = tsequence_inst_n(seq, i);
-    instants[i] = tinstant_make(point, inst->temptype, inst->t);
-    pfree(DatumGetPointer(point));
-  }
-
-  for (int i = 0; i < seq->count; i++)
-    lwpoint_free((LWPOINT *) points[i]);
-  pfree(points);
-  PG_FREE_IF_COPY_P(gs, DatumGetPointer(transf));
-  pfree(DatumGetPointer(transf)); pfree(DatumGetPointer(multipoint));
-  lwmpoint_free(lwmpoint);
-
-  return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
-    seq->period.upper_inc, linear, NORMALIZE_NO);
+  int count;
+  const TInstant **instants = tsequence_instants(seq, &count);
+  TInstant **newinstants = tpointinstarr_transform(instants, count, srid);
+  pfree(instants);
+  return tsequence_make_free(newinstants, count, seq->period.lower_inc,
+    seq->period.upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE_NO);
 }
 
 /**
  * @brief Transform a temporal point into another spatial reference system
  *
- * @note In order to do a SINGLE call to the PostGIS transform function we do
- * not iterate through the sequences and call the transform for the sequence
+ * @note In order to do a SINGLE call to PROJ we do not iterate through the
+ * sequences and call the transform for the sequence
  */
 TSequenceSet *
 tpointseqset_transform(const TSequenceSet *ss, int srid)
 {
-  /* Singleton sequence set */
-  if (ss->count == 1)
-  {
-    TSequence *seq = tpointseq_transform(tsequenceset_seq_n(ss, 0),
-      Int32GetDatum(srid));
-    TSequenceSet *result = tsequence_to_tsequenceset(seq);
-    pfree(seq);
-    return result;
-  }
-
-  /* General case */
+  const TInstant **instants = palloc(sizeof(TInstant *) * ss->totalcount);
   int k = 0;
-  LWGEOM **points = palloc(sizeof(LWGEOM *) * ss->totalcount);
-  int maxcount = -1; /* number of instants of the longest sequence */
   for (int i = 0; i < ss->count; i++)
   {
     const TSequence *seq = tsequenceset_seq_n(ss, i);
-    maxcount = Max(maxcount, seq->count);
     for (int j = 0; j < seq->count; j++)
-    {
-      Datum value = tinstant_value(tsequence_inst_n(seq, j));
-      GSERIALIZED *gsvalue = DatumGetGserializedP(value);
-      points[k++] = lwgeom_from_gserialized(gsvalue);
-    }
+      instants[k++] = tsequence_inst_n(seq, j);
   }
-  /* Last parameter set to STEP to force the function to return multipoint */
-  LWGEOM *lwgeom = lwpointarr_make_trajectory(points, ss->totalcount, STEP);
-  Datum multipoint = PointerGetDatum(geo_serialize(lwgeom));
-  pfree(lwgeom);
-  Datum transf = datum_transform(multipoint, srid);
-  GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(transf);
-  LWMPOINT *lwmpoint = lwgeom_as_lwmpoint(lwgeom_from_gserialized(gs));
+  TInstant **newinstants = tpointinstarr_transform(instants, ss->totalcount,
+    srid);
+  pfree(instants);
   TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
-  TInstant **instants = palloc(sizeof(TInstant *) * maxcount);
   bool linear = MOBDB_FLAGS_GET_LINEAR(ss->flags);
   k = 0;
   for (int i = 0; i < ss->count; i++)
   {
     const TSequence *seq = tsequenceset_seq_n(ss, i);
-    for (int j = 0; j < seq->count; j++)
-    {
-      Datum point = PointerGetDatum(geo_serialize((LWGEOM *) (lwmpoint->geoms[k++])));
-      const TInstant *inst = tsequence_inst_n(seq, j);
-      instants[j] = tinstant_make(point, inst->temptype, inst->t);
-      pfree(DatumGetPointer(point));
-    }
-    sequences[i] = tsequence_make((const TInstant **) instants, seq->count,
-      seq->period.lower_inc, seq->period.upper_inc, linear, NORMALIZE_NO);
-    for (int j = 0; j < seq->count; j++)
-      pfree(instants[j]);
+    sequences[i] = tsequence_make((const TInstant **) &newinstants[k],
+      seq->count, seq->period.lower_inc, seq->period.upper_inc, linear,
+      NORMALIZE_NO);
+    k += seq->count;
   }
-  TSequenceSet *result = tsequenceset_make_free(sequences, ss->count, NORMALIZE_NO);
-  for (int i = 0; i < ss->totalcount; i++)
-    lwpoint_free((LWPOINT *) points[i]);
-  pfree(points); pfree(instants);
-  PG_FREE_IF_COPY_P(gs, DatumGetPointer(transf));
-  pfree(DatumGetPointer(transf)); pfree(DatumGetPointer(multipoint));
-  lwmpoint_free(lwmpoint);
-  return result;
+  pfree_array((void **) newinstants, ss->totalcount);
+  return tsequenceset_make_free(sequences, ss->count, NORMALIZE_NO);
 }
 
 /**
@@ -994,6 +964,49 @@ Tpoint_azimuth(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Motion metrics
+ *****************************************************************************/
+
+PG_FUNCTION_INFO_V1(Tpoint_motion_metrics);
+/**
+ * @ingroup mobilitydb_temporal_spatial_accessor
+ * @brief Return in a single pass the length, cumulative length, speed, and
+ * azimuth of a temporal point
+ * @sqlfunc motionMetrics()
+ */
+PGDLLEXPORT Datum
+Tpoint_motion_metrics(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  /* Store fcinfo into a global variable */
+  store_fcinfo(fcinfo);
+  double length;
+  Temporal *cumlength, *speed, *azimuth;
+  tpoint_motion_metrics(temp, &length, &cumlength, &speed, &azimuth);
+
+  /* Build a tuple description for the function output */
+  TupleDesc resultTupleDesc;
+  get_call_result_type(fcinfo, NULL, &resultTupleDesc);
+  BlessTupleDesc(resultTupleDesc);
+
+  /* Construct the result */
+  bool result_is_null[4] = {0,0,0,0};
+  Datum result_values[4];
+  result_values[0] = Float8GetDatum(length);
+  result_values[1] = PointerGetDatum(cumlength);
+  result_values[2] = PointerGetDatum(speed);
+  result_is_null[2] = (speed == NULL);
+  result_values[3] = PointerGetDatum(azimuth);
+  result_is_null[3] = (azimuth == NULL);
+  HeapTuple resultTuple = heap_form_tuple(resultTupleDesc, result_values,
+    result_is_null);
+  Datum result = HeapTupleGetDatum(resultTuple);
+
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_DATUM(result);
+}
+
 /*****************************************************************************
  * Temporal bearing
  *****************************************************************************/
@@ -738,3 +738,25 @@ DROP INDEX tbl_period_quadtree_idx;
 DROP INDEX tbl_periodset_quadtree_idx;
 
 -------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Galloping merges
+-------------------------------------------------------------------------------
+
+SELECT periodset '{[2000-01-01, 2000-01-05), [2000-01-06, 2000-01-07]}' @> periodset '{[2000-01-01, 2000-01-02], [2000-01-03, 2000-01-05], [2000-01-06, 2000-01-07]}';
+SELECT periodset '{[2000-01-01, 2000-01-05), [2000-01-06, 2000-01-07]}' @> periodset '{[2000-01-01, 2000-01-02], [2000-01-03, 2000-01-05), [2000-01-06, 2000-01-07]}';
+SELECT periodset '{[2000-01-01, 2000-01-05], [2000-01-06, 2000-01-07]}' @> periodset '{[2000-01-01, 2000-01-02], [2000-01-03, 2000-01-05], [2000-01-06, 2000-01-07]}';
+SELECT periodset '{[2000-01-01, 2000-01-05), [2000-01-06, 2000-01-07]}' @> periodset '{[2000-01-03, 2000-01-05]}';
+SELECT periodset(array_agg(period(timestamptz '2000-01-01' + 2 * k * interval '1 day', timestamptz '2000-01-01' + (2 * k + 1) * interval '1 day', true, true) ORDER BY k)) @> periodset '{[2000-01-01, 2000-01-02], [2000-03-01, 2000-03-02]}' FROM generate_series(0, 99) k;
+SELECT periodset(array_agg(period(timestamptz '2000-01-01' + 2 * k * interval '1 day', timestamptz '2000-01-01' + (2 * k + 1) * interval '1 day', true, true) ORDER BY k)) @> periodset '{[2000-01-01, 2000-01-02], [2000-01-04, 2000-01-05]}' FROM generate_series(0, 99) k;
+
+SELECT timestampset '{2000-01-01, 2000-01-03, 2000-01-05}' - timestampset '{2000-01-02}';
+SELECT timestampset '{2000-01-01, 2000-01-03, 2000-01-05}' - timestampset '{2000-01-01}';
+SELECT timestampset '{2000-01-01, 2000-01-02, 2000-01-03, 2000-01-04, 2000-01-05}' - timestampset '{2000-01-02, 2000-01-04}';
+SELECT timestampset '{2000-01-01, 2000-01-03, 2000-01-05}' + timestampset '{2000-01-02}';
+SELECT timestampset '{2000-01-01, 2000-01-03, 2000-01-05}' * timestampset '{2000-01-02, 2000-01-03}';
+SELECT numTimestamps(timestampset(array_agg(timestamptz '2000-01-01' + k * interval '1 day' ORDER BY k)) - timestampset '{2000-01-02, 2000-03-01}') FROM generate_series(0, 99) k;
+SELECT numTimestamps(timestampset(array_agg(timestamptz '2000-01-01' + k * interval '1 day' ORDER BY k)) * timestampset '{2000-01-02, 2000-03-01, 2001-01-01}') FROM generate_series(0, 99) k;
+SELECT numTimestamps(timestampset(array_agg(timestamptz '2000-01-01' + k * interval '1 day' ORDER BY k)) + timestampset '{1999-12-31, 2000-01-02}') FROM generate_series(0, 99) k;
+
+-------------------------------------------------------------------------------
@@ -27,6 +27,47 @@
 --
 -------------------------------------------------------------------------------
 
+-------------------------------------------------------------------------------
+-- Long sequences
+-------------------------------------------------------------------------------
+-- Timestamps of the instants of the long sequences in the tests below, which
+-- have more than 512 instants and thus a block directory
+
+CREATE TABLE tbl_timestamptz_long AS
+SELECT i, timestamptz '2000-01-01' + i * i * interval '1 minute' AS t
+FROM generate_series(0, 1000) i;
+
+-- Long sequences whose values increase with time, so that the restrictions
+-- below skip some blocks and keep others, and the same sequences split into
+-- pieces of 101 instants, which have no block directory, to compare with
+
+CREATE TABLE tbl_tnumber_long AS
+SELECT tint_seq(array_agg(tint_inst(i, t) ORDER BY i)) AS ti,
+  tfloat_seq(array_agg(tfloat_inst(i, t) ORDER BY i)) AS tf,
+  ARRAY(SELECT tint_seq(array_agg(tint_inst(i, t) ORDER BY i))
+    FROM tbl_timestamptz_long, generate_series(0, 9) j
+    WHERE i BETWEEN j * 100 AND (j + 1) * 100 GROUP BY j ORDER BY j) AS ti_pieces,
+  ARRAY(SELECT tfloat_seq(array_agg(tfloat_inst(i, t) ORDER BY i))
+    FROM tbl_timestamptz_long, generate_series(0, 9) j
+    WHERE i BETWEEN j * 100 AND (j + 1) * 100 GROUP BY j ORDER BY j) AS tf_pieces
+FROM tbl_timestamptz_long;
+
+-------------------------------------------------------------------------------
+-- Sequence sets
+-------------------------------------------------------------------------------
+-- Sequence sets of ten sequences in which consecutive sequences have an
+-- instant at the same timestamp, with the same value in the linear one and a
+-- different value in the stepwise one
+
+CREATE TABLE tbl_tfloat_seqset AS
+SELECT tfloat_seqset(array_agg(tfloat_seq(ARRAY[tfloat_inst(k, t1), tfloat_inst(k + 1, t2)],
+    k = 0, false) ORDER BY k)) AS linear,
+  tfloat_seqset(array_agg(tfloat_seq(ARRAY[tfloat_inst(1 + (k % 2) * 0.5, t1), tfloat_inst(1 + (k % 2) * 0.5, t2)],
+    k = 0, false, false) ORDER BY k)) AS step
+FROM (SELECT k, timestamptz '2000-01-01' + k * interval '1 day' AS t1,
+  timestamptz '2000-01-01' + (k + 1) * interval '1 day' AS t2
+  FROM generate_series(0, 9) k) t;
+
 -------------------------------------------------------------------------------
 -- Utility functions
 -------------------------------------------------------------------------------
@@ -120,6 +161,9 @@ SELECT ttext '  { [ AAA@2001-01-01 08:00:00 , BBB@2001-01-01 08:05:00 , CCC@2001
 SELECT ttext '{[AAA@2001-01-01 08:00:00,BBB@2001-01-01 08:05:00,CCC@2001-01-01 08:06:00],
  [AAA@2001-01-01 09:00:00,BBB@2001-01-01 09:05:00,CCC@2001-01-01 09:06:00]}';
 
+SELECT asText(linear)::tfloat = linear FROM tbl_tfloat_seqset;
+SELECT asText(step)::tfloat = step FROM tbl_tfloat_seqset;
+
 /* Errors */
 SELECT tbool_seqset(tbool '{[true@2000-01-01, true@2000-01-03], [false@2000-01-02, false@2000-01-04]}');
 SELECT tint_seqset(tint '{[1@2000-01-01, 1@2000-01-03], [2@2000-01-02, 2@2000-01-04]}');
@@ -1185,6 +1229,10 @@ SELECT numInstants(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC
 
 SELECT numInstants(tfloat '{[1@2000-01-01, 2@2000-01-02),(2@2000-01-02, 3@2000-01-03]}');
 
+SELECT numInstants(step) FROM tbl_tfloat_seqset;
+SELECT numInstants(tint(step)) FROM tbl_tfloat_seqset;
+SELECT numInstants(linear) FROM tbl_tfloat_seqset;
+
 SELECT startInstant(tbool 't@2000-01-01');
 SELECT startInstant(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}');
 SELECT startInstant(tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]');
@@ -1250,6 +1298,9 @@ SELECT instantN(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]', 4);
 SELECT instantN(tfloat '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]', 4);
 SELECT instantN(ttext '[AA@2000-01-01, BB@2000-01-02, AA@2000-01-03]', 4);
 
+SELECT asText(instantN(tint(step), 11)) FROM tbl_tfloat_seqset;
+SELECT asText(instantN(linear, 5)) FROM tbl_tfloat_seqset;
+
 SELECT instants(tbool 't@2000-01-01');
 SELECT instants(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}');
 SELECT instants(tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]');
@@ -1290,6 +1341,9 @@ SELECT numTimestamps(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[C
 
 SELECT numTimestamps(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03),[3.5@2000-01-03, 3.5@2000-01-05]}');
 
+SELECT numTimestamps(step) FROM tbl_tfloat_seqset;
+SELECT numTimestamps(tint(step)) FROM tbl_tfloat_seqset;
+
 SELECT startTimestamp(tbool 't@2000-01-01');
 SELECT startTimestamp(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}');
 SELECT startTimestamp(tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]');
@@ -1354,6 +1408,8 @@ SELECT timestampN(ttext '[AA@2000-01-01, BB@2000-01-02, AA@2000-01-03]', 4);
 SELECT timestampN(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03),[3.5@2000-01-03, 3.5@2000-01-05]}',0);
 SELECT timestampN(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03),[3.5@2000-01-03, 3.5@2000-01-05]}',10);
 
+SELECT timestampN(linear, 11) FROM tbl_tfloat_seqset;
+
 SELECT timestamps(tbool 't@2000-01-01');
 SELECT timestamps(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}');
 SELECT timestamps(tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]');
@@ -1396,6 +1452,8 @@ SELECT shift(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}', '5 min');
 SELECT shift(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]', '5 min');
 SELECT shift(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}', '5 min');
 
+SELECT numInstants(shift(step, interval '1 day')) FROM tbl_tfloat_seqset;
+
 SELECT tscale(tbool 't@2000-01-01', '1 day');
 SELECT tscale(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}', '1 day');
 SELECT tscale(tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]', '1 day');
@@ -1415,6 +1473,8 @@ SELECT tscale(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}', '1 day')
 SELECT tscale(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]', '1 day');
 SELECT tscale(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}', '1 day');
 
+SELECT numTimestamps(tscale(step, interval '1 day')) FROM tbl_tfloat_seqset;
+
 SELECT shiftTscale(tbool 't@2000-01-01', '1 day', '1 day');
 SELECT shiftTscale(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}', '1 day', '1 day');
 SELECT shiftTscale(tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]', '1 day', '1 day');
@@ -1722,6 +1782,13 @@ WITH values(v) AS (SELECT unnest(ARRAY[1 - 1e-17, 1 + 1e-12, 2 - 1e-15, 2 + 1e-1
   temp(t) AS (SELECT tfloat '[1@2000-01-01, 2@2000-01-02]')
 SELECT DISTINCT t = merge(atValue(t,v), minusValue(t,v)) FROM temp, values;
 
+SELECT atValue(tf, 448.0) = (SELECT merge(array_agg(r)) FROM unnest(tf_pieces) p, atValue(p, 448.0) r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+SELECT minusValue(tf, 448.0) = (SELECT merge(array_agg(r)) FROM unnest(tf_pieces) p, minusValue(p, 448.0) r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+SELECT atValue(tf, 1000.0) = (SELECT merge(array_agg(r)) FROM unnest(tf_pieces) p, atValue(p, 1000.0) r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+SELECT minusValue(tf, 0.0) = (SELECT merge(array_agg(r)) FROM unnest(tf_pieces) p, minusValue(p, 0.0) r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+SELECT atValue(ti, 450) = (SELECT merge(array_agg(r)) FROM unnest(ti_pieces) p, atValue(p, 450) r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+SELECT minusValue(ti, 450) = (SELECT merge(array_agg(r)) FROM unnest(ti_pieces) p, minusValue(p, 450) r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+
 SELECT atValues(tbool 't@2000-01-01', ARRAY[true]);
 SELECT atValues(tbool '{t@2000-01-01}', ARRAY[true]);
 SELECT atValues(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}', ARRAY[true]);
@@ -1782,6 +1849,11 @@ SELECT minusValues(tint '{[1@2000-01-01, 1@2000-01-03],[2@2000-01-04, 2@2000-01-
 SELECT minusValues(tfloat '{[1.5@2000-01-01, 1.5@2000-01-03],[2.5@2000-01-04, 2.5@2000-01-05]}', ARRAY[1.5, 2.5]);
 SELECT minusValues(ttext '{[AA@2000-01-01, AA@2000-01-03],[BB@2000-01-04, BB@2000-01-05]}', ARRAY[text 'AA', 'BB']);
 
+SELECT atValues(tf, ARRAY[100.5, 900.0]) = (SELECT merge(array_agg(r)) FROM unnest(tf_pieces) p, atValues(p, ARRAY[100.5, 900.0]) r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+SELECT minusValues(tf, ARRAY[100.5, 900.0]) = (SELECT merge(array_agg(r)) FROM unnest(tf_pieces) p, minusValues(p, ARRAY[100.5, 900.0]) r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+SELECT atValues(ti, ARRAY[100, 900]) = (SELECT merge(array_agg(r)) FROM unnest(ti_pieces) p, atValues(p, ARRAY[100, 900]) r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+SELECT minusValues(ti, ARRAY[100, 900]) = (SELECT merge(array_agg(r)) FROM unnest(ti_pieces) p, minusValues(p, ARRAY[100, 900]) r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+
 SELECT atSpan(tint '1@2000-01-01', intspan '[1,3]');
 SELECT atSpan(tint '{1@2000-01-01}', intspan '[1,3]');
 SELECT atSpan(tint '{1@2000-01-01, 2@2000-01-02, 1@2000-01-03}', intspan '[1,3]');
@@ -1824,6 +1896,13 @@ SELECT minusSpan(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@
 SELECT minusSpan(tfloat 'Interp=Stepwise;{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}', floatspan '[1,3]');
 SELECT minusSpan(tfloat 'Interp=Stepwise;{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}', floatspan '[2,3]');
 
+SELECT atSpan(tf, floatspan '[300, 310]') = (SELECT merge(array_agg(r)) FROM unnest(tf_pieces) p, atSpan(p, floatspan '[300, 310]') r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+SELECT minusSpan(tf, floatspan '[300, 310]') = (SELECT merge(array_agg(r)) FROM unnest(tf_pieces) p, minusSpan(p, floatspan '[300, 310]') r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+SELECT atSpan(tf, floatspan '[0, 10]') = (SELECT merge(array_agg(r)) FROM unnest(tf_pieces) p, atSpan(p, floatspan '[0, 10]') r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+SELECT minusSpan(tf, floatspan '[0, 10]') = (SELECT merge(array_agg(r)) FROM unnest(tf_pieces) p, minusSpan(p, floatspan '[0, 10]') r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+SELECT atSpan(ti, intspan '[300, 310]') = (SELECT merge(array_agg(r)) FROM unnest(ti_pieces) p, atSpan(p, intspan '[300, 310]') r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+SELECT minusSpan(ti, intspan '[300, 310]') = (SELECT merge(array_agg(r)) FROM unnest(ti_pieces) p, minusSpan(p, intspan '[300, 310]') r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+
 SELECT atSpans(tint '1@2000-01-01', ARRAY[intspan '[1,3]']);
 SELECT atSpans(tint '{1@2000-01-01}', ARRAY[intspan '[1,3]']);
 SELECT atSpans(tint '{1@2000-01-01}', ARRAY[intspan '[2,3]']);
@@ -1891,6 +1970,9 @@ SELECT minusSpans(tfloat'[1@2000-01-01, 2@2000_01-03]',ARRAY[floatspan '[1,1.1]'
 SELECT minusSpans(tfloat '[1@2000-01-01, 2@2000-01-02]', ARRAY[floatspan '[3,4]', '[5,6]']);
 SELECT minusSpans(tfloat '1@2000-01-01', ARRAY[floatspan '[0,1)', '(1,2]']);
 
+SELECT atSpans(tf, ARRAY[floatspan '[100.5, 110]', '[900, 905.5]']) = (SELECT merge(array_agg(r)) FROM unnest(tf_pieces) p, atSpans(p, ARRAY[floatspan '[100.5, 110]', '[900, 905.5]']) r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+SELECT minusSpans(tf, ARRAY[floatspan '[100.5, 110]', '[900, 905.5]']) = (SELECT merge(array_agg(r)) FROM unnest(tf_pieces) p, minusSpans(p, ARRAY[floatspan '[100.5, 110]', '[900, 905.5]']) r WHERE r IS NOT NULL) FROM tbl_tnumber_long;
+
 SELECT atMin(tint '1@2000-01-01');
 SELECT atMin(tint '{1@2000-01-01, 2@2000-01-02, 1@2000-01-03}');
 SELECT atMin(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]');
@@ -2362,6 +2444,9 @@ SELECT integral(tfloat 'Interp=Stepwise;[1.5@2000-01-01, 2.5@2000-01-02, 1.5@200
 SELECT integral(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}');
 SELECT integral(tfloat 'Interp=Stepwise;{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}');
 
+SELECT integral(tfloat_seq(array_agg(tfloat_inst((i * 7) % 11, t) ORDER BY i))) FROM tbl_timestamptz_long;
+SELECT integral(tfloat_seq(array_agg(tfloat_inst((i * 7) % 11, t) ORDER BY i), true, true, false)) FROM tbl_timestamptz_long;
+
 SELECT round(twAvg(tint '1@2000-01-01')::numeric, 6);
 SELECT round(twAvg(tint '{1@2000-01-01, 2@2000-01-02, 1@2000-01-03}')::numeric, 6);
 SELECT round(twAvg(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]')::numeric, 6);
@@ -2378,6 +2463,9 @@ SELECT round(twAvg(tfloat 'Interp=Stepwise;[1.5@2000-01-01, 2.5@2000-01-02, 1.5@
 SELECT round(twAvg(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}')::numeric, 6);
 SELECT round(twAvg(tfloat 'Interp=Stepwise;{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}')::numeric, 6);
 
+SELECT round(twAvg(tfloat_seq(array_agg(tfloat_inst((i * 7) % 11, t) ORDER BY i)))::numeric, 6) FROM tbl_timestamptz_long;
+SELECT round(twAvg(tfloat_seq(array_agg(tfloat_inst((i * 7) % 11, t) ORDER BY i), true, true, false))::numeric, 6) FROM tbl_timestamptz_long;
+
 -------------------------------------------------------------------------------
 -- Comparison functions and B-tree indexing
 -------------------------------------------------------------------------------
@@ -2799,3 +2887,57 @@ SELECT ttext_hash(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]');
 SELECT ttext_hash(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}');
 
 ------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Long sequences with a block directory
+-------------------------------------------------------------------------------
+
+SELECT tint(tfloat_seq(array_agg(tfloat_inst(0.5 + (i % 4) * 0.125, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), true, true, false)) ?= 0 FROM generate_series(0, 599) i;
+SELECT tint(tfloat_seq(array_agg(tfloat_inst(0.5 + (i % 4) * 0.125, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), true, true, false)) %= 0 FROM generate_series(0, 599) i;
+SELECT tint(tfloat_seqset(ARRAY[tfloat_seq(array_agg(tfloat_inst(0.5 + (i % 4) * 0.125, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), true, true, false), tfloat 'Interp=Stepwise;[5@2000-02-01, 5@2000-02-02]'])) ?= 0 FROM generate_series(0, 599) i;
+SELECT atValue(tint(tfloat_seqset(ARRAY[tfloat_seq(array_agg(tfloat_inst(0.5 + (i % 4) * 0.125, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), true, true, false), tfloat 'Interp=Stepwise;[5@2000-02-01, 5@2000-02-02]'])), 0) IS NOT NULL FROM generate_series(0, 599) i;
+SELECT minValue(tint(tfloat_seqset(ARRAY[tfloat_seq(array_agg(tfloat_inst(0.5 + (i % 4) * 0.125, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), true, true, false), tfloat 'Interp=Stepwise;[5@2000-02-01, 5@2000-02-02]']))) FROM generate_series(0, 599) i;
+
+SELECT asText(tfloat_seq(array_agg(tfloat_inst(0.5 + (i % 4) * 0.125, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), true, true, false))::tfloat = tfloat_seq(array_agg(tfloat_inst(0.5 + (i % 4) * 0.125, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), true, true, false) FROM generate_series(0, 599) i;
+SELECT tfloat_hash(asText(tfloat_seq(array_agg(tfloat_inst(0.5 + (i % 4) * 0.125, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), true, true, false))::tfloat) = tfloat_hash(tfloat_seq(array_agg(tfloat_inst(0.5 + (i % 4) * 0.125, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), true, true, false)) FROM generate_series(0, 599) i;
+SELECT tfloat_cmp(asText(tfloat_seqset(ARRAY[tfloat_seq(array_agg(tfloat_inst(0.5 + (i % 4) * 0.125, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), true, true, false), tfloat 'Interp=Stepwise;[5@2000-02-01, 5@2000-02-02]']))::tfloat, tfloat_seqset(ARRAY[tfloat_seq(array_agg(tfloat_inst(0.5 + (i % 4) * 0.125, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), true, true, false), tfloat 'Interp=Stepwise;[5@2000-02-01, 5@2000-02-02]'])) FROM generate_series(0, 599) i;
+
+-------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Operator Oid cache
+-------------------------------------------------------------------------------
+
+SELECT to_regclass('mobilitydb_opcache') IS NULL;
+SELECT COUNT(*) FROM pg_proc WHERE proname = 'fill_opcache';
+SELECT COUNT(*) FROM (VALUES (tint '2@2000-01-01'), (tint '5@2000-01-01')) t(temp) WHERE temp && tbox 'TBOX XT([1.5,2.5],[2000-01-01,2000-01-03])';
+CREATE DOMAIN tint_oid_cache AS tint;
+SELECT COUNT(*) FROM (VALUES (tint '2@2000-01-01'), (tint '5@2000-01-01')) t(temp) WHERE temp && tbox 'TBOX XT([1.5,2.5],[2000-01-01,2000-01-03])';
+DROP DOMAIN tint_oid_cache;
+SELECT COUNT(*) FROM (VALUES (tint '2@2000-01-01'), (tint '5@2000-01-01')) t(temp) WHERE temp && tbox 'TBOX XT([1.5,2.5],[2000-01-01,2000-01-03])';
+
+-------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Sorting values, spans, and sequences
+-------------------------------------------------------------------------------
+
+SELECT getValues(tint '{5@2000-01-01, -3@2000-01-02, 7@2000-01-03, -3@2000-01-04, 0@2000-01-05}');
+SELECT getValues(tint '[5@2000-01-01, -3@2000-01-02, 7@2000-01-03, -3@2000-01-04, 0@2000-01-05]');
+SELECT getValues(tint_seq(array_agg(tint_inst((i * 37) % 101 - 50, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i))) =
+  ARRAY(SELECT generate_series(-50, 50)) FROM generate_series(0, 100) i;
+SELECT getValues(tfloat '{[5@2000-01-01, 6@2000-01-02], [-2@2000-01-03, -1@2000-01-04], [5.5@2000-01-05, 8@2000-01-06]}');
+SELECT atValues(tint '[5@2000-01-01, -3@2000-01-02, 7@2000-01-03, -3@2000-01-04, 0@2000-01-05]', ARRAY[7, -3, 7]);
+SELECT atSpans(tint '[1@2000-01-01, 5@2000-01-02, 9@2000-01-03]', ARRAY[intspan '[8, 10]', '[0, 2]']);
+SELECT atSpans(tfloat '[1@2000-01-01, 5@2000-01-05]', ARRAY[floatspan '[4, 5]', '[1, 2]']);
+SELECT merge(ARRAY[tint '[3@2000-01-03, 4@2000-01-04]', '[1@2000-01-01, 2@2000-01-02]']);
+SELECT merge(array_agg(tint_seq(ARRAY[tint_inst(i % 7, timestamptz '2000-01-01' + i * interval '1 day'), tint_inst(i % 7, timestamptz '2000-01-01' + i * interval '1 day' + interval '1 hour')]) ORDER BY i DESC)) =
+  merge(array_agg(tint_seq(ARRAY[tint_inst(i % 7, timestamptz '2000-01-01' + i * interval '1 day'), tint_inst(i % 7, timestamptz '2000-01-01' + i * interval '1 day' + interval '1 hour')]) ORDER BY i)) FROM generate_series(0, 199) i;
+
+-------------------------------------------------------------------------------
+
+DROP TABLE tbl_tfloat_seqset;
+DROP TABLE tbl_tnumber_long;
+DROP TABLE tbl_timestamptz_long;
+
+-------------------------------------------------------------------------------
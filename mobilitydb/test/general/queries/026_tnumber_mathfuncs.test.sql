@@ -27,6 +27,16 @@
 --
 -------------------------------------------------------------------------------
 
+-------------------------------------------------------------------------------
+-- Long sequences
+-------------------------------------------------------------------------------
+-- Timestamps of the instants of the long sequences in the tests below, which
+-- have more than 512 instants and thus a block directory
+
+CREATE TABLE tbl_timestamptz_long AS
+SELECT i, timestamptz '2000-01-01' + i * i * interval '1 minute' AS t
+FROM generate_series(0, 1000) i;
+
 -------------------------------------------------------------------------------
 -- Temporal addition
 -------------------------------------------------------------------------------
@@ -158,6 +168,18 @@ SELECT tfloat '[1@2000-01-01, 2@2000-01-03, 1@2000-01-05]' + tfloat 'Interp=Step
 SELECT tfloat '{[1@2000-01-01, 2@2000-01-02),(1@2000-01-03, 2@2000-01-04]}' + tfloat '(1@2000-01-02, 2@2000-01-03)';
 SELECT tfloat '{[1@2000-01-01, 2@2000-01-02),(1@2000-01-03, 2@2000-01-04]}' + tfloat '{(1@2000-01-02, 2@2000-01-03)}';
 
+SELECT tfloat_seq(array_agg(tfloat_inst(i % 5, t) ORDER BY i)) + 2.5 =
+  tfloat_seq(array_agg(tfloat_inst(i % 5 + 2.5, t) ORDER BY i)) FROM tbl_timestamptz_long;
+SELECT tfloat_seqset(array_agg(tfloat_seq(ARRAY[tfloat_inst(j % 5, t1), tfloat_inst((j + 1) % 5, t2)]) ORDER BY j)) + 1 =
+  tfloat_seqset(array_agg(tfloat_seq(ARRAY[tfloat_inst(j % 5 + 1, t1), tfloat_inst((j + 1) % 5 + 1, t2)]) ORDER BY j)) FROM (SELECT j, timestamptz '2000-01-01' + j * interval '1 day' AS t1,
+  timestamptz '2000-01-01' + j * interval '1 day' + interval '6 hours' AS t2
+  FROM generate_series(0, 99) j) t;
+SELECT tfloat_seqset(array_agg(tfloat_seq(ARRAY[tfloat_inst(j % 5, t1), tfloat_inst((j + 1) % 5, t2)]) ORDER BY j)) +
+  tfloat_seqset(array_agg(tfloat_seq(ARRAY[tfloat_inst(j % 3, t1), tfloat_inst((j + 2) % 3, t2)]) ORDER BY j)) =
+  tfloat_seqset(array_agg(tfloat_seq(ARRAY[tfloat_inst(j % 5 + j % 3, t1), tfloat_inst((j + 1) % 5 + (j + 2) % 3, t2)]) ORDER BY j)) FROM (SELECT j, timestamptz '2000-01-01' + j * interval '1 day' AS t1,
+  timestamptz '2000-01-01' + j * interval '1 day' + interval '6 hours' AS t2
+  FROM generate_series(0, 99) j) t;
+
 -------------------------------------------------------------------------------
 -- Temporal subtraction
 -------------------------------------------------------------------------------
@@ -283,6 +305,9 @@ SELECT tfloat '{1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03}' - tfloat '{[1.5
 SELECT tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]' - tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}';
 SELECT tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}' - tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}';
 
+SELECT tfloat_seq(array_agg(tfloat_inst(i % 5, t) ORDER BY i)) - tfloat_seq(array_agg(tfloat_inst(i % 3, t) ORDER BY i)) =
+  tfloat_seq(array_agg(tfloat_inst(i % 5 - i % 3, t) ORDER BY i)) FROM tbl_timestamptz_long;
+
 -------------------------------------------------------------------------------
 -- Temporal multiplication
 -------------------------------------------------------------------------------
@@ -410,6 +435,9 @@ SELECT tfloat '{1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03}' * tfloat '{[1.5
 SELECT tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]' * tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}';
 SELECT tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}' * tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}';
 
+SELECT tint_seq(array_agg(tint_inst(i % 5, t) ORDER BY i)) * 0 =
+  tint_seq(ARRAY[tint_inst(0, min(t)), tint_inst(0, max(t))]) FROM tbl_timestamptz_long;
+
 -------------------------------------------------------------------------------
 -- Temporal division
 -------------------------------------------------------------------------------
@@ -544,6 +572,9 @@ SELECT round(0 / tfloat '[1@2000-01-01, 2@2000-01-05]', 2);
 SELECT round(tfloat '[-1@2000-01-04, 1@2000-01-05]' / tfloat '[-1@2000-01-01, 1@2000-01-05]', 2);
 SELECT round(tint '{[1@2000-01-01, 2@2000-01-02],[1@2000-01-05, 2@2000-01-06]}' / tfloat '[3@2000-01-03, 4@2000-01-04]', 2);
 
+SELECT tfloat_seq(array_agg(tfloat_inst(i % 5, t) ORDER BY i), true, true, false) / 4 =
+  tfloat_seq(array_agg(tfloat_inst((i % 5) / 4.0, t) ORDER BY i), true, true, false) FROM tbl_timestamptz_long;
+
 /* Errors */
 SELECT tint '1@2000-01-01' / 0;
 SELECT tfloat '1@2000-01-01' / 0;
@@ -582,3 +613,6 @@ SELECT round(derivative(tfloat 'Interp=Stepwise;{[1@2000-01-01, 2@2000-01-02, 1@
 
 -------------------------------------------------------------------------------
 
+DROP TABLE tbl_timestamptz_long;
+
+-------------------------------------------------------------------------------
@@ -27,6 +27,27 @@
 --
 -------------------------------------------------------------------------------
 
+-------------------------------------------------------------------------------
+-- Long sequences
+-------------------------------------------------------------------------------
+-- Timestamps of the instants of the long sequences in the tests below, which
+-- have more than 512 instants and thus a block directory
+
+CREATE TABLE tbl_timestamptz_long AS
+SELECT i, timestamptz '2000-01-01' + i * i * interval '1 minute' AS t
+FROM generate_series(0, 1000) i;
+
+-- Long sequence going right and then up, so that the restrictions below skip
+-- some blocks and keep others, and the same sequence split into pieces of 101
+-- instants, which have no block directory, to compare with
+
+CREATE TABLE tbl_tgeompoint_long AS
+SELECT tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(least(i, 500), greatest(i - 500, 0)), t) ORDER BY i)) AS seq,
+  ARRAY(SELECT tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(least(i, 500), greatest(i - 500, 0)), t) ORDER BY i))
+    FROM tbl_timestamptz_long, generate_series(0, 9) j
+    WHERE i BETWEEN j * 100 AND (j + 1) * 100 GROUP BY j ORDER BY j) AS pieces
+FROM tbl_timestamptz_long;
+
 -------------------------------------------------------------------------------
 -- STBOX
 
@@ -290,6 +311,14 @@ SELECT ST_AsText(trajectory(tgeompoint '{[Point(1 1)@2001-01-01], [Point(1 1)@20
 SELECT ST_AsText(trajectory(tgeogpoint '{[Point(1 1)@2001-01-01], [Point(1 1)@2001-02-01], [Point(1 1)@2001-03-01]}'));
 SELECT ST_AsText(trajectory(tgeompoint 'Interp=Stepwise;{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02],[Point(1 1)@2000-01-03, Point(2 2)@2000-01-04]}'));
 
+SELECT ST_NPoints(trajectory(tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(i / 2, 0), t) ORDER BY i)))) FROM tbl_timestamptz_long;
+SELECT ST_AsText(trajectory(tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(i / 2, 0), t) ORDER BY i)))) =
+  (SELECT ST_AsText(ST_MakeLine(array_agg(ST_Point(j, 0) ORDER BY j))) FROM generate_series(0, 500) j) FROM tbl_timestamptz_long;
+SELECT ST_NPoints(trajectory(tgeompoint_seq(array_agg(tgeompoint_inst(ST_MakePoint(i / 2, 0, i / 2), t) ORDER BY i)))) FROM tbl_timestamptz_long;
+SELECT GeometryType(trajectory(tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(i / 2, 0), t) ORDER BY i), true, true, false))) FROM tbl_timestamptz_long;
+SELECT ST_NPoints(trajectory(tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(i / 2, 0), t) ORDER BY i), true, true, false))) FROM tbl_timestamptz_long;
+SELECT ST_NPoints(trajectory(tgeogpoint_seq(array_agg(tgeogpoint_inst(ST_Point((i / 2) * 0.1, 0)::geography, t) ORDER BY i)))::geometry) FROM tbl_timestamptz_long;
+
 --------------------------------------------------------
 
 -- 2D
@@ -759,6 +788,11 @@ SELECT asText(minusGeometry(tgeompoint '{[Point(1 1)@2000-01-01, Point(3 3)@2000
 SELECT asText(minusGeometry(tgeompoint 'Point(1 1)@2000-01-01', geometry 'Linestring(1 1 1,2 2 2)'));
 SELECT asText(minusGeometry(tgeompoint 'Point(1 1 1)@2000-01-01', geometry 'Linestring(1 1,2 2)'));
 
+-- Long sequences
+SELECT atGeometry(seq, geometry 'Polygon((300 -1,300 1,310 1,310 -1,300 -1))') = (SELECT merge(array_agg(r)) FROM unnest(pieces) p, atGeometry(p, geometry 'Polygon((300 -1,300 1,310 1,310 -1,300 -1))') r WHERE r IS NOT NULL) FROM tbl_tgeompoint_long;
+SELECT minusGeometry(seq, geometry 'Polygon((300 -1,300 1,310 1,310 -1,300 -1))') = (SELECT merge(array_agg(r)) FROM unnest(pieces) p, minusGeometry(p, geometry 'Polygon((300 -1,300 1,310 1,310 -1,300 -1))') r WHERE r IS NOT NULL) FROM tbl_tgeompoint_long;
+SELECT atGeometry(seq, geometry 'Polygon((200 200,200 300,300 300,300 200,200 200))') IS NULL AND minusGeometry(seq, geometry 'Polygon((200 200,200 300,300 300,300 200,200 200))') = seq FROM tbl_tgeompoint_long;
+
 /* Errors */
 SELECT minusGeometry(tgeompoint 'Point(1 1)@2000-01-01', geometry 'SRID=5676;Linestring(1 1,2 2)');
 
@@ -782,9 +816,88 @@ SELECT asText(minusStbox(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01
 SELECT asText(minusStbox(tgeompoint 'Interp=Stepwise;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', 'STBOX XT(((1,1),(2,2)),[2000-01-01,2000-01-02])'));
 SELECT asText(minusStbox(tgeompoint 'Interp=Stepwise;{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', 'STBOX XT(((1,1),(2,2)),[2000-01-01,2000-01-02])'));
 
+-- Long sequences
+SELECT atStbox(seq, stbox 'STBOX X(((490,-1),(510,20)))') = (SELECT merge(array_agg(r)) FROM unnest(pieces) p, atStbox(p, stbox 'STBOX X(((490,-1),(510,20)))') r WHERE r IS NOT NULL) FROM tbl_tgeompoint_long;
+SELECT minusStbox(seq, stbox 'STBOX X(((490,-1),(510,20)))') = (SELECT merge(array_agg(r)) FROM unnest(pieces) p, minusStbox(p, stbox 'STBOX X(((490,-1),(510,20)))') r WHERE r IS NOT NULL) FROM tbl_tgeompoint_long;
+SELECT atStbox(seq, stbox 'STBOX X(((200,200),(300,300)))') IS NULL AND minusStbox(seq, stbox 'STBOX X(((200,200),(300,300)))') = seq FROM tbl_tgeompoint_long;
+
 /* Errors */
 SELECT asText(atStbox(tgeompoint 'SRID=4326;Point(1 1)@2000-01-01', 'GEODSTBOX ZT(((1,1,1),(2,2,2)),[2000-01-01,2000-01-02])'));
 SELECT asText(atStbox(tgeompoint 'SRID=5676;Point(1 1)@2000-01-01', 'STBOX XT(((1,1),(2,2)),[2000-01-01,2000-01-02])'));
 SELECT asText(atStbox(tgeompoint 'Point(1 1)@2000-01-01', 'STBOX ZT(((1,1,1),(2,2,2)),[2000-01-01,2000-01-02])'));
 
 -------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Motion metrics
+-------------------------------------------------------------------------------
+
+WITH geom(t) AS (VALUES
+    (tgeompoint 'Point(1 1)@2000-01-01'),
+    (tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}'),
+    (tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]'),
+    (tgeompoint '[Point(1 1)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03, Point(2 2)@2000-01-04, Point(3 1)@2000-01-05]'),
+    (tgeompoint '[Point(1 1)@2000-01-01, Point(1 1)@2000-01-02]'),
+    (tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}'),
+    (tgeompoint '{(Point(1 1)@2000-01-01, Point(2 2)@2000-01-02), (Point(2 2)@2000-01-02, Point(4 1)@2000-01-03], [Point(3 3)@2000-01-04]}'),
+    (tgeompoint 'Interp=Stepwise;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]'),
+    (tgeompoint 'Interp=Stepwise;{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}')),
+  geog(t) AS (VALUES
+    (tgeogpoint 'Point(1.5 1.5)@2000-01-01'),
+    (tgeogpoint '{Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03}'),
+    (tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]'),
+    (tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(1.5 1.5)@2000-01-02, Point(2.5 2.5)@2000-01-03]'),
+    (tgeogpoint '{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}'),
+    (tgeogpoint 'Interp=Stepwise;[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]')),
+  temp(m, length, cumulativeLength, speed, azimuth) AS (
+    SELECT motionMetrics(t), length(t), cumulativeLength(t),
+      CASE WHEN interpolation(t) = 'Linear' THEN speed(t) END, azimuth(t) FROM geom
+    UNION ALL
+    SELECT motionMetrics(t), length(t), cumulativeLength(t),
+      CASE WHEN interpolation(t) = 'Linear' THEN speed(t) END, azimuth(t) FROM geog)
+SELECT bool_and(abs((m).length - length) <= 1e-9 * (1 + length) AND
+  round((m).cumulativeLength, 6) = round(cumulativeLength, 6) AND
+  round((m).speed, 6) IS NOT DISTINCT FROM round(speed, 6) AND
+  round((m).azimuth, 6) IS NOT DISTINCT FROM round(azimuth, 6))
+FROM temp;
+
+SELECT (motionMetrics(tgeompoint '[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02]')).length;
+
+-------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Self-intersections of long sequences
+-------------------------------------------------------------------------------
+
+SELECT isSimple(x) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 999) k) t;
+SELECT array_length(makeSimple(x), 1) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 999) k) t;
+SELECT bool_and(isSimple(p)) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 999) k) t, unnest(makeSimple(x)) p;
+SELECT isSimple(x) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(CASE WHEN k <= 100 THEN ST_Point(k, 0) WHEN k = 101 THEN ST_Point(100, 100) WHEN k = 102 THEN ST_Point(50, 100) ELSE ST_Point(50, -50) END, timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 103) k) t;
+SELECT array_length(makeSimple(x), 1) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(CASE WHEN k <= 100 THEN ST_Point(k, 0) WHEN k = 101 THEN ST_Point(100, 100) WHEN k = 102 THEN ST_Point(50, 100) ELSE ST_Point(50, -50) END, timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 103) k) t;
+SELECT bool_and(isSimple(p)) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(CASE WHEN k <= 100 THEN ST_Point(k, 0) WHEN k = 101 THEN ST_Point(100, 100) WHEN k = 102 THEN ST_Point(50, 100) ELSE ST_Point(50, -50) END, timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 103) k) t, unnest(makeSimple(x)) p;
+SELECT isSimple(x) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(CASE WHEN k = 0 THEN ST_Point(0, 0) WHEN k = 1 THEN ST_Point(1000, 0) WHEN k <= 101 THEN ST_Point(1000 - (k - 1) * 10, 10) ELSE ST_Point(500, -10) END, timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 102) k) t;
+SELECT array_length(makeSimple(x), 1) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(CASE WHEN k = 0 THEN ST_Point(0, 0) WHEN k = 1 THEN ST_Point(1000, 0) WHEN k <= 101 THEN ST_Point(1000 - (k - 1) * 10, 10) ELSE ST_Point(500, -10) END, timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 102) k) t;
+SELECT bool_and(isSimple(p)) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(CASE WHEN k = 0 THEN ST_Point(0, 0) WHEN k = 1 THEN ST_Point(1000, 0) WHEN k <= 101 THEN ST_Point(1000 - (k - 1) * 10, 10) ELSE ST_Point(500, -10) END, timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 102) k) t, unnest(makeSimple(x)) p;
+SELECT isSimple(x) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k), true, true, false) AS x FROM generate_series(0, 999) k) t;
+SELECT array_length(makeSimple(x), 1) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k), true, true, false) AS x FROM generate_series(0, 999) k) t;
+SELECT bool_and(isSimple(p)) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k), true, true, false) AS x FROM generate_series(0, 999) k) t, unnest(makeSimple(x)) p;
+SELECT isSimple(x) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(CASE WHEN k = 1000 THEN ST_Point(500, 0) ELSE ST_Point(k, k % 2) END, timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k), true, true, false) AS x FROM generate_series(0, 1000) k) t;
+SELECT array_length(makeSimple(x), 1) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(CASE WHEN k = 1000 THEN ST_Point(500, 0) ELSE ST_Point(k, k % 2) END, timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k), true, true, false) AS x FROM generate_series(0, 1000) k) t;
+SELECT bool_and(isSimple(p)) FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(CASE WHEN k = 1000 THEN ST_Point(500, 0) ELSE ST_Point(k, k % 2) END, timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k), true, true, false) AS x FROM generate_series(0, 1000) k) t, unnest(makeSimple(x)) p;
+SELECT isSimple(x) FROM (SELECT tgeompoint_instset(array_agg(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 999) k) t;
+SELECT array_length(makeSimple(x), 1) FROM (SELECT tgeompoint_instset(array_agg(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 999) k) t;
+SELECT bool_and(isSimple(p)) FROM (SELECT tgeompoint_instset(array_agg(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 999) k) t, unnest(makeSimple(x)) p;
+SELECT isSimple(x) FROM (SELECT tgeompoint_instset(array_agg(tgeompoint_inst(CASE WHEN k = 1000 THEN ST_Point(500, 0) ELSE ST_Point(k, k % 2) END, timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 1000) k) t;
+SELECT array_length(makeSimple(x), 1) FROM (SELECT tgeompoint_instset(array_agg(tgeompoint_inst(CASE WHEN k = 1000 THEN ST_Point(500, 0) ELSE ST_Point(k, k % 2) END, timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 1000) k) t;
+SELECT bool_and(isSimple(p)) FROM (SELECT tgeompoint_instset(array_agg(tgeompoint_inst(CASE WHEN k = 1000 THEN ST_Point(500, 0) ELSE ST_Point(k, k % 2) END, timestamptz '2000-01-01' + k * k * interval '1 minute') ORDER BY k)) AS x FROM generate_series(0, 1000) k) t, unnest(makeSimple(x)) p;
+
+SELECT isSimple(tgeompoint '{Point(0.000001 0)@2000-01-01, Point(1 1)@2000-01-02, Point(0.0000009999995 0)@2000-01-03}');
+SELECT array_length(makeSimple(tgeompoint '{Point(0.000001 0)@2000-01-01, Point(1 1)@2000-01-02, Point(0.0000009999995 0)@2000-01-03}'), 1);
+SELECT isSimple(tgeompoint 'Interp=Stepwise;[Point(0 0.000002)@2000-01-01, Point(1 1)@2000-01-02, Point(0 0.0000020000005)@2000-01-03]');
+
+-------------------------------------------------------------------------------
+
+DROP TABLE tbl_tgeompoint_long;
+DROP TABLE tbl_timestamptz_long;
+
+-------------------------------------------------------------------------------
@@ -819,3 +819,46 @@ SELECT shortestLine(geography 'Linestring(0 0 0,3 3 3)', tgeogpoint 'Point(1.5 1
 SELECT shortestLine(tgeogpoint 'Point(1.5 1.5 1.5)@2000-01-01', geography 'Linestring(0 0 0,3 3 3)');
 
 --------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Temporal distance between linear sequences
+-------------------------------------------------------------------------------
+
+SELECT round(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]' <-> tgeompoint '(Point(4 2)@2000-01-02, Point(0 2)@2000-01-04, Point(0 0)@2000-01-06]', 6);
+SELECT (a <-> b) = tfloat_seq(tgeompoint_seqset(a) <-> tgeompoint_seqset(b))
+FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(k, k % 3), timestamptz '2000-01-01' + k * interval '1 minute') ORDER BY k)) AS a FROM generate_series(0, 999) k) t1,
+  (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(1000 - k, k % 5 - 2), timestamptz '2000-01-01' + k * interval '1 minute' + interval '20 seconds') ORDER BY k)) AS b FROM generate_series(0, 999) k) t2;
+SELECT (a <-> b) = tfloat_seq(tgeompoint_seqset(a) <-> tgeompoint_seqset(b))
+FROM (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(ST_MakePoint(k, k % 3, k % 2), timestamptz '2000-01-01' + k * interval '1 minute') ORDER BY k)) AS a FROM generate_series(0, 999) k) t1,
+  (SELECT tgeompoint_seq(array_agg(tgeompoint_inst(ST_MakePoint(1000 - k, k % 5 - 2, k % 4), timestamptz '2000-01-01' + k * interval '1 minute' + interval '20 seconds') ORDER BY k)) AS b FROM generate_series(0, 999) k) t2;
+
+-------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Nearest approach distance of sequence sets
+-------------------------------------------------------------------------------
+
+SELECT round(NearestApproachDistance(a, geometry 'GEOMETRYCOLLECTION(Point(2000 5),Linestring(502 3,503 100),Point(-50 -50))')::numeric, 6)
+FROM (SELECT tgeompoint_seqset(array_agg(tgeompoint_seq(ARRAY[tgeompoint_inst(ST_Point(10 * i, 0), timestamptz '2000-01-01' + i * interval '1 day'),
+    tgeompoint_inst(ST_Point(10 * i + 5, 0), timestamptz '2000-01-01' + i * interval '1 day' + interval '12 hours')]) ORDER BY i)) AS a
+  FROM generate_series(0, 99) i) t;
+SELECT round(NearestApproachDistance(a, geometry 'Linestring(502 -1,502 1)')::numeric, 6)
+FROM (SELECT tgeompoint_seqset(array_agg(tgeompoint_seq(ARRAY[tgeompoint_inst(ST_Point(10 * i, 0), timestamptz '2000-01-01' + i * interval '1 day'),
+    tgeompoint_inst(ST_Point(10 * i + 5, 0), timestamptz '2000-01-01' + i * interval '1 day' + interval '12 hours')]) ORDER BY i)) AS a
+  FROM generate_series(0, 99) i) t;
+SELECT round(NearestApproachDistance(a, b)::numeric, 6)
+FROM (SELECT tgeompoint_seqset(array_agg(tgeompoint_seq(ARRAY[tgeompoint_inst(ST_Point(10 * i, 0), timestamptz '2000-01-01' + i * interval '1 day'),
+    tgeompoint_inst(ST_Point(10 * i + 5, 0), timestamptz '2000-01-01' + i * interval '1 day' + interval '12 hours')]) ORDER BY i)) AS a
+  FROM generate_series(0, 99) i) t1,
+  (SELECT tgeompoint_seqset(array_agg(tgeompoint_seq(ARRAY[tgeompoint_inst(ST_Point(10 * i + 5, 4 + abs(i - 37)), timestamptz '2000-01-01' + i * interval '1 day'),
+    tgeompoint_inst(ST_Point(10 * i, 4 + abs(i - 37)), timestamptz '2000-01-01' + i * interval '1 day' + interval '12 hours')]) ORDER BY i)) AS b
+  FROM generate_series(0, 99) i) t2;
+SELECT NearestApproachDistance(a, b) = minValue(a <-> b)
+FROM (SELECT tgeompoint_seqset(array_agg(tgeompoint_seq(ARRAY[tgeompoint_inst(ST_Point(10 * i, 0), timestamptz '2000-01-01' + i * interval '1 day'),
+    tgeompoint_inst(ST_Point(10 * i + 5, 0), timestamptz '2000-01-01' + i * interval '1 day' + interval '12 hours')]) ORDER BY i)) AS a
+  FROM generate_series(0, 99) i) t1,
+  (SELECT tgeompoint_seqset(array_agg(tgeompoint_seq(ARRAY[tgeompoint_inst(ST_Point(10 * i + 5, 4 + abs(i - 37)), timestamptz '2000-01-01' + i * interval '1 day'),
+    tgeompoint_inst(ST_Point(10 * i, 4 + abs(i - 37)), timestamptz '2000-01-01' + i * interval '1 day' + interval '12 hours')]) ORDER BY i)) AS b
+  FROM generate_series(0, 99) i) t2;
+
+-------------------------------------------------------------------------------
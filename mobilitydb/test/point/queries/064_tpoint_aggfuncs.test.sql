@@ -83,3 +83,28 @@ SELECT extent(temp) FROM (VALUES
   (tgeompoint 'Point(1 1)@2000-01-01')) t(temp);
 
 -------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Online compression
+-------------------------------------------------------------------------------
+
+SELECT numInstants(compress(tgeompoint_inst(ST_Point(k, k), timestamptz '2000-01-01' + k * interval '1 day'), 'deadreckoning', 0.1 ORDER BY k)) FROM generate_series(0, 10) k;
+SELECT numInstants(compress(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * interval '1 day'), 'deadreckoning', 0.1 ORDER BY k)) FROM generate_series(0, 10) k;
+SELECT compress(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * interval '1 day'), 'DeadReckoning', 5.0 ORDER BY k) = tgeompoint '[Point(0 0)@2000-01-01, Point(10 0)@2000-01-11]' FROM generate_series(0, 10) k;
+SELECT numInstants(compress(tgeompoint_inst(ST_Point(k, k), timestamptz '2000-01-01' + k * interval '1 day'), 'squishe', 0.1 ORDER BY k)) FROM generate_series(0, 10) k;
+SELECT numInstants(compress(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * interval '1 day'), 'squishe', 0.1 ORDER BY k)) FROM generate_series(0, 10) k;
+SELECT compress(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * interval '1 day'), 'squishe', 0.1 ORDER BY k) = tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * interval '1 day') ORDER BY k)) FROM generate_series(0, 10) k;
+SELECT compress(tgeompoint_inst(ST_Point(k, k), timestamptz '2000-01-01' + k * interval '1 day'), 'squishe', 0.1, 3 ORDER BY k) = tgeompoint '[Point(0 0)@2000-01-01, Point(10 10)@2000-01-11]' FROM generate_series(0, 10) k;
+SELECT compress(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * interval '1 day'), 'squishe', 0.1, 3 ORDER BY k) = tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(k, k % 2), timestamptz '2000-01-01' + k * interval '1 day') ORDER BY k)) FROM generate_series(0, 10) k;
+SELECT compress(tgeompoint_inst(ST_Point(k, k), timestamptz '2000-01-01' + k * interval '1 day'), 'squishe', 0.1 ORDER BY k) IS NULL FROM generate_series(1, 0) k;
+
+SELECT compress(tgeompoint_inst(ST_Point(k, k), timestamptz '2000-01-01' + k * interval '1 day'), 'foo', 0.1 ORDER BY k) FROM generate_series(0, 10) k;
+SELECT compress(tgeompoint_inst(ST_Point(k, k), timestamptz '2000-01-01' + k * interval '1 day'), 'deadreckoning', -1.0 ORDER BY k) FROM generate_series(0, 10) k;
+SELECT compress(tgeompoint_inst(ST_Point(k, k), timestamptz '2000-01-01' + k * interval '1 day'), 'squishe', -1.0, 10 ORDER BY k) FROM generate_series(0, 10) k;
+SELECT compress(tgeompoint_inst(ST_Point(k, k), timestamptz '2000-01-01' + k * interval '1 day'), 'squishe', 0.1, 2 ORDER BY k) FROM generate_series(0, 10) k;
+SELECT compress(tgeompoint_inst(ST_Point(k, k), timestamptz '2000-01-01' + k * interval '1 day'), NULL, 0.1 ORDER BY k) FROM generate_series(0, 10) k;
+SELECT compress(tgeompoint_inst(ST_Point(k, k), timestamptz '2000-01-01' + k * interval '1 day'), 'squishe', 0.1, NULL ORDER BY k) FROM generate_series(0, 10) k;
+SELECT compress(tgeompoint_inst(ST_Point(k, k), timestamptz '2000-01-01' + k * interval '1 day'), 'deadreckoning', 0.1 ORDER BY k DESC) FROM generate_series(0, 10) k;
+SELECT compress(tgeompoint_inst(ST_Point(k, k), timestamptz '2000-01-01' + k * interval '1 day'), 'squishe', 0.1 ORDER BY k DESC) FROM generate_series(0, 10) k;
+
+-------------------------------------------------------------------------------
@@ -506,3 +506,14 @@ SELECT dwithin(tgeogpoint 'Point(1 1)@2000-01-01', geography 'SRID=4283;Point(1
 SELECT dwithin(tgeogpoint 'SRID=4283;Point(1 1)@2000-01-01', tgeogpoint 'Point(1 1)@2000-01-01', 2);
 
 -------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Distance threshold between geography points
+-------------------------------------------------------------------------------
+
+SELECT COUNT(*) FROM generate_series(1, 80) i, unnest(ARRAY[0.9, 0.99, 0.995, 0.999, 1.001, 1.005, 1.01, 1.1]::float[]) f, LATERAL (SELECT geography(ST_Point(i * 4.4 - 176, i - 40.5)) AS g1, geography(ST_Point(i * 4.4 - 176 + 0.5, i - 40.5 + 0.3)) AS g2) p WHERE dwithin(g1, tgeogpoint_inst(g2, timestamptz '2000-01-01'), f * ST_Distance(g1, g2)) <> ST_DWithin(g1, g2, f * ST_Distance(g1, g2));
+SELECT COUNT(*) FROM generate_series(1, 80) i, unnest(ARRAY[0.9, 0.99, 0.995, 0.999, 1.001, 1.005, 1.01, 1.1]::float[]) f, LATERAL (SELECT geography(ST_Point(i * 4.4 - 176, i - 40.5)) AS g1, geography(ST_Point(i * 4.4 - 176 + 0.5, i - 40.5 + 0.3)) AS g2) p WHERE dwithin(g1, tgeogpoint_inst(g2, timestamptz '2000-01-01'), f * ST_Distance(g1, g2));
+SELECT COUNT(*) FROM generate_series(1, 80) i, unnest(ARRAY[0.9, 0.99, 0.995, 0.999, 1.001, 1.005, 1.01, 1.1]::float[]) f, LATERAL (SELECT geography(ST_Point(i * 4.4 - 176, i - 40.5)) AS g1, geography(ST_Point(i * 4.4 - 176 + 1.5, i - 40.5 + 0.7)) AS g2) p WHERE dwithin(g1, tgeogpoint_inst(g2, timestamptz '2000-01-01'), f * ST_Distance(g1, g2)) <> ST_DWithin(g1, g2, f * ST_Distance(g1, g2));
+SELECT COUNT(*) FROM generate_series(1, 80) i, unnest(ARRAY[0.9, 0.99, 0.995, 0.999, 1.001, 1.005, 1.01, 1.1]::float[]) f, LATERAL (SELECT geography(ST_Point(i * 4.4 - 176, i - 40.5)) AS g1, geography(ST_Point(i * 4.4 - 176 + 1.5, i - 40.5 + 0.7)) AS g2) p WHERE dwithin(g1, tgeogpoint_inst(g2, timestamptz '2000-01-01'), f * ST_Distance(g1, g2));
+
+-------------------------------------------------------------------------------
@@ -0,0 +1,70 @@
+-------------------------------------------------------------------------------
+--
+-- This MobilityDB code is provided under The PostgreSQL License.
+-- Copyright (c) 2016-2022, Université libre de Bruxelles and MobilityDB
+-- contributors
+--
+-- MobilityDB includes portions of PostGIS version 3 source code released
+-- under the GNU General Public License (GPLv2 or later).
+-- Copyright (c) 2001-2022, PostGIS contributors
+--
+-- Permission to use, copy, modify, and distribute this software and its
+-- documentation for any purpose, without fee, and without a written
+-- agreement is hereby granted, provided that the above copyright notice and
+-- this paragraph and the following two paragraphs appear in all copies.
+--
+-- IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+-- DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+-- LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+-- EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+-- OF SUCH DAMAGE.
+--
+-- UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+-- INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+-- AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+-- AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+-- PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS. 
+--
+-------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Generation of trips on a road network
+-------------------------------------------------------------------------------
+
+CREATE TABLE tbl_datagen_edges(geom geometry, source int, target int, maxSpeed float, category int);
+INSERT INTO tbl_datagen_edges VALUES (geometry 'Linestring(0 0,100 0)', 1, 2, 50.0, 0), (geometry 'Linestring(100 0,100 100)', 2, 3, 50.0, 1), (geometry 'Linestring(100 100,0 100)', 3, 4, 30.0, 0), (geometry 'Linestring(0 100,0 0)', 4, 1, 30.0, 2), (geometry 'Linestring(0 0,50 50,100 100)', 1, 3, 70.0, 1);
+
+SELECT COUNT(*) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 3, 3, date '2000-01-03', 1);
+SELECT COUNT(DISTINCT (vehicle, day)) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 3, 3, date '2000-01-03', 1);
+SELECT bool_and(seqno IN (1, 2)) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 3, 3, date '2000-01-03', 1);
+SELECT bool_and(ST_X(startValue(trip)) IN (0, 100) AND ST_Y(startValue(trip)) IN (0, 100) AND ST_X(endValue(trip)) IN (0, 100) AND ST_Y(endValue(trip)) IN (0, 100)) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 3, 3, date '2000-01-03', 1);
+SELECT bool_and(startTimestamp(trip)::date = day) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 3, 3, date '2000-01-03', 1);
+SELECT COUNT(*) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 2, 7, date '2000-01-03', 5) WHERE extract(dow FROM day) BETWEEN 1 AND 5;
+SELECT bool_and(seqno IN (1, 2)) IS NOT FALSE FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 2, 7, date '2000-01-03', 5) WHERE extract(dow FROM day) IN (0, 6);
+
+SELECT (SELECT array_agg(asText(trip) ORDER BY vehicle, day, seqno) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 3, 3, date '2000-01-03', 42)) = (SELECT array_agg(asText(trip) ORDER BY vehicle, day, seqno) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 3, 3, date '2000-01-03', 42));
+SELECT (SELECT array_agg(asText(trip) ORDER BY vehicle, day, seqno) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 3, 3, date '2000-01-03', 42, true)) = (SELECT array_agg(asText(trip) ORDER BY vehicle, day, seqno) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 3, 3, date '2000-01-03', 42, true));
+SELECT (SELECT array_agg(asText(trip) ORDER BY vehicle, day, seqno) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 3, 3, date '2000-01-03', 42)) = (SELECT array_agg(asText(trip) ORDER BY vehicle, day, seqno) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 3, 3, date '2000-01-03', 43));
+SELECT (SELECT array_agg(asText(trip) ORDER BY vehicle, day, seqno) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 4, 3, date '2000-01-03', 42)) = (SELECT array_agg(asText(trip) ORDER BY vehicle, day, seqno) FROM (SELECT * FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 2, 3, date '2000-01-03', 42) UNION ALL SELECT * FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 3, 4, 3, date '2000-01-03', 42)) t);
+SELECT (SELECT array_agg(asText(trip) ORDER BY vehicle, day, seqno) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 3, 3, 3, date '2000-01-03', 42)) = (SELECT array_agg(asText(trip) ORDER BY vehicle, day, seqno) FROM (SELECT * FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 4, 3, date '2000-01-03', 42) WHERE vehicle = 3) t);
+
+SELECT COUNT(*) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 2, 1, 3, date '2000-01-03', 1);
+SELECT COUNT(*) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 0, 1, 3, date '2000-01-03', 1);
+SELECT COUNT(*) FROM create_trips((SELECT array_agg(ROW(geom, source, target, maxSpeed, category) ORDER BY source, target) FROM tbl_datagen_edges), 1, 1, 0, date '2000-01-03', 1);
+SELECT COUNT(*) FROM create_trips(ARRAY[ROW(geometry 'Linestring(0 0,100 0)', 1, 2)], 1, 1, 1, date '2000-01-03');
+SELECT COUNT(*) FROM create_trips(ARRAY[ROW(geometry 'Linestring(0 0,100 0)', 1, 2, 0.0::float, 0)], 1, 1, 1, date '2000-01-03');
+SELECT COUNT(*) FROM create_trips(ARRAY[ROW(geometry 'Linestring(0 0,100 0)', 1, 2, 50.0::float, 3)], 1, 1, 1, date '2000-01-03');
+
+CREATE TYPE datagen_edge AS (geom geometry, source int, target int, maxSpeed float, category int);
+CREATE TABLE tbl_datagen_network(edges datagen_edge[]);
+ALTER TABLE tbl_datagen_network ALTER COLUMN edges SET STORAGE EXTERNAL;
+INSERT INTO tbl_datagen_network SELECT array_agg(ROW(ST_Segmentize(geom, 0.5), source, target, maxSpeed, category)::datagen_edge ORDER BY source, target) FROM tbl_datagen_edges;
+SELECT COUNT(*) FROM create_trips((SELECT edges FROM tbl_datagen_network), 1, 3, 3, date '2000-01-03', 1);
+SELECT bool_and(ST_X(startValue(trip)) IN (0, 100) AND ST_Y(startValue(trip)) IN (0, 100) AND ST_X(endValue(trip)) IN (0, 100) AND ST_Y(endValue(trip)) IN (0, 100)) FROM create_trips((SELECT edges FROM tbl_datagen_network), 1, 3, 3, date '2000-01-03', 1);
+SELECT (SELECT array_agg(asText(trip) ORDER BY vehicle, day, seqno) FROM create_trips((SELECT edges FROM tbl_datagen_network), 1, 4, 3, date '2000-01-03', 42)) = (SELECT array_agg(asText(trip) ORDER BY vehicle, day, seqno) FROM create_trips((SELECT array_agg(ROW(ST_Segmentize(geom, 0.5), source, target, maxSpeed, category)::datagen_edge ORDER BY source, target) FROM tbl_datagen_edges), 1, 4, 3, date '2000-01-03', 42));
+DROP TABLE tbl_datagen_network;
+DROP TYPE datagen_edge;
+
+DROP TABLE tbl_datagen_edges;
+
+-------------------------------------------------------------------------------
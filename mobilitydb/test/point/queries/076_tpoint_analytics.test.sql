@@ -193,3 +193,54 @@ SELECT asText(simplify(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02
 SELECT asText(simplify(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-04]', 1, true));
 
 -------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Repeated points and gridding in asMVTGeom
+-------------------------------------------------------------------------------
+
+SELECT ST_AsText((mvt).geom), array_length((mvt).times, 1)
+FROM (SELECT asMVTGeom(tgeompoint '{Point(0 0)@2000-01-01, Point(0.1 0)@2000-01-02, Point(0.2 0)@2000-01-03, Point(100 0)@2000-01-04, Point(200 0)@2000-01-05, Point(300 0)@2000-01-06}',
+  stbox 'STBOX X(((0,0),(4096,4096)))') AS mvt) AS t;
+SELECT ST_AsText((mvt).geom), array_length((mvt).times, 1)
+FROM (SELECT asMVTGeom(tgeompoint '{Point(0 0)@2000-01-01, Point(100 100)@2000-01-02, Point(100.1 100)@2000-01-03}',
+  stbox 'STBOX X(((0,0),(4096,4096)))') AS mvt) AS t;
+SELECT ST_AsText((mvt).geom), array_length((mvt).times, 1)
+FROM (SELECT asMVTGeom(tgeompoint '{Point(0 0)@2000-01-01, Point(0.4 0.4)@2000-01-02, Point(100 50)@2000-01-03}',
+  stbox 'STBOX X(((0,0),(4096,4096)))') AS mvt) AS t;
+SELECT ST_AsText((mvt).geom), array_length((mvt).times, 1)
+FROM (SELECT asMVTGeom(tgeompoint 'Interp=Stepwise;[Point(0 0)@2000-01-01, Point(0.4 0.4)@2000-01-02, Point(100 50)@2000-01-03]',
+  stbox 'STBOX X(((0,0),(4096,4096)))') AS mvt) AS t;
+SELECT ST_AsText((mvt).geom), array_length((mvt).times, 1)
+FROM (SELECT asMVTGeom(tgeompoint 'Interp=Stepwise;[Point(0 0)@2000-01-01, Point(10 10)@2000-01-02, Point(10 10)@2000-01-03)',
+  stbox 'STBOX X(((0,0),(4096,4096)))') AS mvt) AS t;
+SELECT ST_AsText((mvt).geom), array_length((mvt).times, 1)
+FROM (SELECT asMVTGeom(tgeompoint 'Interp=Stepwise;[Point(0 0)@2000-01-01, Point(10 10)@2000-01-02, Point(10.4 10.4)@2000-01-03, Point(10.4 10.4)@2000-01-04)',
+  stbox 'STBOX X(((0,0),(4096,4096)))') AS mvt) AS t;
+SELECT ST_AsText((mvt).geom)
+FROM (SELECT asMVTGeom(tgeompoint 'Interp=Stepwise;[Point(0 0)@2000-01-01, Point(0.3 0)@2000-01-02, Point(0.3 0)@2000-01-03)',
+  stbox 'STBOX X(((0,0),(4096,4096)))') AS mvt) AS t;
+SELECT ST_NPoints((mvt).geom), array_length((mvt).times, 1)
+FROM (SELECT asMVTGeom(tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(10 * k + 0.1 * j, 100 * (k % 2)),
+  timestamptz '2000-01-01' + k * k * interval '1 minute' + j * interval '30 seconds') ORDER BY k, j)),
+  stbox 'STBOX X(((0,0),(4096,4096)))') AS mvt
+  FROM generate_series(0, 99) k, generate_series(0, 1) j) AS t;
+SELECT ST_AsText(ST_EndPoint((mvt).geom))
+FROM (SELECT asMVTGeom(tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(10 * k + 0.1 * j, 100 * (k % 2)),
+  timestamptz '2000-01-01' + k * k * interval '1 minute' + j * interval '30 seconds') ORDER BY k, j)),
+  stbox 'STBOX X(((0,0),(4096,4096)))') AS mvt
+  FROM generate_series(0, 99) k, generate_series(0, 1) j) AS t;
+
+-------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Simplification of long sequences
+-------------------------------------------------------------------------------
+
+SELECT asText(simplify(tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(k, CASE WHEN k <= 20000 THEN 0 WHEN k <= 40000 THEN (k - 20000) / 200.0 ELSE (70000 - k) / 300.0 END),
+  timestamptz '2000-01-01' + k * interval '1 minute' + (k % 2) * interval '1 second') ORDER BY k)), 1)) FROM generate_series(0, 70000) k;
+SELECT asText(simplify(tgeompoint_seq(array_agg(tgeompoint_inst(ST_Point(k, CASE WHEN k <= 20000 THEN 0 WHEN k <= 40000 THEN (k - 20000) / 200.0 ELSE (70000 - k) / 300.0 END),
+  timestamptz '2000-01-01' + k * interval '1 minute' + (k % 2) * interval '1 second') ORDER BY k)), 1, true)) FROM generate_series(0, 70000) k;
+SELECT simplify(tfloat_seq(array_agg(tfloat_inst(CASE WHEN k <= 20000 THEN 0 WHEN k <= 40000 THEN (k - 20000) / 200.0 ELSE (70000 - k) / 300.0 END,
+  timestamptz '2000-01-01' + k * interval '1 minute' + (k % 2) * interval '1 second') ORDER BY k)), 1) FROM generate_series(0, 70000) k;
+
+-------------------------------------------------------------------------------